@@ -0,0 +1,252 @@
+#include "core/Arena.h"
+#include "http/HttpServer.h"
+#include "http/Response.h"
+#include "utils/Logger.h"
+#include <arpa/inet.h>
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+// 统计全局堆分配次数：计数器allocs_per_request为每次迭代（每个请求）经过operator new的次数
+namespace
+{
+std::atomic<uint64_t> allocations{0};
+}
+
+void* operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// 替换后的operator new以malloc分配，GCC内联后会把与之配对的free误报为不匹配
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+// 默认的pmr内存资源（new_delete_resource）经过带对齐参数的版本
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    size_t align = static_cast<size_t>(alignment);
+    if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+constexpr int PORT = 18190;
+const std::string BODY = "Hello World1111111111";
+
+void reportAllocations(benchmark::State& state, uint64_t before)
+{
+    state.counters["allocs_per_request"] = benchmark::Counter(
+        static_cast<double>(allocations.load(std::memory_order_relaxed) - before) / state.iterations());
+}
+
+// 处理器的典型响应：两个头部和一个短消息体
+void fillResponse(Response& response)
+{
+    response.setHeader("Content-Type", "application/json");
+    response.setHeader("Cache-Control", "public, max-age=10");
+    response.setBody("{\"message\": \"Hello, ");
+    response.append("world\"}");
+}
+
+// 旧方式：响应的字符串和头部列表分配在全局堆
+void BM_HeapResponse(benchmark::State& state)
+{
+    const uint64_t before = allocations.load();
+    for (auto _ : state)
+    {
+        Response response;
+        fillResponse(response);
+        benchmark::DoNotOptimize(response.body().data());
+    }
+    reportAllocations(state, before);
+}
+
+// 连接的请求内存池：请求结束后整体重置，块在线程本地链表中复用
+void BM_ArenaResponse(benchmark::State& state)
+{
+    Arena arena;
+    const uint64_t before = allocations.load();
+    for (auto _ : state)
+    {
+        {
+            Response response(&arena);
+            fillResponse(response);
+            benchmark::DoNotOptimize(response.body().data());
+        }
+        arena.reset();
+    }
+    reportAllocations(state, before);
+}
+
+// 进程内启动的服务器（单个Reactor），所有端到端基准共用；服务器线程不退出，由main直接结束进程
+void startServer()
+{
+    static std::once_flag once;
+    std::call_once(once, [] {
+        char dir[] = "/tmp/vortex-bench-XXXXXX";
+        if (mkdtemp(dir) == nullptr)
+        {
+            return;
+        }
+        std::ofstream(std::string(dir) + "/index.txt") << std::string(1024, 'x');
+
+        ServerConfig config;
+        config.port = PORT;
+        config.threadNum = 1;
+        config.reactorNum = 1;
+        config.staticRoot = dir;
+        config.maxKeepAliveRequests = 0;
+        auto* server = new HttpServer(config);
+        server->get("/", [](const Request&, Response& response) { response.setBody(BODY); });
+        server->get("/hello/:name", [](const Request& request, Response& response) {
+            response.setHeader("Cache-Control", "public, max-age=10");
+            response.setBody("Hello ");
+            response.append(request.param("name"));
+        });
+        server->fixedRoute("GET", "/healthz", 200, "text/plain", "OK");
+        std::thread([server] { server->start(); }).detach();
+        usleep(200 * 1000);
+    });
+}
+
+int connectServer()
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(PORT);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// 读完一个响应（头部加Content-Length字节的消息体），全部数据落在buffer中
+bool readResponse(int fd, char* buffer, size_t capacity)
+{
+    size_t received = 0;
+    while (received < capacity)
+    {
+        ssize_t n = recv(fd, buffer + received, capacity - received, 0);
+        if (n <= 0)
+        {
+            return false;
+        }
+        received += static_cast<size_t>(n);
+        std::string_view data(buffer, received);
+        size_t headerEnd = data.find("\r\n\r\n");
+        if (headerEnd == std::string_view::npos)
+        {
+            continue;
+        }
+        size_t length = 0;
+        size_t field = data.find("Content-Length: ");
+        if (field != std::string_view::npos && field < headerEnd)
+        {
+            length = std::strtoul(buffer + field + 16, nullptr, 10);
+        }
+        if (received >= headerEnd + 4 + length)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 长连接上逐个发送请求并读完响应；计数包含客户端一侧（本循环不分配内存），反映服务器处理每个请求的堆分配
+void BM_ServerRequest(benchmark::State& state, const char* path)
+{
+    startServer();
+    int fd = connectServer();
+    if (fd < 0)
+    {
+        state.SkipWithError("cannot connect to the in-process server");
+        return;
+    }
+    const std::string request = std::string("GET ") + path + " HTTP/1.1\r\nHost: bench\r\nAccept: */*\r\n\r\n";
+    char buffer[16384];
+    auto roundTrip = [&] {
+        return send(fd, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size()) &&
+               readResponse(fd, buffer, sizeof(buffer));
+    };
+    // 预热：连接的缓冲区、内存池的块和各处缓存达到稳定状态
+    for (int i = 0; i < 1000; ++i)
+    {
+        roundTrip();
+    }
+
+    const uint64_t before = allocations.load();
+    for (auto _ : state)
+    {
+        if (!roundTrip())
+        {
+            state.SkipWithError("connection closed");
+            break;
+        }
+    }
+    reportAllocations(state, before);
+    close(fd);
+}
+} // namespace
+
+BENCHMARK(BM_HeapResponse);
+BENCHMARK(BM_ArenaResponse);
+BENCHMARK_CAPTURE(BM_ServerRequest, handler, "/")->UseRealTime();
+BENCHMARK_CAPTURE(BM_ServerRequest, params, "/hello/vortex")->UseRealTime();
+BENCHMARK_CAPTURE(BM_ServerRequest, fixed, "/healthz")->UseRealTime();
+BENCHMARK_CAPTURE(BM_ServerRequest, static_file, "/index.txt")->UseRealTime();
+
+int main(int argc, char** argv)
+{
+    Logger::instance().setLevel(ERROR);
+    signal(SIGPIPE, SIG_IGN);
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    // 服务器线程仍在事件循环中，跳过静态对象的析构
+    std::fflush(nullptr);
+    _exit(0);
+}
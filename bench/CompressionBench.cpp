@@ -0,0 +1,62 @@
+#include "http/Compression.h"
+#include "utils/Logger.h"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace
+{
+// 典型的JSON接口响应
+std::string makeJson(size_t size)
+{
+    std::string json = "[";
+    for (int i = 0; json.size() < size; ++i)
+    {
+        json += "{\"id\":" + std::to_string(i) + ",\"name\":\"user" + std::to_string(i * 7919 % 10007) +
+                "\",\"email\":\"user" + std::to_string(i) + "@example.com\",\"active\":" +
+                (i % 3 ? "true" : "false") + "},";
+    }
+    json.back() = ']';
+    return json;
+}
+
+// 参数：编码（1 gzip / 2 brotli）、级别、消息体大小
+void BM_Compress(benchmark::State& state)
+{
+    auto encoding = static_cast<ContentEncoding>(state.range(0));
+    if (encoding == ContentEncoding::BROTLI && !Compression::brotliAvailable())
+    {
+        state.SkipWithError("built without brotli (make BROTLI=1)");
+        return;
+    }
+    const std::string body = makeJson(static_cast<size_t>(state.range(2)));
+    std::string output;
+    for (auto _ : state)
+    {
+        Compression::compress(encoding, static_cast<int>(state.range(1)), body, output);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(body.size()));
+    state.counters["ratio"] = static_cast<double>(body.size()) / static_cast<double>(output.size());
+}
+
+void BM_Negotiate(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Compression::negotiate("gzip, deflate, br;q=0.9, zstd"));
+    }
+}
+} // namespace
+
+BENCHMARK(BM_Compress)->ArgsProduct({{1}, {1, 4, 6, 9}, {4096, 65536}});
+BENCHMARK(BM_Compress)->ArgsProduct({{2}, {4, 6, 11}, {4096, 65536}});
+BENCHMARK(BM_Negotiate);
+
+int main(int argc, char** argv)
+{
+    Logger::instance().setLevel(ERROR);
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
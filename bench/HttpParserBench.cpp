@@ -0,0 +1,154 @@
+#include "LegacyHttpParser.h"
+#include "http/CharClass.h"
+#include "http/HttpParser.h"
+#include "utils/Logger.h"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace
+{
+// 典型浏览器请求（约500字节，12个头部）
+const std::string BROWSER_REQUEST =
+    "GET /static/js/app.3f2a9c.js?v=20240101 HTTP/1.1\r\n"
+    "Host: www.example.com\r\n"
+    "Connection: keep-alive\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+    "Chrome/120.0.0.0 Safari/537.36\r\n"
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8\r\n"
+    "Accept-Encoding: gzip, deflate, br\r\n"
+    "Accept-Language: zh-CN,zh;q=0.9,en;q=0.8\r\n"
+    "Cache-Control: max-age=0\r\n"
+    "Referer: https://www.example.com/index.html\r\n"
+    "Sec-Fetch-Dest: script\r\n"
+    "Sec-Fetch-Mode: no-cors\r\n"
+    "Sec-Fetch-Site: same-origin\r\n"
+    "Cookie: session=7f9c2ba4e88f827d616045507605853e; theme=dark; lang=zh-CN\r\n"
+    "\r\n";
+
+// 最小请求（如压测工具发出的请求）
+const std::string SMALL_REQUEST =
+    "GET / HTTP/1.1\r\n"
+    "Host: localhost\r\n"
+    "\r\n";
+
+// 带长Cookie和长URL的请求，向量化收益最明显
+std::string makeLargeRequest()
+{
+    std::string request = "GET /search?q=" + std::string(1024, 'x') + " HTTP/1.1\r\n";
+    request += "Host: www.example.com\r\n";
+    request += "Cookie: " + std::string(4096, 'c') + "\r\n";
+    request += "Authorization: Bearer " + std::string(1024, 't') + "\r\n";
+    request += "\r\n";
+    return request;
+}
+const std::string LARGE_REQUEST = makeLargeRequest();
+
+const std::string& requestFor(int64_t kind)
+{
+    switch (kind)
+    {
+        case 0:
+            return SMALL_REQUEST;
+        case 1:
+            return BROWSER_REQUEST;
+        default:
+            return LARGE_REQUEST;
+    }
+}
+
+const char* requestName(int64_t kind)
+{
+    switch (kind)
+    {
+        case 0:
+            return "small";
+        case 1:
+            return "browser";
+        default:
+            return "large";
+    }
+}
+
+void BM_LegacyParse(benchmark::State& state)
+{
+    const std::string& request = requestFor(state.range(0));
+    LegacyHttpParser parser;
+    for (auto _ : state)
+    {
+        size_t consumed = parser.parse(request.data(), request.size());
+        benchmark::DoNotOptimize(consumed);
+        parser.reset();
+    }
+    state.SetLabel(requestName(state.range(0)));
+    state.SetBytesProcessed(state.iterations() * request.size());
+}
+
+void BM_Parse(benchmark::State& state)
+{
+    const std::string& request = requestFor(state.range(0));
+    auto isa = static_cast<CharClass::Isa>(state.range(1));
+    CharClass::selectIsa(isa);
+
+    HttpParser parser;
+    for (auto _ : state)
+    {
+        size_t consumed = parser.parse(request.data(), request.size());
+        benchmark::DoNotOptimize(consumed);
+        parser.reset();
+    }
+    state.SetLabel(std::string(requestName(state.range(0))) + "/" +
+                   CharClass::isaName(CharClass::currentIsa()));
+    state.SetBytesProcessed(state.iterations() * request.size());
+    CharClass::selectIsa(CharClass::bestIsa());
+}
+
+// 请求逐字节到达：旧解析器反复查找不完整的词法单元，新解析器记住已查找的位置
+void BM_ParseByteByByte(benchmark::State& state)
+{
+    const std::string& request = requestFor(state.range(0));
+    HttpParser parser;
+    for (auto _ : state)
+    {
+        for (size_t len = 1; len <= request.size(); ++len)
+        {
+            benchmark::DoNotOptimize(parser.parse(request.data(), len));
+        }
+        parser.reset();
+    }
+    state.SetLabel(requestName(state.range(0)));
+}
+
+void BM_LegacyParseByteByByte(benchmark::State& state)
+{
+    const std::string& request = requestFor(state.range(0));
+    LegacyHttpParser parser;
+    for (auto _ : state)
+    {
+        size_t offset = 0;
+        for (size_t len = 1; len <= request.size(); ++len)
+        {
+            offset += parser.parse(request.data() + offset, len - offset);
+        }
+        parser.reset();
+    }
+    state.SetLabel(requestName(state.range(0)));
+}
+} // namespace
+
+BENCHMARK(BM_LegacyParse)->DenseRange(0, 2);
+BENCHMARK(BM_Parse)->ArgsProduct({{0, 1, 2},
+                                  {static_cast<int64_t>(CharClass::Isa::SCALAR),
+                                   static_cast<int64_t>(CharClass::Isa::SSE42),
+                                   static_cast<int64_t>(CharClass::Isa::AVX2)}});
+BENCHMARK(BM_LegacyParseByteByByte)->Arg(1);
+BENCHMARK(BM_ParseByteByByte)->Arg(1);
+
+int main(int argc, char** argv)
+{
+    // 屏蔽解析器的DEBUG日志，只测量解析本身
+    Logger::instance().setLevel(ERROR);
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
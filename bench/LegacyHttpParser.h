@@ -0,0 +1,131 @@
+#pragma once
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief 向量化之前的逐字节解析器，仅作为基准测试的对照
+ *
+ * 逻辑与原HttpParser一致：std::find查找分隔符，方法、路径、版本和每个头部
+ * 都拷贝进std::string，并逐个插入unordered_map
+ */
+class LegacyHttpParser
+{
+public:
+    enum class State
+    {
+        METHOD,
+        PATH,
+        VERSION,
+        HEADER_KEY,
+        HEADER_VAL
+    };
+
+    size_t parse(const char* data, size_t length)
+    {
+        const char* begin = data;
+        const char* end = data + length;
+
+        while (data < end && !parseComplete && !parseError)
+        {
+            const char* tokenStart = data;
+            switch (state)
+            {
+                case State::METHOD:
+                    if (const char* space = std::find(data, end, ' '); space != end)
+                    {
+                        method.assign(data, space);
+                        data = space + 1;
+                        state = State::PATH;
+                    }
+                    break;
+
+                case State::PATH:
+                    if (const char* space = std::find(data, end, ' '); space != end)
+                    {
+                        path.assign(data, space);
+                        data = space + 1;
+                        state = State::VERSION;
+                    }
+                    break;
+
+                case State::VERSION:
+                    if (const char* crlf = std::find(data, end, '\r'); crlf != end && crlf + 1 < end)
+                    {
+                        version.assign(data, crlf);
+                        data = crlf + 2;
+                        state = State::HEADER_KEY;
+                    }
+                    break;
+
+                case State::HEADER_KEY: {
+                    if (*data == '\r')
+                    {
+                        if (data + 1 < end)
+                        {
+                            data += 2;
+                            parseComplete = true;
+                        }
+                        break;
+                    }
+                    const char* lineEnd = std::find(data, end, '\r');
+                    if (lineEnd == end)
+                    {
+                        break;
+                    }
+                    const char* colon = std::find(data, lineEnd, ':');
+                    if (colon == lineEnd)
+                    {
+                        parseError = true;
+                        break;
+                    }
+                    currentHeaderKey.assign(data, colon);
+                    data = colon + 1;
+                    state = State::HEADER_VAL;
+                    break;
+                }
+
+                case State::HEADER_VAL:
+                    if (const char* crlf = std::find(data, end, '\r'); crlf != end && crlf + 1 < end)
+                    {
+                        while (data < crlf && (*data == ' ' || *data == '\t')) ++data;
+                        std::string value(data, crlf);
+                        headers[currentHeaderKey] = value;
+                        data = crlf + 2;
+                        state = State::HEADER_KEY;
+                    }
+                    break;
+            }
+
+            if (data == tokenStart && !parseComplete)
+            {
+                break;
+            }
+        }
+        return data - begin;
+    }
+
+    void reset()
+    {
+        state = State::METHOD;
+        parseComplete = false;
+        parseError = false;
+        method.clear();
+        path.clear();
+        version.clear();
+        headers.clear();
+        currentHeaderKey.clear();
+    }
+
+    bool isComplete() const { return parseComplete; }
+
+private:
+    State state = State::METHOD;
+    bool parseComplete = false;
+    bool parseError = false;
+    std::string method;
+    std::string path;
+    std::string version;
+    std::unordered_map<std::string, std::string> headers;
+    std::string currentHeaderKey;
+};
@@ -0,0 +1,90 @@
+#include "utils/AsyncLogging.h"
+#include "utils/Logger.h"
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <unistd.h>
+#include <string>
+
+namespace
+{
+// 典型的请求日志字段
+const std::string METHOD = "GET";
+const std::string PATH = "/api/v1/users/42/history";
+constexpr int FD = 137;
+constexpr size_t BYTES = 4096;
+
+// 级别被过滤的LOG语句：短路后不构造LogStream、不求值参数
+void BM_LogFiltered(benchmark::State& state)
+{
+    Logger::instance().setLevel(ERROR);
+    for (auto _ : state)
+    {
+        LOG(DEBUG) << "Request " << METHOD << " " << PATH << " on fd " << FD << " (" << BYTES << " bytes)";
+    }
+}
+
+// 只格式化：LogStream的流式拼接，析构时级别不足不输出
+void BM_LogStreamFormat(benchmark::State& state)
+{
+    Logger::instance().setLevel(FATAL);
+    for (auto _ : state)
+    {
+        LogStream stream(INFO);
+        stream << "Request " << METHOD << " " << PATH << " on fd " << FD << " (" << BYTES << " bytes)";
+        benchmark::DoNotOptimize(stream);
+    }
+}
+
+// 格式化并追加到异步后端（与文件日志相同的路径，写到临时文件）；
+// 多线程时共用一个后端，每个线程写自己的缓冲区
+void BM_LogAsyncAppend(benchmark::State& state)
+{
+    static char path[] = "/tmp/vortex_logbench_XXXXXX";
+    static AsyncLogging* backend = nullptr;
+    if (state.thread_index() == 0)
+    {
+        std::strcpy(path, "/tmp/vortex_logbench_XXXXXX");
+        int fd = mkstemp(path);
+        if (fd >= 0)
+        {
+            close(fd);
+            backend = new AsyncLogging(path);
+            backend->start();
+        }
+    }
+    for (auto _ : state)
+    {
+        if (backend == nullptr)
+        {
+            state.SkipWithError("mkstemp failed");
+            break;
+        }
+        LogStream stream(INFO);
+        stream << "Request " << METHOD << " " << PATH << " on fd " << FD << " (" << BYTES << " bytes)";
+        std::string line = "[INFO] " + stream.str() + "\n";
+        backend->append(line.data(), line.size());
+    }
+    if (state.thread_index() == 0 && backend != nullptr)
+    {
+        state.counters["dropped"] = static_cast<double>(backend->droppedCount());
+        backend->stop();
+        delete backend;
+        backend = nullptr;
+        unlink(path);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+} // namespace
+
+BENCHMARK(BM_LogFiltered);
+BENCHMARK(BM_LogStreamFormat);
+BENCHMARK(BM_LogAsyncAppend)->ThreadRange(1, 8)->UseRealTime();
+
+int main(int argc, char** argv)
+{
+    Logger::instance().setLevel(ERROR);
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
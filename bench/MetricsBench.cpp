@@ -0,0 +1,90 @@
+#include "utils/Logger.h"
+#include "utils/Metrics.h"
+#include <benchmark/benchmark.h>
+#include <mutex>
+
+namespace
+{
+// 对照组：所有线程共享一个原子变量，多线程下缓存行来回迁移
+std::atomic<uint64_t> sharedCounter{0};
+
+// 对照组：加锁的计数和求和
+std::mutex baselineMutex;
+uint64_t baselineCount = 0;
+uint64_t baselineSum = 0;
+
+void BM_CounterSharded(benchmark::State& state)
+{
+    static Counter counter;
+    for (auto _ : state)
+    {
+        counter.add();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_CounterSharedAtomic(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        sharedCounter.fetch_add(1, std::memory_order_relaxed);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_HistogramRecord(benchmark::State& state)
+{
+    static Histogram histogram;
+    uint64_t value = 1000 + static_cast<uint64_t>(state.thread_index()) * 7919;
+    for (auto _ : state)
+    {
+        histogram.record(value);
+        value = value * 6364136223846793005ull + 1442695040888963407ull;
+        value >>= 40; // 约0~16毫秒
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_MutexRecord(benchmark::State& state)
+{
+    uint64_t value = 1000;
+    for (auto _ : state)
+    {
+        std::lock_guard<std::mutex> lock(baselineMutex);
+        ++baselineCount;
+        baselineSum += value;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// 抓取一次的开销：与注册的指标数成正比，和记录路径无关
+void BM_RegistryRender(benchmark::State& state)
+{
+    MetricsRegistry registry;
+    for (int i = 0; i < state.range(0); ++i)
+    {
+        registry.counter("bench_counter_total", "Counter.", "id=\"" + std::to_string(i) + "\"").add(i);
+        registry.histogram("bench_latency_seconds", "Latency.", "id=\"" + std::to_string(i) + "\"").record(
+            static_cast<uint64_t>(i) * 1000);
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(registry.render());
+    }
+}
+} // namespace
+
+BENCHMARK(BM_CounterSharded)->ThreadRange(1, 8);
+BENCHMARK(BM_CounterSharedAtomic)->ThreadRange(1, 8);
+BENCHMARK(BM_HistogramRecord)->ThreadRange(1, 8);
+BENCHMARK(BM_MutexRecord)->ThreadRange(1, 8);
+BENCHMARK(BM_RegistryRender)->Arg(4)->Arg(32)->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char** argv)
+{
+    Logger::instance().setLevel(ERROR);
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,238 @@
+#include "core/Epoll.h"
+#include "core/IoUringPoller.h"
+#include "utils/Logger.h"
+#include <benchmark/benchmark.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <memory>
+#include <vector>
+
+namespace
+{
+// N对非阻塞socketpair：[0]端注册到事件源，[1]端由基准线程写入
+struct SocketPairs
+{
+    explicit SocketPairs(int n)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            int sv[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sv) == 0)
+            {
+                local.push_back(sv[0]);
+                peer.push_back(sv[1]);
+            }
+        }
+    }
+    ~SocketPairs()
+    {
+        for (size_t i = 0; i < local.size(); ++i)
+        {
+            close(local[i]);
+            close(peer[i]);
+        }
+    }
+
+    // 每个对端写一个字节
+    void writeAll() const
+    {
+        for (int fd : peer)
+        {
+            ssize_t n = write(fd, "x", 1);
+            (void)n;
+        }
+    }
+
+    std::vector<int> local;
+    std::vector<int> peer;
+};
+
+// 内核不支持io_uring时跳过该基准
+std::unique_ptr<IoUringPoller> makeUring(benchmark::State& state)
+{
+    try
+    {
+        return std::make_unique<IoUringPoller>();
+    }
+    catch (const std::exception& e)
+    {
+        state.SkipWithError(e.what());
+        return nullptr;
+    }
+}
+
+// 就绪通知 + read：每轮向N个连接各写一字节，等到N个可读事件并逐个读空
+void pollerReadiness(benchmark::State& state, Poller& poller)
+{
+    SocketPairs pairs(static_cast<int>(state.range(0)));
+    for (int fd : pairs.local)
+    {
+        poller.addFd(fd, EPOLLIN | EPOLLET);
+    }
+
+    char buf[64];
+    int64_t waits = 0;
+    for (auto _ : state)
+    {
+        pairs.writeAll();
+        size_t pending = pairs.local.size();
+        while (pending > 0)
+        {
+            int n = poller.wait(-1);
+            ++waits;
+            for (int i = 0; i < n; ++i)
+            {
+                while (read(poller.events()[i].data.fd, buf, sizeof(buf)) > 0)
+                {
+                }
+                --pending;
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["waits/iter"] = benchmark::Counter(static_cast<double>(waits) / state.iterations());
+}
+
+void BM_EpollReadiness(benchmark::State& state)
+{
+    Epoll poller;
+    pollerReadiness(state, poller);
+}
+
+void BM_UringReadiness(benchmark::State& state)
+{
+    auto poller = makeUring(state);
+    if (poller)
+    {
+        pollerReadiness(state, *poller);
+        state.counters["enter/iter"] =
+            benchmark::Counter(static_cast<double>(poller->stats().enterCalls) / state.iterations());
+    }
+}
+
+// 完成式：multishot recv直接交付数据，一次io_uring_enter取回所有连接的数据，不再逐个read
+void BM_UringRecvMultishot(benchmark::State& state)
+{
+    auto uring = makeUring(state);
+    if (!uring)
+    {
+        return;
+    }
+    IoUringPoller& poller = *uring;
+    SocketPairs pairs(static_cast<int>(state.range(0)));
+    size_t received = 0;
+    for (int fd : pairs.local)
+    {
+        poller.recvMultishot(fd, [&received](const char*, ssize_t n) {
+            if (n > 0)
+            {
+                received += static_cast<size_t>(n);
+            }
+        });
+    }
+    poller.wait(0);
+    poller.runCompletions();
+
+    uint64_t enterBefore = poller.stats().enterCalls;
+    for (auto _ : state)
+    {
+        pairs.writeAll();
+        received = 0;
+        while (received < pairs.local.size())
+        {
+            poller.wait(-1);
+            poller.runCompletions();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["enter/iter"] = benchmark::Counter(
+        static_cast<double>(poller.stats().enterCalls - enterBefore) / state.iterations());
+}
+
+// 修改关注事件：epoll每次一个epoll_ctl，io_uring只写入提交队列，下一次wait时批量提交
+void pollerModify(benchmark::State& state, Poller& poller)
+{
+    SocketPairs pairs(static_cast<int>(state.range(0)));
+    for (int fd : pairs.local)
+    {
+        poller.addFd(fd, EPOLLIN | EPOLLET);
+    }
+    bool writable = false;
+    for (auto _ : state)
+    {
+        writable = !writable;
+        for (int fd : pairs.local)
+        {
+            poller.modFd(fd, writable ? (EPOLLIN | EPOLLOUT | EPOLLET) : (EPOLLIN | EPOLLET));
+        }
+        poller.wait(0);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// 注册和移除：短连接场景下每个连接各一次
+void pollerAddRemove(benchmark::State& state, Poller& poller)
+{
+    SocketPairs pairs(static_cast<int>(state.range(0)));
+    for (auto _ : state)
+    {
+        for (int fd : pairs.local)
+        {
+            poller.addFd(fd, EPOLLIN | EPOLLET);
+        }
+        for (int fd : pairs.local)
+        {
+            poller.removeFd(fd);
+        }
+        poller.wait(0);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_EpollAddRemove(benchmark::State& state)
+{
+    Epoll poller;
+    pollerAddRemove(state, poller);
+}
+
+void BM_UringAddRemove(benchmark::State& state)
+{
+    auto poller = makeUring(state);
+    if (poller)
+    {
+        pollerAddRemove(state, *poller);
+    }
+}
+
+void BM_EpollModify(benchmark::State& state)
+{
+    Epoll poller;
+    pollerModify(state, poller);
+}
+
+void BM_UringModify(benchmark::State& state)
+{
+    auto poller = makeUring(state);
+    if (poller)
+    {
+        pollerModify(state, *poller);
+    }
+}
+} // namespace
+
+BENCHMARK(BM_EpollReadiness)->Arg(1)->Arg(64)->Arg(256);
+BENCHMARK(BM_UringReadiness)->Arg(1)->Arg(64)->Arg(256);
+BENCHMARK(BM_UringRecvMultishot)->Arg(1)->Arg(64)->Arg(256);
+BENCHMARK(BM_EpollAddRemove)->Arg(64)->Arg(256);
+BENCHMARK(BM_UringAddRemove)->Arg(64)->Arg(256);
+BENCHMARK(BM_EpollModify)->Arg(64)->Arg(256);
+BENCHMARK(BM_UringModify)->Arg(64)->Arg(256);
+
+int main(int argc, char** argv)
+{
+    Logger::instance().setLevel(ERROR);
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "http/HttpDate.h"
+#include "http/ResponseWriter.h"
+#include "utils/Logger.h"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace
+{
+const std::string BODY = "Hello World1111111111";
+
+// 旧实现：字符串拼接 + std::to_string
+void BM_ConcatResponse(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        const std::string response =
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Type: text/plain\r\n"
+            "Content-Length: " +
+            std::to_string(BODY.size()) + "\r\n" +
+            "Connection: keep-alive\r\n" +
+            "\r\n" +
+            BODY;
+        benchmark::DoNotOptimize(response.data());
+    }
+}
+
+// 新实现：预先格式化的状态行、缓存的Date、内部缓冲格式化整数，组装为iovec
+void BM_WriterResponse(benchmark::State& state)
+{
+    const std::string serverHeader = "Server: VortexHTTP\r\n";
+    for (auto _ : state)
+    {
+        ResponseWriter writer;
+        writer.statusLine(200);
+        writer.append(serverHeader);
+        writer.date();
+        writer.append("Content-Type: text/plain\r\n");
+        writer.header("Content-Length", static_cast<uint64_t>(BODY.size()));
+        writer.endHeaders(true);
+        writer.append(BODY);
+        benchmark::DoNotOptimize(writer.iov());
+        benchmark::DoNotOptimize(writer.size());
+    }
+}
+
+// 预先序列化的固定响应（错误页、健康检查）
+void BM_FixedResponse(benchmark::State& state)
+{
+    const FixedResponse fixed = FixedResponse::make(404, "text/html", "<html>404</html>", "Server: VortexHTTP\r\n");
+    for (auto _ : state)
+    {
+        ResponseWriter writer;
+        writer.fixed(fixed, true);
+        benchmark::DoNotOptimize(writer.iov());
+    }
+}
+
+void BM_FormatUint(benchmark::State& state)
+{
+    char digits[20];
+    uint64_t value = 1;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ResponseWriter::formatUint(value, digits));
+        value = value * 7 + 3;
+    }
+}
+
+void BM_ToString(benchmark::State& state)
+{
+    uint64_t value = 1;
+    for (auto _ : state)
+    {
+        std::string digits = std::to_string(value);
+        benchmark::DoNotOptimize(digits.data());
+        value = value * 7 + 3;
+    }
+}
+} // namespace
+
+BENCHMARK(BM_ConcatResponse);
+BENCHMARK(BM_WriterResponse);
+BENCHMARK(BM_FixedResponse);
+BENCHMARK(BM_FormatUint);
+BENCHMARK(BM_ToString);
+
+int main(int argc, char** argv)
+{
+    Logger::instance().setLevel(ERROR);
+    HttpDate::refresh();
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include "http/Router.h"
+#include "utils/Logger.h"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+// 模拟一个大型REST服务：若干资源，每个资源有集合、单个对象和若干子资源/动作
+const char* const RESOURCES[] = {"users", "orders", "products", "invoices", "repos", "teams",
+                                 "projects", "issues", "comments", "payments"};
+const char* const ACTIONS[] = {"history", "settings", "members", "events", "audit",
+                               "export", "stats", "tags", "labels", "permissions"};
+
+// 生成约routeCount条路由，版本前缀区分出更多静态分支
+std::vector<std::string> makePatterns(size_t routeCount)
+{
+    std::vector<std::string> patterns;
+    for (size_t version = 1; patterns.size() < routeCount; ++version)
+    {
+        std::string prefix = "/api/v" + std::to_string(version);
+        for (const char* resource : RESOURCES)
+        {
+            std::string base = prefix + "/" + resource;
+            patterns.push_back(base);
+            patterns.push_back(base + "/:id");
+            for (const char* action : ACTIONS)
+            {
+                patterns.push_back(base + "/:id/" + action);
+                patterns.push_back(base + "/:id/" + action + "/:item");
+            }
+        }
+        patterns.push_back(prefix + "/static/*path");
+    }
+    return patterns;
+}
+
+void buildRouter(Router& router, size_t routeCount)
+{
+    for (const std::string& pattern : makePatterns(routeCount))
+    {
+        router.add("GET", pattern, [](const Request&, Response&) {});
+    }
+}
+
+// 查找路径：静态、单参数、双参数、通配、未命中
+const char* lookupPath(int64_t kind)
+{
+    switch (kind)
+    {
+        case 0:
+            return "/api/v1/products";
+        case 1:
+            return "/api/v1/products/123456";
+        case 2:
+            return "/api/v1/products/123456/permissions/987";
+        case 3:
+            return "/api/v1/static/js/vendor/app.3f2a9c.js";
+        default:
+            return "/api/v1/products/123456/unknown";
+    }
+}
+
+const char* lookupName(int64_t kind)
+{
+    switch (kind)
+    {
+        case 0:
+            return "static";
+        case 1:
+            return "param";
+        case 2:
+            return "two-params";
+        case 3:
+            return "wildcard";
+        default:
+            return "miss";
+    }
+}
+
+void BM_RouterMatch(benchmark::State& state)
+{
+    Router router;
+    buildRouter(router, static_cast<size_t>(state.range(0)));
+    const std::string_view path = lookupPath(state.range(1));
+
+    RouteParams params;
+    for (auto _ : state)
+    {
+        const Route* route = router.match("GET", path, params);
+        benchmark::DoNotOptimize(route);
+        benchmark::DoNotOptimize(params);
+    }
+    state.SetLabel(std::to_string(router.size()) + " routes/" + lookupName(state.range(1)));
+}
+
+// 对照：逐条尝试全部路由的线性匹配
+bool matchLinear(std::string_view pattern, std::string_view path, RouteParams& params)
+{
+    params.clear();
+    size_t i = 0;
+    size_t j = 0;
+    while (i < pattern.size())
+    {
+        if (pattern[i] == ':' || pattern[i] == '*')
+        {
+            size_t nameEnd = std::min(pattern.find('/', i), pattern.size());
+            size_t valueEnd = pattern[i] == '*' ? path.size() : std::min(path.find('/', j), path.size());
+            if (pattern[i] == ':' && valueEnd == j)
+            {
+                return false;
+            }
+            params.push(pattern.substr(i + 1, nameEnd - i - 1), path.substr(j, valueEnd - j));
+            i = nameEnd;
+            j = valueEnd;
+            continue;
+        }
+        if (j >= path.size() || pattern[i] != path[j])
+        {
+            return false;
+        }
+        ++i;
+        ++j;
+    }
+    return j == path.size();
+}
+
+void BM_LinearMatch(benchmark::State& state)
+{
+    const std::vector<std::string> patterns = makePatterns(static_cast<size_t>(state.range(0)));
+    const std::string_view path = lookupPath(state.range(1));
+
+    RouteParams params;
+    for (auto _ : state)
+    {
+        const std::string* found = nullptr;
+        for (const std::string& pattern : patterns)
+        {
+            if (matchLinear(pattern, path, params))
+            {
+                found = &pattern;
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetLabel(std::to_string(patterns.size()) + " routes/" + lookupName(state.range(1)));
+}
+
+void BM_RouterBuild(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        Router router;
+        buildRouter(router, static_cast<size_t>(state.range(0)));
+        benchmark::DoNotOptimize(router.size());
+    }
+}
+} // namespace
+
+BENCHMARK(BM_RouterMatch)->ArgsProduct({{100, 1000, 5000}, {0, 1, 2, 3, 4}});
+BENCHMARK(BM_LinearMatch)->ArgsProduct({{1000}, {0, 2, 4}});
+BENCHMARK(BM_RouterBuild)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char** argv)
+{
+    Logger::instance().setLevel(ERROR);
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
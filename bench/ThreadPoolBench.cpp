@@ -0,0 +1,157 @@
+#include "core/ThreadPool.h"
+#include "utils/Logger.h"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace
+{
+// 每轮提交的任务数
+constexpr int BATCH = 1024;
+
+ThreadPool::Mode modeOf(int64_t arg)
+{
+    return arg == 0 ? ThreadPool::Mode::SHARED_QUEUE : ThreadPool::Mode::WORK_STEALING;
+}
+
+const char* modeName(int64_t arg)
+{
+    return arg == 0 ? "shared" : "stealing";
+}
+
+const char* policyName(ThreadPool::OverflowPolicy policy)
+{
+    switch (policy)
+    {
+        case ThreadPool::OverflowPolicy::REJECT:
+            return "reject";
+        case ThreadPool::OverflowPolicy::BLOCK:
+            return "block";
+        default:
+            return "drop-oldest";
+    }
+}
+
+// 等待本轮任务全部执行完
+void waitFor(const std::atomic<int>& done, int expected)
+{
+    while (done.load(std::memory_order_acquire) < expected)
+    {
+        std::this_thread::yield();
+    }
+}
+
+// 单个提交线程：提交一批空任务并等待执行完，衡量enqueue+调度的吞吐
+void BM_ThreadPoolEnqueue(benchmark::State& state)
+{
+    ThreadPool pool(static_cast<size_t>(state.range(1)), modeOf(state.range(0)));
+    std::atomic<int> done{0};
+    for (auto _ : state)
+    {
+        done.store(0, std::memory_order_relaxed);
+        for (int i = 0; i < BATCH; ++i)
+        {
+            pool.enqueue([&done] { done.fetch_add(1, std::memory_order_release); });
+        }
+        waitFor(done, BATCH);
+    }
+    state.SetItemsProcessed(state.iterations() * BATCH);
+    state.SetLabel(modeName(state.range(0)));
+}
+
+// 单任务往返：提交一个任务到它执行完的延迟（含唤醒休眠线程）
+void BM_ThreadPoolRoundTrip(benchmark::State& state)
+{
+    ThreadPool pool(static_cast<size_t>(state.range(1)), modeOf(state.range(0)));
+    std::atomic<int> done{0};
+    for (auto _ : state)
+    {
+        done.store(0, std::memory_order_relaxed);
+        pool.enqueue([&done] { done.fetch_add(1, std::memory_order_release); });
+        waitFor(done, 1);
+    }
+    state.SetLabel(modeName(state.range(0)));
+}
+
+// 任务内继续提交子任务（扇出），工作窃取模式下走本地队列
+void BM_ThreadPoolFanOut(benchmark::State& state)
+{
+    ThreadPool pool(static_cast<size_t>(state.range(1)), modeOf(state.range(0)));
+    std::atomic<int> done{0};
+    constexpr int CHILDREN = 64;
+    constexpr int PARENTS = BATCH / CHILDREN;
+    for (auto _ : state)
+    {
+        done.store(0, std::memory_order_relaxed);
+        for (int i = 0; i < PARENTS; ++i)
+        {
+            pool.enqueue([&pool, &done] {
+                for (int c = 0; c < CHILDREN; ++c)
+                {
+                    pool.enqueue([&done] { done.fetch_add(1, std::memory_order_release); });
+                }
+            });
+        }
+        waitFor(done, BATCH);
+    }
+    state.SetItemsProcessed(state.iterations() * BATCH);
+    state.SetLabel(modeName(state.range(0)));
+}
+
+// 有界队列过载：提交速度远超单个工作线程的处理速度，衡量提交开销和各策略的丢弃比例
+void BM_ThreadPoolOverflow(benchmark::State& state)
+{
+    constexpr size_t CAPACITY = 64;
+    auto policy = static_cast<ThreadPool::OverflowPolicy>(state.range(1));
+    ThreadPool pool(1, modeOf(state.range(0)), CAPACITY, policy);
+    std::atomic<int> done{0};
+    std::atomic<int> dropped{0};
+    int64_t shed = 0;
+    for (auto _ : state)
+    {
+        done.store(0, std::memory_order_relaxed);
+        dropped.store(0, std::memory_order_relaxed);
+        int accepted = 0;
+        for (int i = 0; i < BATCH; ++i)
+        {
+            bool ok = pool.enqueue(
+                [&done] {
+                    // 约1微秒的处理
+                    auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(1);
+                    while (std::chrono::steady_clock::now() < until)
+                    {
+                    }
+                    done.fetch_add(1, std::memory_order_release);
+                },
+                [&dropped] { dropped.fetch_add(1, std::memory_order_relaxed); });
+            accepted += ok ? 1 : 0;
+        }
+        while (done.load(std::memory_order_acquire) + dropped.load(std::memory_order_relaxed) < accepted)
+        {
+            std::this_thread::yield();
+        }
+        shed += BATCH - done.load(std::memory_order_relaxed);
+    }
+    state.SetItemsProcessed(state.iterations() * BATCH);
+    state.counters["shed"] = static_cast<double>(shed) / static_cast<double>(state.iterations() * BATCH);
+    state.SetLabel(std::string(modeName(state.range(0))) + "/" + policyName(policy));
+}
+} // namespace
+
+// 参数：调度模式（0共享队列/1工作窃取）、工作线程数
+BENCHMARK(BM_ThreadPoolEnqueue)->ArgsProduct({{0, 1}, {1, 4}})->UseRealTime();
+BENCHMARK(BM_ThreadPoolRoundTrip)->ArgsProduct({{0, 1}, {1, 4}})->UseRealTime();
+BENCHMARK(BM_ThreadPoolFanOut)->ArgsProduct({{0, 1}, {4}})->UseRealTime();
+// 参数：调度模式、队列满时的策略（0拒绝/1阻塞/2丢弃最早）
+BENCHMARK(BM_ThreadPoolOverflow)->ArgsProduct({{0, 1}, {0, 1, 2}})->UseRealTime();
+
+int main(int argc, char** argv)
+{
+    Logger::instance().setLevel(ERROR);
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,417 @@
+#include "core/Buffer.h"
+#include "core/Epoll.h"
+#include "http/HttpParser.h"
+#include "utils/Logger.h"
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * 反向代理压测用的上游服务器
+ *
+ * 每个线程一个Epoll（水平触发），TCP端口以SO_REUSEPORT各自监听，Unix域socket共享同一个监听fd。
+ * 支持长连接和流水线请求，请求体读取后丢弃，响应由查询参数控制：
+ * - size=N     消息体为N字节（默认为一句问候）
+ * - chunked=1  以chunked分块发送消息体
+ * - close=1    响应后关闭连接
+ * 响应带X-Backend（监听地址）和X-Request-Bytes（请求体字节数），便于验证转发和负载均衡。
+ *
+ * 用法：backend --port=9001 --unix=/tmp/backend.sock --threads=1
+ */
+
+namespace
+{
+struct Options
+{
+    int port = 0;            // TCP端口，0表示不监听
+    std::string unixPath;    // Unix域socket路径，为空表示不监听
+    int threads = 1;
+};
+
+void usage()
+{
+    std::cerr << "usage: backend [--port=N] [--unix=PATH] [--threads=N]\n";
+}
+
+Options parseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        if (key == "--port")
+        {
+            options.port = std::atoi(value.c_str());
+        }
+        else if (key == "--unix")
+        {
+            options.unixPath = value;
+        }
+        else if (key == "--threads")
+        {
+            options.threads = std::max(1, std::atoi(value.c_str()));
+        }
+        else
+        {
+            usage();
+            throw std::runtime_error("Unknown option: " + arg);
+        }
+    }
+    if (options.port == 0 && options.unixPath.empty())
+    {
+        usage();
+        throw std::runtime_error("Nothing to listen on");
+    }
+    return options;
+}
+
+int listenTcp(int port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, SOMAXCONN) < 0)
+    {
+        throw std::runtime_error("Cannot listen on port " + std::to_string(port) + ": " + strerror(errno));
+    }
+    return fd;
+}
+
+int listenUnix(const std::string& path)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path))
+    {
+        throw std::runtime_error("Unix socket path too long: " + path);
+    }
+    memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, SOMAXCONN) < 0)
+    {
+        throw std::runtime_error("Cannot listen on " + path + ": " + strerror(errno));
+    }
+    return fd;
+}
+
+// 查询串中参数的数值，不存在时返回fallback
+long queryValue(std::string_view target, std::string_view name, long fallback)
+{
+    size_t question = target.find('?');
+    std::string_view query = question == std::string_view::npos ? std::string_view() : target.substr(question + 1);
+    while (!query.empty())
+    {
+        size_t amp = query.find('&');
+        std::string_view pair = query.substr(0, amp);
+        query = amp == std::string_view::npos ? std::string_view() : query.substr(amp + 1);
+        if (pair.size() > name.size() && pair.substr(0, name.size()) == name && pair[name.size()] == '=')
+        {
+            return std::atol(std::string(pair.substr(name.size() + 1)).c_str());
+        }
+    }
+    return fallback;
+}
+
+struct Client
+{
+    int fd;
+    HttpParser parser;
+    Buffer input;
+    Buffer output;
+    size_t headerLength = 0;
+    bool closeAfterWrite = false;
+    bool writing = false;    // 是否关注了EPOLLOUT
+};
+
+/**
+ * @brief 单个线程：一个Epoll驱动监听socket和全部连接
+ */
+class Worker
+{
+public:
+    Worker(std::vector<int> listenFds, std::string name) : listeners(std::move(listenFds)), name(std::move(name))
+    {
+        for (int fd : listeners)
+        {
+            poller.addFd(fd, EPOLLIN);
+        }
+    }
+
+    void run()
+    {
+        for (;;)
+        {
+            int n = poller.wait(-1);
+            for (int i = 0; i < n; ++i)
+            {
+                const epoll_event& event = poller.events()[i];
+                if (isListener(event.data.fd))
+                {
+                    acceptAll(event.data.fd);
+                    continue;
+                }
+                auto it = clients.find(event.data.fd);
+                if (it == clients.end())
+                {
+                    continue;
+                }
+                Client& client = *it->second;
+                if ((event.events & EPOLLOUT) && !flush(client))
+                {
+                    continue;
+                }
+                if (event.events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                {
+                    readClient(client);
+                }
+            }
+        }
+    }
+
+private:
+    bool isListener(int fd) const
+    {
+        for (int listener : listeners)
+        {
+            if (listener == fd)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void acceptAll(int listenFd)
+    {
+        for (;;)
+        {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0)
+            {
+                return;
+            }
+            auto client = std::make_unique<Client>();
+            client->fd = fd;
+            poller.addFd(fd, EPOLLIN);
+            clients.emplace(fd, std::move(client));
+        }
+    }
+
+    void closeClient(Client& client)
+    {
+        int fd = client.fd;
+        poller.removeFd(fd);
+        close(fd);
+        clients.erase(fd);
+    }
+
+    void readClient(Client& client)
+    {
+        int savedErrno = 0;
+        ssize_t n = client.input.readFd(client.fd, &savedErrno);
+        if (n == 0 || (n < 0 && savedErrno != EAGAIN && savedErrno != EINTR))
+        {
+            closeClient(client);
+            return;
+        }
+        while (client.input.readableBytes() > 0 && !client.closeAfterWrite)
+        {
+            HttpParser& parser = client.parser;
+            if (!parser.isHeaderComplete())
+            {
+                client.headerLength = parser.parse(client.input.peek(), client.input.readableBytes());
+                if (parser.hasError())
+                {
+                    closeClient(client);
+                    return;
+                }
+                if (!parser.isHeaderComplete())
+                {
+                    break;
+                }
+            }
+            if (!parser.isComplete())
+            {
+                size_t used = parser.parseBody(client.input.peek() + client.headerLength,
+                                               client.input.readableBytes() - client.headerLength,
+                                               [](std::string_view) {});
+                client.input.erase(client.headerLength, used);
+                if (parser.hasError())
+                {
+                    closeClient(client);
+                    return;
+                }
+                if (!parser.isComplete())
+                {
+                    break;
+                }
+            }
+            respond(client);
+            client.input.retrieve(client.headerLength);
+            parser.reset();
+        }
+        flush(client);
+    }
+
+    void respond(Client& client)
+    {
+        const HttpParser& parser = client.parser;
+        std::string_view target = parser.getPath();
+        long size = queryValue(target, "size", -1);
+        bool chunked = queryValue(target, "chunked", 0) != 0;
+        client.closeAfterWrite = queryValue(target, "close", 0) != 0 || !parser.shouldKeepAlive();
+        bool head = parser.getMethod() == "HEAD";
+
+        std::string body = size < 0 ? "Hello from backend " + name : std::string(static_cast<size_t>(size), 'x');
+        std::string header = "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nX-Backend: " + name +
+                            "\r\nX-Request-Bytes: " + std::to_string(parser.bodyBytes()) + "\r\n";
+        if (client.closeAfterWrite)
+        {
+            header += "Connection: close\r\n";
+        }
+        if (chunked)
+        {
+            header += "Transfer-Encoding: chunked\r\n\r\n";
+            client.output.append(header);
+            if (head)
+            {
+                return;
+            }
+            constexpr size_t CHUNK = 16 * 1024;
+            for (size_t offset = 0; offset < body.size(); offset += CHUNK)
+            {
+                size_t length = std::min(CHUNK, body.size() - offset);
+                char sizeLine[24];
+                int len = snprintf(sizeLine, sizeof(sizeLine), "%zx\r\n", length);
+                client.output.append(sizeLine, static_cast<size_t>(len));
+                client.output.append(body.data() + offset, length);
+                client.output.append("\r\n", 2);
+            }
+            client.output.append("0\r\n\r\n", 5);
+            return;
+        }
+        header += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+        client.output.append(header);
+        if (!head)
+        {
+            client.output.append(body);
+        }
+    }
+
+    // 写出积压的输出，连接被关闭时返回false
+    bool flush(Client& client)
+    {
+        while (client.output.readableBytes() > 0)
+        {
+            int savedErrno = 0;
+            ssize_t n = client.output.writeFd(client.fd, &savedErrno);
+            if (n > 0)
+            {
+                continue;
+            }
+            if (savedErrno == EAGAIN || savedErrno == EWOULDBLOCK)
+            {
+                if (!client.writing)
+                {
+                    poller.modFd(client.fd, EPOLLIN | EPOLLOUT);
+                    client.writing = true;
+                }
+                return true;
+            }
+            if (savedErrno != EINTR)
+            {
+                closeClient(client);
+                return false;
+            }
+        }
+        if (client.closeAfterWrite)
+        {
+            closeClient(client);
+            return false;
+        }
+        if (client.writing)
+        {
+            poller.modFd(client.fd, EPOLLIN);
+            client.writing = false;
+        }
+        return true;
+    }
+
+    Epoll poller;
+    std::vector<int> listeners;
+    std::string name;
+    std::unordered_map<int, std::unique_ptr<Client>> clients;
+};
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Logger::instance().setLevel(ERROR);
+    try
+    {
+        Options options = parseOptions(argc, argv);
+        int unixFd = options.unixPath.empty() ? -1 : listenUnix(options.unixPath);
+        std::string name = options.port != 0 ? "127.0.0.1:" + std::to_string(options.port) : "";
+        if (!options.unixPath.empty())
+        {
+            name += (name.empty() ? "unix:" : ",unix:") + options.unixPath;
+        }
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        for (int i = 0; i < options.threads; ++i)
+        {
+            std::vector<int> listeners;
+            if (options.port != 0)
+            {
+                listeners.push_back(listenTcp(options.port));
+            }
+            if (unixFd >= 0)
+            {
+                listeners.push_back(unixFd);
+            }
+            workers.push_back(std::make_unique<Worker>(std::move(listeners), name));
+        }
+        std::cout << "backend listening on " << name << " with " << options.threads << " thread(s)" << std::endl;
+
+        std::vector<std::thread> threads;
+        for (auto& worker : workers)
+        {
+            threads.emplace_back([&worker] { worker->run(); });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
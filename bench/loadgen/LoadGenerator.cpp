@@ -0,0 +1,706 @@
+#include "core/Epoll.h"
+#include "utils/Logger.h"
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * HTTP/1.1负载生成器
+ *
+ * 每个线程一个Epoll，均分全部连接；每个连接保持pipeline个在途请求（闭环压测），
+ * 响应到达即补发下一个。延迟为请求写出到完整响应读入的时间，预热期结束后开始统计，
+ * 全部样本合并排序后计算精确分位数，结果以JSON输出便于对比不同版本。
+ *
+ * 用法：loadgen --port=8080 --connections=64 --threads=2 --duration=10 --pipeline=1 --keepalive=1
+ */
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+struct Options
+{
+    std::string host = "127.0.0.1";
+    int port = 8080;
+    std::string path = "/";
+    int threads = 2;
+    int connections = 64;
+    double duration = 10.0;   // 统计时长（秒）
+    double warmup = 1.0;      // 预热时长（秒），期间的请求不计入结果
+    int pipeline = 1;         // 每个连接的在途请求数
+    bool keepAlive = true;    // false时每个请求新建连接（Connection: close）
+    std::string out;          // 结果JSON另存的文件，为空只输出到标准输出
+};
+
+void usage()
+{
+    std::cerr << "Usage: loadgen [--host=127.0.0.1] [--port=8080] [--path=/] [--threads=2]\n"
+                 "               [--connections=64] [--duration=10] [--warmup=1] [--pipeline=1]\n"
+                 "               [--keepalive=1] [--out=result.json]\n";
+}
+
+Options parseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help")
+        {
+            usage();
+            std::exit(EXIT_SUCCESS);
+        }
+        size_t eq = arg.find('=');
+        if (arg.compare(0, 2, "--") != 0 || eq == std::string::npos)
+        {
+            usage();
+            throw std::runtime_error("invalid argument: " + arg);
+        }
+        std::string key = arg.substr(2, eq - 2);
+        std::string value = arg.substr(eq + 1);
+        if (key == "host") options.host = value;
+        else if (key == "port") options.port = std::atoi(value.c_str());
+        else if (key == "path") options.path = value;
+        else if (key == "threads") options.threads = std::atoi(value.c_str());
+        else if (key == "connections") options.connections = std::atoi(value.c_str());
+        else if (key == "duration") options.duration = std::atof(value.c_str());
+        else if (key == "warmup") options.warmup = std::atof(value.c_str());
+        else if (key == "pipeline") options.pipeline = std::atoi(value.c_str());
+        else if (key == "keepalive") options.keepAlive = value != "0" && value != "false";
+        else if (key == "out") options.out = value;
+        else
+        {
+            usage();
+            throw std::runtime_error("unknown option: " + key);
+        }
+    }
+    if (options.threads < 1 || options.connections < options.threads || options.pipeline < 1 ||
+        options.duration <= 0 || options.port <= 0)
+    {
+        throw std::runtime_error("invalid options: need threads>=1, connections>=threads, pipeline>=1, duration>0");
+    }
+    if (!options.keepAlive)
+    {
+        options.pipeline = 1; // 短连接每个连接只有一个请求
+    }
+    return options;
+}
+
+// 一个完整响应的解析结果
+struct ParsedResponse
+{
+    size_t length = 0;        // 响应总字节数（头部+消息体）
+    int status = 0;
+    bool close = false;       // 服务器要求关闭连接
+    bool untilClose = false;  // 无长度信息，消息体持续到连接关闭
+};
+
+enum class ParseResult
+{
+    COMPLETE,
+    INCOMPLETE,
+    ERROR
+};
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+bool containsIgnoreCase(std::string_view haystack, std::string_view needle)
+{
+    for (size_t i = 0; i + needle.size() <= haystack.size(); ++i)
+    {
+        if (equalsIgnoreCase(haystack.substr(i, needle.size()), needle))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 跳过chunked消息体，返回其长度（含结束块和尾部），不完整返回0
+size_t chunkedLength(std::string_view body, bool& error)
+{
+    size_t pos = 0;
+    while (true)
+    {
+        size_t lineEnd = body.find("\r\n", pos);
+        if (lineEnd == std::string_view::npos)
+        {
+            return 0;
+        }
+        char* end = nullptr;
+        std::string sizeLine(body.substr(pos, lineEnd - pos));
+        unsigned long size = std::strtoul(sizeLine.c_str(), &end, 16);
+        if (end == sizeLine.c_str())
+        {
+            error = true;
+            return 0;
+        }
+        pos = lineEnd + 2;
+        if (size == 0)
+        {
+            // 尾部字段以空行结束，没有尾部字段时紧跟一个空行
+            if (body.substr(pos, 2) == "\r\n")
+            {
+                return pos + 2;
+            }
+            size_t trailerEnd = body.find("\r\n\r\n", pos);
+            return trailerEnd == std::string_view::npos ? 0 : trailerEnd + 4;
+        }
+        if (body.size() < pos + size + 2)
+        {
+            return 0;
+        }
+        pos += size + 2;
+    }
+}
+
+ParseResult parseResponse(std::string_view data, ParsedResponse& response)
+{
+    size_t headerEnd = data.find("\r\n\r\n");
+    if (headerEnd == std::string_view::npos)
+    {
+        return ParseResult::INCOMPLETE;
+    }
+    if (data.size() < 12 || data.compare(0, 7, "HTTP/1.") != 0)
+    {
+        return ParseResult::ERROR;
+    }
+    response = ParsedResponse{};
+    response.status = std::atoi(std::string(data.substr(9, 3)).c_str());
+
+    long long contentLength = -1;
+    bool chunked = false;
+    size_t pos = data.find("\r\n") + 2;
+    while (pos < headerEnd)
+    {
+        size_t lineEnd = data.find("\r\n", pos);
+        std::string_view line = data.substr(pos, lineEnd - pos);
+        pos = lineEnd + 2;
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos)
+        {
+            continue;
+        }
+        std::string_view name = line.substr(0, colon);
+        std::string_view value = line.substr(colon + 1);
+        if (equalsIgnoreCase(name, "content-length"))
+        {
+            contentLength = std::atoll(std::string(value).c_str());
+        }
+        else if (equalsIgnoreCase(name, "transfer-encoding"))
+        {
+            chunked = containsIgnoreCase(value, "chunked");
+        }
+        else if (equalsIgnoreCase(name, "connection"))
+        {
+            response.close = containsIgnoreCase(value, "close");
+        }
+    }
+
+    size_t bodyStart = headerEnd + 4;
+    // 1xx/204/304没有消息体
+    if (response.status < 200 || response.status == 204 || response.status == 304)
+    {
+        response.length = bodyStart;
+        return ParseResult::COMPLETE;
+    }
+    if (chunked)
+    {
+        bool error = false;
+        size_t length = chunkedLength(data.substr(bodyStart), error);
+        if (error)
+        {
+            return ParseResult::ERROR;
+        }
+        if (length == 0)
+        {
+            return ParseResult::INCOMPLETE;
+        }
+        response.length = bodyStart + length;
+        return ParseResult::COMPLETE;
+    }
+    if (contentLength < 0)
+    {
+        response.untilClose = true;
+        response.close = true;
+        return ParseResult::INCOMPLETE;
+    }
+    if (data.size() < bodyStart + static_cast<size_t>(contentLength))
+    {
+        return ParseResult::INCOMPLETE;
+    }
+    response.length = bodyStart + static_cast<size_t>(contentLength);
+    return ParseResult::COMPLETE;
+}
+
+// 单个线程的统计结果
+struct Result
+{
+    uint64_t requests = 0;
+    uint64_t bytes = 0;
+    uint64_t status[6] = {0, 0, 0, 0, 0, 0}; // 按状态码类别，[0]为无法识别
+    uint64_t connectErrors = 0;
+    uint64_t readErrors = 0;
+    uint64_t writeErrors = 0;
+    uint64_t parseErrors = 0;
+    uint64_t reconnects = 0;
+    std::vector<int64_t> latencies;          // 纳秒
+};
+
+struct Connection
+{
+    int fd = -1;
+    bool connecting = true;
+    std::string output;                      // 待写出的请求
+    size_t outputOffset = 0;
+    std::string input;                       // 已读入、尚未解析完的响应
+    std::deque<int64_t> sentAt;              // 在途请求的发出时间
+};
+
+/**
+ * @brief 单个压测线程：一个Epoll驱动若干连接
+ */
+class Worker
+{
+public:
+    Worker(const Options& options, const sockaddr_storage& address, socklen_t addressLen, int connections,
+           int64_t measureStart, int64_t measureEnd)
+        : options(options), address(address), addressLen(addressLen), connectionCount(connections),
+          measureStart(measureStart), measureEnd(measureEnd)
+    {
+        request = "GET " + options.path + " HTTP/1.1\r\nHost: " + options.host + ":" +
+                  std::to_string(options.port) + "\r\nUser-Agent: vortex-loadgen\r\n";
+        if (!options.keepAlive)
+        {
+            request += "Connection: close\r\n";
+        }
+        request += "\r\n";
+    }
+
+    void run()
+    {
+        for (int i = 0; i < connectionCount; ++i)
+        {
+            openConnection();
+        }
+        while (nowNs() < measureEnd)
+        {
+            int n = poller.wait(100);
+            for (int i = 0; i < n; ++i)
+            {
+                const epoll_event& event = poller.events()[i];
+                handleEvent(event.data.fd, event.events);
+            }
+        }
+        for (auto& conn : connections)
+        {
+            if (conn)
+            {
+                close(conn->fd);
+            }
+        }
+    }
+
+    Result result;
+
+private:
+    bool measuring(int64_t t) const { return t >= measureStart && t < measureEnd; }
+
+    void openConnection()
+    {
+        int fd = socket(address.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+        {
+            throw std::runtime_error(std::string("socket failed: ") + strerror(errno));
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (connect(fd, reinterpret_cast<const sockaddr*>(&address), addressLen) < 0 && errno != EINPROGRESS)
+        {
+            ++result.connectErrors;
+            close(fd);
+            return;
+        }
+        if (static_cast<size_t>(fd) >= connections.size())
+        {
+            connections.resize(static_cast<size_t>(fd) + 1);
+        }
+        connections[static_cast<size_t>(fd)] = std::make_unique<Connection>();
+        connections[static_cast<size_t>(fd)]->fd = fd;
+        poller.addFd(fd, EPOLLIN | EPOLLOUT | EPOLLET);
+    }
+
+    // 关闭连接并新建一个补上，保持连接数不变
+    void reopen(Connection& conn, bool failed)
+    {
+        if (failed && !conn.sentAt.empty())
+        {
+            ++result.readErrors;
+        }
+        int fd = conn.fd;
+        poller.removeFd(fd);
+        close(fd);
+        connections[static_cast<size_t>(fd)].reset();
+        ++result.reconnects;
+        if (nowNs() < measureEnd)
+        {
+            openConnection();
+        }
+    }
+
+    void handleEvent(int fd, uint32_t events)
+    {
+        Connection* conn = static_cast<size_t>(fd) < connections.size() ? connections[static_cast<size_t>(fd)].get()
+                                                                         : nullptr;
+        if (conn == nullptr)
+        {
+            return;
+        }
+        if (conn->connecting)
+        {
+            if ((events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) == 0)
+            {
+                return;
+            }
+            int error = 0;
+            socklen_t len = sizeof(error);
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len);
+            if (error != 0)
+            {
+                ++result.connectErrors;
+                reopen(*conn, false);
+                return;
+            }
+            conn->connecting = false;
+            if (!fillPipeline(*conn))
+            {
+                return;
+            }
+        }
+        if (events & EPOLLIN)
+        {
+            if (!readResponses(*conn))
+            {
+                return;
+            }
+        }
+        if (events & EPOLLOUT)
+        {
+            flush(*conn);
+        }
+    }
+
+    // 补足在途请求并写出；连接被重建时返回false
+    bool fillPipeline(Connection& conn)
+    {
+        int64_t t = nowNs();
+        while (static_cast<int>(conn.sentAt.size()) < options.pipeline && t < measureEnd)
+        {
+            conn.output += request;
+            conn.sentAt.push_back(t);
+        }
+        return flush(conn);
+    }
+
+    // 写出待发送的请求；写失败时重建连接并返回false
+    bool flush(Connection& conn)
+    {
+        while (conn.outputOffset < conn.output.size())
+        {
+            ssize_t n = send(conn.fd, conn.output.data() + conn.outputOffset, conn.output.size() - conn.outputOffset,
+                             MSG_NOSIGNAL);
+            if (n > 0)
+            {
+                conn.outputOffset += static_cast<size_t>(n);
+            }
+            else if (n < 0 && errno == EAGAIN)
+            {
+                return true;
+            }
+            else
+            {
+                ++result.writeErrors;
+                reopen(conn, false);
+                return false;
+            }
+        }
+        conn.output.clear();
+        conn.outputOffset = 0;
+        return true;
+    }
+
+    // 读入并处理所有完整响应；连接被关闭或重建时返回false
+    bool readResponses(Connection& conn)
+    {
+        char buf[65536];
+        bool eof = false;
+        while (true)
+        {
+            ssize_t n = recv(conn.fd, buf, sizeof(buf), 0);
+            if (n > 0)
+            {
+                conn.input.append(buf, static_cast<size_t>(n));
+                if (measuring(nowNs()))
+                {
+                    result.bytes += static_cast<uint64_t>(n);
+                }
+                continue;
+            }
+            if (n == 0)
+            {
+                eof = true;
+            }
+            else if (errno != EAGAIN)
+            {
+                reopen(conn, true);
+                return false;
+            }
+            break;
+        }
+
+        size_t consumed = 0;
+        bool closeAfter = false;
+        while (!conn.sentAt.empty())
+        {
+            ParsedResponse response;
+            ParseResult parsed = parseResponse(std::string_view(conn.input).substr(consumed), response);
+            if (parsed == ParseResult::INCOMPLETE && response.untilClose && eof)
+            {
+                response.length = conn.input.size() - consumed;
+                parsed = ParseResult::COMPLETE;
+            }
+            if (parsed == ParseResult::ERROR)
+            {
+                ++result.parseErrors;
+                reopen(conn, false);
+                return false;
+            }
+            if (parsed == ParseResult::INCOMPLETE)
+            {
+                break;
+            }
+            consumed += response.length;
+            if (response.status < 200)
+            {
+                continue; // 中间响应，继续等待最终响应
+            }
+            int64_t t = nowNs();
+            if (measuring(t))
+            {
+                ++result.requests;
+                ++result.status[response.status >= 100 && response.status < 600 ? response.status / 100 : 0];
+                result.latencies.push_back(t - conn.sentAt.front());
+            }
+            conn.sentAt.pop_front();
+            if (response.close)
+            {
+                closeAfter = true;
+                break;
+            }
+        }
+        conn.input.erase(0, consumed);
+
+        if (closeAfter || eof)
+        {
+            reopen(conn, eof && !closeAfter);
+            return false;
+        }
+        return fillPipeline(conn);
+    }
+
+    const Options& options;
+    sockaddr_storage address;
+    socklen_t addressLen;
+    int connectionCount;
+    int64_t measureStart;
+    int64_t measureEnd;
+    std::string request;
+    Epoll poller;
+    std::vector<std::unique_ptr<Connection>> connections; // 以fd为下标
+};
+
+socklen_t resolve(const Options& options, sockaddr_storage& address)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* info = nullptr;
+    std::string port = std::to_string(options.port);
+    int rc = getaddrinfo(options.host.c_str(), port.c_str(), &hints, &info);
+    if (rc != 0 || info == nullptr)
+    {
+        throw std::runtime_error("cannot resolve " + options.host + ": " + gai_strerror(rc));
+    }
+    socklen_t len = info->ai_addrlen;
+    std::memcpy(&address, info->ai_addr, len);
+    freeaddrinfo(info);
+    return len;
+}
+
+// 已排序样本的分位数（最近秩法），单位微秒
+double percentileUs(const std::vector<int64_t>& sorted, double q)
+{
+    if (sorted.empty())
+    {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(q * static_cast<double>(sorted.size()));
+    return static_cast<double>(sorted[std::min(rank, sorted.size() - 1)]) / 1e3;
+}
+
+std::string jsonEscape(const std::string& s)
+{
+    std::string out;
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+std::string toJson(const Options& options, const Result& total, const std::vector<int64_t>& sorted)
+{
+    double mean = 0.0;
+    for (int64_t v : sorted)
+    {
+        mean += static_cast<double>(v);
+    }
+    mean = sorted.empty() ? 0.0 : mean / static_cast<double>(sorted.size()) / 1e3;
+
+    char buf[2048];
+    snprintf(buf, sizeof(buf),
+             "{\n"
+             "  \"target\": \"%s:%d%s\",\n"
+             "  \"threads\": %d,\n"
+             "  \"connections\": %d,\n"
+             "  \"pipeline\": %d,\n"
+             "  \"keepalive\": %s,\n"
+             "  \"duration_s\": %.3f,\n"
+             "  \"requests\": %llu,\n"
+             "  \"throughput_rps\": %.1f,\n"
+             "  \"throughput_mib_s\": %.2f,\n"
+             "  \"latency_us\": {\"mean\": %.1f, \"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, "
+             "\"p999\": %.1f, \"max\": %.1f},\n"
+             "  \"status\": {\"1xx\": %llu, \"2xx\": %llu, \"3xx\": %llu, \"4xx\": %llu, \"5xx\": %llu, "
+             "\"other\": %llu},\n"
+             "  \"errors\": {\"connect\": %llu, \"read\": %llu, \"write\": %llu, \"parse\": %llu},\n"
+             "  \"reconnects\": %llu\n"
+             "}\n",
+             jsonEscape(options.host).c_str(), options.port, jsonEscape(options.path).c_str(), options.threads,
+             options.connections, options.pipeline, options.keepAlive ? "true" : "false", options.duration,
+             static_cast<unsigned long long>(total.requests),
+             static_cast<double>(total.requests) / options.duration,
+             static_cast<double>(total.bytes) / options.duration / (1024.0 * 1024.0), mean,
+             percentileUs(sorted, 0.50), percentileUs(sorted, 0.90), percentileUs(sorted, 0.99),
+             percentileUs(sorted, 0.999), sorted.empty() ? 0.0 : static_cast<double>(sorted.back()) / 1e3,
+             static_cast<unsigned long long>(total.status[1]), static_cast<unsigned long long>(total.status[2]),
+             static_cast<unsigned long long>(total.status[3]), static_cast<unsigned long long>(total.status[4]),
+             static_cast<unsigned long long>(total.status[5]), static_cast<unsigned long long>(total.status[0]),
+             static_cast<unsigned long long>(total.connectErrors), static_cast<unsigned long long>(total.readErrors),
+             static_cast<unsigned long long>(total.writeErrors), static_cast<unsigned long long>(total.parseErrors),
+             static_cast<unsigned long long>(total.reconnects));
+    return buf;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Logger::instance().setLevel(ERROR);
+    try
+    {
+        Options options = parseOptions(argc, argv);
+        sockaddr_storage address{};
+        socklen_t addressLen = resolve(options, address);
+
+        int64_t measureStart = nowNs() + static_cast<int64_t>(options.warmup * 1e9);
+        int64_t measureEnd = measureStart + static_cast<int64_t>(options.duration * 1e9);
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        for (int i = 0; i < options.threads; ++i)
+        {
+            // 连接数不能整除时前几个线程多分一个
+            int share = options.connections / options.threads + (i < options.connections % options.threads ? 1 : 0);
+            workers.push_back(
+                std::make_unique<Worker>(options, address, addressLen, share, measureStart, measureEnd));
+        }
+        std::vector<std::thread> threads;
+        for (auto& worker : workers)
+        {
+            threads.emplace_back([&worker] { worker->run(); });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        Result total;
+        for (auto& worker : workers)
+        {
+            const Result& r = worker->result;
+            total.requests += r.requests;
+            total.bytes += r.bytes;
+            for (int i = 0; i < 6; ++i)
+            {
+                total.status[i] += r.status[i];
+            }
+            total.connectErrors += r.connectErrors;
+            total.readErrors += r.readErrors;
+            total.writeErrors += r.writeErrors;
+            total.parseErrors += r.parseErrors;
+            total.reconnects += r.reconnects;
+            total.latencies.insert(total.latencies.end(), r.latencies.begin(), r.latencies.end());
+        }
+        std::sort(total.latencies.begin(), total.latencies.end());
+
+        std::string json = toJson(options, total, total.latencies);
+        std::cout << json;
+        if (!options.out.empty())
+        {
+            std::ofstream file(options.out);
+            file << json;
+            if (!file)
+            {
+                throw std::runtime_error("cannot write " + options.out);
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "loadgen: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief 基于排队时间的自适应准入控制（CoDel）
+ *
+ * 采用服务端队列常用的CoDel变体：每个interval统计一次任务排队时间的最小值，
+ * 最小值仍超过target说明队列在整个区间内都没有排空（持续积压而非突发），进入过载状态；
+ * 过载期间排队超过2*target的任务直接拒绝，让其余任务的排队时间回落到target附近。
+ * 突发流量只要能在一个interval内消化就不会触发拒绝。
+ * 所有方法可在任意线程并发调用。
+ */
+class AdmissionController
+{
+public:
+    // targetNs为0表示不启用，所有任务都准入
+    AdmissionController(int64_t targetNs, int64_t intervalNs);
+
+    /**
+     * @brief 任务出队时记录其排队时间并决定是否拒绝
+     * @return 应拒绝（直接回复过载）时返回true
+     */
+    bool shouldShed(int64_t sojournNs, int64_t nowNs);
+
+    // 当前是否处于过载状态
+    bool overloaded() const { return overload.load(std::memory_order_relaxed); }
+
+private:
+    const int64_t targetNs;
+    const int64_t intervalNs;
+    std::atomic<int64_t> intervalEndNs{0};   // 当前统计区间的结束时间
+    std::atomic<int64_t> minSojournNs{INT64_MAX}; // 当前区间内的最小排队时间
+    std::atomic<bool> overload{false};
+};
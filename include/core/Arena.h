@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+
+/**
+ * @brief 请求作用域的内存池（bump分配器）
+ *
+ * 作为std::pmr::memory_resource供pmr容器使用：分配只在当前块内移动指针，单个释放为空操作，
+ * reset时一次性回收此前的全部分配。固定大小的块取自线程本地的空闲链表，reset后归还，
+ * 因此稳定运行后不经过全局堆，空闲的长连接也不占用块；超过半块的分配单独向堆申请，reset时释放。
+ * 不加锁，同一时刻只能由一个线程使用
+ */
+class Arena : public std::pmr::memory_resource
+{
+public:
+    static constexpr size_t BLOCK_SIZE = 8192; // 固定块大小（含块头）
+
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    ~Arena() override { reset(); }
+
+    // 回收全部分配，之前分配的内存都不能再使用
+    void reset();
+
+    // 当前持有的字节数（含单独申请的大块）
+    size_t capacity() const { return held; }
+
+private:
+    struct Block
+    {
+        Block* next;
+        size_t size;   // 含块头的总大小，等于BLOCK_SIZE的块归还到空闲链表
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    Block* blocks = nullptr;   // 持有的全部块，链表头为当前分配的固定块（如果有）
+    char* cursor = nullptr;    // 当前块中下一个可用字节
+    char* limit = nullptr;     // 当前块的末尾
+    size_t held = 0;
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+/**
+ * @brief 可增长的字节缓冲区
+ *
+ * 读写两个下标划分出可读区域和可写区域，
+ * 头部已读空间在扩容前优先被回收复用，避免频繁重新分配
+ */
+class Buffer
+{
+public:
+    static constexpr size_t INITIAL_SIZE = 1024;  // 初始容量
+
+    explicit Buffer(size_t initialSize = INITIAL_SIZE) : buffer(initialSize) {}
+
+    // 可读/可写字节数
+    size_t readableBytes() const { return writerIndex - readerIndex; }
+    size_t writableBytes() const { return buffer.size() - writerIndex; }
+
+    // 可读数据起始地址
+    const char* peek() const { return buffer.data() + readerIndex; }
+
+    // 消费len字节可读数据
+    void retrieve(size_t len);
+
+    // 移除可读区域中从offset开始的len字节，其后的数据前移补位
+    void erase(size_t offset, size_t len);
+
+    // 清空全部数据
+    void retrieveAll() { readerIndex = writerIndex = 0; }
+
+    // 追加数据
+    void append(const char* data, size_t len);
+    void append(const std::string& str) { append(str.data(), str.size()); }
+
+    // 从fd读取数据追加到缓冲区，返回读到的字节数，出错时返回-1并设置savedErrno
+    ssize_t readFd(int fd, int* savedErrno);
+
+    // 把至多maxLen字节可读数据写到socket，返回写出的字节数，出错时返回-1并设置savedErrno
+    ssize_t writeFd(int fd, int* savedErrno, size_t maxLen = SIZE_MAX, int flags = 0);
+
+private:
+    // 确保至少有len字节可写空间
+    void ensureWritable(size_t len);
+
+    std::vector<char> buffer;
+    size_t readerIndex = 0;
+    size_t writerIndex = 0;
+};
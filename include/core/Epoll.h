@@ -1,4 +1,5 @@
 #pragma once
+#include "core/Poller.h"
 #include <vector>
 #include <sys/epoll.h>
 
@@ -8,7 +9,7 @@
  * 封装epoll系统调用，提供更安全易用的API
  * 支持边缘触发(ET)模式和水平触发(LT)模式
  */
-class Epoll 
+class Epoll : public Poller
 {
 public:
     static constexpr int MAX_EVENTS = 1024;  // 单次epoll_wait最大事件数
@@ -17,22 +18,24 @@ public:
     Epoll();
     
     // 析构时关闭epoll文件描述符
-    ~Epoll();
+    ~Epoll() override;
     
     // 添加文件描述符到epoll监控
-    void addFd(int fd, uint32_t events);
+    void addFd(int fd, uint32_t events) override;
     
     // 修改已注册的文件描述符事件
-    void modFd(int fd, uint32_t events);
+    void modFd(int fd, uint32_t events) override;
     
     // 移除监控的文件描述符
-    void removeFd(int fd);
+    void removeFd(int fd) override;
     
     // 等待事件发生
-    int wait(int timeoutMs = -1);
+    int wait(int timeoutMs = -1) override;
     
     // 获取就绪事件数组
-    const epoll_event* events() const { return readyEvents.data(); }
+    const epoll_event* events() const override { return readyEvents.data(); }
+
+    Backend backend() const override { return Backend::EPOLL; }
 
 private:
     int epollFd = -1;                       // epoll实例文件描述符
@@ -0,0 +1,107 @@
+#pragma once
+#include "core/Poller.h"
+#include "core/TimerWheel.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <unordered_map>
+
+/**
+ * @brief 单线程事件循环（Reactor）
+ *
+ * 每个EventLoop独占一个事件源（epoll或io_uring，见Poller），按fd分发就绪事件到注册的回调。
+ * 通过eventfd支持其他线程向循环线程投递任务（runInLoop/queueInLoop）。
+ * addFd/removeFd只能在循环线程（或循环启动前）调用，modFd可在任意线程调用。
+ * 内置分层时间轮，等待的超时取自最近的定时器，定时器接口只能在循环线程调用。
+ */
+class IoUringPoller;
+
+class EventLoop
+{
+public:
+    using EventCallback = std::function<void(uint32_t events)>;
+    using Functor = std::function<void()>;
+
+    // 请求的后端不可用时回退到epoll
+    explicit EventLoop(Poller::Backend backend = Poller::Backend::EPOLL);
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // 在当前线程运行事件循环，直到quit()被调用
+    void loop();
+
+    // 退出事件循环（线程安全）
+    void quit();
+
+    // 注册fd及其事件回调
+    void addFd(int fd, uint32_t events, EventCallback cb);
+
+    // 修改fd关注的事件（线程安全）
+    void modFd(int fd, uint32_t events);
+
+    // 注销fd，回调在本次分发结束后才真正释放
+    void removeFd(int fd);
+
+    // 在循环线程执行任务：若当前即为循环线程则立即执行，否则排队并唤醒
+    void runInLoop(Functor cb);
+
+    // 排队到循环线程，在本轮事件处理完后执行
+    void queueInLoop(Functor cb);
+
+    // 在delayMs毫秒后于循环线程执行cb（仅循环线程调用）
+    TimerId runAfter(int64_t delayMs, Functor cb);
+
+    // 每隔intervalMs毫秒于循环线程执行一次cb，直到被取消（仅循环线程调用）
+    TimerId runEvery(int64_t intervalMs, Functor cb);
+
+    // 重新调度定时器，可在定时器自身的回调中调用（仅循环线程调用）
+    bool restartTimer(TimerId id, int64_t delayMs);
+
+    // 取消定时器（仅循环线程调用）
+    void cancelTimer(TimerId id);
+
+    // 单调时钟的当前毫秒数
+    static int64_t nowMs();
+
+    // 单调时钟的当前纳秒数
+    static int64_t nowNs();
+
+    // 本轮就绪事件返回时的单调时钟纳秒数（仅循环线程调用）
+    int64_t pollTimeNs() const { return pollReturnNs; }
+
+    // 实际使用的事件源后端
+    Poller::Backend backend() const { return poller->backend(); }
+
+    // io_uring后端的完成式接口，epoll后端返回nullptr（仅循环线程使用）
+    IoUringPoller* uring() { return uringPoller; }
+
+    // 判断调用者是否处于循环线程；loop()开始之前和返回之后总是false，投递的任务都排队到循环中执行
+    bool isInLoopThread() const { return threadId.load(std::memory_order_acquire) == std::this_thread::get_id(); }
+
+private:
+    // 唤醒阻塞在等待中的循环线程
+    void wakeup();
+
+    // 执行其他线程投递的任务
+    void doPendingFunctors();
+
+    std::unique_ptr<Poller> poller;              // 本循环独占的事件源
+    IoUringPoller* uringPoller = nullptr;        // poller为io_uring时指向它
+    int wakeupFd = -1;                           // 跨线程唤醒用的eventfd
+    std::atomic<std::thread::id> threadId{};     // 运行loop()的线程ID，未运行时为空ID
+    std::atomic<bool> quitFlag{false};           // 退出标志
+    TimerWheel timers;                           // 定时器，仅循环线程访问
+    int64_t pollReturnNs = 0;                    // 本轮事件返回的时间，仅循环线程访问
+
+    // fd -> 事件回调，仅循环线程访问
+    std::unordered_map<int, std::shared_ptr<EventCallback>> callbacks;
+
+    std::mutex pendingMutex;                     // 保护pendingFunctors
+    std::vector<Functor> pendingFunctors;        // 跨线程投递的任务
+    std::atomic<bool> callingPending{false};     // 是否正在执行投递任务
+};
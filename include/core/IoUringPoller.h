@@ -0,0 +1,168 @@
+#pragma once
+#include "core/Poller.h"
+#include <linux/io_uring.h>
+#include <sys/types.h>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief 基于io_uring的事件源
+ *
+ * 直接使用io_uring_setup/io_uring_enter/io_uring_register系统调用，不依赖liburing。
+ * 两类用法共用同一个环：
+ * - 就绪通知（Poller接口）：每个fd一个POLL_ADD请求，非EPOLLONESHOT时为multishot；
+ *   注册、修改和移除只写入提交队列，在下一次io_uring_enter时与等待合并为一次系统调用
+ * - 完成式I/O：multishot accept、基于provided buffer ring的multishot recv、send、
+ *   先取消全部请求再close，结果以回调交付；一轮循环中所有连接产生的请求一次提交。
+ *   缓冲环不可用的内核上改用IORING_OP_PROVIDE_BUFFERS提供同一组缓冲
+ * 完成式接口和wait只能在循环线程调用；modFd可在任意线程调用，循环线程阻塞在内核中时立即提交。
+ */
+class IoUringPoller : public Poller
+{
+public:
+    using AcceptCallback = std::function<void(int fd)>;                    // fd为负数时为-errno
+    using RecvCallback = std::function<void(const char* data, ssize_t n)>; // n为0表示对端关闭，负数为-errno
+    using SendCallback = std::function<void(ssize_t n)>;                   // 已发送字节数或-errno
+    using PollCallback = std::function<void(uint32_t events)>;
+
+    static constexpr unsigned RING_ENTRIES = 1024;      // 提交队列长度
+    static constexpr unsigned BUFFER_COUNT = 512;       // recv缓冲数量（2的幂）
+    static constexpr unsigned BUFFER_SIZE = 16 * 1024;  // 单个recv缓冲的大小
+
+    // 提交与完成的统计
+    struct Stats
+    {
+        uint64_t enterCalls = 0;  // io_uring_enter调用次数
+        uint64_t submitted = 0;   // 提交的请求数
+        uint64_t completed = 0;   // 处理的完成事件数
+    };
+
+    // 创建环并注册recv缓冲，内核不支持所需特性时抛出std::runtime_error
+    IoUringPoller();
+    ~IoUringPoller() override;
+
+    IoUringPoller(const IoUringPoller&) = delete;
+    IoUringPoller& operator=(const IoUringPoller&) = delete;
+
+    void addFd(int fd, uint32_t events) override;
+    void modFd(int fd, uint32_t events) override;
+    void removeFd(int fd) override;
+    int wait(int timeoutMs) override;
+    const epoll_event* events() const override { return readyEvents.data(); }
+    Backend backend() const override { return Backend::IO_URING; }
+
+    // 执行上一次wait取出的完成式操作的回调；EventLoop在记录本轮时间后、分发就绪事件前调用
+    void runCompletions();
+
+    // multishot accept，新连接为非阻塞；返回的编号可用于cancel
+    uint64_t acceptMultishot(int listenFd, AcceptCallback cb);
+
+    // multishot recv，数据位于内核选择的缓冲中，只在回调期间有效；缓冲耗尽时自动重新提交
+    uint64_t recvMultishot(int fd, RecvCallback cb);
+
+    // 发送data的前len字节，完成前data必须保持有效
+    uint64_t send(int fd, const void* data, size_t len, int flags, SendCallback cb);
+
+    // 单次就绪通知
+    uint64_t pollOnce(int fd, uint32_t events, PollCallback cb);
+
+    // 取消一个进行中的操作，操作的最后一次回调为-ECANCELED（或在取消生效前正常结束）
+    void cancel(uint64_t op);
+
+    // 取消fd上的全部操作后关闭fd（同一批提交，按顺序执行）
+    void close(int fd);
+
+    const Stats& stats() const { return counters; }
+
+private:
+    // 完成事件的处理函数：res为结果，flags为CQE标志；
+    // 在操作的最后一个完成事件中返回true表示以同一编号重新提交（multishot被内核终止时）
+    using Completion = std::function<bool(int32_t res, uint32_t flags)>;
+
+    // 进行中的完成式操作
+    struct Op
+    {
+        uint32_t generation = 0;
+        bool active = false;
+        bool cancelled = false;  // 已请求取消，结束后不再重新提交
+        io_uring_sqe sqe{};      // 提交的请求，重新提交时复用
+        Completion handler;
+    };
+
+    // 就绪通知的注册状态
+    struct FdState
+    {
+        uint32_t events = 0;
+        uint32_t generation = 0;
+        bool registered = false;
+        bool armed = false;     // 内核中是否有该fd的POLL_ADD
+    };
+
+    // 拷贝一个准备好的SQE到提交队列（需持有sqMutex）
+    void push(const io_uring_sqe& sqe);
+
+    // 调用io_uring_enter提交（需持有sqMutex）
+    void submitLocked();
+
+    // 为fd提交POLL_ADD（需持有sqMutex）
+    void armPoll(int fd, FdState& state);
+
+    // 分配操作槽位，提交sqe并返回user_data
+    uint64_t submitOp(const io_uring_sqe& sqe, Completion handler);
+
+    // 注册provided buffer ring并实际收一次数据确认可用，失败时返回false
+    bool setupBufferRing();
+
+    // 把recv缓冲归还给内核
+    void recycleBuffer(uint16_t bid);
+
+    // 处理一个完成事件
+    void dispatch(uint64_t userData, int32_t res, uint32_t flags);
+
+    int ringFd = -1;
+    void* ringPtr = nullptr;
+    size_t ringSize = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqesSize = 0;
+
+    // 提交队列
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+    unsigned sqLocalTail = 0;
+    unsigned pendingSubmit = 0;    // 已写入但尚未提交的SQE数量
+
+    // 完成队列
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    // provided buffer ring，为空时改用IORING_OP_PROVIDE_BUFFERS逐个归还缓冲
+    io_uring_buf_ring* bufRing = nullptr;
+    size_t bufRingSize = 0;
+    std::unique_ptr<char[]> bufferPool;
+    uint16_t bufTail = 0;
+
+    std::mutex sqMutex;            // 保护提交队列和fdStates
+    bool waiting = false;          // 循环线程是否阻塞在io_uring_enter中
+    std::vector<FdState> fdStates; // fd -> 就绪通知状态
+
+    std::deque<Op> ops;            // 操作槽位（deque保证回调执行期间元素地址不变）
+    std::vector<uint32_t> freeOps; // 空闲槽位
+
+    struct Cqe
+    {
+        uint64_t userData;
+        int32_t res;
+        uint32_t flags;
+    };
+    std::vector<Cqe> harvested;              // 本轮取出、尚未执行回调的完成式操作
+    std::vector<epoll_event> readyEvents;    // 本轮的就绪事件
+    Stats counters;
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <sys/epoll.h>
+
+/**
+ * @brief I/O事件源接口
+ *
+ * EventLoop通过该接口等待fd就绪，不关心底层机制。事件以epoll_event表示
+ * （events为EPOLLIN/EPOLLOUT等掩码，data.fd为fd），两种实现都按EPOLLET/EPOLLONESHOT的语义工作：
+ * - EPOLL：epoll_create1/epoll_ctl/epoll_wait
+ * - IO_URING：io_uring的POLL_ADD请求，注册和修改在下一次io_uring_enter时批量提交，
+ *   并额外提供accept/recv/send/close的完成式接口（见IoUringPoller）
+ */
+class Poller
+{
+public:
+    enum class Backend
+    {
+        EPOLL,
+        IO_URING
+    };
+
+    virtual ~Poller() = default;
+
+    // 添加文件描述符及关注的事件
+    virtual void addFd(int fd, uint32_t events) = 0;
+
+    // 修改关注的事件（线程安全）
+    virtual void modFd(int fd, uint32_t events) = 0;
+
+    // 移除文件描述符
+    virtual void removeFd(int fd) = 0;
+
+    // 等待事件发生，返回就绪事件数量
+    virtual int wait(int timeoutMs) = 0;
+
+    // 获取就绪事件数组
+    virtual const epoll_event* events() const = 0;
+
+    // 实际使用的后端
+    virtual Backend backend() const = 0;
+
+    /**
+     * @brief 创建事件源
+     *
+     * 请求IO_URING但内核不支持（或被禁用）时记录日志并回退到EPOLL
+     */
+    static std::unique_ptr<Poller> create(Backend preferred);
+
+    // 后端名称
+    static const char* backendName(Backend backend);
+};
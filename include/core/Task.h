@@ -0,0 +1,110 @@
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <utility>
+
+/**
+ * @brief 协程帧的内存池
+ *
+ * 按64字节分级的线程本地空闲链表，每级最多缓存固定数量的帧：同一个处理器每次请求产生的帧
+ * 大小相同，稳定运行后帧的分配和释放都不经过全局堆。帧在哪个线程释放就归还到哪个线程的链表，
+ * 不需要加锁；超过最大分级的帧直接使用operator new
+ */
+class FramePool
+{
+public:
+    static void* allocate(size_t size);
+    static void deallocate(void* frame, size_t size) noexcept;
+};
+
+/**
+ * @brief 无返回值的协程任务
+ *
+ * 惰性启动：创建后处于挂起状态，作为子任务被co_await时开始执行，顶层任务由start开始执行。
+ * 子任务结束时以对称转移直接恢复等待它的协程，不经过事件循环；顶层任务结束时控制回到最后一次恢复它的调用方。
+ * 协程帧从FramePool分配，Task对象销毁时一并销毁（可能仍处于挂起状态的）协程帧及其中的子任务
+ */
+class Task
+{
+public:
+    struct promise_type
+    {
+        std::coroutine_handle<> continuation; // 等待本任务结束的协程，顶层任务为空
+        std::exception_ptr exception;         // 协程中未捕获的异常
+
+        static void* operator new(size_t size) { return FramePool::allocate(size); }
+        static void operator delete(void* frame, size_t size) noexcept { FramePool::deallocate(frame, size); }
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // 结束时转到等待者，没有等待者时返回调用方；帧保留到Task销毁
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> self) noexcept
+            {
+                std::coroutine_handle<> next = self.promise().continuation;
+                return next ? next : std::noop_coroutine();
+            }
+            void await_resume() const noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+    };
+
+    Task() = default;
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() { reset(); }
+
+    // 顶层任务：执行到第一个挂起点（或结束）
+    void start() { handle.resume(); }
+
+    bool done() const { return !handle || handle.done(); }
+
+    // 已结束的任务中未捕获的异常，没有时为空
+    std::exception_ptr exception() const { return handle ? handle.promise().exception : nullptr; }
+
+    // 作为子任务被co_await：保存等待者后转到本任务执行，结束时重新抛出其中未捕获的异常
+    bool await_ready() const noexcept { return done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+    void await_resume() const
+    {
+        if (std::exception_ptr error = exception())
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    void reset()
+    {
+        if (handle)
+        {
+            handle.destroy();
+            handle = nullptr;
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle;
+};
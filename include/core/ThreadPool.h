@@ -6,32 +6,112 @@
 #include <condition_variable>
 #include <functional>
 #include <atomic>
+#include <memory>
 
 /**
  * @brief 线程池实现
- * 
- * 基于任务队列的生产者-消费者模型实现
- * 支持动态线程数量控制
+ *
+ * 支持两种调度模式：
+ * - SHARED_QUEUE：基于单一任务队列的生产者-消费者模型
+ * - WORK_STEALING：每个工作线程一个无锁Chase-Lev双端队列，外部提交经由目标线程的
+ *   无锁收件箱进入，空闲线程从其他线程窃取任务，先自旋再休眠
+ *
+ * 可设置排队任务数上限，队列满时按OverflowPolicy拒绝、阻塞或丢弃最早的任务
  */
-class ThreadPool 
+class ThreadPool
 {
 public:
-    // 构造函数指定线程数量
-    explicit ThreadPool(size_t numThreads);
-    
+    // 调度模式
+    enum class Mode
+    {
+        SHARED_QUEUE,   // 共享队列+互斥锁+条件变量
+        WORK_STEALING   // 每线程无锁双端队列+工作窃取
+    };
+
+    // 排队任务数达到上限时的处理策略
+    enum class OverflowPolicy
+    {
+        REJECT,      // 拒绝新任务
+        BLOCK,       // 阻塞提交线程直到有空位（工作线程自己提交时不阻塞，避免全部阻塞而死锁）
+        DROP_OLDEST  // 丢弃最早排队的任务（调用其onDropped）后接受新任务
+    };
+
+    /**
+     * @brief 构造函数指定线程数量、调度模式和排队上限
+     * @param capacity 排队（尚未开始执行）的任务数上限，0表示不限
+     */
+    explicit ThreadPool(size_t numThreads, Mode mode = Mode::SHARED_QUEUE, size_t capacity = 0,
+                        OverflowPolicy policy = OverflowPolicy::REJECT);
+
     // 析构函数等待所有线程结束
     ~ThreadPool();
-    
-    // 向任务队列添加任务
-    void enqueue(std::function<void()> task);
-    
-    // 获取当前任务队列大小
+
+    /**
+     * @brief 向任务队列添加任务
+     *
+     * 工作窃取模式下只有外部提交受上限约束，工作线程派生的任务总是进入本地队列；
+     * DROP_OLDEST只能丢弃已搬入本地队列的任务，找不到时按REJECT处理
+     * @param onDropped 任务排队后被DROP_OLDEST丢弃时调用，在提交新任务的线程中执行
+     * @return 队列已满、任务被拒绝（不会执行）时返回false；线程池已停止时抛出std::runtime_error
+     */
+    bool enqueue(std::function<void()> task, std::function<void()> onDropped = nullptr);
+
+    // 获取当前任务队列大小（工作窃取模式下为各线程队列之和的近似值）
     size_t queueSize() const;
 
+    // 排队任务数上限，0表示不限
+    size_t capacity() const { return maxQueued; }
+
 private:
+    struct Task;
+    struct Worker;
+
+    // 共享队列模式的任务
+    struct QueuedTask
+    {
+        std::function<void()> fn;
+        std::function<void()> onDropped;
+    };
+
+    // 共享队列模式的工作线程主循环
+    void sharedQueueLoop();
+
+    // 工作窃取模式的工作线程主循环
+    void workStealingLoop(size_t index);
+
+    // 工作窃取模式：依次尝试本地队列、收件箱和窃取其他线程
+    Task* findTask(Worker& self);
+
+    // 工作窃取模式：是否还有任何待执行任务
+    bool hasPendingTasks() const;
+
+    // 工作窃取模式：有线程休眠时唤醒一个
+    void wakeOne();
+
+    // 工作窃取模式：外部提交占用一个排队名额，队列满时按策略处理，返回false表示拒绝
+    bool reserveSlot();
+
+    // 工作窃取模式：任务开始执行，释放排队名额并唤醒阻塞的提交线程
+    void releaseSlot();
+
+    // 执行任务并捕获异常
+    static void runTask(std::function<void()>& task);
+
+    Mode mode;                              // 调度模式
     std::vector<std::thread> workers;       // 工作线程集合
     mutable std::mutex queueMutex;          // 任务队列互斥锁
     std::condition_variable condition;      // 条件变量
-    std::queue<std::function<void()>> tasks;// 任务队列
+    std::queue<QueuedTask> tasks;           // 任务队列
     std::atomic<bool> stop{false};          // 停止标志
-};
\ No newline at end of file
+
+    // 排队上限
+    size_t maxQueued;                       // 排队任务数上限，0表示不限
+    OverflowPolicy policy;                  // 队列满时的策略
+    std::condition_variable spaceCondition; // BLOCK策略下等待空位
+    std::atomic<int> blockedSubmitters{0};  // 正在等待空位的提交线程数
+    std::atomic<size_t> queued{0};          // 工作窃取模式：外部提交且尚未开始执行的任务数
+
+    // 工作窃取模式状态
+    std::vector<std::unique_ptr<Worker>> stealingWorkers; // 各线程的队列和收件箱
+    std::atomic<size_t> nextWorker{0};      // 外部提交的轮转起点
+};
@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief 定时器句柄
+ *
+ * 由节点下标和代数组成，节点被回收复用后旧句柄自动失效
+ */
+struct TimerId
+{
+    int32_t index = -1;
+    uint32_t generation = 0;
+
+    bool valid() const { return index >= 0; }
+};
+
+/**
+ * @brief 分层时间轮
+ *
+ * 4层（256/64/64/64槽）共可表示约2^26个tick，插入、取消、重启均为O(1)。
+ * 定时器节点存放在连续的节点池中并通过下标组成双向链表，取消不释放内存、
+ * 只把节点放回空闲链表，10万级连接下也不会产生额外的分配。
+ * 非线程安全，只能在所属事件循环线程中使用。
+ */
+class TimerWheel
+{
+public:
+    using Callback = std::function<void()>;
+
+    // tickMs为时间轮精度，nowMs为当前单调时间（毫秒）
+    TimerWheel(int64_t tickMs, int64_t nowMs);
+
+    // 添加在delayMs毫秒后触发的定时器
+    TimerId add(int64_t delayMs, Callback cb);
+
+    // 以新的延迟重新调度（可在该定时器自己的回调中调用），句柄失效时返回false
+    bool restart(TimerId id, int64_t delayMs);
+
+    // 取消定时器（可在任意回调中调用），句柄失效时无操作
+    void cancel(TimerId id);
+
+    // 推进时间轮到nowMs并执行所有到期的定时器
+    void advance(int64_t nowMs);
+
+    // 距离下一个可能到期的tick的毫秒数，没有定时器时返回-1（供epoll_wait使用）
+    int nextTimeoutMs(int64_t nowMs) const;
+
+    // 活跃定时器数量
+    size_t size() const { return activeCount; }
+
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int ROOT_BITS = 8;
+    static constexpr int LEVEL_BITS = 6;
+    static constexpr int ROOT_SIZE = 1 << ROOT_BITS;
+    static constexpr int LEVEL_SIZE = 1 << LEVEL_BITS;
+    static constexpr int SLOT_COUNT = ROOT_SIZE + (LEVELS - 1) * LEVEL_SIZE;
+
+    enum class NodeState : uint8_t
+    {
+        FREE,      // 在空闲链表中
+        ACTIVE,    // 挂在某个槽上
+        FIRING,    // 回调执行中
+        CANCELLED  // 回调执行中被取消
+    };
+
+    struct Node
+    {
+        int64_t expire = 0;        // 到期tick
+        Callback callback;
+        int32_t prev = -1;
+        int32_t next = -1;
+        int32_t slot = -1;         // 所在槽（全局槽编号）
+        uint32_t generation = 0;
+        NodeState state = NodeState::FREE;
+    };
+
+    // 根据到期tick计算槽编号
+    int slotFor(int64_t expire) const;
+
+    // 把节点挂到对应的槽
+    void link(int32_t index);
+
+    // 从所在槽摘下节点
+    void unlink(int32_t index);
+
+    // 回收节点
+    void release(int32_t index);
+
+    // 把高层槽中的节点重新分配到低层
+    void cascade(int level, int slotIndex);
+
+    // 句柄是否指向有效节点
+    bool alive(TimerId id) const;
+
+    const int64_t tickMs;
+    int64_t currentTick;           // 已处理到的tick
+    size_t activeCount = 0;
+
+    std::vector<Node> nodes;       // 节点池
+    std::vector<int32_t> slots;    // 每个槽的链表头
+    int32_t freeList = -1;         // 空闲节点链表头
+};
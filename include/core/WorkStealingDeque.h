@@ -0,0 +1,133 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Chase-Lev无锁工作窃取双端队列
+ *
+ * 所有者线程在底部push/pop（LIFO，缓存友好），其他线程在顶部steal（FIFO）。
+ * 实现参照Lê等人《Correct and Efficient Work-Stealing for Weak Memory Models》。
+ * 扩容后的旧数组保留到析构时才释放，窃取者读取旧数组始终安全。
+ */
+template <typename T>
+class WorkStealingDeque
+{
+public:
+    explicit WorkStealingDeque(int64_t initialCapacity = 256)
+    {
+        arrays.emplace_back(new Array(initialCapacity));
+        array.store(arrays.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // 仅所有者调用：压入底部
+    void push(T* item)
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Array* a = array.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1)
+        {
+            a = grow(a, b, t);
+        }
+        a->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // 仅所有者调用：从底部弹出，队列为空或被窃取者抢走最后一个元素时返回nullptr
+    T* pop()
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Array* a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            // 队列为空
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T* item = a->get(b);
+        if (t == b)
+        {
+            // 最后一个元素，与窃取者竞争
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                             std::memory_order_relaxed))
+            {
+                item = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // 任意线程调用：从顶部窃取，失败（为空或竞争失败）时返回nullptr
+    T* steal()
+    {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+        {
+            return nullptr;
+        }
+
+        Array* a = array.load(std::memory_order_acquire);
+        T* item = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed))
+        {
+            return nullptr;
+        }
+        return item;
+    }
+
+    // 近似元素个数（并发下仅作参考）
+    size_t sizeApprox() const
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+private:
+    // 容量为2的幂的环形数组
+    struct Array
+    {
+        explicit Array(int64_t cap) : capacity(cap), mask(cap - 1), slots(new std::atomic<T*>[cap]) {}
+
+        // 槽位使用acquire/release（x86上无额外开销），使元素内容的可见性不只依赖栅栏
+        T* get(int64_t i) const { return slots[i & mask].load(std::memory_order_acquire); }
+        void put(int64_t i, T* item) { slots[i & mask].store(item, std::memory_order_release); }
+
+        const int64_t capacity;
+        const int64_t mask;
+        std::unique_ptr<std::atomic<T*>[]> slots;
+    };
+
+    // 容量翻倍并拷贝 [t, b) 区间的元素
+    Array* grow(Array* old, int64_t b, int64_t t)
+    {
+        arrays.emplace_back(new Array(old->capacity * 2));
+        Array* bigger = arrays.back().get();
+        for (int64_t i = t; i < b; ++i)
+        {
+            bigger->put(i, old->get(i));
+        }
+        array.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    std::atomic<Array*> array{nullptr};
+    std::vector<std::unique_ptr<Array>> arrays; // 当前及历史数组，仅所有者修改
+};
@@ -0,0 +1,139 @@
+#pragma once
+#include "core/Task.h"
+#include "http/HttpParser.h"
+#include "http/Request.h"
+#include "http/Response.h"
+#include "http/Router.h"
+#include <coroutine>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class UpstreamGroup;
+
+/**
+ * @brief 协程处理器向上游发出的请求的结果
+ */
+struct UpstreamResult
+{
+    int error = 0;   // 0表示响应完整；502为连接失败、响应不完整或超过maxBodySize，504为超时
+    int status = 0;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+
+    // 按名称（不区分大小写）取头部值，不存在时返回空视图
+    std::string_view header(std::string_view name) const
+    {
+        for (const auto& field : headers)
+        {
+            if (HttpHeaders::equalsIgnoreCase(field.first, name))
+            {
+                return field.second;
+            }
+        }
+        return std::string_view();
+    }
+};
+
+/**
+ * @brief 协程路由处理器（Task(AsyncContext&)）的请求上下文
+ *
+ * 处理器中可以co_await：
+ * - sleep(ms)：挂起指定的毫秒数，由连接所属事件循环的定时器恢复
+ * - write(data)：写出一段响应体（第一次调用时发出response()中的状态码和头部，以chunked分帧），
+ *   输出积压达到高水位时挂起，客户端消费后恢复
+ * - fetch(group, ...)：经所属Reactor的上游连接池发出请求，完整响应到达后恢复
+ * 协程只在连接所属的事件循环中恢复，恢复期间持有连接锁，等待I/O时不占用任何线程。
+ * 没有调用write的处理器结束后按response()一次性发送，与同步处理器相同。
+ * 请求头和请求体已拷贝出连接的输入缓冲区，在协程结束前一直有效。
+ * 挂起期间连接按写超时（writeTimeoutMs）计时，每次恢复后续期；
+ * 连接在挂起期间关闭时协程不再恢复，协程帧（连同其中的局部对象）被销毁
+ */
+class AsyncContext
+{
+public:
+    struct SleepAwaiter
+    {
+        AsyncContext& context;
+        int64_t delayMs;
+
+        bool await_ready() const noexcept { return delayMs <= 0; }
+        void await_suspend(std::coroutine_handle<> handle) { context.suspendSleep(delayMs, handle); }
+        void await_resume() const noexcept {}
+    };
+
+    struct WriteAwaiter
+    {
+        AsyncContext& context;
+        std::string_view data;
+
+        // 数据在此写出（或排入输出缓冲），只有积压达到高水位时才挂起
+        bool await_ready() { return !context.writeBody(data); }
+        void await_suspend(std::coroutine_handle<> handle) { context.suspendWrite(handle); }
+        void await_resume() const noexcept {}
+    };
+
+    struct FetchAwaiter
+    {
+        AsyncContext& context;
+        UpstreamGroup& group;
+        std::string request;     // 完整的请求报文
+        bool headRequest;
+        UpstreamResult result;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { context.suspendFetch(*this, handle); }
+        UpstreamResult await_resume() { return std::move(result); }
+    };
+
+    AsyncContext(const AsyncContext&) = delete;
+    AsyncContext& operator=(const AsyncContext&) = delete;
+    virtual ~AsyncContext() = default;
+
+    const Request& request() const { return req; }
+    Response& response() { return resp; }
+
+    SleepAwaiter sleep(int64_t delayMs) { return SleepAwaiter{*this, delayMs}; }
+
+    // data在co_await返回之前必须保持有效
+    WriteAwaiter write(std::string_view data) { return WriteAwaiter{*this, data}; }
+
+    /**
+     * @brief 向group中的一个上游发出请求
+     *
+     * Host取group的第一个上游地址，有消息体时生成Content-Length；幂等方法在复用的连接失效时重发
+     * @param headers 附加的完整头部行（含CRLF）
+     */
+    FetchAwaiter fetch(UpstreamGroup& group, std::string_view method, std::string_view target,
+                       std::string_view body = std::string_view(), std::string_view headers = std::string_view());
+
+protected:
+    // head为请求头的拷贝，source和sourceParams是解析base处同一份请求头的结果
+    AsyncContext(std::string head, const HttpParser& source, const RouteParams& sourceParams, const char* base,
+                 std::string body);
+
+    // 由服务器实现：安排在delayMs毫秒后恢复handle
+    virtual void suspendSleep(int64_t delayMs, std::coroutine_handle<> handle) = 0;
+
+    // 由服务器实现：写出消息体分片，需要等待积压回落（或连接已关闭）时返回true
+    virtual bool writeBody(std::string_view data) = 0;
+
+    // 由服务器实现：积压回落后恢复handle
+    virtual void suspendWrite(std::coroutine_handle<> handle) = 0;
+
+    // 由服务器实现：发出awaiter.request，结果写入awaiter.result后恢复handle
+    virtual void suspendFetch(FetchAwaiter& awaiter, std::coroutine_handle<> handle) = 0;
+
+private:
+    static HttpParser rebased(const HttpParser& source, const char* head);
+    static RouteParams rebased(const RouteParams& source, const char* from, const char* to);
+
+    std::string head;
+    HttpParser parser;
+    RouteParams params;
+    std::string body;
+    Request req;
+    Response resp;
+};
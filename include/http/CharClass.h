@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @brief HTTP字符集分类与向量化扫描
+ *
+ * 每个字符集同时保存256项查找表（标量路径）和16字节的nibble位图（SIMD路径）：
+ * 以低4位为下标用pshufb取出该行允许的高4位集合，再与高4位对应的比特相与，
+ * 一条指令即可判定16/32个字节是否都属于字符集。
+ * 启动时按CPU能力在AVX2、SSE4.2和标量实现之间选择。
+ */
+class CharClass
+{
+public:
+    // 字符集
+    enum Kind
+    {
+        TOKEN,        // RFC 9110 tchar：方法名、头部字段名
+        TARGET,       // 请求目标：可见ASCII字符（不含空格）
+        FIELD_VALUE,  // 头部字段值：HTAB、SP、可见ASCII和obs-text
+        KIND_COUNT
+    };
+
+    // 扫描实现
+    enum class Isa
+    {
+        SCALAR,
+        SSE42,
+        AVX2
+    };
+
+    // 返回[p, end)中第一个不属于kind字符集的字节位置，全部属于时返回end
+    static const char* skip(Kind kind, const char* p, const char* end);
+
+    // 单个字节是否属于字符集
+    static bool contains(Kind kind, unsigned char c);
+
+    // 当前CPU支持的最佳实现
+    static Isa bestIsa();
+
+    // 切换扫描实现（用于基准测试对比），不支持的实现会被降级
+    static void selectIsa(Isa isa);
+
+    // 当前使用的实现
+    static Isa currentIsa();
+
+    // 实现名称
+    static const char* isaName(Isa isa);
+};
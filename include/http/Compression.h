@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief 响应的内容编码
+ */
+enum class ContentEncoding : uint8_t
+{
+    IDENTITY,
+    GZIP,
+    BROTLI
+};
+
+/**
+ * @brief 按Content-Type前缀选择压缩级别
+ *
+ * 规则按顺序匹配（不区分大小写），第一条前缀匹配的规则生效；level为0表示不压缩
+ */
+struct CompressionRule
+{
+    std::string typePrefix;  // 如 "text/"、"application/json"
+    int level;               // gzip级别1~9，brotli以同一数值作为quality
+};
+
+/**
+ * @brief 响应压缩：Accept-Encoding协商、级别策略和gzip/brotli编码
+ *
+ * gzip基于zlib；brotli需要编译时定义VORTEX_WITH_BROTLI（make BROTLI=1），否则协商时不会选中
+ */
+class Compression
+{
+public:
+    static constexpr int ENCODINGS = 3;  // 编码种类数，可作为以ContentEncoding为下标的数组长度
+
+    // 是否编译了brotli支持
+    static bool brotliAvailable();
+
+    /**
+     * @brief 按Accept-Encoding选择编码
+     *
+     * 取客户端q值最高的可用编码，q值相同时优先brotli；q=0表示拒绝，"*"匹配未列出的编码。
+     * 没有可用编码时返回IDENTITY
+     * @param allowBrotli 是否可以选择brotli（未编译brotli时仍可发送磁盘上预压缩的.br文件）
+     */
+    static ContentEncoding negotiate(std::string_view acceptEncoding, bool allowBrotli = brotliAvailable());
+
+    // Content-Encoding头部的值（IDENTITY为空串）
+    static const char* token(ContentEncoding encoding);
+
+    // 磁盘上预压缩同名文件的后缀（IDENTITY为空串）
+    static const char* fileSuffix(ContentEncoding encoding);
+
+    // 编码的最高级别，用于只压缩一次的静态内容
+    static int maxLevel(ContentEncoding encoding);
+
+    // 按规则查找Content-Type的压缩级别，没有匹配的规则返回0
+    static int levelFor(const std::vector<CompressionRule>& rules, std::string_view contentType);
+
+    // 默认规则：文本、JSON、JavaScript、XML、SVG和WASM，已压缩的媒体类型不在其中
+    static std::vector<CompressionRule> defaultRules();
+
+    /**
+     * @brief 压缩数据
+     * @param level 超出编码支持范围时截断到最近的有效值
+     * @return 编码不可用或压缩失败时返回false
+     */
+    static bool compress(ContentEncoding encoding, int level, std::string_view input, std::string& output);
+};
@@ -0,0 +1,111 @@
+#pragma once
+#include "core/Arena.h"
+#include "core/Buffer.h"
+#include "core/TimerWheel.h"
+#include "http/Http2Session.h"
+#include "http/HttpParser.h"
+#include "http/ResponseCache.h"
+#include "http/Router.h"
+#include "http/StaticFileHandler.h"
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <functional>
+#include <memory>
+
+class EventLoop;
+
+/**
+ * @brief 待通过sendfile发送的文件区间
+ *
+ * startAt记录入队时输出缓冲的累计字节数，输出缓冲写到该位置后才开始发送文件，
+ * 从而保证文件内容与前后的响应头按入队顺序交错输出
+ */
+struct FileSegment
+{
+    std::shared_ptr<const CachedFile> file; // 文件（持有引用防止发送中被关闭）
+    off_t offset;                           // 下一个待发送字节的文件偏移
+    size_t remaining;                       // 剩余待发送字节数
+    uint64_t startAt;                       // 在输出流中的起始位置
+};
+
+/**
+ * @brief 客户端连接状态
+ *
+ * 以fd为键由所属Reactor持有，跨请求保存解析器和缓冲区，用于HTTP长连接。
+ * 单Reactor模式下fd以EPOLLONESHOT注册，处理完才重新激活，
+ * 工作线程处理期间还持有mutex，保证同一连接不会被并发处理。
+ */
+struct Connection
+{
+    Connection(int fd, EventLoop* loop) : fd(fd), loop(loop) {}
+
+    const int fd;              // 连接socket
+    EventLoop* const loop;     // 所属事件循环
+
+    std::mutex mutex;          // 串行化同一连接上的处理
+    HttpParser parser;         // 当前请求的解析器
+    int requestCount = 0;      // 已处理的请求数
+
+    Buffer inputBuffer;        // 已读入但尚未解析完的请求数据（可包含多个流水线请求）
+    size_t headerLength = 0;   // 当前请求头的字节数，请求处理完之前一直保留在输入缓冲开头
+    std::string body;          // 路由未注册流式处理器时缓存的请求体
+    const Route* route = nullptr; // 请求头完整时匹配到的路由，没有匹配时为空
+    RouteParams params;        // 路由参数，值引用输入缓冲区中的请求路径
+    const char* requestBase = nullptr; // 解析结果和路由参数当前引用的请求起始地址
+    Arena arena;               // 请求作用域的内存池（处理器的Response等），每个请求的响应写出后重置
+    Buffer outputBuffer;       // 内核暂未接收的待发送数据
+    std::vector<FileSegment> pendingFiles; // 排队中的文件区间（通常只有一两个，从头部移除，容量留给后续请求）
+    uint64_t bytesQueued = 0;  // 累计追加到输出缓冲的字节数
+    uint64_t bytesFlushed = 0; // 累计从输出缓冲写出的字节数
+    uint32_t events = 0;       // 当前在epoll中关注的事件
+    bool readPaused = false;   // 输出积压超过高水位时暂停读取
+    bool closeAfterWrite = false; // 待发送数据写完后关闭连接
+    bool responsePending = false; // 响应正在异步生成（线程池压缩或上游转发），完成前不处理后续请求
+    bool shedRequest = false;  // 过载：本次处理中请求头完整后直接回复503
+    bool requestDeferred = false; // 同一个缓存键正由其他请求生成：请求留在输入缓冲中，被唤醒后重新处理
+    bool cacheRetry = false;   // 被唤醒后重新处理的请求，不再等待
+    ResponseCache::EntryPtr cacheHandoff; // 唤醒时交来的条目（leader的响应不可缓存时为空）
+    std::function<void()> onWritable; // 异步响应或HTTP/2消息体因输出积压暂停时设置，积压回落后调用一次（持有mutex时访问）
+    std::function<void()> cancelSleep; // 协程处理器挂起在sleep时设置，关闭时取消其定时器（仅循环线程访问）
+    std::unique_ptr<Http2Session> http2; // 切换到HTTP/2后的协议状态，之后输入全部交给它；为空表示HTTP/1.x
+
+    // io_uring完成式路径（多Reactor + io_uring后端）的状态，仅循环线程访问
+    bool uring = false;        // 是否走完成式路径
+    uint64_t recvOp = 0;       // 进行中的multishot recv，0表示没有
+    bool sending = false;      // 是否有进行中的send或等待可写的sendfile
+    std::string sendBuffer;    // 进行中的send引用的数据，完成前保持不变
+    size_t sendOffset = 0;     // sendBuffer中已发送的字节数
+
+    // 输出缓冲或文件区间中是否还有待写出的内容
+    bool hasQueuedOutput() const
+    {
+        return outputBuffer.readableBytes() > 0 || !pendingFiles.empty();
+    }
+
+    // 是否还有未写出的数据或文件，包括进行中的send和尚未生成完的异步响应
+    bool hasPendingOutput() const
+    {
+        return hasQueuedOutput() || sending || responsePending;
+    }
+
+    // 尚未被内核接收的字节数（不含文件）
+    size_t pendingBytes() const
+    {
+        return outputBuffer.readableBytes() + (sendBuffer.size() - sendOffset);
+    }
+    std::atomic<bool> closed{false}; // 是否已发起关闭
+
+    // 超时：处理线程在每轮处理结束时更新截止时间，所属循环的定时器到期时检查
+    std::atomic<int64_t> deadline{0};    // 截止时间（单调时钟毫秒），0表示不限
+    std::atomic<int64_t> timerExpire{0}; // 定时器计划触发时间，0表示未调度
+    int64_t requestStartMs = 0;          // 当前未完成请求开始到达的时间，0表示没有
+    TimerId timer;                       // 超时定时器，仅循环线程访问
+
+    // 指标计时（单调时钟纳秒），由处理该连接的线程访问
+    int64_t acceptedNs = 0;    // 连接建立的时间
+    int64_t readyNs = 0;       // 本轮就绪事件返回的时间
+    int64_t parseNs = 0;       // 当前请求头已花费的解析时间
+    int64_t sendStartNs = 0;   // io_uring路径中当前send提交的时间
+};
@@ -0,0 +1,131 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief HPACK（RFC 7541）的公共部分：静态表、动态表和Huffman编码
+ */
+class Hpack
+{
+public:
+    static constexpr size_t STATIC_TABLE_SIZE = 61;
+    static constexpr size_t ENTRY_OVERHEAD = 32;   // 动态表中每个条目额外计入的字节数
+    static constexpr size_t DEFAULT_TABLE_SIZE = 4096;
+
+    // 静态表第index项（1起），越界时返回false
+    static bool staticEntry(size_t index, std::string_view& name, std::string_view& value);
+
+    // 在静态表中查找：完全匹配时返回下标并置exact，只有名称匹配时返回第一个同名项，都没有返回0
+    static size_t findStatic(std::string_view name, std::string_view value, bool& exact);
+
+    // Huffman解码，编码非法（含EOS、超过7位或不全为1的填充）时返回false
+    static bool huffmanDecode(std::string_view input, std::string& output);
+
+    // Huffman编码后的字节数
+    static size_t huffmanLength(std::string_view input);
+
+    // Huffman编码并追加到output
+    static void huffmanEncode(std::string_view input, std::string& output);
+};
+
+/**
+ * @brief 编解码双方各自维护的动态表
+ *
+ * 新条目插入表头（下标最小），大小超过上限时从表尾淘汰
+ */
+class HpackDynamicTable
+{
+public:
+    explicit HpackDynamicTable(size_t maxSize = Hpack::DEFAULT_TABLE_SIZE) : capacity(maxSize) {}
+
+    // 插入条目，单个条目超过上限时清空整个表（RFC 7541 4.4）
+    void insert(std::string_view name, std::string_view value);
+
+    // 调整上限并淘汰超出的条目
+    void resize(size_t maxSize);
+
+    // 第index项（0为最新），越界时返回nullptr
+    const std::pair<std::string, std::string>* at(size_t index) const
+    {
+        return index < entries.size() ? &entries[index] : nullptr;
+    }
+
+    size_t count() const { return entries.size(); }
+    size_t size() const { return used; }
+    size_t maxSize() const { return capacity; }
+
+private:
+    void evict();
+
+    std::deque<std::pair<std::string, std::string>> entries;
+    size_t used = 0;
+    size_t capacity;
+};
+
+/**
+ * @brief 请求头部块的解码器（每个HTTP/2连接一个）
+ */
+class HpackDecoder
+{
+public:
+    // 头部字段回调，name/value只在回调期间有效；返回false后不再回调，但仍解码完整个块以保持动态表同步
+    using FieldCallback = std::function<bool(std::string_view name, std::string_view value)>;
+
+    // maxTableSize为本端通告的SETTINGS_HEADER_TABLE_SIZE，对端的表大小更新不能超过它
+    explicit HpackDecoder(size_t maxTableSize = Hpack::DEFAULT_TABLE_SIZE)
+        : table(maxTableSize), limit(maxTableSize)
+    {
+    }
+
+    /**
+     * @brief 解码一个完整的头部块
+     *
+     * 无论流是否还需要，每个头部块都必须解码，以保持动态表与对端同步
+     * @return 编码错误（连接级COMPRESSION_ERROR）时返回false
+     */
+    bool decode(std::string_view block, const FieldCallback& onField);
+
+private:
+    // 解码字符串字面量到scratch，结果指向原始数据或scratch
+    bool readString(std::string_view& input, std::string& scratch, std::string_view& out);
+
+    HpackDynamicTable table;
+    size_t limit;
+    std::string nameScratch;
+    std::string valueScratch;
+};
+
+/**
+ * @brief 响应头部块的编码器（每个HTTP/2连接一个）
+ *
+ * 静态表或动态表中完全匹配的字段以下标编码，其余以字面量编码（Huffman更短时使用Huffman），
+ * 可索引的字段加入动态表，之后的响应中同样的字段（如server、content-type）只需一两个字节
+ */
+class HpackEncoder
+{
+public:
+    // 对端的SETTINGS_HEADER_TABLE_SIZE：动态表不超过它与本端上限中的较小者，在下一个头部块开头通知对端
+    void setPeerTableSize(size_t size);
+
+    // 开始一个头部块：输出挂起的动态表大小更新
+    void begin(std::string& out);
+
+    // 编码一个字段，名称须为小写；indexable为false的字段（如content-length）不加入动态表
+    void encode(std::string_view name, std::string_view value, bool indexable, std::string& out);
+
+private:
+    // 以prefixBits位前缀编码整数，first为首字节的高位标志
+    static void writeInteger(uint64_t value, int prefixBits, uint8_t first, std::string& out);
+
+    static void writeString(std::string_view text, std::string& out);
+
+    HpackDynamicTable table;
+    size_t pendingMin = SIZE_MAX;      // 两个头部块之间出现过的最小表大小，SIZE_MAX表示没有待通知的更新
+    size_t pendingFinal = 0;           // 待通知的最终表大小
+};
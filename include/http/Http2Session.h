@@ -0,0 +1,259 @@
+#pragma once
+#include "http/Hpack.h"
+#include "http/HttpParser.h"
+#include "http/Router.h"
+#include "http/StaticFileHandler.h"
+#include <sys/types.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief HTTP/2连接上的一个请求流
+ *
+ * 请求的伪头部和头部字段被合成为一段HTTP/1.1风格的请求头（"GET /path HTTP/2.0\r\nhost: ..."），
+ * 由流自己的HttpParser解析，因此路由处理器看到的Request与HTTP/1.1请求完全相同
+ */
+struct Http2Stream
+{
+    explicit Http2Stream(uint32_t id) : id(id) {}
+
+    const uint32_t id;
+    std::string head;          // 合成的请求头，parser引用它
+    HttpParser parser;         // 请求头的解析结果
+    const Route* route = nullptr; // 匹配到的路由，没有匹配时为空
+    RouteParams params;        // 路由参数，值引用head
+    std::string body;          // 路由未注册流式处理器时缓存的请求体
+    uint64_t bodyBytes = 0;    // 已收到的请求体字节数
+    bool remoteClosed = false; // 已收到END_STREAM（请求完整）
+    bool responded = false;    // 已开始响应（HEADERS已编码）
+
+    // 接收方向的流量控制窗口（本端通告给对端的剩余额度）
+    int64_t recvWindow = 0;
+    // 发送方向的流量控制窗口（对端允许本端发送的剩余额度）
+    int64_t sendWindow = 0;
+
+    // 待发送的消息体：内存中的字符串，或文件区间（由pump以pread读出）
+    std::string data;
+    size_t dataOffset = 0;
+    std::shared_ptr<const CachedFile> file;
+    off_t fileOffset = 0;
+    size_t remaining = 0;      // 尚未生成DATA帧的消息体字节数
+    bool queued = false;       // 是否在发送轮转队列中
+};
+
+/**
+ * @brief 一个明文HTTP/2（h2c）连接的协议状态机
+ *
+ * 不做socket I/O：服务器把读到的字节交给receive，把output()中生成的帧写出。
+ * - 帧解析：DATA、HEADERS（含CONTINUATION、PADDED、PRIORITY标志）、PRIORITY（忽略）、RST_STREAM、
+ *   SETTINGS、PING、GOAWAY、WINDOW_UPDATE；服务端不接收PUSH_PROMISE，未知类型的帧被忽略
+ * - 头部块以HPACK解码，被拒绝或已关闭的流上的头部块同样解码，保持动态表与对端同步
+ * - 流量控制：接收方向消费过半即以WINDOW_UPDATE补足；发送方向按连接和流两级窗口以及对端的
+ *   最大帧大小切分DATA帧，多个流的消息体轮转交错，一个大响应不会阻塞其他流
+ * - 并发流数超过通告的上限时以REFUSED_STREAM拒绝新流；请求格式错误时以PROTOCOL_ERROR重置该流
+ * 请求头完整、请求体分片到达和请求完整时依次调用回调，回调中可直接调用respond；
+ * 响应先于请求体结束时，发完响应后以RST_STREAM(NO_ERROR)结束该流。
+ * 所有方法由持有连接锁的线程调用，不加锁
+ */
+class Http2Session
+{
+public:
+    // 客户端连接前言
+    static constexpr std::string_view PREFACE = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+
+    // 错误码（RFC 9113 7）
+    enum ErrorCode : uint32_t
+    {
+        NO_ERROR = 0x0,
+        PROTOCOL_ERROR = 0x1,
+        INTERNAL_ERROR = 0x2,
+        FLOW_CONTROL_ERROR = 0x3,
+        STREAM_CLOSED = 0x5,
+        FRAME_SIZE_ERROR = 0x6,
+        REFUSED_STREAM = 0x7,
+        CANCEL = 0x8,
+        COMPRESSION_ERROR = 0x9,
+        ENHANCE_YOUR_CALM = 0xb
+    };
+
+    // 本端的参数
+    struct Options
+    {
+        uint32_t maxConcurrentStreams = 100;  // 通告的最大并发流数
+        uint32_t streamWindow = 1 << 20;      // 每个流的接收窗口
+        uint32_t connectionWindow = 16 << 20; // 连接的接收窗口
+        size_t maxHeaderSize = 64 * 1024;     // 合成的请求头和单个头部块的上限
+    };
+
+    // 请求流的回调，全部在receive（或upgrade）期间调用；stream在回调期间有效
+    struct Handler
+    {
+        // 请求头完整（流已通过校验）
+        std::function<void(Http2Stream& stream)> onHeaders;
+
+        // 请求体分片，data只在回调期间有效
+        std::function<void(Http2Stream& stream, std::string_view data)> onData;
+
+        // 请求完整（收到END_STREAM）
+        std::function<void(Http2Stream& stream)> onRequest;
+    };
+
+    // 响应头部字段，名称大小写不限（编码时转为小写）
+    struct Field
+    {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    Http2Session(const Options& options, Handler handler);
+
+    Http2Session(const Http2Session&) = delete;
+    Http2Session& operator=(const Http2Session&) = delete;
+
+    /**
+     * @brief 以h2c升级开始：应用HTTP2-Settings头部（base64url编码的SETTINGS载荷）
+     *
+     * 101响应即为对这些设置的确认，不再发送SETTINGS ACK
+     * @return 头部的值不是合法的SETTINGS载荷时返回false，此时不应升级
+     */
+    bool applyUpgradeSettings(std::string_view http2Settings);
+
+    // 发送本端的SETTINGS和连接窗口的WINDOW_UPDATE（服务器连接前言），收到客户端前言之前调用一次
+    void start();
+
+    /**
+     * @brief h2c升级：原HTTP/1.1请求成为流1（已处于半关闭状态），调用方填写请求头和请求体后自行分发
+     */
+    Http2Stream& upgradeStream();
+
+    /**
+     * @brief 处理收到的数据，只消费完整的帧（以及连接前言）
+     * @return 消费的字节数，剩余的不完整帧留给下一次调用
+     */
+    size_t receive(const char* data, size_t length);
+
+    // 响应：HEADERS立即编码进输出，消息体（可为空）由pump按流量控制窗口分帧发送
+    void respond(Http2Stream& stream, int status, const std::vector<Field>& fields, std::string body);
+
+    // 以文件区间作为消息体的响应
+    void respondFile(Http2Stream& stream, int status, const std::vector<Field>& fields,
+                     std::shared_ptr<const CachedFile> file, off_t offset, size_t length);
+
+    // 以错误码重置流
+    void resetStream(Http2Stream& stream, ErrorCode code);
+
+    /**
+     * @brief 按轮转顺序为待发送消息体的流生成DATA帧
+     *
+     * 输出超过budget字节、连接窗口耗尽或所有流都在等待窗口时停止
+     */
+    void pump(size_t budget);
+
+    // 是否有在当前窗口内就能发送的消息体（输出积压回落后应继续pump）
+    bool hasReadyData() const { return !sendQueue.empty() && connectionSendWindow > 0; }
+
+    // 待写出的帧，调用方写出后清空
+    std::string& output() { return out; }
+
+    // 连接已结束：发送过GOAWAY（连接错误），或对端发送了GOAWAY且没有进行中的流
+    bool finished() const { return failed || (goawayReceived && streams.empty()); }
+
+    // 进行中的流数
+    size_t streamCount() const { return streams.size(); }
+
+private:
+    // 帧类型
+    enum FrameType : uint8_t
+    {
+        DATA = 0x0,
+        HEADERS = 0x1,
+        PRIORITY = 0x2,
+        RST_STREAM = 0x3,
+        SETTINGS = 0x4,
+        PUSH_PROMISE = 0x5,
+        PING = 0x6,
+        GOAWAY = 0x7,
+        WINDOW_UPDATE = 0x8,
+        CONTINUATION = 0x9
+    };
+
+    // 处理一个完整的帧，连接错误时返回false（GOAWAY已写入输出）
+    bool handleFrame(uint8_t type, uint8_t flags, uint32_t streamId, std::string_view payload);
+    bool handleData(uint8_t flags, uint32_t streamId, std::string_view payload);
+    bool handleHeaders(uint8_t flags, uint32_t streamId, std::string_view payload);
+    bool handleContinuation(uint8_t flags, uint32_t streamId, std::string_view payload);
+    bool handleSettings(uint8_t flags, uint32_t streamId, std::string_view payload);
+    bool handleWindowUpdate(uint32_t streamId, std::string_view payload);
+
+    // 应用对端的SETTINGS载荷，非法时以对应错误码返回false
+    bool applySettings(std::string_view payload, ErrorCode& error);
+
+    // 头部块接收完整：解码并创建流或处理尾部字段
+    bool finishHeaderBlock();
+
+    // 由解码出的字段合成请求头并校验，请求格式错误时返回false
+    bool buildRequest(Http2Stream& stream, const std::vector<std::pair<std::string, std::string>>& fields);
+
+    // 请求完整：校验Content-Length并调用onRequest
+    void finishRequest(uint32_t streamId);
+
+    // 接收窗口消费过半时以WINDOW_UPDATE补足（stream为空表示只补连接窗口）
+    void replenishWindows(Http2Stream* stream);
+
+    // 发送HEADERS（必要时拆分出CONTINUATION）
+    void writeHeaders(Http2Stream& stream, int status, const std::vector<Field>& fields, bool endStream);
+
+    // 消息体发送完毕：对端也已结束时移除流，否则以RST_STREAM(NO_ERROR)提前结束
+    void finishResponse(Http2Stream& stream);
+
+    // 把流加入发送轮转队列
+    void schedule(Http2Stream& stream);
+
+    // 连接错误：写出GOAWAY，之后不再处理任何帧
+    bool connectionError(ErrorCode code);
+
+    void writeFrameHeader(size_t length, uint8_t type, uint8_t flags, uint32_t streamId);
+    void writeRstStream(uint32_t streamId, ErrorCode code);
+    void writeWindowUpdate(uint32_t streamId, uint32_t increment);
+
+    Http2Stream* findStream(uint32_t streamId);
+
+    // 流是否在本端最近发送过RST_STREAM的流之中
+    bool wasReset(uint32_t streamId) const;
+    void removeStream(uint32_t streamId);
+
+    Options options;
+    Handler handler;
+    HpackDecoder decoder;
+    HpackEncoder encoder;
+    std::unordered_map<uint32_t, std::unique_ptr<Http2Stream>> streams;
+    std::deque<uint32_t> sendQueue;   // 待发送消息体且流窗口有余量的流，轮转生成DATA帧
+    std::deque<uint32_t> resetIds;    // 本端最近重置的流ID（按发送顺序，最多保留固定数量）
+    std::string out;
+
+    bool prefaceReceived = false;
+    bool settingsReceived = false;    // 前言之后的第一个帧必须是SETTINGS
+    bool goawayReceived = false;
+    bool failed = false;              // 已因连接错误发送GOAWAY
+    uint32_t lastStreamId = 0;        // 对端创建过的最大流ID
+
+    // 正在接收的头部块（HEADERS之后跟CONTINUATION）
+    uint32_t headerStreamId = 0;      // 非0表示头部块未结束
+    bool headerEndStream = false;
+    std::string headerBlock;
+
+    // 对端的设置
+    uint32_t peerInitialWindow = 65535;
+    uint32_t peerMaxFrameSize = 16384;
+
+    // 连接级的流量控制窗口
+    int64_t connectionRecvWindow = 65535;
+    int64_t connectionSendWindow = 65535;
+};
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <ctime>
+#include <string_view>
+
+/**
+ * @brief 缓存的Date响应头
+ *
+ * Date的精度只到秒，每个响应都调用gmtime+strftime没有必要。事件循环每秒调用一次refresh，
+ * 格式化结果写入两个槽位中空闲的一个后原子切换，响应路径只读取当前槽位，不加锁也不格式化。
+ */
+class HttpDate
+{
+public:
+    // 按当前时间重新生成Date头部行（由事件循环每秒调用，单线程调用）
+    static void refresh();
+
+    // 完整的Date头部行（含CRLF），返回的视图在下一次刷新之后仍至少有效一秒
+    static std::string_view header();
+
+    // 把时间格式化为IMF-fixdate（如 Sun, 06 Nov 1994 08:49:37 GMT），返回写入的长度
+    static size_t format(time_t t, char* out, size_t size);
+};
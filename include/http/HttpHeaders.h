@@ -0,0 +1,130 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief 常用头部字段的编号
+ *
+ * 解析时识别一次，之后按编号O(1)访问，无需再做字符串比较
+ */
+enum class HeaderId : uint8_t
+{
+    HOST,
+    CONNECTION,
+    CONTENT_LENGTH,
+    CONTENT_TYPE,
+    TRANSFER_ENCODING,
+    ACCEPT,
+    ACCEPT_ENCODING,
+    ACCEPT_LANGUAGE,
+    USER_AGENT,
+    COOKIE,
+    AUTHORIZATION,
+    CACHE_CONTROL,
+    EXPECT,
+    RANGE,
+    IF_RANGE,
+    IF_NONE_MATCH,
+    IF_MODIFIED_SINCE,
+    UPGRADE,
+    HTTP2_SETTINGS,
+    TE,
+    REFERER,
+    ORIGIN,
+    X_FORWARDED_FOR,
+    KNOWN_COUNT,        // 常用字段数量
+    OTHER = KNOWN_COUNT // 其他字段
+};
+
+/**
+ * @brief 请求头部表
+ *
+ * 字段以相对请求起始位置的偏移保存，通过setBase指定的地址转换为string_view，
+ * 输入缓冲区搬移后只需更新基址。前INLINE_CAPACITY个字段存放在对象内的定长数组中，
+ * 普通请求的头部不会产生任何堆分配；常用字段额外记录下标，按编号查找为O(1)，
+ * 其余字段按名称不区分大小写线性查找。
+ */
+class HttpHeaders
+{
+public:
+    static constexpr size_t INLINE_CAPACITY = 32;
+
+    // 头部字段视图
+    struct Field
+    {
+        std::string_view name;
+        std::string_view value;
+        HeaderId id;
+    };
+
+    HttpHeaders() { clear(); }
+
+    // 设置偏移的基址（请求的第一个字节）
+    void setBase(const char* data) { base = data; }
+
+    // 追加字段，偏移均相对基址
+    void add(uint32_t nameOffset, uint32_t nameLength, uint32_t valueOffset, uint32_t valueLength);
+
+    // 清空全部字段（溢出部分保留容量）
+    void clear();
+
+    // 字段数量
+    size_t size() const { return count; }
+
+    // 按添加顺序访问第i个字段
+    Field operator[](size_t i) const;
+
+    // 按编号取第一个同名字段的值，不存在时返回空视图
+    std::string_view get(HeaderId id) const;
+
+    // 按名称取第一个同名字段的值（不区分大小写），不存在时返回空视图
+    std::string_view get(std::string_view name) const;
+
+    // 是否存在指定字段
+    bool has(HeaderId id) const { return first[static_cast<size_t>(id)] >= 0; }
+
+    // 同名字段出现的次数（用于检测重复的Content-Length等）
+    size_t countOf(HeaderId id) const;
+
+    // 把字段名识别为编号，不是常用字段时返回OTHER
+    static HeaderId identify(std::string_view name);
+
+    // 常用字段的规范名称
+    static std::string_view nameOf(HeaderId id);
+
+    // 不区分大小写比较ASCII字符串
+    static bool equalsIgnoreCase(std::string_view a, std::string_view b);
+
+    // 逗号分隔的列表（如Connection、Upgrade）中是否有token（不区分大小写，忽略两侧空白）
+    static bool hasToken(std::string_view list, std::string_view token);
+
+    // If-None-Match的值是否为"*"或列出了etag（弱比较，忽略W/前缀）
+    static bool matchesETag(std::string_view ifNoneMatch, std::string_view etag);
+
+private:
+    struct Entry
+    {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t valueOffset;
+        uint32_t valueLength;
+        HeaderId id;
+    };
+
+    const Entry& entry(size_t i) const
+    {
+        return i < INLINE_CAPACITY ? inlineEntries[i] : overflow[i - INLINE_CAPACITY];
+    }
+
+    std::string_view view(uint32_t offset, uint32_t length) const
+    {
+        return std::string_view(base + offset, length);
+    }
+
+    const char* base = nullptr;
+    uint32_t count = 0;
+    int32_t first[static_cast<size_t>(HeaderId::KNOWN_COUNT)]; // 常用字段首次出现的下标，-1表示没有
+    Entry inlineEntries[INLINE_CAPACITY];
+    std::vector<Entry> overflow;   // 超出内联容量的字段
+};
@@ -1,51 +1,194 @@
 #pragma once
-#include <string>
-#include <unordered_map>
+#include "http/HttpHeaders.h"
+#include <cstdint>
+#include <functional>
+#include <string_view>
 
 /**
  * @brief HTTP请求解析器
- * 
- * 实现HTTP/1.1协议的请求行和头部解析
- * 支持状态机模式解析不完整请求
+ *
+ * 实现HTTP/1.1协议的请求行和头部解析；RESPONSE模式下解析状态行，用于读取上游服务器的响应。
+ * 解析结果不拷贝，只记录相对请求起始位置的偏移，通过string_view直接引用连接的输入缓冲区；
+ * 分隔符查找和字符合法性校验由CharClass以16/32字节为单位向量化完成。
+ * 消息体（Content-Length或chunked）由parseBody以可恢复的状态机解码，分片交给回调，
+ * 不在解析器内缓存。
  */
-class HttpParser 
+class HttpParser
 {
 public:
     // 解析状态枚举
-    enum class State 
+    enum class State
     {
-        METHOD,     // 解析请求方法
-        PATH,       // 解析请求路径
-        VERSION,    // 解析协议版本
-        HEADER_KEY, // 解析头部字段名
-        HEADER_VAL, // 解析头部字段值
-        BODY        // 解析消息体（暂未实现）
+        REQUEST_LINE,   // 解析请求行
+        HEADERS,        // 解析头部字段
+        BODY,           // 按Content-Length读取消息体
+        CHUNK_SIZE,     // chunked：读取块大小行
+        CHUNK_DATA,     // chunked：读取块数据
+        CHUNK_DATA_END, // chunked：块数据后的CRLF
+        CHUNK_TRAILER,  // chunked：尾部字段，直到空行
+        COMPLETE        // 请求完整
     };
 
+    // 消息体的长度确定方式
+    enum class BodyType
+    {
+        NONE,           // 没有消息体
+        CONTENT_LENGTH, // 由Content-Length给出
+        CHUNKED,        // Transfer-Encoding: chunked
+        UNTIL_CLOSE     // 响应没有长度信息，消息体持续到连接关闭
+    };
+
+    // 解析的消息类型
+    enum class Mode
+    {
+        REQUEST,        // 请求行 + 头部
+        RESPONSE        // 状态行 + 头部
+    };
+
+    explicit HttpParser(Mode mode = Mode::REQUEST) : mode(mode) {}
+
+    // 消息体分片回调，data只在回调期间有效
+    using BodyCallback = std::function<void(std::string_view data)>;
+
+    /**
+     * @brief 增量解析HTTP请求数据
+     *
+     * data必须从当前请求的第一个字节开始，每次传入目前已到达的全部数据。
+     * 已解析的完整行会被记住，再次调用时只处理新到达的行，不会重复扫描；
+     * 请求头完整前返回0，完整后返回请求头的字节数，之后的数据属于下一个流水线请求。
+     * 解析结果引用data指向的内存，调用方在处理完请求后才能移除或改动这部分数据。
+     * @param data 当前请求起始地址（缓冲区可能已搬移，每次以最新地址传入）
+     * @param length 可用数据长度
+     * @return 请求头完整时返回其字节数，否则返回0
+     */
+    size_t parse(const char* data, size_t length);
+
     /**
-     * @brief 解析HTTP请求数据
-     * @param data 输入数据指针
-     * @param length 数据长度
+     * @brief 增量解码消息体
+     *
+     * 请求头完整后调用，data为请求头之后尚未解码的数据。解码出的消息体分片依次交给onData，
+     * 不完整的块大小行或块尾CRLF不消费，留待更多数据到达后重新传入。
+     * 消息体总量将超过maxBody时停止解码，超出部分不交给onData，之后exceedsBodyLimit()为true。
+     * @return 本次消费的字节数
      */
-    void parse(const char* data, size_t length);
-    
-    // 状态检查方法
-    bool isComplete() const { return parseComplete; }
-    
-    // 获取解析结果
-    const std::string& getMethod() const { return method; }
-    const std::string& getPath() const { return path; }
-    const std::string& getVersion() const { return version; }
-    std::string getHeader(const std::string& key) const;
+    size_t parseBody(const char* data, size_t length, const BodyCallback& onData,
+                     uint64_t maxBody = UINT64_MAX);
+
+    // 输入缓冲区搬移后，把解析结果指向请求起始的新地址
+    void rebase(const char* data)
+    {
+        base = data;
+        headers.setBase(data);
+    }
+
+    // 重置解析器以复用于同一连接上的下一个请求
+    void reset();
+
+    /**
+     * @brief RESPONSE模式：声明下一个响应没有消息体（对应HEAD请求），在parse之前调用，reset后失效
+     *
+     * 1xx、204、304响应总是没有消息体，不需要声明
+     */
+    void expectNoBody() { noBody = true; }
+
+    /**
+     * @brief RESPONSE模式：连接已关闭，结束持续到关闭的消息体
+     * @return 消息体按声明的长度完整时返回true，被截断时返回false
+     */
+    bool finishAtClose();
+
+    // 状态检查方法：请求头是否完整、整个请求（含消息体）是否完整、格式是否错误
+    bool isHeaderComplete() const { return parseComplete; }
+    bool isComplete() const { return state == State::COMPLETE; }
+    bool hasError() const { return parseError; }
+
+    // 消息体超过parseBody传入的上限
+    bool exceedsBodyLimit() const { return bodyTooLarge; }
+
+    // 消息体信息（请求头完整后有效）
+    BodyType bodyType() const { return body; }
+    uint64_t contentLength() const { return declaredLength; }
+    uint64_t bodyBytes() const { return bodyReceived; }
+
+    // 是否带有Expect: 100-continue
+    bool expectsContinue() const;
+
+    // 已解析的完整行的字节数
+    size_t consumedBytes() const { return scanned; }
+
+    // 按HTTP/1.0与HTTP/1.1语义判断是否保持连接
+    bool shouldKeepAlive() const;
+
+    // 获取解析结果（仅在请求完整后、缓冲区被改动前有效）
+    std::string_view getMethod() const { return view(method); }
+    std::string_view getPath() const { return view(path); }
+    std::string_view getVersion() const { return view(version); }
+
+    // 版本是否为HTTP/1.0或HTTP/1.1；其他语法合法的版本（如HTTP/9.9）由HTTP/1.x连接以505拒绝，
+    // HTTP/2合成的请求头使用HTTP/2.0，不经过该检查
+    bool isKnownVersion() const
+    {
+        std::string_view v = getVersion();
+        return v == "HTTP/1.1" || v == "HTTP/1.0";
+    }
+
+    // RESPONSE模式下的状态码和原因短语
+    int getStatus() const { return status; }
+    std::string_view getReason() const { return view(path); }
+
+    // 按编号或名称（不区分大小写）查找头部，不存在时返回空视图
+    std::string_view getHeader(HeaderId id) const { return headers.get(id); }
+    std::string_view getHeader(std::string_view key) const { return headers.get(key); }
+
+    // 全部头部字段
+    const HttpHeaders& getHeaders() const { return headers; }
 
 private:
-    State state = State::METHOD;  // 当前解析状态
+    // 相对请求起始位置的区间
+    struct Span
+    {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    // 解析一行（不含末尾的\n），出错时设置parseError
+    void parseRequestLine(const char* line, const char* lineEnd);
+    void parseStatusLine(const char* line, const char* lineEnd);
+    void parseHeaderLine(const char* line, const char* lineEnd);
+
+    // 请求头完整后根据Content-Length/Transfer-Encoding确定消息体长度，非法组合视为格式错误
+    void prepareBody();
+
+    // 解析块大小行（不含CRLF），返回false表示格式错误
+    bool parseChunkSize(const char* line, const char* lineEnd);
+
+    Span spanOf(const char* from, const char* to) const
+    {
+        return Span{static_cast<uint32_t>(from - base), static_cast<uint32_t>(to - from)};
+    }
+    std::string_view view(Span span) const { return std::string_view(base + span.offset, span.length); }
+
+    Mode mode;                    // 解析请求还是响应
+    State state = State::REQUEST_LINE; // 当前解析状态（响应的状态行同样处于REQUEST_LINE）
     bool parseComplete = false;   // 解析完成标志
-    
-    // 解析结果存储
-    std::string method;
-    std::string path;
-    std::string version;
-    std::unordered_map<std::string, std::string> headers;
-    std::string currentHeaderKey; // 临时存储当前处理的header key
-};
\ No newline at end of file
+    bool parseError = false;      // 请求格式错误标志
+    size_t scanned = 0;           // 已解析的完整行的字节数
+    size_t searched = 0;          // 已查找过行结束符的位置，避免对不完整的行重复查找
+    const char* base = nullptr;   // 最近一次传入的请求起始地址
+
+    // 解析结果（偏移），响应的原因短语保存在path中
+    Span method;
+    Span path;
+    Span version;
+    int status = 0;               // 响应状态码
+    bool noBody = false;          // 响应没有消息体（对应HEAD请求）
+    HttpHeaders headers;          // 头部字段（偏移相对同一基址）
+
+    // 消息体解码状态
+    BodyType body = BodyType::NONE;
+    uint64_t declaredLength = 0;  // Content-Length
+    uint64_t bodyReceived = 0;    // 已解码的消息体字节数
+    bool bodyTooLarge = false;    // 消息体超过上限
+    uint64_t chunkRemaining = 0;  // 当前块（或Content-Length消息体）剩余字节数
+    size_t trailerBytes = 0;      // 已读取的尾部字段字节数
+};
@@ -1,46 +1,332 @@
 #pragma once
-#include "core/Epoll.h"
+#include "core/AdmissionController.h"
+#include "core/EventLoop.h"
 #include "core/ThreadPool.h"
+#include "http/AsyncContext.h"
+#include "http/HttpDate.h"
 #include "http/HttpParser.h"
+#include "http/Request.h"
+#include "http/Response.h"
+#include "http/ResponseCache.h"
+#include "http/ResponseWriter.h"
+#include "http/Router.h"
+#include "http/Connection.h"
+#include "http/ServerConfig.h"
+#include "http/ServerMetrics.h"
+#include "http/StaticFileHandler.h"
+#include "http/UpstreamPool.h"
 #include "utils/Logger.h"
 #include <netinet/in.h>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <unordered_map>
 
 /**
  * @brief HTTP服务器主类
  * 
- * 整合Epoll事件循环和线程池，实现高并发服务
+ * 整合事件循环（epoll或io_uring）和线程池，实现高并发服务。支持两种架构：
+ * - 单Reactor（reactorNum == 0）：主线程事件循环，读事件交给线程池处理
+ * - 多Reactor（reactorNum > 0）：每个线程独占EventLoop和SO_REUSEPORT监听socket，
+ *   连接在所属线程内处理完毕，线程池只留给阻塞型任务
  */
 class HttpServer 
 {
 public:
-    // 构造函数指定端口和线程数量
-    HttpServer(int port, int threadNum);
+    // 构造函数指定端口、线程池线程数量和Reactor线程数量
+    HttpServer(int port, int threadNum, int reactorNum = 0);
+
+    // 使用完整配置构造
+    explicit HttpServer(const ServerConfig& config);
+    ~HttpServer();
     
-    // 启动服务器主循环
+    // 启动服务器主循环（阻塞当前线程）
     void start();
 
+    // 把阻塞型任务交给线程池执行，线程池队列已满被拒绝时返回false
+    bool runBlocking(std::function<void()> task) { return pool.enqueue(std::move(task)); }
+
+    /**
+     * @brief 注册路由（需在start之前调用）
+     *
+     * 模式支持 :name（匹配一个路径段）和末尾的 *name（匹配剩余路径），
+     * 处理器在连接所在线程调用；给出onBody时请求体按分片流式交给它，不再缓存在内存中。
+     * 模式非法或与已有路由冲突时抛出std::runtime_error
+     */
+    void route(std::string_view method, std::string_view pattern,
+               Route::Handler handler, Route::BodyHandler onBody = nullptr)
+    {
+        router.add(method, pattern, std::move(handler), std::move(onBody));
+    }
+    void get(std::string_view pattern, Route::Handler handler) { route("GET", pattern, std::move(handler)); }
+    void post(std::string_view pattern, Route::Handler handler, Route::BodyHandler onBody = nullptr)
+    {
+        route("POST", pattern, std::move(handler), std::move(onBody));
+    }
+
+    /**
+     * @brief 注册协程处理的路由（需在start之前调用）
+     *
+     * 处理器返回Task，可以在其中co_await定时器、流式写出和上游请求（见AsyncContext），
+     * 等待期间不占用线程；协程由连接所属的事件循环恢复
+     */
+    void routeAsync(std::string_view method, std::string_view pattern, Route::AsyncHandler handler)
+    {
+        router.add(method, pattern, std::move(handler));
+    }
+    void getAsync(std::string_view pattern, Route::AsyncHandler handler)
+    {
+        routeAsync("GET", pattern, std::move(handler));
+    }
+
+    // 注册返回固定内容的路由（如健康检查），响应在注册时即序列化好，请求时不调用任何处理器
+    void fixedRoute(std::string_view method, std::string_view pattern, int code,
+                    std::string_view contentType, std::string_view body);
+
+    /**
+     * @brief 注册反向代理路由（需在start之前调用）
+     *
+     * 匹配pattern的请求（methods中的方法）转发到config中的上游，响应流式写回客户端。
+     * 每个Reactor维护自己到各上游的长连接池，上游地址非法或无法解析时抛出std::runtime_error
+     */
+    void proxy(std::string_view pattern, ProxyConfig config,
+               const std::vector<std::string>& methods = {"GET", "HEAD", "POST", "PUT", "DELETE", "PATCH",
+                                                          "OPTIONS"});
+
+    // 指标注册表，应用可在start之前注册自己的指标，与内置指标一起输出
+    MetricsRegistry& metrics() { return metricsRegistry; }
+
 private:
-    // 处理Epoll事件
-    void handleEvent(int fd, uint32_t events);
+    using ConnectionPtr = std::shared_ptr<Connection>;
+
+    // 每个事件循环及其监听socket和连接
+    struct Reactor
+    {
+        explicit Reactor(Poller::Backend backend) : loop(backend), upstreams(loop) {}
+
+        EventLoop loop;      // 本线程的事件循环
+        IoUringPoller* uring = nullptr; // 非空时连接走io_uring完成式路径
+        int listenFd = -1;   // 本Reactor的监听socket（共享监听时各Reactor相同）
+        int idleFd = -1;     // 预留的fd，fd耗尽时腾出来接受并关闭新连接
+        std::thread thread;  // 运行loop的线程（单Reactor模式下为空）
+        std::unordered_map<int, ConnectionPtr> connections; // fd -> 连接状态，仅循环线程访问
+        UpstreamPool upstreams; // 反向代理的上游连接，仅循环线程访问（先于loop析构）
+    };
+
+    // 按配置的地址和TCP选项创建并监听socket，reusePort为true时开启SO_REUSEPORT
+    int createListenSocket(bool reusePort);
+
+    // 处理连接上的就绪事件
+    void handleEvent(Reactor* reactor, const ConnectionPtr& conn, uint32_t events);
     
-    // 接受新的客户端连接
-    void acceptConnection();
+    // 接受新的客户端连接，一次最多acceptBatch个
+    void acceptConnection(Reactor* reactor);
     
-    // 关闭指定连接
-    void closeConnection(int fd);
+    // 关闭指定连接（可在任意线程调用，实际关闭在所属循环线程完成）
+    void closeConnection(Reactor* reactor, const ConnectionPtr& conn);
     
-    // 处理HTTP请求
-    void handleRequest(int fd);
+    // 在持有连接锁的情况下处理读写事件，readyNs为事件源返回该事件的时间；
+    // shed为true（线程池拒绝或丢弃了该任务）时本次读到的请求直接回复503
+    void handleConnection(Reactor* reactor, const ConnectionPtr& conn, uint32_t events, int64_t readyNs,
+                          bool shed = false);
+
+    // 读空socket并处理缓冲区中所有完整的（流水线）请求
+    void handleRequest(Reactor* reactor, const ConnectionPtr& conn);
+
+    // 依次解析并响应输入缓冲区中的完整请求，连接被关闭时返回false
+    bool processRequests(Reactor* reactor, const ConnectionPtr& conn);
+
+    // 请求头完整后检查请求体长度并按需回复100 Continue，连接被关闭时返回false
+    bool startRequestBody(Reactor* reactor, const ConnectionPtr& conn);
+
+    // 发送错误响应并在写完后关闭连接，总是返回false
+    bool finishErrorResponse(Reactor* reactor, const ConnectionPtr& conn, int code);
+
+    // 为连接创建HTTP/2会话，请求流的回调分发到路由
+    void startHttp2(const ConnectionPtr& conn);
+
+    // 请求完整且带Upgrade: h2c时升级：回复101，该请求作为流1在HTTP/2上响应；不升级时返回false
+    bool upgradeHttp2(const ConnectionPtr& conn);
+
+    // 把输入缓冲交给HTTP/2会话并写出生成的帧，连接被关闭时返回false
+    bool processHttp2(Reactor* reactor, const ConnectionPtr& conn);
+
+    // 写出HTTP/2会话生成的帧；消息体按输出积压分批生成，积压过高时等可写后继续，连接出错时返回false
+    bool flushHttp2(Reactor* reactor, const ConnectionPtr& conn);
+
+    // 完整的HTTP/2请求：由路由处理器、静态文件或404/405响应
+    void dispatchHttp2(Http2Session& session, Http2Stream& stream);
+
+    // 以处理器生成的响应回复HTTP/2流（消息体被取走）
+    void respondHttp2(Http2Session& session, Http2Stream& stream, Response& response);
+
+    // 以错误响应回复HTTP/2流，allow非空时附加Allow
+    void respondHttp2Error(Http2Session& session, Http2Stream& stream, int code,
+                           std::string_view allow = std::string_view());
+
+    // 以静态文件回复HTTP/2流（支持Range和条件请求，不压缩）
+    void serveStaticFileHttp2(Http2Session& session, Http2Stream& stream);
+
+    // 可写事件：继续发送积压的输出
+    void handleWrite(Reactor* reactor, const ConnectionPtr& conn);
     
-    // 发送HTTP响应
-    void sendResponse(int fd);
+    // 发送HTTP响应，连接出错时返回false
+    bool sendResponse(Reactor* reactor, const ConnectionPtr& conn, bool keepAlive);
+
+    // 调用匹配到的路由处理器并发送其响应，连接出错时返回false；
+    // 多Reactor模式下需要压缩的响应交给线程池，返回时尚未发送
+    bool sendRouteResponse(Reactor* reactor, const ConnectionPtr& conn, bool keepAlive);
+
+    // 转发的响应写回客户端的状态
+    struct ProxyState;
+
+    // 把请求转发到路由的上游，返回时尚未发送；连接出错时返回false
+    bool forwardRequest(Reactor* reactor, const ConnectionPtr& conn, bool keepAlive);
+
+    // 上游响应头到达：写出状态行和头部，选择向客户端的分帧方式
+    ProxyHandler::Flow proxyHeaders(Reactor* reactor, const ConnectionPtr& conn, ProxyState& state,
+                                    const HttpParser& response);
+
+    // 上游响应体分片到达：按选定的分帧方式写出
+    ProxyHandler::Flow proxyBody(Reactor* reactor, const ConnectionPtr& conn, ProxyState& state,
+                                 std::string_view data);
+
+    // 写出转发的数据之后：提交输出、刷新超时，积压超过高水位时暂停读取上游
+    ProxyHandler::Flow afterProxyWrite(Reactor* reactor, const ConnectionPtr& conn, ProxyState& state);
+
+    // 转发结束：补齐分帧或回复错误，再继续处理等待期间排队的请求
+    void finishProxy(Reactor* reactor, const ConnectionPtr& conn, ProxyState& state, int error);
+
+    // 协程处理器的一次调用（AsyncContext的服务器端实现）
+    struct AsyncCall;
+
+    // 拷贝请求并启动路由的协程处理器，执行到第一个挂起点；连接出错时返回false
+    bool startAsync(Reactor* reactor, const ConnectionPtr& conn, bool keepAlive);
+
+    // 在所属循环中恢复挂起的协程，协程结束时发送响应并继续处理等待期间排队的请求
+    void resumeAsync(const std::shared_ptr<AsyncCall>& call, std::coroutine_handle<> handle);
+
+    // 写出协程的消息体分片（第一次写出时先发响应头），需要等待积压回落或连接已关闭时返回true
+    bool writeAsyncBody(const ConnectionPtr& conn, AsyncCall& call, std::string_view data);
+
+    // 协程结束：发送响应或补齐分帧，连接出错时返回false
+    bool finishAsync(const ConnectionPtr& conn, AsyncCall& call);
+
+    // 动态响应的压缩决定
+    struct CompressionChoice
+    {
+        ContentEncoding encoding = ContentEncoding::IDENTITY;
+        int level = 0;
+        bool vary = false;   // 按Content-Type和大小可以压缩，响应需带Vary: Accept-Encoding
+    };
+
+    // 线程池中压缩的响应
+    struct CompressionJob;
+
+    // 按请求的Accept-Encoding、响应的Content-Type和消息体大小决定是否压缩
+    CompressionChoice chooseCompression(const HttpParser& parser, const Response& response) const;
+
+    // 写出处理器生成的响应，body为（可能已压缩的）消息体，extraHeaders为附加的完整头部行，
+    // 连接出错时返回false
+    bool writeRouteResponse(const ConnectionPtr& conn, const Response& response, const CompressionChoice& choice,
+                            std::string_view body, bool keepAlive, bool headOnly,
+                            std::string_view extraHeaders = std::string_view());
+
+    // 以缓存的条目响应（If-None-Match匹配所选表示的ETag时回复304），连接出错时返回false
+    bool sendCachedResponse(const ConnectionPtr& conn, const ResponseCache::EntryPtr& entry, bool keepAlive,
+                            bool headOnly);
+
+    // 缓存条目的压缩表示：单Reactor模式下就地压缩，多Reactor模式下第一次请求时提交线程池（本次仍发送原始内容）
+    std::shared_ptr<const std::string> cachedEncoding(const ResponseCache::EntryPtr& entry,
+                                                      const CompressionChoice& choice);
+
+    // 同一个缓存键的leader完成后，在所属循环中重新处理等待的请求
+    void resumeCachedRequest(Reactor* reactor, const ConnectionPtr& conn, ResponseCache::EntryPtr entry);
+
+    // 线程池压缩完成后在所属循环发送响应，并继续处理等待期间排队的请求
+    void finishCompressedResponse(Reactor* reactor, const ConnectionPtr& conn, CompressionJob& job);
+
+    // 多Reactor模式下异步响应写出后，在所属循环中继续处理等待期间排队的请求（持有连接锁）
+    void resumeAfterResponse(Reactor* reactor, const ConnectionPtr& conn);
+
+    // 静态文件的压缩表示：按Accept-Encoding选择，尚未压缩过时提交到线程池（本次仍发送原始内容）。
+    // vary输出该文件是否可能有多种表示
+    std::shared_ptr<const EncodedFile> staticEncoding(const std::shared_ptr<const CachedFile>& file,
+                                                      const HttpParser& parser, bool& vary);
+
+    //发送错误响应（keepAlive为false时写完后关闭连接），extraHeaders为附加的完整头部行，连接出错时返回false
+    bool sendErrorResponse(const ConnectionPtr& conn, int code, bool keepAlive = false,
+                           const std::string& extraHeaders = std::string());
+
+    // 发送数据：先直接写，写不完的部分进入输出缓冲并关注EPOLLOUT
+    bool sendData(const ConnectionPtr& conn, const char* data, size_t len);
+
+    // 发送组装好的响应，more为true表示后面紧跟文件内容
+    bool sendVector(const ConnectionPtr& conn, const ResponseWriter& writer, bool more = false);
+
+    // 以一次sendmsg发送多段数据，写不完的部分进入输出缓冲并关注EPOLLOUT
+    bool sendIov(const ConnectionPtr& conn, const iovec* iov, int iovcnt, int flags);
+
+    // 排队一段文件区间并尝试立即以sendfile发送
+    bool sendFile(const ConnectionPtr& conn, const std::shared_ptr<const CachedFile>& file,
+                  off_t offset, size_t length);
+
+    // 写出已排队的输出并更新关注事件，出错时返回false
+    bool sendQueued(const ConnectionPtr& conn);
+
+    // 按顺序写出输出缓冲和文件区间，直到写完或EAGAIN，出错时返回false
+    bool flushOutput(const ConnectionPtr& conn);
+
+    // 以静态文件响应GET/HEAD请求（支持Range和条件请求）
+    bool serveStaticFile(const ConnectionPtr& conn, bool keepAlive);
+
+    // 根据输出积压和读暂停状态更新epoll关注的事件
+    // 单Reactor模式下fd为EPOLLONESHOT，只在rearm为true（处理结束）时重新激活
+    void updateEvents(const ConnectionPtr& conn, bool rearm = false);
+
+    // 根据连接状态计算新的超时截止时间，截止时间提前时通知所属循环重新调度定时器
+    void refreshDeadline(Reactor* reactor, const ConnectionPtr& conn);
+
+    // 按截止时间调度连接的超时定时器（仅循环线程调用）
+    void armTimer(Reactor* reactor, const ConnectionPtr& conn);
+
+    // 超时定时器到期：截止时间已被推后则重新调度，否则关闭连接
+    void handleTimeout(Reactor* reactor, const std::weak_ptr<Connection>& weakConn);
+
+    // io_uring完成式路径：multishot accept得到新连接
+    void acceptUring(Reactor* reactor, int connFd);
+
+    // io_uring完成式路径：为连接提交multishot recv
+    void startUringRecv(Reactor* reactor, const ConnectionPtr& conn);
+
+    // io_uring完成式路径：收到数据（n > 0）、对端关闭（n == 0）或recv结束（n < 0）
+    void handleUringRecv(Reactor* reactor, const ConnectionPtr& conn, const char* data, ssize_t n);
+
+    // io_uring完成式路径：提交积压的输出，同一时刻每个连接只有一个send在途
+    void flushUring(Reactor* reactor, const ConnectionPtr& conn);
+
+    // io_uring完成式路径：提交sendBuffer中尚未发送的部分
+    void submitUringSend(Reactor* reactor, const ConnectionPtr& conn, int flags);
+
+    // io_uring完成式路径：send完成
+    void handleUringSent(Reactor* reactor, const ConnectionPtr& conn, int flags, ssize_t n);
+
+    // io_uring完成式路径：输出全部写出后关闭连接或恢复读取
+    void onUringDrained(Reactor* reactor, const ConnectionPtr& conn);
 
-    //发送错误响应
-    void sendErrorResponse(int fd, int code, const std::string& message);
+    // 返回新连接初始关注的事件
+    uint32_t initialEvents() const;
 
-    int port;                // 服务器监听端口
-    int listenFd;            // 监听socket的文件描述符
-    Epoll epoll;             // Epoll事件管理器
+    ServerConfig config;     // 服务器配置
+    MetricsRegistry metricsRegistry; // 指标注册表
+    ServerMetrics stats;     // 内置指标
+    bool multiReactor;       // 是否为多Reactor模式
     ThreadPool pool;         // 线程池
-    struct sockaddr_in addr; // 服务器地址结构
+    AdmissionController admission; // 单Reactor模式下按线程池排队时间的准入控制
+    std::unique_ptr<StaticFileHandler> staticFiles; // 静态文件处理器（未配置根目录时为空）
+    std::unique_ptr<ResponseCache> responseCache;   // 路由处理器的响应缓存（未启用时为空）
+    Router router;           // 路由表（启动后只读）
+    std::string serverHeader; // 预先生成的Server头部行（未配置名称时为空）
+    std::unordered_map<int, FixedResponse> errorResponses; // 预先序列化的错误响应
+    std::vector<std::unique_ptr<Reactor>> reactors; // 事件循环集合
 };
\ No newline at end of file
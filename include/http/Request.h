@@ -0,0 +1,59 @@
+#pragma once
+#include "http/HttpParser.h"
+#include "http/Router.h"
+#include <string_view>
+
+/**
+ * @brief 交给路由处理器的请求视图
+ *
+ * 不拷贝任何数据：请求行和头部引用解析器（即连接的输入缓冲区），路由参数引用请求路径，
+ * 请求体引用连接缓存的消息体。只在处理器调用期间有效。
+ */
+class Request
+{
+public:
+    Request(const HttpParser& parser, const RouteParams& params, std::string_view body)
+        : parser(parser), routeParams(params), content(body)
+    {
+        std::string_view target = parser.getPath();
+        size_t question = target.find('?');
+        if (question != std::string_view::npos)
+        {
+            pathPart = target.substr(0, question);
+            queryPart = target.substr(question + 1);
+        }
+        else
+        {
+            pathPart = target;
+        }
+    }
+
+    // 请求行
+    std::string_view method() const { return parser.getMethod(); }
+    std::string_view target() const { return parser.getPath(); }  // 原始请求目标（含查询串）
+    std::string_view path() const { return pathPart; }            // 不含查询串的路径
+    std::string_view query() const { return queryPart; }          // '?'之后的查询串，没有时为空
+    std::string_view version() const { return parser.getVersion(); }
+
+    // 头部字段，不存在时返回空视图
+    std::string_view header(HeaderId id) const { return parser.getHeader(id); }
+    std::string_view header(std::string_view name) const { return parser.getHeader(name); }
+    const HttpHeaders& headers() const { return parser.getHeaders(); }
+
+    // 路由参数（:name 或 *name），不存在时返回空视图
+    std::string_view param(std::string_view name) const { return routeParams.get(name); }
+    const RouteParams& params() const { return routeParams; }
+
+    // 缓存的请求体；路由注册了流式处理器时为空
+    std::string_view body() const { return content; }
+
+    // 底层解析器
+    const HttpParser& raw() const { return parser; }
+
+private:
+    const HttpParser& parser;
+    const RouteParams& routeParams;
+    std::string_view content;
+    std::string_view pathPart;
+    std::string_view queryPart;
+};
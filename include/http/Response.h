@@ -0,0 +1,72 @@
+#pragma once
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 路由处理器填写的响应
+ *
+ * 处理器只设置状态码、头部和消息体；Content-Length和Connection由服务器在发送时生成，
+ * HEAD请求的消息体由服务器省略。
+ * 字符串和头部列表是pmr容器：以连接的请求内存池构造时全部分配在池中，随请求结束一次性回收；
+ * 默认构造的响应使用全局堆。赋值给另一个响应时内容按目标的分配器复制，移动构造则沿用来源的内存池。
+ */
+class Response
+{
+public:
+    using HeaderList = std::pmr::vector<std::pair<std::pmr::string, std::pmr::string>>;
+
+    Response() = default;
+    explicit Response(std::pmr::memory_resource* resource)
+        : reasonText(resource), headerList(resource), bodyText(resource)
+    {
+    }
+
+    // 状态码，原因短语为空时使用标准短语
+    void setStatus(int code, std::string_view reason = std::string_view())
+    {
+        statusCode = code;
+        reasonText.assign(reason.data(), reason.size());
+    }
+
+    // 追加头部字段（不检查重复）
+    void addHeader(std::string_view name, std::string_view value)
+    {
+        headerList.emplace_back(name, value);
+    }
+
+    // 设置头部字段，已存在的同名字段（不区分大小写）被替换
+    void setHeader(std::string_view name, std::string_view value);
+
+    // 移除全部同名头部字段（不区分大小写）
+    void removeHeader(std::string_view name);
+
+    // 设置Content-Type
+    void setContentType(std::string_view type) { setHeader("Content-Type", type); }
+
+    // 设置或追加消息体
+    void setBody(std::string_view content) { bodyText.assign(content.data(), content.size()); }
+    void append(std::string_view data) { bodyText.append(data.data(), data.size()); }
+
+    int status() const { return statusCode; }
+    std::string_view reason() const { return reasonText.empty() ? reasonPhrase(statusCode) : reasonText; }
+    const HeaderList& headers() const { return headerList; }
+    std::string_view body() const { return bodyText; }
+
+    // 是否设置了指定头部（不区分大小写）
+    bool hasHeader(std::string_view name) const;
+
+    // 指定头部的值（不区分大小写），未设置时为空
+    std::string_view header(std::string_view name) const;
+
+    // 标准原因短语，未知状态码返回"Unknown"
+    static std::string_view reasonPhrase(int code);
+
+private:
+    int statusCode = 200;
+    std::pmr::string reasonText;
+    HeaderList headerList;
+    std::pmr::string bodyText;
+};
@@ -0,0 +1,203 @@
+#pragma once
+#include "http/Compression.h"
+#include "http/HttpParser.h"
+#include "http/Response.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 缓存的一个响应
+ *
+ * 插入后内容不再改变，各线程共享读取；压缩表示在第一次被请求时生成并挂在条目上
+ */
+struct CachedResponse
+{
+    std::string key;             // 缓存键
+    std::vector<std::string> varyNames; // 键中包含的请求头（小写）
+    Response response;           // 处理器生成的响应（ETag另存，不在头部中）
+    std::string etags[Compression::ENCODINGS]; // 各编码表示的ETag，以ContentEncoding为下标
+    int64_t storedMs = 0;        // 插入时间（单调时钟毫秒），用于Age
+    int64_t expiresMs = 0;       // 过期时间（单调时钟毫秒）
+    bool pass = false;           // 不可缓存的标记：命中时不合并等待，直接调用处理器
+    std::string cacheControl;    // 响应的Cache-Control，304时原样发送
+    std::string vary;            // 响应的Vary，304时原样发送
+
+    // 压缩后的消息体，空字符串表示压缩后没有变小；并发读写一律经std::atomic_load/atomic_store
+    mutable std::shared_ptr<const std::string> encoded[Compression::ENCODINGS];
+    mutable std::atomic<bool> compressStarted[Compression::ENCODINGS] = {}; // 是否已开始压缩
+};
+
+/**
+ * @brief 路由处理器前的共享响应缓存
+ *
+ * 键为"GET 请求目标"加上响应Vary中列出的请求头的值（HEAD与GET共用条目；Accept-Encoding除外，
+ * 压缩表示挂在同一条目上）。按键的哈希分到多个分片，每个分片一把锁，各自执行W-TinyLFU：
+ * - 新条目先进入窗口LRU（约占分片容量的1%），吸收突发的新键
+ * - 被挤出窗口的条目作为候选进入主区，主区已满时与受试段最久未用的条目比较访问频率，
+ *   频率更高才被接纳，否则直接丢弃；频率由4行的Count-Min Sketch估计，计数定期减半以淡忘历史
+ * - 主区为分段LRU：受试段中的条目再次命中后升入受保护段（约占主区的80%），受保护段溢出时降回受试段
+ * 容量以字节计（消息体、头部和键），压缩表示不计入。
+ *
+ * 同一个键同时未命中时只有第一个请求（leader）调用处理器，其余请求登记回调，
+ * leader插入结果后调用complete把条目交给它们。响应不可缓存时留下一个短期的标记（hit-for-pass），
+ * 之后的请求不再排队等待，直接调用处理器
+ */
+class ResponseCache
+{
+public:
+    using EntryPtr = std::shared_ptr<const CachedResponse>;
+    // 等待者：以leader插入的条目（不可缓存时为空）被调用，调用线程不确定
+    using Waiter = std::function<void(const EntryPtr& entry)>;
+
+    /**
+     * @param capacityBytes 缓存的总字节数
+     * @param shards 分片数（取不小于它的2的幂）
+     * @param defaultTtlMs 响应没有Cache-Control时的缓存时间，0表示不缓存这类响应
+     */
+    ResponseCache(size_t capacityBytes, size_t shards, int64_t defaultTtlMs);
+
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+    // 查找结果
+    struct Lookup
+    {
+        EntryPtr entry;         // 命中的条目
+        std::string key;        // 查找用的键，请求不可缓存时为空
+        bool waiting = false;   // 同一个键正由其他请求生成，waiter已登记，完成后被调用
+        bool leader = false;    // 调用方负责生成响应，之后必须以key调用complete
+        bool pass = false;      // 命中了不可缓存的标记，不必再尝试插入
+    };
+
+    /**
+     * @brief 查找请求对应的响应
+     *
+     * 请求带Cache-Control: no-cache（或Pragma: no-cache）时不使用缓存的条目，但仍参与合并。
+     * waiter为空时不合并：未命中直接返回，调用方自行生成响应
+     */
+    Lookup lookup(const HttpParser& request, int64_t nowMs, Waiter waiter);
+
+    /**
+     * @brief 按响应的Cache-Control和Vary插入条目
+     *
+     * 可缓存时response的内容被移入条目；条目可能未通过准入而没有留在缓存中，但仍可用于本次响应
+     * @return 生成的条目；响应不可缓存时返回nullptr，response保持不变
+     */
+    EntryPtr insert(const HttpParser& request, Response& response, int64_t nowMs);
+
+    // leader生成响应结束（无论是否可缓存）：以它的条目唤醒等待key的请求
+    void complete(const std::string& key, const EntryPtr& entry);
+
+    // 条目是否适用于request（Vary列出的请求头与生成条目的请求相同）
+    static bool matches(const CachedResponse& entry, const HttpParser& request);
+
+    // 当前的条目数和字节数
+    size_t size() const;
+    size_t bytes() const;
+
+    // 请求是否可能由缓存响应：GET/HEAD且不带Authorization
+    static bool cacheableRequest(const HttpParser& request);
+
+private:
+    // 条目所在的段
+    enum class Segment : uint8_t
+    {
+        WINDOW,
+        PROBATION,
+        PROTECTED
+    };
+
+    struct Item
+    {
+        EntryPtr entry;
+        uint64_t hash;          // 键的哈希，用于频率估计
+        size_t primaryLength;   // 键中"GET 请求目标"部分的长度
+        size_t charge;          // 计入容量的字节数
+        Segment segment;
+    };
+    using ItemList = std::list<Item>;
+
+    /**
+     * @brief 4行Count-Min Sketch，计数饱和于15，累计增加sampleSize次后全部减半
+     */
+    class FrequencySketch
+    {
+    public:
+        explicit FrequencySketch(size_t width);
+        void increment(uint64_t hash);
+        int estimate(uint64_t hash) const;
+
+    private:
+        size_t index(uint64_t hash, int row) const;
+
+        std::vector<uint8_t> table;  // 4行，每行width个计数
+        size_t mask;
+        size_t additions = 0;
+        size_t sampleSize;
+    };
+
+    // 同一请求目标下被缓存的Vary字段（小写）及其条目数
+    struct VaryInfo
+    {
+        std::vector<std::string> names;
+        size_t entries = 0;
+    };
+
+    struct Shard
+    {
+        explicit Shard(size_t sketchWidth) : sketch(sketchWidth) {}
+
+        std::mutex mutex;
+        ItemList window, probation, protectedList;
+        size_t windowBytes = 0, probationBytes = 0, protectedBytes = 0;
+        std::unordered_map<std::string, ItemList::iterator> index;   // 键 -> 条目
+        std::unordered_map<std::string, VaryInfo> vary;              // "方法 请求目标" -> Vary字段
+        std::unordered_map<std::string, std::vector<Waiter>> inflight; // 正在生成的键 -> 等待者
+        FrequencySketch sketch;
+    };
+
+    // 主键"GET 请求目标"
+    static std::string primaryKey(const HttpParser& request);
+
+    // 主键加上names中各请求头的值
+    static std::string fullKey(const std::string& primary, const std::vector<std::string>& names,
+                               const HttpParser& request);
+
+    Shard& shardFor(const std::string& primary) { return *shards[std::hash<std::string>()(primary) & shardMask]; }
+
+    ItemList& listOf(Shard& shard, Segment segment);
+    size_t& bytesOf(Shard& shard, Segment segment);
+
+    // 把条目移到segment的最近使用端（需持有分片锁）
+    void moveTo(Shard& shard, ItemList::iterator it, Segment segment);
+
+    // 命中：窗口和受保护段内移到最近使用端，受试段升入受保护段（需持有分片锁）
+    void onHit(Shard& shard, ItemList::iterator it);
+
+    // 移除条目（需持有分片锁）
+    void remove(Shard& shard, ItemList::iterator it);
+
+    // 把新条目放入窗口并按需淘汰，替换同键的旧条目
+    void store(const std::string& primary, EntryPtr entry, size_t charge);
+
+    // 窗口超出容量时把候选条目移入主区或淘汰（需持有分片锁）
+    void evict(Shard& shard);
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t shardMask;
+    size_t windowCapacity;      // 每个分片
+    size_t mainCapacity;
+    size_t protectedCapacity;
+    size_t maxEntryBytes;       // 超过该值的响应不缓存
+    int64_t defaultTtlMs;
+    std::atomic<size_t> entryCount{0};
+    std::atomic<size_t> byteCount{0};
+};
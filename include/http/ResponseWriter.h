@@ -0,0 +1,106 @@
+#pragma once
+#include <sys/uio.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief 启动时预先序列化的固定响应
+ *
+ * 除Date和Connection外的状态行、头部和消息体都已生成，发送时只需拼出4段iovec，
+ * 用于错误响应和健康检查等内容不变的小响应
+ */
+struct FixedResponse
+{
+    int code = 0;       // 状态码
+    std::string contentType; // Content-Type的值（HTTP/2响应重新编码头部时使用）
+    std::string head;   // 状态行 + Server/Content-Type/Content-Length及附加头部
+    std::string body;   // 消息体
+
+    /**
+     * @param serverHeader 完整的Server头部行（含CRLF），为空时不发送
+     * @param extraHeaders 附加的完整头部行（含CRLF）
+     */
+    static FixedResponse make(int code, std::string_view contentType, std::string_view body,
+                              std::string_view serverHeader, std::string_view extraHeaders = std::string_view());
+};
+
+/**
+ * @brief 分散/聚集（scatter-gather）响应组装器
+ *
+ * 状态行、头部和消息体以iovec列表的形式组装，一次系统调用写出，不拼接字符串：
+ * - 常见状态码的状态行、Date头部、Connection行都引用预先格式化好的字符串
+ * - 整数和短小的头部拷贝到对象内的定长缓冲，相邻的拷贝合并成同一个iovec
+ * - 消息体和较长的字段值直接引用调用方的内存
+ * 普通响应不产生任何堆分配；被引用的内存必须在发送完成前保持有效。
+ */
+class ResponseWriter
+{
+public:
+    static constexpr size_t INLINE_IOVECS = 32;
+    static constexpr size_t SCRATCH_SIZE = 512;
+
+    ResponseWriter() = default;
+    ResponseWriter(const ResponseWriter&) = delete;
+    ResponseWriter& operator=(const ResponseWriter&) = delete;
+
+    // 状态行；reason为空或为标准短语时使用预先格式化的状态行
+    void statusLine(int code, std::string_view reason = std::string_view());
+
+    // 头部字段行；短小的字段拷贝到内部缓冲，较长的值直接引用
+    void header(std::string_view name, std::string_view value);
+
+    // 整数值的头部字段行（如Content-Length），格式化到内部缓冲
+    void header(std::string_view name, uint64_t value);
+
+    // 当前缓存的Date头部行
+    void date();
+
+    // Connection头部行以及结束头部的空行
+    void endHeaders(bool keepAlive);
+
+    // 追加一段数据（引用，不拷贝）
+    void append(std::string_view data);
+
+    // 追加一段数据的拷贝
+    void appendCopy(std::string_view data);
+
+    // 追加整数的十进制表示
+    void appendUint(uint64_t value);
+
+    // 组装预先序列化的固定响应，headOnly时省略消息体
+    void fixed(const FixedResponse& response, bool keepAlive, bool headOnly = false);
+
+    // 组装结果
+    const iovec* iov() const { return overflow.empty() ? inlineVecs : overflow.data(); }
+    int iovCount() const { return static_cast<int>(count); }
+    size_t size() const { return bytes; }
+
+    // 清空以复用
+    void clear();
+
+    // 预先格式化的状态行（含CRLF），未知状态码返回空视图
+    static std::string_view statusLineOf(int code);
+
+    // 把整数格式化为十进制写入out（至少20字节），返回长度，不分配内存
+    static size_t formatUint(uint64_t value, char* out);
+
+private:
+    // 在内部缓冲中预留n字节，缓冲用完时改为单独分配
+    char* reserve(size_t n);
+
+    // 追加一个iovec；与上一段在内存中相邻时直接合并
+    void push(const char* data, size_t length);
+
+    iovec inlineVecs[INLINE_IOVECS];
+    std::vector<iovec> overflow;    // 超出内联容量后全部iovec转移到这里
+    size_t count = 0;
+    size_t bytes = 0;
+
+    char scratch[SCRATCH_SIZE];
+    size_t scratchUsed = 0;
+    std::vector<std::unique_ptr<char[]>> spill; // 内部缓冲用完后的拷贝（用到时才分配）
+};
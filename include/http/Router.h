@@ -0,0 +1,158 @@
+#pragma once
+#include "core/Task.h"
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Request;
+class Response;
+class AsyncContext;
+struct FixedResponse;
+class UpstreamGroup;
+
+/**
+ * @brief 路由参数
+ *
+ * 定长数组保存匹配到的 :param 和 *wildcard，名称指向路由树节点，值指向请求路径，匹配过程不分配内存
+ */
+class RouteParams
+{
+public:
+    static constexpr size_t MAX_PARAMS = 8;
+
+    struct Param
+    {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    // 按名称取参数值，不存在时返回空视图
+    std::string_view get(std::string_view name) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (params[i].name == name)
+            {
+                return params[i].value;
+            }
+        }
+        return std::string_view();
+    }
+
+    size_t size() const { return count; }
+    const Param& operator[](size_t i) const { return params[i]; }
+
+    void push(std::string_view name, std::string_view value) { params[count++] = Param{name, value}; }
+    void pop() { --count; }
+    void clear() { count = 0; }
+
+    // 请求所在的缓冲区从from搬移到to之后，修正参数值的指向
+    void rebase(const char* from, const char* to)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            params[i].value = std::string_view(to + (params[i].value.data() - from), params[i].value.size());
+        }
+    }
+
+private:
+    Param params[MAX_PARAMS];
+    size_t count = 0;
+};
+
+/**
+ * @brief 注册的路由
+ */
+struct Route
+{
+    // 请求处理器：请求体已完整接收（或已流式交付），填写response后由服务器发送
+    using Handler = std::function<void(const Request& request, Response& response)>;
+
+    // 请求体流式处理器：请求体按分片到达时调用，data只在回调期间有效
+    using BodyHandler = std::function<void(const Request& request, std::string_view data)>;
+
+    // 协程处理器：可以在其中等待定时器、写出背压和上游响应，不占用线程
+    using AsyncHandler = std::function<Task(AsyncContext& context)>;
+
+    std::string method;
+    std::string pattern;
+    Handler handler;
+    BodyHandler onBody;    // 为空时请求体缓存在内存中，通过Request::body()访问
+    std::shared_ptr<const FixedResponse> fixed; // 非空时直接发送该预先序列化的响应，不调用handler
+    std::shared_ptr<UpstreamGroup> upstream;    // 非空时把请求转发到该组上游（反向代理），不调用handler
+    AsyncHandler async;    // 非空时以协程处理请求（见AsyncContext），不调用handler
+};
+
+/**
+ * @brief 基于压缩前缀树（radix tree）的路由器
+ *
+ * 每个方法一棵树，静态片段按公共前缀合并成一个节点，参数片段作为特殊子节点：
+ * - /users/:id       匹配一个路径段，值通过 params.get("id") 获取
+ * - *path            只能作为最后一段，匹配剩余的全部路径（如静态资源目录下的任意文件）
+ * 匹配优先级为 静态 > 参数 > 通配，静态分支走不通时回溯到参数分支。
+ * 所有路由须在服务器启动前注册，匹配过程只读且不分配内存，可被多个线程并发调用。
+ */
+class Router
+{
+public:
+    Router();
+    ~Router();
+
+    Router(const Router&) = delete;
+    Router& operator=(const Router&) = delete;
+
+    // 注册路由，模式非法或与已有路由冲突时抛出std::runtime_error
+    void add(std::string_view method, std::string_view pattern,
+             Route::Handler handler, Route::BodyHandler onBody = nullptr);
+
+    // 注册返回固定响应的路由
+    void add(std::string_view method, std::string_view pattern, std::shared_ptr<const FixedResponse> fixed);
+
+    // 注册转发到上游的路由
+    void add(std::string_view method, std::string_view pattern, std::shared_ptr<UpstreamGroup> upstream);
+
+    // 注册协程处理的路由
+    void add(std::string_view method, std::string_view pattern, Route::AsyncHandler handler);
+
+    /**
+     * @brief 匹配路由
+     * @param path 请求路径（不含查询串）
+     * @param params 输出匹配到的参数
+     * @return 未匹配时返回nullptr；HEAD请求没有专门的路由时匹配GET路由
+     */
+    const Route* match(std::string_view method, std::string_view path, RouteParams& params) const;
+
+    // 路径能被哪些方法匹配（逗号分隔，用于405响应的Allow头），都不能匹配时返回空串
+    std::string allowedMethods(std::string_view path) const;
+
+    // 已注册的路由数量
+    size_t size() const { return routes.size(); }
+
+private:
+    struct Node;
+
+    // 每个方法一棵树
+    struct MethodTree
+    {
+        std::string method;
+        std::unique_ptr<Node> root;
+    };
+
+    // 校验模式并把路由插入对应方法的树
+    void addRoute(Route route);
+
+    // 把模式的剩余部分插入到node之下
+    void insert(Node* node, std::string_view pattern, std::string_view rest, const Route* route);
+
+    // 在node之下匹配路径的剩余部分
+    static const Route* matchNode(const Node* node, std::string_view rest, RouteParams& params);
+
+    // 按方法查找树
+    const Node* treeFor(std::string_view method) const;
+
+    std::vector<MethodTree> trees;
+    std::deque<Route> routes;   // deque保证注册过程中已有路由的地址不变
+};
@@ -0,0 +1,101 @@
+#pragma once
+#include "core/Poller.h"
+#include "core/ThreadPool.h"
+#include "http/Compression.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 服务器配置项
+ *
+ * 所有字段都有默认值，按需覆盖后传给HttpServer构造函数
+ */
+struct ServerConfig
+{
+    int port = 8080;                 // 监听端口
+    int threadNum = 4;               // 线程池工作线程数量
+    int reactorNum = 0;              // Reactor线程数量，0表示单Reactor+线程池模式
+    bool workStealing = false;       // 线程池是否使用工作窃取调度
+
+    // 过载保护：线程池排队上限（0不限）和队列满时的策略。单Reactor模式下请求被拒绝或丢弃时，
+    // 由循环线程读取请求头后直接回复预先生成的503；BLOCK会阻塞提交任务的循环线程
+    size_t poolQueueCapacity = 4096;
+    ThreadPool::OverflowPolicy poolOverflowPolicy = ThreadPool::OverflowPolicy::REJECT;
+
+    // 单Reactor模式下按线程池排队时间做CoDel准入（毫秒，target为0不启用）：
+    // 排队时间在整个interval内都高于target时，排队超过2*target的请求直接回复503
+    int64_t shedTargetMs = 5;
+    int64_t shedIntervalMs = 100;
+    int retryAfterSeconds = 1;       // 503响应的Retry-After
+
+    // 监听socket
+    std::string bindAddress;         // 监听地址，为空时绑定IPv6双栈"::"（不支持IPv6时回退到0.0.0.0）
+    bool ipv6Only = false;           // IPv6地址只接受IPv6连接（IPV6_V6ONLY）
+    int listenBacklog = 0;           // listen的积压队列长度，0表示SOMAXCONN
+    int acceptBatch = 64;            // 每次可读事件最多accept的连接数，其余留到下一轮
+    // 多Reactor模式：true为每个循环独立的SO_REUSEPORT socket（内核按四元组哈希分发），
+    // false为所有循环共享一个socket并以EPOLLEXCLUSIVE注册（只唤醒一个等待中的循环）
+    bool reusePort = true;
+
+    // TCP选项：TCP_NODELAY设置在监听socket上由连接继承；TCP_DEFER_ACCEPT让内核在收到数据
+    //（或超时）后才交付连接（秒，0不启用）；TCP_FASTOPEN为挂起的TFO请求队列长度（0不启用）
+    bool tcpNoDelay = true;
+    int deferAcceptSeconds = 0;
+    int fastOpenQueue = 0;
+
+    // 事件源后端；IO_URING不可用时回退到EPOLL。多Reactor模式下io_uring连接走完成式路径
+    //（multishot accept/recv、异步send/close），单Reactor模式下只作为就绪通知使用
+    Poller::Backend ioBackend = Poller::Backend::EPOLL;
+
+    // 长连接
+    int maxKeepAliveRequests = 1000; // 单个连接最多处理的请求数，0表示不限
+
+    // 超时（毫秒，0表示不限）：空闲长连接、请求头接收完成、输出积压无进展、请求体接收无进展
+    int64_t idleTimeoutMs = 60000;
+    int64_t headerTimeoutMs = 10000;
+    int64_t writeTimeoutMs = 30000;
+    int64_t bodyTimeoutMs = 30000;   // 接收请求体时两次读到数据的最长间隔
+
+    // 请求头（请求行+头部）最大字节数，超出返回431
+    size_t maxHeaderSize = 64 * 1024;
+
+    // 请求体最大字节数，超出返回413
+    size_t maxBodySize = 8 * 1024 * 1024;
+
+    // 输出缓冲：积压超过高水位暂停读取，回落到一半以下恢复
+    size_t outputHighWaterMark = 4 * 1024 * 1024;
+
+    // Server响应头的值，为空时不发送
+    std::string serverName = "VortexHTTP";
+
+    // 以Prometheus文本格式输出内置指标的路径（GET），为空时不注册；指标本身总是记录
+    std::string metricsPath = "/metrics";
+
+    // 静态文件服务：根目录为空表示不启用
+    std::string staticRoot;
+    size_t fileCacheCapacity = 1024; // 缓存的打开文件数上限
+
+    // 响应压缩：按Accept-Encoding协商gzip（编译时启用brotli则同时支持br），
+    // 级别按Content-Type取自compressionRules，级别为0或没有匹配的类型不压缩。
+    // 多Reactor模式下动态响应在线程池中压缩；静态文件优先使用磁盘上较新的.gz/.br同名文件，
+    // 否则首次请求时在线程池中以最高级别压缩一次并随文件缓存，压缩完成前先发送原始内容
+    bool compression = true;
+    size_t compressMinSize = 1024;                 // 小于该值的消息体不压缩
+    size_t staticCompressMaxSize = 16 * 1024 * 1024; // 超过该值的静态文件不在内存中压缩
+    std::vector<CompressionRule> compressionRules = Compression::defaultRules();
+
+    // 路由处理器前的响应缓存（字节数，0表示不启用）：只缓存GET/HEAD请求的处理器响应，
+    // 按Cache-Control（s-maxage/max-age，no-store/private/no-cache不缓存）和Vary保存，
+    // 同一个键的并发未命中只调用一次处理器；If-None-Match与缓存的ETag相同时直接回复304
+    size_t responseCacheBytes = 0;
+    size_t responseCacheShards = 16;       // 分片数（每片一把锁）
+    int64_t responseCacheDefaultTtlMs = 0; // 响应没有Cache-Control时的缓存时间，0表示不缓存这类响应
+
+    // 明文HTTP/2（h2c）：新连接以连接前言开头（prior knowledge），或HTTP/1.1请求带Upgrade: h2c时升级。
+    // 各流按与HTTP/1.1相同的路由、静态文件处理分发；HTTP/2响应不压缩、不经过响应缓存，反向代理路由回复501
+    bool http2 = true;
+    uint32_t http2MaxStreams = 100;             // 每个连接的最大并发流数
+    uint32_t http2StreamWindow = 1024 * 1024;   // 每个流的接收窗口（字节），连接窗口为它的16倍
+};
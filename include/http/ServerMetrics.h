@@ -0,0 +1,55 @@
+#pragma once
+#include "utils/Metrics.h"
+
+/**
+ * @brief HttpServer内置的指标
+ *
+ * 连接、请求、字节数计数器和各处理阶段的延迟直方图，构造时注册到给定的注册表。
+ * 阶段划分（单位纳秒，输出为秒）：
+ * - acceptToFirstByte：连接建立到第一个响应交给内核
+ * - queueWait：事件源返回就绪到开始处理该连接（单Reactor模式下含线程池排队）
+ * - parse：解析请求头（跨多次读取时累加）
+ * - handler：路由处理器执行
+ * - write：响应交给内核（sendmsg耗时，io_uring为send提交到完成）
+ * - request：事件源返回就绪到该请求的响应发送完毕
+ * - upstream：反向代理转发请求到收到上游的响应头
+ *
+ * shed为过载保护直接回复503的请求数；cacheHits/cacheMisses/cacheCoalesced为响应缓存的命中、
+ * 未命中（调用处理器）和等待同一个键的其他请求生成响应的次数；http2Connections/http2Streams为
+ * 以HTTP/2通信的连接数和其上的请求流数
+ */
+struct ServerMetrics
+{
+    explicit ServerMetrics(MetricsRegistry& registry);
+
+    // 按状态码类别计数响应
+    void countResponse(int code)
+    {
+        int index = code / 100 - 1;
+        if (index >= 0 && index < 5)
+        {
+            responses[index]->add();
+        }
+    }
+
+    Counter& accepted;
+    Counter& closed;
+    Counter& requests;
+    Counter* responses[5];   // 1xx ~ 5xx
+    Counter& bytesReceived;
+    Counter& bytesSent;
+    Counter& shed;
+    Counter& cacheHits;
+    Counter& cacheMisses;
+    Counter& cacheCoalesced;
+    Counter& http2Connections;
+    Counter& http2Streams;
+
+    Histogram& acceptToFirstByte;
+    Histogram& queueWait;
+    Histogram& parse;
+    Histogram& handler;
+    Histogram& write;
+    Histogram& request;
+    Histogram& upstream;
+};
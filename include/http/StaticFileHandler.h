@@ -0,0 +1,136 @@
+#pragma once
+#include "http/Compression.h"
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <mutex>
+#include <list>
+#include <unordered_map>
+#include <ctime>
+#include <sys/types.h>
+
+/**
+ * @brief 已打开的静态文件及其预计算的响应头
+ *
+ * 文件描述符随对象析构关闭；正在发送的响应持有shared_ptr，
+ * 因此缓存淘汰不会影响进行中的sendfile
+ */
+struct EncodedFile;
+
+struct CachedFile
+{
+    ~CachedFile();
+
+    int fd = -1;                 // 只读打开的文件描述符
+    off_t size = 0;              // 文件大小
+    time_t mtime = 0;            // 最后修改时间
+    std::string realPath;        // 解析后的真实路径（用于inotify失效）
+    const char* contentType = ""; // 按扩展名推断的Content-Type
+    std::string etag;            // 形如 "mtime-size" 的强校验值
+    std::string lastModified;    // HTTP日期格式的修改时间
+    std::string commonHeaders;   // Content-Type/Last-Modified/ETag/Accept-Ranges 头部行
+    std::string okHeaders;       // 完整200响应的状态行+头部（不含Connection和结尾空行）
+
+    // 各编码的压缩表示，以ContentEncoding为下标：打开时找到的同名压缩文件，
+    // 或之后在线程池中压缩好的内容；并发读写一律经std::atomic_load/atomic_store
+    mutable std::shared_ptr<const EncodedFile> encoded[Compression::ENCODINGS];
+    mutable std::atomic<bool> compressStarted[Compression::ENCODINGS] = {}; // 是否已提交内存压缩
+};
+
+/**
+ * @brief 静态文件的一种压缩表示
+ *
+ * 来自磁盘上较新的.gz/.br同名文件时以sendfile发送，否则为压缩一次后常驻内存的内容。
+ * 随原始文件的缓存条目一起失效
+ */
+struct EncodedFile
+{
+    std::shared_ptr<const CachedFile> file; // 磁盘上的同名压缩文件，为空时内容在data中
+    std::string data;            // 内存中的压缩内容
+    off_t size = 0;              // 压缩后的大小
+    std::string etag;            // 原始ETag加编码后缀，与未压缩表示区分
+    std::string okHeaders;       // 完整200响应的状态行+头部（含Content-Encoding和Vary，不含Connection和结尾空行）
+};
+
+/**
+ * @brief 静态文件处理器
+ *
+ * 以配置目录为根解析请求路径，维护“打开的fd + stat结果 + 预计算响应头”的LRU缓存，
+ * 通过inotify监听缓存文件所在目录，文件或其.gz/.br同名文件变化时使对应条目失效
+ */
+class StaticFileHandler
+{
+public:
+    StaticFileHandler(const std::string& root, size_t capacity);
+    ~StaticFileHandler();
+
+    StaticFileHandler(const StaticFileHandler&) = delete;
+    StaticFileHandler& operator=(const StaticFileHandler&) = delete;
+
+    /**
+     * @brief 查找请求路径对应的文件
+     * @param path 请求路径（可带查询串）
+     * @return 文件不存在、越出根目录或无法打开时返回nullptr
+     */
+    std::shared_ptr<const CachedFile> lookup(const std::string& path);
+
+    // Range头解析结果
+    enum class RangeResult
+    {
+        NONE,           // 无Range或不支持的格式（如多区间），返回完整内容
+        SATISFIABLE,    // 单区间有效，返回206
+        UNSATISFIABLE   // 区间越界，返回416
+    };
+
+    /**
+     * @brief 解析单区间的 "bytes=" Range头
+     * @param first/last 输出闭区间 [first, last]
+     */
+    static RangeResult parseRange(std::string_view header, off_t size, off_t& first, off_t& last);
+
+    // 根据If-None-Match/If-Modified-Since判断是否可以返回304，etag为所选表示的ETag
+    static bool notModified(const CachedFile& file, std::string_view etag, std::string_view ifNoneMatch,
+                            std::string_view ifModifiedSince);
+
+    /**
+     * @brief 读取文件并压缩为内存中的表示（在线程池中调用）
+     * @return 读取失败或压缩后没有变小时返回nullptr
+     */
+    static std::shared_ptr<const EncodedFile> compress(const CachedFile& file, ContentEncoding encoding,
+                                                       int level);
+
+    // inotify文件描述符，需注册到事件循环
+    int inotifyFd() const { return notifyFd; }
+
+    // 读取inotify事件并使变化文件的缓存失效
+    void handleInotify();
+
+private:
+    using Entry = std::pair<std::string, std::shared_ptr<const CachedFile>>;
+
+    // 打开文件并生成缓存条目
+    std::shared_ptr<const CachedFile> open(const std::string& requestPath);
+
+    // 打开不早于原始文件的.gz/.br同名文件作为压缩表示
+    static void openSiblings(CachedFile& file);
+
+    // 生成压缩表示的ETag和响应头
+    static void describe(const CachedFile& file, ContentEncoding encoding, EncodedFile& encoded);
+
+    // 为文件所在目录添加inotify监听（需持有mutex），失败时返回false
+    bool watchDirectory(const std::string& dir);
+
+    // 使真实路径为realPath的所有条目失效（需持有mutex）
+    void invalidate(const std::string& realPath);
+
+    std::string root;            // 解析后的根目录真实路径
+    size_t capacity;             // 最多缓存的文件数
+    int notifyFd = -1;           // inotify实例
+
+    std::mutex mutex;
+    std::list<Entry> lru;        // 最近使用的在前
+    std::unordered_map<std::string, std::list<Entry>::iterator> index; // 请求路径 -> LRU节点
+    std::unordered_map<int, std::string> watches;     // inotify watch -> 目录
+    std::unordered_map<std::string, int> watchedDirs; // 目录 -> inotify watch
+};
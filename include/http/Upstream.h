@@ -0,0 +1,71 @@
+#pragma once
+#include <sys/socket.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 反向代理的上游配置
+ */
+struct ProxyConfig
+{
+    // 上游地址："127.0.0.1:9000"、"[::1]:9000"、"localhost:9000"，或Unix域socket "unix:/run/app.sock"
+    std::vector<std::string> upstreams;
+
+    int64_t connectTimeoutMs = 1000;    // 建立上游连接的超时
+    int64_t responseTimeoutMs = 30000;  // 发出请求到收到响应头、以及读取响应体时两次读到数据的最长间隔
+    size_t maxIdlePerReactor = 32;      // 每个Reactor为每个上游保留的空闲长连接数
+
+    // 被动健康检查：连续失败maxFails次（连接失败、超时、响应不完整）后摘除failTimeoutMs，
+    // 期间不再选中，到期后重新参与选择；所有上游都被摘除时仍选择最早恢复的一个
+    int maxFails = 3;
+    int64_t failTimeoutMs = 10000;
+};
+
+/**
+ * @brief 一个上游服务器及其负载和健康状态
+ *
+ * 计数为原子变量，各Reactor共享同一份状态，负载均衡看到的是全局的进行中请求数
+ */
+struct UpstreamServer
+{
+    std::string name;                   // 配置中的地址
+    sockaddr_storage address{};         // 解析后的地址
+    socklen_t addressLength = 0;
+    std::atomic<int> outstanding{0};    // 所有Reactor上进行中的请求数
+    std::atomic<int> failures{0};       // 连续失败次数
+    std::atomic<int64_t> ejectedUntilMs{0}; // 被摘除的截止时间（单调时钟毫秒），0表示正常
+};
+
+/**
+ * @brief 一组可互相替代的上游服务器
+ *
+ * 选择进行中请求最少（least outstanding requests）的健康服务器，数量相同时轮转，
+ * 失败由代理连接管理器上报，用于被动健康检查。线程安全
+ */
+class UpstreamGroup
+{
+public:
+    // 解析并校验全部地址，非法或无法解析时抛出std::runtime_error
+    explicit UpstreamGroup(ProxyConfig config);
+
+    const ProxyConfig& config() const { return options; }
+
+    // 选择一个服务器（不为空），exclude非空时尽量避开它（用于换一个上游重试）
+    UpstreamServer* pick(int64_t nowMs, const UpstreamServer* exclude = nullptr);
+
+    // 收到完整的响应头：清零连续失败次数
+    void reportSuccess(UpstreamServer& server);
+
+    // 一次失败：连续失败达到上限时摘除该服务器
+    void reportFailure(UpstreamServer& server, int64_t nowMs);
+
+    size_t size() const { return servers.size(); }
+
+private:
+    ProxyConfig options;
+    std::vector<std::unique_ptr<UpstreamServer>> servers;
+    std::atomic<size_t> nextIndex{0};   // 进行中请求数相同时的轮转起点
+};
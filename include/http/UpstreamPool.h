@@ -0,0 +1,134 @@
+#pragma once
+#include "http/HttpParser.h"
+#include "http/Upstream.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class EventLoop;
+
+/**
+ * @brief 一次转发的回调，全部在所属循环线程中调用
+ */
+struct ProxyHandler
+{
+    // 回调的返回值：继续读取上游、暂停读取（直到UpstreamPool::resume）、放弃本次转发
+    enum class Flow
+    {
+        CONTINUE,
+        PAUSE,
+        ABORT
+    };
+
+    // 收到完整的响应头（已跳过1xx中间响应），response引用内部缓冲，只在回调期间有效
+    std::function<Flow(const HttpParser& response)> onHeaders;
+
+    // 解码后的响应体分片（chunked已去除分块格式），data只在回调期间有效
+    std::function<Flow(std::string_view data)> onBody;
+
+    // 转发结束：0表示响应完整，502为连接失败或响应不完整、格式错误，504为超时。
+    // 任一回调返回ABORT后不再调用
+    std::function<void(int error)> onComplete;
+};
+
+/**
+ * @brief 每个Reactor一个的上游连接管理器
+ *
+ * 上游连接只在所属循环线程中创建和使用，以水平触发注册在同一个事件源上，不需要加锁：
+ * - 请求完成且上游允许长连接时，连接按上游服务器放回空闲栈（后进先出，优先复用最热的连接），
+ *   空闲期间任何可读事件（对端关闭或多余数据）都直接关闭该连接
+ * - 复用的连接在收到任何响应字节之前断开（上游已关闭空闲连接的竞态），幂等请求在新连接上重发一次
+ * - 连接失败或超时在收到响应之前换一个上游重试，每个上游最多尝试一次
+ * - 响应体边读边交给回调，回调返回PAUSE时停止读取上游，背压一直传导到上游的socket
+ */
+class UpstreamPool
+{
+public:
+    // 一次进行中的转发，对调用方不透明
+    struct Exchange;
+
+    explicit UpstreamPool(EventLoop& loop);
+    ~UpstreamPool();
+
+    UpstreamPool(const UpstreamPool&) = delete;
+    UpstreamPool& operator=(const UpstreamPool&) = delete;
+
+    /**
+     * @brief 把请求转发到group中的一个上游（仅循环线程调用）
+     *
+     * 连接立即失败时回调可能在返回之前就被调用
+     * @param request 完整的请求报文（请求行、头部和消息体）
+     * @param headRequest 请求方法为HEAD，响应没有消息体
+     * @param idempotent 请求可以安全重发
+     */
+    std::shared_ptr<Exchange> forward(UpstreamGroup& group, std::string request, bool headRequest,
+                                      bool idempotent, ProxyHandler handler);
+
+    // 恢复被PAUSE暂停的转发，转发已结束时什么也不做（仅循环线程调用）
+    void resume(const std::shared_ptr<Exchange>& exchange);
+
+    // 当前的空闲连接数
+    size_t idleCount() const;
+
+private:
+    struct Link;
+    using LinkPtr = std::shared_ptr<Link>;
+    using ExchangePtr = std::shared_ptr<Exchange>;
+
+    // 失败后的重试方式
+    enum class Retry
+    {
+        NONE,           // 不重试，以错误结束
+        NEXT_UPSTREAM,  // 尚未发出请求（连接失败或超时）：换一个上游，直到每个上游都试过
+        NEW_CONNECTION  // 复用的连接已失效：在新建的连接上重发一次
+    };
+
+    // 选择上游并取一个空闲连接或发起新连接
+    void connect(const ExchangePtr& exchange);
+
+    // 新建到server的非阻塞连接，立即失败时返回nullptr
+    LinkPtr open(UpstreamServer* server);
+
+    // 连接上的就绪事件
+    void handleEvent(int fd);
+
+    // 写出请求的剩余部分，写完后等待响应
+    void writeRequest(const LinkPtr& link, const ExchangePtr& exchange);
+
+    // 读取响应直到EAGAIN、暂停或本轮上限
+    void readResponse(const LinkPtr& link, const ExchangePtr& exchange);
+
+    // 解析缓冲中的响应数据并交给回调
+    void processResponse(const LinkPtr& link, const ExchangePtr& exchange);
+
+    // 连接出错或超时：按retry重试，否则以error结束转发；countFailure为false时不计入上游的健康状态
+    void fail(const ExchangePtr& exchange, int error, bool countFailure, Retry retry);
+
+    // 响应完整：连接放回空闲栈或关闭，然后通知回调
+    void finish(const LinkPtr& link, const ExchangePtr& exchange, bool reusable);
+
+    // 回调放弃转发：关闭连接，不再调用回调
+    void abort(const ExchangePtr& exchange);
+
+    // 归还exchange在当前上游计入的进行中请求数
+    void release(Exchange& exchange);
+
+    // 以delayMs重新调度exchange的超时定时器
+    void armTimer(const ExchangePtr& exchange, int64_t delayMs);
+
+    // 超时定时器到期
+    void handleTimeout(const std::weak_ptr<Exchange>& weakExchange);
+
+    // 调整连接在事件源中关注的事件，0表示注销
+    void setEvents(Link& link, uint32_t events);
+
+    // 注销并关闭连接
+    void closeLink(const LinkPtr& link);
+
+    EventLoop& loop;
+    std::unordered_map<int, LinkPtr> links;                            // fd -> 连接（含空闲连接）
+    std::unordered_map<UpstreamServer*, std::vector<LinkPtr>> idle;    // 每个上游的空闲栈
+};
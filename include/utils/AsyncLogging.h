@@ -0,0 +1,130 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstring>
+#include <ctime>
+
+/**
+ * @brief 定长日志缓冲区
+ *
+ * 每个写日志的线程持有一块，前端只做一次memcpy追加，写满后整块交给后台线程
+ */
+class LogBuffer
+{
+public:
+    static constexpr size_t CAPACITY = 512 * 1024; // 单块缓冲区大小(512KB)
+
+    LogBuffer() : data(new char[CAPACITY]) {}
+
+    // 追加数据（调用方保证剩余空间足够）
+    void append(const char *buf, size_t len)
+    {
+        std::memcpy(data.get() + used, buf, len);
+        used += len;
+    }
+
+    size_t length() const { return used; }
+    size_t avail() const { return CAPACITY - used; }
+    const char *begin() const { return data.get(); }
+    void reset() { used = 0; }
+
+private:
+    std::unique_ptr<char[]> data;
+    size_t used = 0;
+};
+
+/**
+ * @brief 持久打开的日志文件，支持按大小和按天滚动
+ *
+ * 只由后台线程访问，无需加锁
+ */
+class LogFile
+{
+public:
+    LogFile(const std::string &path, size_t rollSize);
+    ~LogFile();
+
+    // 批量写入，必要时触发滚动
+    void write(const char *buf, size_t len);
+
+private:
+    void open();
+    void roll();
+
+    std::string path;    // 日志文件路径
+    size_t rollSize;     // 单个文件最大字节数
+    size_t written = 0;  // 当前文件已写字节数
+    int fd = -1;         // 持久打开的文件描述符
+    std::time_t dayEnd = 0;   // 当前文件所属自然日（本地时间）的结束时间，到达后按天滚动
+};
+
+/**
+ * @brief 异步日志后端（线程私有缓冲）
+ *
+ * 每个线程把格式化好的日志行追加到自己的缓冲区，只持有该线程私有的锁（只在后台线程收集时才有竞争），
+ * 不同线程之间互不阻塞；缓冲区写满后挂到本线程的待写队列，后台线程被唤醒。
+ * 后台线程在缓冲区写满或每隔flushInterval秒收集所有线程的缓冲区，批量write()到持久打开的文件。
+ * 同一线程的日志保持顺序，同一批次内不同线程的日志按线程分组写出。
+ * 待写缓冲区总数超过上限时前端直接丢弃日志并计数，保证过载时内存有界。
+ */
+class AsyncLogging
+{
+public:
+    AsyncLogging(const std::string &path, size_t rollSize = 64 * 1024 * 1024,
+                 int flushIntervalSec = 3, size_t maxPendingBuffers = 64);
+    ~AsyncLogging();
+
+    AsyncLogging(const AsyncLogging &) = delete;
+    AsyncLogging &operator=(const AsyncLogging &) = delete;
+
+    // 追加一条日志（线程安全）
+    void append(const char *line, size_t len);
+
+    // 启动/停止后台写线程，停止前写出已追加的全部日志
+    void start();
+    void stop();
+
+    // 过载时被丢弃的日志条数
+    size_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    using BufferPtr = std::unique_ptr<LogBuffer>;
+
+    // 线程私有的缓冲区，由该线程和后台线程共享
+    struct ThreadBuffer
+    {
+        std::mutex mutex;
+        BufferPtr current;              // 正在追加的缓冲区，被后台取走后为空
+        std::vector<BufferPtr> full;    // 已写满、按顺序等待落盘的缓冲区
+    };
+
+    // 当前线程的缓冲区，首次调用时创建并登记
+    ThreadBuffer &localBuffer();
+
+    // 取走所有线程已追加的日志，并移除已退出且已取空的线程的缓冲区
+    void collect(std::vector<BufferPtr> &out);
+
+    // 后台线程主循环
+    void threadFunc();
+
+    const std::string path;
+    const size_t rollSize;
+    const int flushInterval;
+    const size_t maxPendingBuffers;
+
+    std::atomic<bool> running{false};
+    std::atomic<size_t> dropped{0};
+    std::atomic<size_t> pendingBuffers{0}; // 各线程写满待落盘的缓冲区总数
+    std::thread thread;
+
+    std::mutex mutex;                  // 保护以下成员
+    std::condition_variable cond;
+    bool wakeup = false;               // 有缓冲区写满或请求停止
+    std::vector<std::shared_ptr<ThreadBuffer>> threadBuffers; // 写过日志的线程
+    std::vector<BufferPtr> freeBuffers;  // 落盘后回收的空缓冲区
+};
@@ -4,6 +4,8 @@
 #include <atomic>
 #include <sstream>
 #include <fstream>
+#include <memory>
+#include "utils/AsyncLogging.h"
 
 const std::string logPath = "/var/log/httplog.txt";
 
@@ -34,8 +36,13 @@ public:
 
 private:
     Logger(); // 默认构造私有化
+    void appendToFile(const std::string &line);
     std::mutex logMutex;
     bool saveToFile;
+
+    // 文件日志走异步双缓冲后端，首次写入文件时才创建并启动（兼容daemon()的fork）
+    std::unique_ptr<AsyncLogging> asyncLog;
+    std::once_flag asyncLogStarted;
 };
 
 class LogStream : public std::ostringstream
@@ -48,7 +55,24 @@ private:
     LogLevel level;
 };
 
-#define LOG(level) LogStream(level)
+// 吞掉LOG表达式的结果，使三目运算符两侧类型均为void
+class LogVoidify
+{
+public:
+    void operator&(const std::ostream &) {}
+};
+
+// 编译期最低日志级别，低于该级别的LOG语句在编译时即被消除（如 -DLOG_MIN_LEVEL=INFO）
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL DEBUG
+#endif
+
+// 级别被过滤时短路，既不构造LogStream也不求值任何<<参数
+#define LOG_IS_ON(level) \
+    ((level) >= LOG_MIN_LEVEL && (level) >= Logger::instance().currentLevel.load(std::memory_order_relaxed))
+
+#define LOG(level) \
+    !LOG_IS_ON(level) ? (void)0 : LogVoidify() & LogStream(level)
 
 #define LOGTOSCREEN() Logger::instance().setLogToScreen()
 
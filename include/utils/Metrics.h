@@ -0,0 +1,148 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 按线程分片的累加计数器
+ *
+ * 每个线程固定写入自己的分片（分片独占缓存行），记录只是一次relaxed fetch_add，
+ * 不加锁、不等待；读取时把所有分片相加。分片数少于线程数时多个线程共享分片，仍然无等待。
+ */
+class Counter
+{
+public:
+    static constexpr size_t SHARDS = 16;
+
+    void add(uint64_t n = 1)
+    {
+        shards[shardIndex()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    // 各分片之和（与并发的add之间不保证瞬时一致）
+    uint64_t value() const;
+
+    // 当前线程使用的分片下标
+    static size_t shardIndex();
+
+private:
+    struct alignas(64) Shard
+    {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Shard, SHARDS> shards;
+};
+
+/**
+ * @brief 对数-线性（HDR风格）延迟直方图，单位纳秒
+ *
+ * 每个2的幂区间等分为SUB_BUCKETS个线性子桶，相对误差不超过1/SUB_BUCKETS，
+ * 覆盖0到2^MAX_EXPONENT纳秒（约18分钟），更大的值计入最后一个桶。
+ * 桶计数同样按线程分片，记录只有两次relaxed fetch_add。
+ */
+class Histogram
+{
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 3;
+    static constexpr uint64_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static constexpr unsigned MAX_EXPONENT = 40;
+    static constexpr size_t BUCKETS = SUB_BUCKETS + (MAX_EXPONENT - SUB_BUCKET_BITS) * SUB_BUCKETS;
+    static constexpr size_t SHARDS = Counter::SHARDS;
+
+    // 合并各分片后的结果
+    struct Snapshot
+    {
+        std::vector<uint64_t> buckets; // 各桶计数
+        uint64_t count = 0;
+        uint64_t sum = 0;              // 纳秒
+
+        // 小于value的记录数（value为桶边界时精确）
+        uint64_t countBelow(uint64_t value) const;
+    };
+
+    Histogram();
+
+    void record(uint64_t ns);
+
+    Snapshot snapshot() const;
+
+    // 值所在的桶
+    static size_t bucketOf(uint64_t ns);
+
+    // 桶的下界（含）
+    static uint64_t bucketLowerBound(size_t bucket);
+
+private:
+    struct alignas(64) Shard
+    {
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> buckets[BUCKETS];
+    };
+    std::unique_ptr<Shard[]> shards;
+};
+
+/**
+ * @brief 指标注册表，以Prometheus文本格式输出
+ *
+ * 指标在启动时注册（加锁，返回的引用在注册表生命周期内有效），之后的记录都是无等待的；
+ * 同名不同标签的指标归为同一族，只输出一次HELP/TYPE。
+ */
+class MetricsRegistry
+{
+public:
+    using GaugeFunction = std::function<double()>;
+
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    /**
+     * @param labels 标签，如 class="2xx"，为空表示无标签
+     */
+    Counter& counter(const std::string& name, const std::string& help, const std::string& labels = "");
+    Histogram& histogram(const std::string& name, const std::string& help, const std::string& labels = "");
+
+    // 抓取时调用fn取值的瞬时量（如队列长度）
+    void gauge(const std::string& name, const std::string& help, GaugeFunction fn,
+               const std::string& labels = "");
+
+    // 以Prometheus文本格式（0.0.4）输出全部指标；直方图以秒为单位，桶边界为2的幂纳秒
+    std::string render() const;
+
+    // Prometheus文本格式的Content-Type
+    static const char* contentType() { return "text/plain; version=0.0.4; charset=utf-8"; }
+
+private:
+    enum class Type
+    {
+        COUNTER,
+        GAUGE,
+        HISTOGRAM
+    };
+
+    struct Entry
+    {
+        Type type = Type::COUNTER;
+        std::string name;
+        std::string help;
+        std::string labels;
+        Counter* counter = nullptr;
+        Histogram* histogram = nullptr;
+        GaugeFunction gauge;
+    };
+
+    // 追加一个条目（需持有mutex）
+    Entry& addEntry(Type type, const std::string& name, const std::string& help, const std::string& labels);
+
+    mutable std::mutex mutex;        // 保护注册和输出，不涉及记录
+    std::vector<Entry> entries;      // 按注册顺序输出
+    std::deque<Counter> counters;    // deque保证元素地址不变
+    std::deque<Histogram> histograms;
+};
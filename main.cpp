@@ -1,6 +1,7 @@
 #include "http/HttpServer.h"
 #include "utils/Logger.h"
 #include <unistd.h>
+#include <algorithm>
 #include <cstdlib>
 
 int main(int argc, char* argv[]) 
@@ -18,16 +19,81 @@ int main(int argc, char* argv[])
         
         int port = 8080;
         int threads = 4;
+        int reactors = 0;   // 0为单Reactor+线程池模式，>0为多Reactor模式
         if (argc > 1) port = std::atoi(argv[1]);
         if (argc > 2) threads = std::atoi(argv[2]);
+        if (argc > 3) reactors = std::atoi(argv[3]);
+        std::string staticRoot = argc > 4 ? argv[4] : "";  // 静态文件根目录，为空则不启用
+        bool useUring = argc > 5 && std::string(argv[5]) == "uring";   // 事件源后端：epoll（默认）或uring
+        std::string upstreams = argc > 6 ? argv[6] : "";   // 反向代理的上游，逗号分隔，如 127.0.0.1:9001,unix:/tmp/b.sock
+        size_t cacheMb = argc > 7 ? std::strtoul(argv[7], nullptr, 10) : 0; // 响应缓存大小（MB），0为不启用
         
         //切换至后台运行
         //daemon(0,0);
         LOG(INFO) << "Starting server on port " << port 
-                 << " with " << threads << " worker threads";
+                 << " with " << threads << " worker threads and "
+                 << reactors << " reactor threads";
         
         // 创建并启动服务器
-        HttpServer server(port, threads);
+        ServerConfig config;
+        config.port = port;
+        config.threadNum = threads;
+        config.reactorNum = reactors;
+        config.staticRoot = staticRoot;
+        config.ioBackend = useUring ? Poller::Backend::IO_URING : Poller::Backend::EPOLL;
+        config.responseCacheBytes = cacheMb * 1024 * 1024;
+        HttpServer server(config);
+
+        // 注册路由
+        server.get("/", [](const Request&, Response& response) {
+            response.setBody("Hello World1111111111");
+        });
+        server.get("/hello/:name", [](const Request& request, Response& response) {
+            response.setHeader("Cache-Control", "public, max-age=10");
+            response.setBody("Hello ");
+            response.append(request.param("name"));
+        });
+        server.fixedRoute("GET", "/healthz", 200, "text/plain", "OK");
+        server.post("/echo", [](const Request& request, Response& response) {
+            response.setContentType("application/octet-stream");
+            response.setBody(request.body());
+        });
+        // 协程处理器：等待定时器时不占用线程，响应分段流式写出
+        server.getAsync("/tick/:count", [](AsyncContext& context) -> Task {
+            int count = std::clamp(std::atoi(std::string(context.request().param("count")).c_str()), 0, 100);
+            context.response().setContentType("text/plain");
+            for (int i = 0; i < count; ++i)
+            {
+                co_await context.sleep(100);
+                co_await context.write("tick " + std::to_string(i) + "\n");
+            }
+        });
+        if (!upstreams.empty())
+        {
+            ProxyConfig proxy;
+            for (size_t start = 0; start <= upstreams.size();)
+            {
+                size_t comma = std::min(upstreams.find(',', start), upstreams.size());
+                proxy.upstreams.push_back(upstreams.substr(start, comma - start));
+                start = comma + 1;
+            }
+            server.proxy("/proxy/*path", proxy);
+
+            // 协程中向上游发出请求，把上游的响应体长度报告给客户端
+            auto group = std::make_shared<UpstreamGroup>(proxy);
+            server.getAsync("/probe/*path", [group](AsyncContext& context) -> Task {
+                std::string target = "/";
+                target += context.request().param("path");
+                UpstreamResult result = co_await context.fetch(*group, "GET", target);
+                if (result.error != 0)
+                {
+                    context.response().setStatus(result.error);
+                    co_return;
+                }
+                context.response().setBody("upstream " + std::to_string(result.status) + ", " +
+                                           std::to_string(result.body.size()) + " bytes\n");
+            });
+        }
         server.start();
     } catch (const std::exception& e) {
         LOG(FATAL) << "Server crashed: " << e.what();
@@ -0,0 +1,32 @@
+#include "core/AdmissionController.h"
+
+AdmissionController::AdmissionController(int64_t targetNs, int64_t intervalNs)
+    : targetNs(targetNs), intervalNs(intervalNs)
+{
+}
+
+bool AdmissionController::shouldShed(int64_t sojournNs, int64_t nowNs)
+{
+    if (targetNs <= 0)
+    {
+        return false;
+    }
+
+    int64_t end = intervalEndNs.load(std::memory_order_relaxed);
+    if (nowNs >= end && intervalEndNs.compare_exchange_strong(end, nowNs + intervalNs))
+    {
+        // 区间结束：以区间内最小排队时间判定过载，本次样本作为新区间的起点。
+        // 超过一个区间没有样本说明队列早已空闲，不沿用旧的判定
+        int64_t minSojourn = minSojournNs.exchange(sojournNs, std::memory_order_relaxed);
+        overload.store(nowNs - end < intervalNs && minSojourn > targetNs, std::memory_order_relaxed);
+    }
+    else
+    {
+        int64_t current = minSojournNs.load(std::memory_order_relaxed);
+        while (sojournNs < current &&
+               !minSojournNs.compare_exchange_weak(current, sojournNs, std::memory_order_relaxed))
+        {
+        }
+    }
+    return overload.load(std::memory_order_relaxed) && sojournNs > 2 * targetNs;
+}
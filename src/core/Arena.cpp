@@ -0,0 +1,107 @@
+#include "core/Arena.h"
+#include <cstdint>
+#include <new>
+
+namespace
+{
+
+constexpr size_t kMaxCached = 64;   // 每个线程最多缓存的空闲块（512KB）
+
+struct FreeBlock
+{
+    FreeBlock* next;
+};
+
+// 线程本地的空闲块链表，线程退出时释放缓存的块
+struct FreeBlocks
+{
+    FreeBlock* head = nullptr;
+    size_t count = 0;
+
+    ~FreeBlocks()
+    {
+        while (head != nullptr)
+        {
+            FreeBlock* next = head->next;
+            ::operator delete(head);
+            head = next;
+        }
+    }
+};
+
+thread_local FreeBlocks freeBlocks;
+
+} // namespace
+
+void* Arena::do_allocate(size_t bytes, size_t alignment)
+{
+    const uintptr_t end = reinterpret_cast<uintptr_t>(limit);
+    uintptr_t start = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    if (cursor != nullptr && start <= end && end - start >= bytes)
+    {
+        cursor = reinterpret_cast<char*>(start + bytes);
+        return reinterpret_cast<void*>(start);
+    }
+
+    // 大块单独申请，挂在当前块之后，不影响当前块的剩余空间
+    if (bytes + alignment > BLOCK_SIZE / 2)
+    {
+        const size_t size = sizeof(Block) + bytes + alignment;
+        Block* block = static_cast<Block*>(::operator new(size));
+        block->size = size;
+        Block** link = cursor != nullptr ? &blocks->next : &blocks;
+        block->next = *link;
+        *link = block;
+        held += size;
+        start = (reinterpret_cast<uintptr_t>(block + 1) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        return reinterpret_cast<void*>(start);
+    }
+
+    FreeBlocks& cache = freeBlocks;
+    Block* block;
+    if (cache.head != nullptr)
+    {
+        block = reinterpret_cast<Block*>(cache.head);
+        cache.head = cache.head->next;
+        --cache.count;
+    }
+    else
+    {
+        block = static_cast<Block*>(::operator new(BLOCK_SIZE));
+    }
+    block->size = BLOCK_SIZE;
+    block->next = blocks;
+    blocks = block;
+    held += BLOCK_SIZE;
+    cursor = reinterpret_cast<char*>(block + 1);
+    limit = reinterpret_cast<char*>(block) + BLOCK_SIZE;
+    return do_allocate(bytes, alignment);
+}
+
+void Arena::reset()
+{
+    if (blocks == nullptr)
+    {
+        return;
+    }
+    FreeBlocks& cache = freeBlocks;
+    while (blocks != nullptr)
+    {
+        Block* next = blocks->next;
+        if (blocks->size == BLOCK_SIZE && cache.count < kMaxCached)
+        {
+            FreeBlock* node = reinterpret_cast<FreeBlock*>(blocks);
+            node->next = cache.head;
+            cache.head = node;
+            ++cache.count;
+        }
+        else
+        {
+            ::operator delete(blocks);
+        }
+        blocks = next;
+    }
+    cursor = nullptr;
+    limit = nullptr;
+    held = 0;
+}
@@ -0,0 +1,102 @@
+#include "core/Buffer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+void Buffer::retrieve(size_t len)
+{
+    if (len < readableBytes())
+    {
+        readerIndex += len;
+    }
+    else
+    {
+        retrieveAll();
+    }
+}
+
+void Buffer::erase(size_t offset, size_t len)
+{
+    size_t readable = readableBytes();
+    if (offset >= readable || len == 0)
+    {
+        return;
+    }
+    len = std::min(len, readable - offset);
+    char* start = buffer.data() + readerIndex + offset;
+    std::memmove(start, start + len, readable - offset - len);
+    writerIndex -= len;
+}
+
+void Buffer::append(const char* data, size_t len)
+{
+    ensureWritable(len);
+    std::memcpy(buffer.data() + writerIndex, data, len);
+    writerIndex += len;
+}
+
+void Buffer::ensureWritable(size_t len)
+{
+    if (writableBytes() >= len)
+    {
+        return;
+    }
+
+    size_t readable = readableBytes();
+    if (readerIndex + writableBytes() >= len)
+    {
+        // 头部已读空间足够：把可读数据搬到开头
+        std::memmove(buffer.data(), buffer.data() + readerIndex, readable);
+    }
+    else
+    {
+        buffer.resize(std::max(buffer.size() * 2, writerIndex + len));
+        std::memmove(buffer.data(), buffer.data() + readerIndex, readable);
+    }
+    readerIndex = 0;
+    writerIndex = readable;
+}
+
+ssize_t Buffer::readFd(int fd, int* savedErrno)
+{
+    // 先读入缓冲区剩余空间，溢出部分落到栈上临时缓冲，一次系统调用即可读取大块数据
+    char extraBuf[65536];
+    const size_t writable = writableBytes();
+    struct iovec vec[2];
+    vec[0].iov_base = buffer.data() + writerIndex;
+    vec[0].iov_len = writable;
+    vec[1].iov_base = extraBuf;
+    vec[1].iov_len = sizeof(extraBuf);
+
+    const int iovcnt = writable < sizeof(extraBuf) ? 2 : 1;
+    ssize_t n = readv(fd, vec, iovcnt);
+    if (n < 0)
+    {
+        *savedErrno = errno;
+    }
+    else if (static_cast<size_t>(n) <= writable)
+    {
+        writerIndex += n;
+    }
+    else
+    {
+        writerIndex = buffer.size();
+        append(extraBuf, n - writable);
+    }
+    return n;
+}
+
+ssize_t Buffer::writeFd(int fd, int* savedErrno, size_t maxLen, int flags)
+{
+    // MSG_NOSIGNAL：对端已关闭时返回EPIPE而不是触发SIGPIPE
+    ssize_t n = send(fd, peek(), std::min(readableBytes(), maxLen), flags | MSG_NOSIGNAL);
+    if (n < 0)
+    {
+        *savedErrno = errno;
+        return -1;
+    }
+    retrieve(static_cast<size_t>(n));
+    return n;
+}
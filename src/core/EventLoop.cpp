@@ -0,0 +1,198 @@
+#include "core/EventLoop.h"
+#include "core/IoUringPoller.h"
+#include "utils/Logger.h"
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cstring>
+#include <ctime>
+
+namespace
+{
+constexpr int64_t TIMER_TICK_MS = 10;   // 时间轮精度
+} // namespace
+
+EventLoop::EventLoop(Poller::Backend backend)
+    : poller(Poller::create(backend)), timers(TIMER_TICK_MS, nowMs())
+{
+    if (poller->backend() == Poller::Backend::IO_URING)
+    {
+        uringPoller = static_cast<IoUringPoller*>(poller.get());
+    }
+
+    wakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeupFd == -1)
+    {
+        LOG(FATAL) << "eventfd failed: " << strerror(errno);
+        throw std::runtime_error("eventfd failed");
+    }
+
+    // 唤醒fd只需读空计数器，真正的任务在doPendingFunctors中执行
+    addFd(wakeupFd, EPOLLIN, [this](uint32_t) {
+        uint64_t one;
+        ssize_t n = read(wakeupFd, &one, sizeof(one));
+        (void)n;
+    });
+}
+
+EventLoop::~EventLoop()
+{
+    close(wakeupFd);
+}
+
+void EventLoop::loop()
+{
+    threadId.store(std::this_thread::get_id(), std::memory_order_release);
+    LOG(DEBUG) << "Event loop started (thread: " << std::this_thread::get_id() << ")";
+
+    while (!quitFlag.load(std::memory_order_acquire))
+    {
+        int numEvents = poller->wait(timers.nextTimeoutMs(nowMs()));
+        pollReturnNs = nowNs();
+        if (uringPoller != nullptr)
+        {
+            uringPoller->runCompletions();
+        }
+        for (int i = 0; i < numEvents; ++i)
+        {
+            const epoll_event& event = poller->events()[i];
+            auto it = callbacks.find(event.data.fd);
+            if (it == callbacks.end())
+            {
+                continue;
+            }
+            // 持有回调的引用计数，回调内部注销自身也是安全的
+            std::shared_ptr<EventCallback> cb = it->second;
+            (*cb)(event.events);
+        }
+        timers.advance(nowMs());
+        doPendingFunctors();
+    }
+    threadId.store(std::thread::id(), std::memory_order_release);
+    LOG(DEBUG) << "Event loop exited (thread: " << std::this_thread::get_id() << ")";
+}
+
+void EventLoop::quit()
+{
+    quitFlag.store(true, std::memory_order_release);
+    if (!isInLoopThread())
+    {
+        wakeup();
+    }
+}
+
+void EventLoop::addFd(int fd, uint32_t events, EventCallback cb)
+{
+    callbacks[fd] = std::make_shared<EventCallback>(std::move(cb));
+    try
+    {
+        poller->addFd(fd, events);
+    }
+    catch (...)
+    {
+        callbacks.erase(fd);
+        throw;
+    }
+}
+
+void EventLoop::modFd(int fd, uint32_t events)
+{
+    poller->modFd(fd, events);
+}
+
+void EventLoop::removeFd(int fd)
+{
+    callbacks.erase(fd);
+    poller->removeFd(fd);
+}
+
+TimerId EventLoop::runAfter(int64_t delayMs, Functor cb)
+{
+    return timers.add(delayMs, std::move(cb));
+}
+
+TimerId EventLoop::runEvery(int64_t intervalMs, Functor cb)
+{
+    // 回调执行完后重启自己；TimerId在添加之后才知道，通过共享的槽位传给回调
+    auto self = std::make_shared<TimerId>();
+    *self = timers.add(intervalMs, [this, self, intervalMs, cb = std::move(cb)] {
+        cb();
+        timers.restart(*self, intervalMs);
+    });
+    return *self;
+}
+
+bool EventLoop::restartTimer(TimerId id, int64_t delayMs)
+{
+    return timers.restart(id, delayMs);
+}
+
+void EventLoop::cancelTimer(TimerId id)
+{
+    timers.cancel(id);
+}
+
+int64_t EventLoop::nowMs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+int64_t EventLoop::nowNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+void EventLoop::runInLoop(Functor cb)
+{
+    if (isInLoopThread())
+    {
+        cb();
+    }
+    else
+    {
+        queueInLoop(std::move(cb));
+    }
+}
+
+void EventLoop::queueInLoop(Functor cb)
+{
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        pendingFunctors.push_back(std::move(cb));
+    }
+    // 非循环线程投递，或循环线程正在执行投递任务时新增任务，都需要唤醒
+    if (!isInLoopThread() || callingPending.load(std::memory_order_acquire))
+    {
+        wakeup();
+    }
+}
+
+void EventLoop::wakeup()
+{
+    uint64_t one = 1;
+    ssize_t n = write(wakeupFd, &one, sizeof(one));
+    if (n != sizeof(one))
+    {
+        LOG(ERROR) << "EventLoop wakeup wrote " << n << " bytes";
+    }
+}
+
+void EventLoop::doPendingFunctors()
+{
+    std::vector<Functor> functors;
+    callingPending.store(true, std::memory_order_release);
+    {
+        // 交换出来再执行，缩短临界区并允许任务中再次投递
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        functors.swap(pendingFunctors);
+    }
+    for (const Functor& functor : functors)
+    {
+        functor();
+    }
+    callingPending.store(false, std::memory_order_release);
+}
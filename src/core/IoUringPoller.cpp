@@ -0,0 +1,664 @@
+#include "core/IoUringPoller.h"
+#include "utils/Logger.h"
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+// user_data高2位区分完成事件的类型，其余为 代数(30位) | 下标(32位)
+constexpr uint64_t TAG_SHIFT = 62;
+constexpr uint64_t TAG_IGNORE = 0;   // 取消、关闭、移除等不关心结果的请求
+constexpr uint64_t TAG_POLL = 1;     // 就绪通知
+constexpr uint64_t TAG_OP = 2;       // 完成式操作
+constexpr uint64_t GENERATION_MASK = (1ull << 30) - 1;
+
+constexpr uint16_t BUFFER_GROUP = 0;
+
+uint64_t encode(uint64_t tag, uint32_t generation, uint32_t index)
+{
+    return (tag << TAG_SHIFT) | ((generation & GENERATION_MASK) << 32) | index;
+}
+
+uint64_t tagOf(uint64_t userData) { return userData >> TAG_SHIFT; }
+uint32_t generationOf(uint64_t userData) { return static_cast<uint32_t>((userData >> 32) & GENERATION_MASK); }
+uint32_t indexOf(uint64_t userData) { return static_cast<uint32_t>(userData); }
+
+int ioUringSetup(unsigned entries, io_uring_params* params)
+{
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags, void* arg, size_t argSize)
+{
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize));
+}
+
+int ioUringRegister(int fd, unsigned opcode, void* arg, unsigned count)
+{
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+template <typename T>
+T loadAcquire(const T* p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+template <typename T>
+void storeRelease(T* p, T value)
+{
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+[[noreturn]] void unsupported(const char* what)
+{
+    throw std::runtime_error(std::string("io_uring unavailable: ") + what);
+}
+} // namespace
+
+IoUringPoller::IoUringPoller()
+{
+    // 完成队列放大到提交队列的4倍，减少溢出；COOP_TASKRUN避免完成事件打断循环线程
+    io_uring_params params{};
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_COOP_TASKRUN;
+    params.cq_entries = RING_ENTRIES * 4;
+    ringFd = ioUringSetup(RING_ENTRIES, &params);
+    if (ringFd < 0 && errno == EINVAL)
+    {
+        params = io_uring_params{};
+        params.flags = IORING_SETUP_CQSIZE;
+        params.cq_entries = RING_ENTRIES * 4;
+        ringFd = ioUringSetup(RING_ENTRIES, &params);
+    }
+    if (ringFd < 0)
+    {
+        unsupported(strerror(errno));
+    }
+
+    const uint32_t required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+    if ((params.features & required) != required)
+    {
+        ::close(ringFd);
+        unsupported("kernel lacks SINGLE_MMAP/NODROP/EXT_ARG");
+    }
+
+    // 提交队列和完成队列共用一次映射
+    ringSize = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    ringPtr = mmap(nullptr, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   ringFd, IORING_OFF_SQ_RING);
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqePtr = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ringFd, IORING_OFF_SQES);
+    if (ringPtr == MAP_FAILED || sqePtr == MAP_FAILED)
+    {
+        if (ringPtr != MAP_FAILED)
+        {
+            munmap(ringPtr, ringSize);
+        }
+        ::close(ringFd);
+        unsupported("mmap failed");
+    }
+    sqes = static_cast<io_uring_sqe*>(sqePtr);
+
+    char* base = static_cast<char*>(ringPtr);
+    sqHead = reinterpret_cast<unsigned*>(base + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned*>(base + params.sq_off.tail);
+    sqArray = reinterpret_cast<unsigned*>(base + params.sq_off.array);
+    sqMask = *reinterpret_cast<unsigned*>(base + params.sq_off.ring_mask);
+    sqEntries = params.sq_entries;
+    sqLocalTail = *sqTail;
+    cqHead = reinterpret_cast<unsigned*>(base + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned*>(base + params.cq_off.tail);
+    cqMask = *reinterpret_cast<unsigned*>(base + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(base + params.cq_off.cqes);
+
+    // recv缓冲由内核在数据到达时挑选，连接不必各自预留读缓冲
+    bufferPool = std::make_unique<char[]>(static_cast<size_t>(BUFFER_COUNT) * BUFFER_SIZE);
+    if (!setupBufferRing())
+    {
+        // 缓冲环不可用时改用IORING_OP_PROVIDE_BUFFERS提供同一组缓冲
+        io_uring_sqe sqe{};
+        sqe.opcode = IORING_OP_PROVIDE_BUFFERS;
+        sqe.fd = static_cast<int32_t>(BUFFER_COUNT);
+        sqe.addr = reinterpret_cast<uint64_t>(bufferPool.get());
+        sqe.len = BUFFER_SIZE;
+        sqe.buf_group = BUFFER_GROUP;
+        sqe.user_data = encode(TAG_IGNORE, 0, 0);
+        push(sqe);
+        submitLocked();
+    }
+
+    LOG(INFO) << "io_uring instance created (fd: " << ringFd << ", sq: " << params.sq_entries
+              << ", cq: " << params.cq_entries << ", "
+              << (bufRing != nullptr ? "buffer ring" : "provided buffers") << ")";
+}
+
+IoUringPoller::~IoUringPoller()
+{
+    if (bufRing != nullptr)
+    {
+        munmap(bufRing, bufRingSize);
+    }
+    munmap(sqes, sqesSize);
+    munmap(ringPtr, ringSize);
+    ::close(ringFd);
+}
+
+bool IoUringPoller::setupBufferRing()
+{
+    bufRingSize = BUFFER_COUNT * sizeof(io_uring_buf);
+    void* ring = mmap(nullptr, bufRingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED)
+    {
+        return false;
+    }
+    bufRing = static_cast<io_uring_buf_ring*>(ring);
+
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<uint64_t>(bufRing);
+    reg.ring_entries = BUFFER_COUNT;
+    reg.bgid = BUFFER_GROUP;
+    if (ioUringRegister(ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+    {
+        LOG(INFO) << "io_uring buffer ring unavailable: " << strerror(errno);
+        munmap(bufRing, bufRingSize);
+        bufRing = nullptr;
+        return false;
+    }
+    for (unsigned bid = 0; bid < BUFFER_COUNT; ++bid)
+    {
+        recycleBuffer(static_cast<uint16_t>(bid));
+    }
+
+    // 注册成功不代表可用（部分内核上从环中选不到缓冲），用一个socketpair实际收一次数据确认
+    int pair[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, pair) < 0)
+    {
+        return true;
+    }
+    int32_t res = -1;
+    uint32_t flags = 0;
+    if (::write(pair[1], "x", 1) == 1)
+    {
+        io_uring_sqe sqe{};
+        sqe.opcode = IORING_OP_RECV;
+        sqe.fd = pair[0];
+        sqe.flags = IOSQE_BUFFER_SELECT;
+        sqe.buf_group = BUFFER_GROUP;
+        sqe.user_data = encode(TAG_IGNORE, 0, 0);
+        push(sqe);
+        pendingSubmit = 0;
+        if (ioUringEnter(ringFd, 1, 1, IORING_ENTER_GETEVENTS, nullptr, 0) == 1)
+        {
+            const io_uring_cqe& cqe = cqes[*cqHead & cqMask];
+            res = cqe.res;
+            flags = cqe.flags;
+            storeRelease(cqHead, *cqHead + 1);
+        }
+    }
+    ::close(pair[0]);
+    ::close(pair[1]);
+
+    if (res == 1 && (flags & IORING_CQE_F_BUFFER))
+    {
+        recycleBuffer(static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT));
+        return true;
+    }
+    LOG(INFO) << "io_uring buffer ring not functional (recv: " << res << "), using provided buffers";
+    io_uring_buf_reg unreg{};
+    unreg.bgid = BUFFER_GROUP;
+    ioUringRegister(ringFd, IORING_UNREGISTER_PBUF_RING, &unreg, 1);
+    munmap(bufRing, bufRingSize);
+    bufRing = nullptr;
+    return false;
+}
+
+void IoUringPoller::push(const io_uring_sqe& sqe)
+{
+    // 提交队列已满时先提交已有的请求
+    if (sqLocalTail - loadAcquire(sqHead) >= sqEntries)
+    {
+        submitLocked();
+    }
+    unsigned index = sqLocalTail & sqMask;
+    sqes[index] = sqe;
+    sqArray[index] = index;
+    ++sqLocalTail;
+    storeRelease(sqTail, sqLocalTail);
+    ++pendingSubmit;
+
+    // 循环线程正阻塞在内核中，不会很快提交，由调用线程直接提交
+    if (waiting)
+    {
+        submitLocked();
+    }
+}
+
+void IoUringPoller::submitLocked()
+{
+    while (pendingSubmit > 0)
+    {
+        int n = ioUringEnter(ringFd, pendingSubmit, 0, 0, nullptr, 0);
+        ++counters.enterCalls;
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EBUSY)
+            {
+                // 完成队列积压，内核暂时不接受新请求；等下一次wait处理完成事件后再提交
+                return;
+            }
+            LOG(ERROR) << "io_uring_enter submit failed: " << strerror(errno);
+            return;
+        }
+        counters.submitted += static_cast<uint64_t>(n);
+        pendingSubmit -= std::min(pendingSubmit, static_cast<unsigned>(n));
+        if (n == 0)
+        {
+            // 其他线程已代为提交
+            pendingSubmit = 0;
+        }
+    }
+}
+
+void IoUringPoller::armPoll(int fd, FdState& state)
+{
+    io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_POLL_ADD;
+    sqe.fd = fd;
+    sqe.poll32_events = state.events & ~static_cast<uint32_t>(EPOLLONESHOT);
+    if (!(state.events & EPOLLONESHOT))
+    {
+        sqe.len = IORING_POLL_ADD_MULTI;
+    }
+    sqe.user_data = encode(TAG_POLL, state.generation, static_cast<uint32_t>(fd));
+    push(sqe);
+    state.armed = true;
+}
+
+void IoUringPoller::addFd(int fd, uint32_t events)
+{
+    std::lock_guard<std::mutex> lock(sqMutex);
+    if (static_cast<size_t>(fd) >= fdStates.size())
+    {
+        fdStates.resize(std::max(static_cast<size_t>(fd) + 1, fdStates.size() * 2));
+    }
+    FdState& state = fdStates[fd];
+    if (state.registered)
+    {
+        LOG(ERROR) << "Failed to add fd " << fd << ": already registered";
+        throw std::runtime_error("io_uring poll add failed");
+    }
+    state.registered = true;
+    state.events = events;
+    ++state.generation;
+    armPoll(fd, state);
+    LOG(DEBUG) << "Added fd " << fd << " to io_uring with events 0x" << std::hex << events;
+}
+
+void IoUringPoller::modFd(int fd, uint32_t events)
+{
+    std::lock_guard<std::mutex> lock(sqMutex);
+    if (static_cast<size_t>(fd) >= fdStates.size() || !fdStates[fd].registered)
+    {
+        LOG(ERROR) << "Failed to modify fd " << fd << ": not registered";
+        throw std::runtime_error("io_uring poll mod failed");
+    }
+    FdState& state = fdStates[fd];
+
+    // 撤销旧的请求（已触发的单次请求无需撤销），新请求换用新的代数，旧请求的迟到事件被忽略
+    if (state.armed)
+    {
+        io_uring_sqe sqe{};
+        sqe.opcode = IORING_OP_POLL_REMOVE;
+        sqe.addr = encode(TAG_POLL, state.generation, static_cast<uint32_t>(fd));
+        sqe.user_data = encode(TAG_IGNORE, 0, 0);
+        push(sqe);
+    }
+    state.events = events;
+    ++state.generation;
+    armPoll(fd, state);
+}
+
+void IoUringPoller::removeFd(int fd)
+{
+    std::lock_guard<std::mutex> lock(sqMutex);
+    if (static_cast<size_t>(fd) >= fdStates.size() || !fdStates[fd].registered)
+    {
+        LOG(ERROR) << "Failed to remove fd " << fd << ": not registered";
+        throw std::runtime_error("io_uring poll remove failed");
+    }
+    FdState& state = fdStates[fd];
+    if (state.armed)
+    {
+        io_uring_sqe sqe{};
+        sqe.opcode = IORING_OP_POLL_REMOVE;
+        sqe.addr = encode(TAG_POLL, state.generation, static_cast<uint32_t>(fd));
+        sqe.user_data = encode(TAG_IGNORE, 0, 0);
+        push(sqe);
+    }
+    state.registered = false;
+    state.armed = false;
+    ++state.generation;
+    LOG(DEBUG) << "Removed fd " << fd << " from io_uring";
+}
+
+int IoUringPoller::wait(int timeoutMs)
+{
+    // 上一轮的完成事件尚未执行时先执行，保证不丢失
+    runCompletions();
+    readyEvents.clear();
+
+    // 1.提交本轮积累的请求并等待完成事件，两者合并为一次io_uring_enter
+    std::unique_lock<std::mutex> lock(sqMutex);
+    unsigned toSubmit = pendingSubmit;
+    pendingSubmit = 0;
+    bool block = timeoutMs != 0 && loadAcquire(cqTail) == *cqHead;
+    if (toSubmit > 0 || block)
+    {
+        waiting = block;
+        lock.unlock();
+
+        __kernel_timespec ts{};
+        io_uring_getevents_arg arg{};
+        if (block && timeoutMs > 0)
+        {
+            ts.tv_sec = timeoutMs / 1000;
+            ts.tv_nsec = static_cast<long long>(timeoutMs % 1000) * 1000000;
+            arg.ts = reinterpret_cast<uint64_t>(&ts);
+        }
+        int n = ioUringEnter(ringFd, toSubmit, block ? 1 : 0,
+                             IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+        int savedErrno = errno;
+
+        lock.lock();
+        waiting = false;
+        ++counters.enterCalls;
+        if (n >= 0)
+        {
+            // 有提交时返回值为提交数，个别请求未被接受时留到下一轮
+            counters.submitted += static_cast<uint64_t>(n);
+            if (static_cast<unsigned>(n) < toSubmit)
+            {
+                pendingSubmit += toSubmit - static_cast<unsigned>(n);
+            }
+        }
+        else if (savedErrno == EAGAIN || savedErrno == EBUSY)
+        {
+            // 完成队列积压，请求未被接受，处理完本轮完成事件后重试
+            pendingSubmit += toSubmit;
+        }
+        else if (savedErrno != EINTR && savedErrno != ETIME)
+        {
+            LOG(ERROR) << "io_uring_enter failed: " << strerror(savedErrno);
+            throw std::runtime_error("io_uring_enter failed");
+        }
+    }
+    lock.unlock();
+
+    // 2.取出全部完成事件：就绪通知转为epoll_event，完成式操作留给runCompletions执行
+    unsigned head = *cqHead;
+    unsigned tail = loadAcquire(cqTail);
+    counters.completed += tail - head;
+    for (; head != tail; ++head)
+    {
+        const io_uring_cqe& cqe = cqes[head & cqMask];
+        if (tagOf(cqe.user_data) == TAG_OP)
+        {
+            harvested.push_back(Cqe{cqe.user_data, cqe.res, cqe.flags});
+        }
+        else
+        {
+            dispatch(cqe.user_data, cqe.res, cqe.flags);
+        }
+    }
+    storeRelease(cqHead, head);
+    return static_cast<int>(readyEvents.size());
+}
+
+void IoUringPoller::runCompletions()
+{
+    // 回调中可以继续提交新请求，新请求的完成事件在下一轮wait中取出
+    for (size_t i = 0; i < harvested.size(); ++i)
+    {
+        dispatch(harvested[i].userData, harvested[i].res, harvested[i].flags);
+    }
+    harvested.clear();
+}
+
+void IoUringPoller::dispatch(uint64_t userData, int32_t res, uint32_t flags)
+{
+    uint64_t tag = tagOf(userData);
+    if (tag == TAG_POLL)
+    {
+        int fd = static_cast<int>(indexOf(userData));
+        std::lock_guard<std::mutex> lock(sqMutex);
+        if (static_cast<size_t>(fd) >= fdStates.size())
+        {
+            return;
+        }
+        FdState& state = fdStates[fd];
+        if (!state.registered || (state.generation & GENERATION_MASK) != generationOf(userData))
+        {
+            return; // 已被修改或移除的旧请求
+        }
+        if (!(flags & IORING_CQE_F_MORE))
+        {
+            state.armed = false;
+            // multishot请求被内核终止（如完成队列溢出），重新提交以保持注册
+            if (!(state.events & EPOLLONESHOT))
+            {
+                armPoll(fd, state);
+            }
+        }
+        if (res > 0)
+        {
+            epoll_event event{};
+            event.events = static_cast<uint32_t>(res);
+            event.data.fd = fd;
+            readyEvents.push_back(event);
+        }
+        return;
+    }
+
+    if (tag != TAG_OP)
+    {
+        return;
+    }
+    uint32_t index = indexOf(userData);
+    if (index >= ops.size() || !ops[index].active ||
+        (ops[index].generation & GENERATION_MASK) != generationOf(userData))
+    {
+        return;
+    }
+    // deque在尾部追加时不移动已有元素，回调中提交新操作不影响op引用
+    Op& op = ops[index];
+    bool resubmit = op.handler(res, flags);
+    if (flags & IORING_CQE_F_MORE)
+    {
+        return; // multishot操作还会产生后续事件
+    }
+    if (resubmit)
+    {
+        if (!op.cancelled)
+        {
+            std::lock_guard<std::mutex> lock(sqMutex);
+            push(op.sqe);
+            return;
+        }
+        // 取消请求生效前multishot恰好结束：补发取消结果，保证调用方总能看到结束事件
+        op.handler(-ECANCELED, 0);
+    }
+    op.active = false;
+    op.cancelled = false;
+    op.handler = nullptr;
+    ++op.generation;
+    freeOps.push_back(index);
+}
+
+uint64_t IoUringPoller::submitOp(const io_uring_sqe& sqe, Completion handler)
+{
+    uint32_t index;
+    if (!freeOps.empty())
+    {
+        index = freeOps.back();
+        freeOps.pop_back();
+    }
+    else
+    {
+        index = static_cast<uint32_t>(ops.size());
+        ops.emplace_back();
+    }
+    Op& op = ops[index];
+    op.active = true;
+    op.handler = std::move(handler);
+    op.sqe = sqe;
+    op.sqe.user_data = encode(TAG_OP, op.generation, index);
+
+    std::lock_guard<std::mutex> lock(sqMutex);
+    push(op.sqe);
+    return op.sqe.user_data;
+}
+
+void IoUringPoller::recycleBuffer(uint16_t bid)
+{
+    if (bufRing == nullptr)
+    {
+        io_uring_sqe sqe{};
+        sqe.opcode = IORING_OP_PROVIDE_BUFFERS;
+        sqe.fd = 1;
+        sqe.addr = reinterpret_cast<uint64_t>(bufferPool.get() + static_cast<size_t>(bid) * BUFFER_SIZE);
+        sqe.len = BUFFER_SIZE;
+        sqe.buf_group = BUFFER_GROUP;
+        sqe.off = bid;
+        sqe.user_data = encode(TAG_IGNORE, 0, 0);
+        std::lock_guard<std::mutex> lock(sqMutex);
+        push(sqe);
+        return;
+    }
+    io_uring_buf& buf = bufRing->bufs[bufTail & (BUFFER_COUNT - 1)];
+    buf.addr = reinterpret_cast<uint64_t>(bufferPool.get() + static_cast<size_t>(bid) * BUFFER_SIZE);
+    buf.len = BUFFER_SIZE;
+    buf.bid = bid;
+    ++bufTail;
+    storeRelease(&bufRing->tail, bufTail);
+}
+
+uint64_t IoUringPoller::acceptMultishot(int listenFd, AcceptCallback cb)
+{
+    io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_ACCEPT;
+    sqe.fd = listenFd;
+    sqe.ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe.accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    return submitOp(sqe, [cb = std::move(cb)](int32_t res, uint32_t) {
+        cb(res);
+        // 内核终止了multishot（如fd耗尽）时重新提交，被取消或监听fd失效时结束
+        return res != -ECANCELED && res != -EBADF && res != -EINVAL;
+    });
+}
+
+uint64_t IoUringPoller::recvMultishot(int fd, RecvCallback cb)
+{
+    io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_RECV;
+    sqe.fd = fd;
+    sqe.flags = IOSQE_BUFFER_SELECT;
+    sqe.buf_group = BUFFER_GROUP;
+    sqe.ioprio = IORING_RECV_MULTISHOT;
+    return submitOp(sqe, [this, cb = std::move(cb)](int32_t res, uint32_t flags) {
+        if (res > 0 && (flags & IORING_CQE_F_BUFFER))
+        {
+            uint16_t bid = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+            cb(bufferPool.get() + static_cast<size_t>(bid) * BUFFER_SIZE, res);
+            recycleBuffer(bid);
+            return true;
+        }
+        if (res == -ENOBUFS)
+        {
+            // 缓冲暂时耗尽，本轮处理完后已有缓冲归还，重新提交即可
+            return true;
+        }
+        cb(nullptr, res);
+        return false;
+    });
+}
+
+uint64_t IoUringPoller::send(int fd, const void* data, size_t len, int flags, SendCallback cb)
+{
+    io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_SEND;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<uint64_t>(data);
+    sqe.len = static_cast<uint32_t>(std::min<size_t>(len, UINT32_MAX));
+    sqe.msg_flags = static_cast<uint32_t>(flags | MSG_NOSIGNAL);
+    return submitOp(sqe, [cb = std::move(cb)](int32_t res, uint32_t) {
+        cb(res);
+        return false;
+    });
+}
+
+uint64_t IoUringPoller::pollOnce(int fd, uint32_t events, PollCallback cb)
+{
+    io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_POLL_ADD;
+    sqe.fd = fd;
+    sqe.poll32_events = events;
+    return submitOp(sqe, [cb = std::move(cb)](int32_t res, uint32_t) {
+        cb(res < 0 ? static_cast<uint32_t>(EPOLLERR) : static_cast<uint32_t>(res));
+        return false;
+    });
+}
+
+void IoUringPoller::cancel(uint64_t op)
+{
+    uint32_t index = indexOf(op);
+    if (tagOf(op) != TAG_OP || index >= ops.size() || !ops[index].active ||
+        (ops[index].generation & GENERATION_MASK) != generationOf(op))
+    {
+        return;
+    }
+    ops[index].cancelled = true;
+
+    io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_ASYNC_CANCEL;
+    sqe.addr = op;
+    sqe.user_data = encode(TAG_IGNORE, 0, 0);
+    std::lock_guard<std::mutex> lock(sqMutex);
+    push(sqe);
+}
+
+void IoUringPoller::close(int fd)
+{
+    // 取消与关闭以硬链接提交：取消失败（无进行中的操作）也不影响关闭
+    io_uring_sqe cancelSqe{};
+    cancelSqe.opcode = IORING_OP_ASYNC_CANCEL;
+    cancelSqe.fd = fd;
+    cancelSqe.cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+    cancelSqe.flags = IOSQE_IO_HARDLINK;
+    cancelSqe.user_data = encode(TAG_IGNORE, 0, 0);
+
+    io_uring_sqe closeSqe{};
+    closeSqe.opcode = IORING_OP_CLOSE;
+    closeSqe.fd = fd;
+    closeSqe.user_data = encode(TAG_IGNORE, 0, 0);
+
+    std::lock_guard<std::mutex> lock(sqMutex);
+    // 两个请求必须位于同一批提交中，链接才会生效
+    if (sqEntries - (sqLocalTail - loadAcquire(sqHead)) < 2)
+    {
+        submitLocked();
+    }
+    push(cancelSqe);
+    push(closeSqe);
+}
@@ -0,0 +1,34 @@
+#include "core/Poller.h"
+#include "core/Epoll.h"
+#include "core/IoUringPoller.h"
+#include "utils/Logger.h"
+#include <exception>
+
+std::unique_ptr<Poller> Poller::create(Backend preferred)
+{
+    if (preferred == Backend::IO_URING)
+    {
+        try
+        {
+            return std::make_unique<IoUringPoller>();
+        }
+        catch (const std::exception& e)
+        {
+            // 旧内核、seccomp或io_uring_disabled都会走到这里
+            LOG(WARNING) << e.what() << ", falling back to epoll";
+        }
+    }
+    return std::make_unique<Epoll>();
+}
+
+const char* Poller::backendName(Backend backend)
+{
+    switch (backend)
+    {
+        case Backend::IO_URING:
+            return "io_uring";
+        case Backend::EPOLL:
+        default:
+            return "epoll";
+    }
+}
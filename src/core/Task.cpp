@@ -0,0 +1,77 @@
+#include "core/Task.h"
+#include <new>
+
+namespace
+{
+
+constexpr size_t kGranularity = 64;     // 分级粒度
+constexpr size_t kClassCount = 32;      // 分级数，最大2KB
+constexpr size_t kMaxCached = 256;      // 每级最多缓存的空闲帧
+
+struct FreeFrame
+{
+    FreeFrame* next;
+};
+
+// 线程本地的空闲链表，线程退出时释放缓存的帧
+struct FreeLists
+{
+    FreeFrame* heads[kClassCount] = {};
+    size_t counts[kClassCount] = {};
+
+    ~FreeLists()
+    {
+        for (FreeFrame* head : heads)
+        {
+            while (head != nullptr)
+            {
+                FreeFrame* next = head->next;
+                ::operator delete(head);
+                head = next;
+            }
+        }
+    }
+};
+
+thread_local FreeLists freeLists;
+
+// 大小所属的分级，超过最大分级时返回kClassCount
+size_t sizeClass(size_t size)
+{
+    return size == 0 ? 0 : (size - 1) / kGranularity;
+}
+
+} // namespace
+
+void* FramePool::allocate(size_t size)
+{
+    const size_t index = sizeClass(size);
+    if (index >= kClassCount)
+    {
+        return ::operator new(size);
+    }
+    FreeLists& lists = freeLists;
+    if (FreeFrame* frame = lists.heads[index])
+    {
+        lists.heads[index] = frame->next;
+        --lists.counts[index];
+        return frame;
+    }
+    // 按分级的上界分配，释放后可以被同一级的任何帧复用
+    return ::operator new((index + 1) * kGranularity);
+}
+
+void FramePool::deallocate(void* frame, size_t size) noexcept
+{
+    const size_t index = sizeClass(size);
+    FreeLists& lists = freeLists;
+    if (index >= kClassCount || lists.counts[index] >= kMaxCached)
+    {
+        ::operator delete(frame);
+        return;
+    }
+    FreeFrame* node = static_cast<FreeFrame*>(frame);
+    node->next = lists.heads[index];
+    lists.heads[index] = node;
+    ++lists.counts[index];
+}
@@ -1,97 +1,566 @@
 #include "core/ThreadPool.h"
+#include "core/WorkStealingDeque.h"
 #include "utils/Logger.h"
 
-ThreadPool::ThreadPool(size_t numThreads) 
+namespace
 {
-    LOG(INFO) << "Initializing thread pool with " << numThreads << " workers";
-    
+constexpr int SPIN_ROUNDS = 64;   // 休眠前自旋查找任务的轮数
+
+// 自旋等待时提示CPU降低功耗并让出流水线
+inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// 线程局部的xorshift随机数，用于选择窃取目标
+inline uint32_t nextRandom()
+{
+    thread_local uint32_t state =
+        static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+} // namespace
+
+// 工作窃取模式下的任务节点，同时作为收件箱的侵入式链表节点
+struct ThreadPool::Task
+{
+    std::function<void()> fn;
+    std::function<void()> onDropped;
+    bool counted = false;                 // 是否占用了排队名额（外部提交）
+    std::atomic<Task*> next{nullptr};
+};
+
+/**
+ * @brief 工作窃取模式下每个工作线程的状态
+ *
+ * deque只由本线程push/pop，其他线程steal；
+ * inbox是Vyukov无锁多生产者单消费者队列，接收来自非工作线程（如Reactor）的提交
+ */
+struct ThreadPool::Worker
+{
+    Worker() : inboxHead(&stub), inboxTail(&stub) {}
+
+    // 任意线程调用：投递到收件箱
+    void pushInbox(Task* task)
+    {
+        inboxSize.fetch_add(1, std::memory_order_relaxed);
+        pushNode(task);
+    }
+
+    // 仅所有者调用：从收件箱取出一个任务
+    Task* popInbox()
+    {
+        Task* tail = inboxTail;
+        Task* next = tail->next.load(std::memory_order_acquire);
+        if (tail == &stub)
+        {
+            if (next == nullptr)
+            {
+                return nullptr;
+            }
+            inboxTail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr)
+        {
+            inboxTail = next;
+            inboxSize.fetch_sub(1, std::memory_order_relaxed);
+            return tail;
+        }
+        // 生产者正在链接新节点，稍后再取
+        if (tail != inboxHead.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+        // tail是最后一个节点：重新挂上stub后才能安全取出tail
+        pushNode(&stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next != nullptr)
+        {
+            inboxTail = next;
+            inboxSize.fetch_sub(1, std::memory_order_relaxed);
+            return tail;
+        }
+        return nullptr;
+    }
+
+    void pushNode(Task* node)
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Task* prev = inboxHead.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    WorkStealingDeque<Task> deque;          // 本地双端队列
+    alignas(64) std::atomic<Task*> inboxHead; // 收件箱头（生产者端）
+    Task* inboxTail;                        // 收件箱尾（消费者端）
+    Task stub;                              // 收件箱哨兵节点
+    std::atomic<size_t> inboxSize{0};       // 收件箱近似长度
+
+    std::atomic<bool> busy{false};          // 是否正在执行任务
+    std::atomic<bool> sleeping{false};      // 是否已休眠
+    std::mutex parkMutex;                   // 休眠/唤醒互斥锁
+    std::condition_variable parkCond;       // 休眠条件变量
+    bool notified = false;                  // 收到唤醒（受parkMutex保护）
+};
+
+namespace
+{
+// 当前线程所属的线程池及工作线程序号（非工作线程为空）
+thread_local ThreadPool* currentPool = nullptr;
+thread_local size_t currentWorkerIndex = 0;
+} // namespace
+
+ThreadPool::ThreadPool(size_t numThreads, Mode mode, size_t capacity, OverflowPolicy policy)
+    : mode(mode), maxQueued(capacity), policy(policy)
+{
+    LOG(INFO) << "Initializing thread pool with " << numThreads << " workers ("
+              << (mode == Mode::WORK_STEALING ? "work-stealing" : "shared queue") << ", queue capacity "
+              << (capacity == 0 ? std::string("unbounded") : std::to_string(capacity)) << ")";
+
+    if (mode == Mode::WORK_STEALING)
+    {
+        // 先创建全部工作线程状态，再启动线程，窃取时可安全遍历
+        for (size_t i = 0; i < numThreads; ++i)
+        {
+            stealingWorkers.emplace_back(new Worker);
+        }
+        for (size_t i = 0; i < numThreads; ++i)
+        {
+            workers.emplace_back([this, i] { workStealingLoop(i); });
+        }
+        return;
+    }
+
     // 创建一批工作线程
-    for (size_t i = 0; i < numThreads; ++i) 
+    for (size_t i = 0; i < numThreads; ++i)
     {
-        workers.emplace_back([this] {
-            // 输出线程启动信息
-            LOG(DEBUG) << "Worker thread started (ID: " 
-                      << std::this_thread::get_id() << ")";
-            
-            // 持续检查任务队列，如果有任务就执行
-            while (true) 
+        workers.emplace_back([this] { sharedQueueLoop(); });
+    }
+}
+
+void ThreadPool::sharedQueueLoop()
+{
+    // 输出线程启动信息
+    LOG(DEBUG) << "Worker thread started (ID: "
+              << std::this_thread::get_id() << ")";
+    currentPool = this;
+
+    // 持续检查任务队列，如果有任务就执行
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+
+            // 等待条件：停止或队列非空
+            condition.wait(lock, [this] {
+                return stop.load() || !tasks.empty();
+            });
+
+            // 终止条件：停止且队列为空
+            if (stop && tasks.empty())
             {
-                std::function<void()> task;
-                {
-                    std::unique_lock<std::mutex> lock(queueMutex);
-                    
-                    // 等待条件：停止或队列非空
-                    condition.wait(lock, [this] {
-                        return stop.load() || !tasks.empty();
-                    });
-                    
-                    // 终止条件：停止且队列为空
-                    if (stop && tasks.empty()) 
-                    {
-                        LOG(DEBUG) << "Worker thread exiting (ID: " 
-                                  << std::this_thread::get_id() << ")";
-                        return;
-                    }
-                    
-                    // 获取队列第一个任务
-                    task = std::move(tasks.front());
-                    tasks.pop();
-                }
-                
-                // 执行任务并记录日志
-                LOG(DEBUG) << "Executing task (Worker ID: " 
+                LOG(DEBUG) << "Worker thread exiting (ID: "
                           << std::this_thread::get_id() << ")";
-                try {
-                    task();
-                } catch (const std::exception& e) {
-                    LOG(ERROR) << "Task failed: " << e.what();
-                }
+                return;
+            }
+
+            // 获取队列第一个任务
+            task = std::move(tasks.front().fn);
+            tasks.pop();
+        }
+        if (blockedSubmitters.load() > 0)
+        {
+            spaceCondition.notify_one();
+        }
+
+        runTask(task);
+    }
+}
+
+void ThreadPool::workStealingLoop(size_t index)
+{
+    LOG(DEBUG) << "Worker thread started (ID: "
+              << std::this_thread::get_id() << ", work-stealing #" << index << ")";
+    currentPool = this;
+    currentWorkerIndex = index;
+    Worker& self = *stealingWorkers[index];
+
+    while (true)
+    {
+        // 1.先自旋查找任务，避免短暂空闲就进入futex休眠
+        Task* task = nullptr;
+        for (int round = 0; round < SPIN_ROUNDS && task == nullptr; ++round)
+        {
+            task = findTask(self);
+            if (task == nullptr)
+            {
+                cpuRelax();
             }
-        });
+        }
+
+        if (task != nullptr)
+        {
+            if (task->counted)
+            {
+                releaseSlot();
+            }
+            self.busy.store(true, std::memory_order_relaxed);
+            runTask(task->fn);
+            delete task;
+            self.busy.store(false, std::memory_order_relaxed);
+            continue;
+        }
+
+        // 2.终止条件：停止且自己的收件箱与所有本地队列均为空
+        if (stop.load(std::memory_order_acquire) &&
+            self.inboxSize.load(std::memory_order_acquire) == 0 && !hasPendingTasks())
+        {
+            LOG(DEBUG) << "Worker thread exiting (ID: "
+                      << std::this_thread::get_id() << ")";
+            return;
+        }
+
+        // 3.休眠：先声明sleeping再复查队列，与提交方的“先入队再检查sleeping”构成Dekker式握手
+        std::unique_lock<std::mutex> lock(self.parkMutex);
+        self.sleeping.store(true, std::memory_order_seq_cst);
+        if (!stop.load() && self.inboxSize.load(std::memory_order_seq_cst) == 0 && !hasPendingTasks())
+        {
+            self.parkCond.wait(lock, [this, &self] { return self.notified || stop.load(); });
+        }
+        self.notified = false;
+        self.sleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+ThreadPool::Task* ThreadPool::findTask(Worker& self)
+{
+    if (Task* task = self.deque.pop())
+    {
+        return task;
+    }
+
+    // 把收件箱整体搬进本地队列，使其可以被空闲线程窃取
+    if (Task* first = self.popInbox())
+    {
+        bool movedAny = false;
+        while (Task* more = self.popInbox())
+        {
+            self.deque.push(more);
+            movedAny = true;
+        }
+        if (movedAny)
+        {
+            wakeOne();
+        }
+        return first;
+    }
+
+    // 从随机起点开始窃取其他线程的队列
+    size_t n = stealingWorkers.size();
+    size_t start = nextRandom() % n;
+    for (size_t i = 0; i < n; ++i)
+    {
+        Worker& victim = *stealingWorkers[(start + i) % n];
+        if (&victim == &self)
+        {
+            continue;
+        }
+        if (Task* task = victim.deque.steal())
+        {
+            return task;
+        }
     }
+    return nullptr;
 }
 
-ThreadPool::~ThreadPool() 
+bool ThreadPool::hasPendingTasks() const
+{
+    for (const auto& worker : stealingWorkers)
+    {
+        if (worker->deque.sizeApprox() > 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::wakeOne()
+{
+    // 与工作线程休眠前的seq_cst写入配对，保证不会丢失唤醒
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (const auto& worker : stealingWorkers)
+    {
+        if (worker->sleeping.load(std::memory_order_relaxed))
+        {
+            {
+                std::lock_guard<std::mutex> lock(worker->parkMutex);
+                worker->notified = true;
+            }
+            worker->parkCond.notify_one();
+            return;
+        }
+    }
+}
+
+void ThreadPool::runTask(std::function<void()>& task)
+{
+    // 执行任务并记录日志
+    LOG(DEBUG) << "Executing task (Worker ID: "
+              << std::this_thread::get_id() << ")";
+    try {
+        task();
+    } catch (const std::exception& e) {
+        LOG(ERROR) << "Task failed: " << e.what();
+    }
+}
+
+ThreadPool::~ThreadPool()
 {
     LOG(INFO) << "Shutting down thread pool";
     {
         std::lock_guard<std::mutex> lock(queueMutex);
         stop = true;
     }
-    
+
     // 唤醒所有线程
     condition.notify_all();
-    
+    spaceCondition.notify_all();
+    for (const auto& worker : stealingWorkers)
+    {
+        {
+            std::lock_guard<std::mutex> lock(worker->parkMutex);
+            worker->notified = true;
+        }
+        worker->parkCond.notify_one();
+    }
+
     // 等待所有线程结束
-    for (std::thread& worker : workers) 
+    for (std::thread& worker : workers)
     {
-        if (worker.joinable()) 
+        if (worker.joinable())
         {
             worker.join();
         }
     }
 }
 
-void ThreadPool::enqueue(std::function<void()> task) 
+bool ThreadPool::enqueue(std::function<void()> task, std::function<void()> onDropped)
 {
+    if (mode == Mode::WORK_STEALING)
+    {
+        if (stop.load(std::memory_order_acquire))
+        {
+            LOG(ERROR) << "Enqueue on stopped ThreadPool";
+            throw std::runtime_error("Enqueue on stopped ThreadPool");
+        }
+
+        if (currentPool == this)
+        {
+            // 工作线程派生的任务直接压入自己的本地队列
+            Task* node = new Task;
+            node->fn = std::move(task);
+            node->onDropped = std::move(onDropped);
+            stealingWorkers[currentWorkerIndex]->deque.push(node);
+            wakeOne();
+            return true;
+        }
+
+        if (maxQueued > 0 && !reserveSlot())
+        {
+            return false;
+        }
+        Task* node = new Task;
+        node->fn = std::move(task);
+        node->onDropped = std::move(onDropped);
+        node->counted = maxQueued > 0;
+
+        // 外部提交：从轮转位置开始优先挑选空闲线程，直接唤醒该线程
+        size_t n = stealingWorkers.size();
+        size_t start = nextWorker.fetch_add(1, std::memory_order_relaxed) % n;
+        Worker* target = stealingWorkers[start].get();
+        for (size_t i = 0; i < n; ++i)
+        {
+            Worker* candidate = stealingWorkers[(start + i) % n].get();
+            if (!candidate->busy.load(std::memory_order_relaxed))
+            {
+                target = candidate;
+                break;
+            }
+        }
+        target->pushInbox(node);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (target->sleeping.load(std::memory_order_relaxed))
+        {
+            {
+                std::lock_guard<std::mutex> lock(target->parkMutex);
+                target->notified = true;
+            }
+            target->parkCond.notify_one();
+        }
+        return true;
+    }
+
+    // 被丢弃的任务在释放锁之后再通知
+    std::function<void()> dropped;
     // 创建作用域，RAII自动控制上锁解锁
     {
-        std::lock_guard<std::mutex> lock(queueMutex);
+        std::unique_lock<std::mutex> lock(queueMutex);
         // 如果线程池关闭，抛出运行时异常
-        if (stop) 
+        if (stop)
         {
             LOG(ERROR) << "Enqueue on stopped ThreadPool";
             throw std::runtime_error("Enqueue on stopped ThreadPool");
         }
+        // 队列已满时按策略处理
+        if (maxQueued > 0 && tasks.size() >= maxQueued)
+        {
+            if (policy == OverflowPolicy::REJECT)
+            {
+                return false;
+            }
+            if (policy == OverflowPolicy::DROP_OLDEST)
+            {
+                dropped = std::move(tasks.front().onDropped);
+                tasks.pop();
+            }
+            else if (currentPool != this)
+            {
+                ++blockedSubmitters;
+                spaceCondition.wait(lock, [this] { return stop.load() || tasks.size() < maxQueued; });
+                --blockedSubmitters;
+                if (stop)
+                {
+                    LOG(ERROR) << "Enqueue on stopped ThreadPool";
+                    throw std::runtime_error("Enqueue on stopped ThreadPool");
+                }
+            }
+        }
         // 否则加入任务队列
-        tasks.emplace(std::move(task));
+        tasks.push(QueuedTask{std::move(task), std::move(onDropped)});
     }
     // 通知一个等待线程
     condition.notify_one();
+    if (dropped)
+    {
+        dropped();
+    }
+    return true;
 }
 
-size_t ThreadPool::queueSize() const 
+/**
+ * @brief 工作窃取模式下占用一个排队名额
+ *
+ * 计数先加后判断，并发提交时不会超出上限；DROP_OLDEST从各本地队列的最旧一端窃取一个任务丢弃，
+ * 其名额直接转给新任务
+ */
+bool ThreadPool::reserveSlot()
 {
+    if (queued.fetch_add(1) < maxQueued)
+    {
+        return true;
+    }
+    queued.fetch_sub(1);
+
+    if (policy == OverflowPolicy::DROP_OLDEST)
+    {
+        size_t n = stealingWorkers.size();
+        size_t start = nextRandom() % n;
+        for (size_t i = 0; i < n; ++i)
+        {
+            Worker& owner = *stealingWorkers[(start + i) % n];
+            Task* victim = owner.deque.steal();
+            if (victim == nullptr)
+            {
+                continue;
+            }
+            if (!victim->counted)
+            {
+                // 工作线程派生的任务不占名额，丢弃它腾不出位置：经收件箱还给原线程
+                owner.pushInbox(victim);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (owner.sleeping.load(std::memory_order_relaxed))
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(owner.parkMutex);
+                        owner.notified = true;
+                    }
+                    owner.parkCond.notify_one();
+                }
+                continue;
+            }
+            if (victim->onDropped)
+            {
+                victim->onDropped();
+            }
+            delete victim;
+            return true;
+        }
+        return false;
+    }
+    if (policy == OverflowPolicy::REJECT)
+    {
+        return false;
+    }
+
+    // BLOCK：与工作线程“先释放名额再检查等待者”构成Dekker式握手，不会丢失唤醒
+    std::unique_lock<std::mutex> lock(queueMutex);
+    ++blockedSubmitters;
+    spaceCondition.wait(lock, [this] {
+        if (stop.load())
+        {
+            return true;
+        }
+        if (queued.fetch_add(1) < maxQueued)
+        {
+            return true;
+        }
+        queued.fetch_sub(1);
+        return false;
+    });
+    --blockedSubmitters;
+    if (stop)
+    {
+        LOG(ERROR) << "Enqueue on stopped ThreadPool";
+        throw std::runtime_error("Enqueue on stopped ThreadPool");
+    }
+    return true;
+}
+
+void ThreadPool::releaseSlot()
+{
+    queued.fetch_sub(1);
+    if (blockedSubmitters.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        spaceCondition.notify_one();
+    }
+}
+
+size_t ThreadPool::queueSize() const
+{
+    if (mode == Mode::WORK_STEALING)
+    {
+        size_t total = 0;
+        for (const auto& worker : stealingWorkers)
+        {
+            total += worker->deque.sizeApprox() +
+                     worker->inboxSize.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
     std::lock_guard<std::mutex> lock(queueMutex);
     return tasks.size();
-}
\ No newline at end of file
+}
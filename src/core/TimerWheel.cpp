@@ -0,0 +1,258 @@
+#include "core/TimerWheel.h"
+#include <algorithm>
+
+TimerWheel::TimerWheel(int64_t tickMs, int64_t nowMs)
+    : tickMs(tickMs), currentTick(nowMs / tickMs), slots(SLOT_COUNT, -1)
+{
+}
+
+TimerId TimerWheel::add(int64_t delayMs, Callback cb)
+{
+    int32_t index;
+    if (freeList >= 0)
+    {
+        index = freeList;
+        freeList = nodes[index].next;
+    }
+    else
+    {
+        index = static_cast<int32_t>(nodes.size());
+        nodes.emplace_back();
+    }
+
+    Node& node = nodes[index];
+    node.callback = std::move(cb);
+    node.state = NodeState::ACTIVE;
+    // 向上取整，至少在下一个tick触发
+    node.expire = currentTick + std::max<int64_t>(1, (delayMs + tickMs - 1) / tickMs);
+    link(index);
+    ++activeCount;
+    return TimerId{index, node.generation};
+}
+
+bool TimerWheel::restart(TimerId id, int64_t delayMs)
+{
+    if (!alive(id))
+    {
+        return false;
+    }
+
+    Node& node = nodes[id.index];
+    if (node.state == NodeState::ACTIVE)
+    {
+        unlink(id.index);
+    }
+    else
+    {
+        // 在自己的回调中重启：重新计入活跃数
+        ++activeCount;
+    }
+    node.state = NodeState::ACTIVE;
+    node.expire = currentTick + std::max<int64_t>(1, (delayMs + tickMs - 1) / tickMs);
+    link(id.index);
+    return true;
+}
+
+void TimerWheel::cancel(TimerId id)
+{
+    if (!alive(id))
+    {
+        return;
+    }
+
+    Node& node = nodes[id.index];
+    if (node.state == NodeState::ACTIVE)
+    {
+        unlink(id.index);
+        --activeCount;
+        release(id.index);
+    }
+    else if (node.state == NodeState::FIRING)
+    {
+        // 回调执行完后由advance回收
+        node.state = NodeState::CANCELLED;
+    }
+}
+
+bool TimerWheel::alive(TimerId id) const
+{
+    return id.index >= 0 && static_cast<size_t>(id.index) < nodes.size() &&
+           nodes[id.index].generation == id.generation &&
+           nodes[id.index].state != NodeState::FREE &&
+           nodes[id.index].state != NodeState::CANCELLED;
+}
+
+int TimerWheel::slotFor(int64_t expire) const
+{
+    int64_t delta = expire - currentTick;
+    if (delta < ROOT_SIZE)
+    {
+        return static_cast<int>(expire & (ROOT_SIZE - 1));
+    }
+
+    // 逐层判断落在哪一层，超出最大范围的定时器放在最高层
+    for (int level = 1; level < LEVELS; ++level)
+    {
+        int shift = ROOT_BITS + level * LEVEL_BITS;
+        if (delta < (int64_t(1) << shift) || level == LEVELS - 1)
+        {
+            int idx = static_cast<int>((expire >> (shift - LEVEL_BITS)) & (LEVEL_SIZE - 1));
+            return ROOT_SIZE + (level - 1) * LEVEL_SIZE + idx;
+        }
+    }
+    return 0;
+}
+
+void TimerWheel::link(int32_t index)
+{
+    Node& node = nodes[index];
+
+    // 超出最大可表示范围时截断到最远的tick，到期后回调可自行重启
+    int64_t maxDelta = (int64_t(1) << (ROOT_BITS + (LEVELS - 1) * LEVEL_BITS)) - 1;
+    if (node.expire - currentTick > maxDelta)
+    {
+        node.expire = currentTick + maxDelta;
+    }
+
+    int slot = slotFor(node.expire);
+    node.slot = slot;
+    node.prev = -1;
+    node.next = slots[slot];
+    if (node.next >= 0)
+    {
+        nodes[node.next].prev = index;
+    }
+    slots[slot] = index;
+}
+
+void TimerWheel::unlink(int32_t index)
+{
+    Node& node = nodes[index];
+    if (node.prev >= 0)
+    {
+        nodes[node.prev].next = node.next;
+    }
+    else
+    {
+        slots[node.slot] = node.next;
+    }
+    if (node.next >= 0)
+    {
+        nodes[node.next].prev = node.prev;
+    }
+    node.prev = node.next = -1;
+    node.slot = -1;
+}
+
+void TimerWheel::release(int32_t index)
+{
+    Node& node = nodes[index];
+    node.callback = nullptr;
+    node.state = NodeState::FREE;
+    ++node.generation;   // 使旧句柄失效
+    node.next = freeList;
+    freeList = index;
+}
+
+void TimerWheel::cascade(int level, int slotIndex)
+{
+    int slot = ROOT_SIZE + (level - 1) * LEVEL_SIZE + slotIndex;
+    int32_t index = slots[slot];
+    slots[slot] = -1;
+    while (index >= 0)
+    {
+        int32_t next = nodes[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+void TimerWheel::advance(int64_t nowMs)
+{
+    int64_t targetTick = nowMs / tickMs;
+    std::vector<int32_t> expired;
+
+    while (currentTick < targetTick)
+    {
+        if (activeCount == 0)
+        {
+            // 没有定时器时直接跳到目标时间
+            currentTick = targetTick;
+            break;
+        }
+
+        ++currentTick;
+        int rootIndex = static_cast<int>(currentTick & (ROOT_SIZE - 1));
+
+        // 低层转完一圈时，把上一层对应槽中的定时器下放
+        if (rootIndex == 0)
+        {
+            for (int level = 1; level < LEVELS; ++level)
+            {
+                int shift = ROOT_BITS + (level - 1) * LEVEL_BITS;
+                int idx = static_cast<int>((currentTick >> shift) & (LEVEL_SIZE - 1));
+                cascade(level, idx);
+                if (idx != 0)
+                {
+                    break;
+                }
+            }
+        }
+
+        // 摘下本tick到期的全部节点后再执行回调，回调中可安全增删定时器
+        expired.clear();
+        for (int32_t index = slots[rootIndex]; index >= 0; index = nodes[index].next)
+        {
+            expired.push_back(index);
+        }
+        for (int32_t index : expired)
+        {
+            unlink(index);
+            nodes[index].state = NodeState::FIRING;
+            --activeCount;
+        }
+
+        for (int32_t index : expired)
+        {
+            // 回调可能新增定时器导致节点池扩容，先把回调移出节点
+            Callback cb = std::move(nodes[index].callback);
+            if (nodes[index].state == NodeState::FIRING)
+            {
+                cb();
+            }
+
+            Node& node = nodes[index];
+            if (node.state == NodeState::ACTIVE)
+            {
+                // 回调中重启了自己
+                node.callback = std::move(cb);
+            }
+            else
+            {
+                release(index);
+            }
+        }
+    }
+}
+
+int TimerWheel::nextTimeoutMs(int64_t nowMs) const
+{
+    if (activeCount == 0)
+    {
+        return -1;
+    }
+
+    // 在根层向前查找第一个非空槽，遇到需要级联的位置即停止
+    int64_t tick = currentTick + 1;
+    for (; tick <= currentTick + ROOT_SIZE; ++tick)
+    {
+        int rootIndex = static_cast<int>(tick & (ROOT_SIZE - 1));
+        if (slots[rootIndex] >= 0 || rootIndex == 0)
+        {
+            break;
+        }
+    }
+
+    int64_t waitMs = tick * tickMs - nowMs;
+    return static_cast<int>(std::max<int64_t>(0, waitMs));
+}
@@ -0,0 +1,42 @@
+#include "http/AsyncContext.h"
+#include "http/Upstream.h"
+
+AsyncContext::AsyncContext(std::string head, const HttpParser& source, const RouteParams& sourceParams,
+                           const char* base, std::string body)
+    : head(std::move(head)),
+      parser(rebased(source, this->head.data())),
+      params(rebased(sourceParams, base, this->head.data())),
+      body(std::move(body)),
+      req(parser, params, this->body)
+{
+}
+
+HttpParser AsyncContext::rebased(const HttpParser& source, const char* head)
+{
+    HttpParser copy = source;
+    copy.rebase(head);
+    return copy;
+}
+
+RouteParams AsyncContext::rebased(const RouteParams& source, const char* from, const char* to)
+{
+    RouteParams copy = source;
+    copy.rebase(from, to);
+    return copy;
+}
+
+AsyncContext::FetchAwaiter AsyncContext::fetch(UpstreamGroup& group, std::string_view method, std::string_view target,
+                                               std::string_view body, std::string_view headers)
+{
+    std::string request;
+    request.reserve(method.size() + target.size() + headers.size() + body.size() + 96);
+    request.append(method).append(" ").append(target).append(" HTTP/1.1\r\n");
+    request.append("Host: ").append(group.config().upstreams.front()).append("\r\n");
+    request.append(headers);
+    if (!body.empty() || (method != "GET" && method != "HEAD"))
+    {
+        request.append("Content-Length: ").append(std::to_string(body.size())).append("\r\n");
+    }
+    request.append("\r\n").append(body);
+    return FetchAwaiter{*this, group, std::move(request), method == "HEAD", UpstreamResult()};
+}
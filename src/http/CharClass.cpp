@@ -0,0 +1,220 @@
+#include "http/CharClass.h"
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HTTP_SIMD_X86 1
+#endif
+
+namespace
+{
+// 字符集的两种表示
+struct Table
+{
+    bool allowed[256];          // 标量查找表
+    alignas(32) uint8_t bitmap[16]; // bitmap[lo]的第hi位表示字符(hi << 4 | lo)是否允许，仅覆盖0x00-0x7f
+    bool allowHigh;             // 0x80-0xff是否整体允许
+};
+
+constexpr bool isTchar(unsigned c)
+{
+    if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+    {
+        return true;
+    }
+    for (const char* s = "!#$%&'*+-.^_`|~"; *s; ++s)
+    {
+        if (c == static_cast<unsigned char>(*s))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+constexpr bool inKind(CharClass::Kind kind, unsigned c)
+{
+    switch (kind)
+    {
+        case CharClass::TOKEN:
+            return isTchar(c);
+        case CharClass::TARGET:
+            return c >= 0x21 && c <= 0x7e;
+        case CharClass::FIELD_VALUE:
+            return c == '\t' || (c >= 0x20 && c != 0x7f);
+        default:
+            return false;
+    }
+}
+
+constexpr Table makeTable(CharClass::Kind kind)
+{
+    Table table{};
+    for (unsigned c = 0; c < 256; ++c)
+    {
+        table.allowed[c] = inKind(kind, c);
+        if (c < 0x80 && table.allowed[c])
+        {
+            table.bitmap[c & 0x0f] |= static_cast<uint8_t>(1u << (c >> 4));
+        }
+    }
+    table.allowHigh = inKind(kind, 0x80);
+    return table;
+}
+
+constexpr Table TABLES[CharClass::KIND_COUNT] = {
+    makeTable(CharClass::TOKEN),
+    makeTable(CharClass::TARGET),
+    makeTable(CharClass::FIELD_VALUE),
+};
+
+using SkipFn = const char* (*)(const Table&, const char*, const char*);
+
+const char* skipScalar(const Table& table, const char* p, const char* end)
+{
+    while (p < end && table.allowed[static_cast<unsigned char>(*p)])
+    {
+        ++p;
+    }
+    return p;
+}
+
+#ifdef HTTP_SIMD_X86
+__attribute__((target("sse4.2")))
+const char* skipSse42(const Table& table, const char* p, const char* end)
+{
+    const __m128i bitmap = _mm_load_si128(reinterpret_cast<const __m128i*>(table.bitmap));
+    const __m128i hiBits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i nibbleMask = _mm_set1_epi8(0x0f);
+
+    while (end - p >= 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i row = _mm_shuffle_epi8(bitmap, _mm_and_si128(v, nibbleMask));
+        __m128i col = _mm_shuffle_epi8(hiBits, _mm_and_si128(_mm_srli_epi16(v, 4), nibbleMask));
+        __m128i rejected = _mm_cmpeq_epi8(_mm_and_si128(row, col), _mm_setzero_si128());
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(rejected));
+        if (table.allowHigh)
+        {
+            // 最高位为1的字节在位图中没有对应比特，单独放行
+            mask &= ~static_cast<unsigned>(_mm_movemask_epi8(v));
+        }
+        if (mask != 0)
+        {
+            return p + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+    return skipScalar(table, p, end);
+}
+
+__attribute__((target("avx2")))
+const char* skipAvx2(const Table& table, const char* p, const char* end)
+{
+    const __m256i bitmap = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(table.bitmap)));
+    const __m256i hiBits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0,
+                                            1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i nibbleMask = _mm256_set1_epi8(0x0f);
+
+    while (end - p >= 32)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i row = _mm256_shuffle_epi8(bitmap, _mm256_and_si256(v, nibbleMask));
+        __m256i col = _mm256_shuffle_epi8(hiBits, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibbleMask));
+        __m256i rejected = _mm256_cmpeq_epi8(_mm256_and_si256(row, col), _mm256_setzero_si256());
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(rejected));
+        if (table.allowHigh)
+        {
+            mask &= ~static_cast<unsigned>(_mm256_movemask_epi8(v));
+        }
+        if (mask != 0)
+        {
+            return p + __builtin_ctz(mask);
+        }
+        p += 32;
+    }
+    // 剩余不足32字节交给SSE处理
+    return skipSse42(table, p, end);
+}
+#endif
+
+CharClass::Isa supportedIsa(CharClass::Isa wanted)
+{
+#ifdef HTTP_SIMD_X86
+    __builtin_cpu_init();
+    if (wanted == CharClass::Isa::AVX2 && __builtin_cpu_supports("avx2"))
+    {
+        return CharClass::Isa::AVX2;
+    }
+    if (wanted != CharClass::Isa::SCALAR && __builtin_cpu_supports("sse4.2"))
+    {
+        return CharClass::Isa::SSE42;
+    }
+#else
+    (void)wanted;
+#endif
+    return CharClass::Isa::SCALAR;
+}
+
+SkipFn skipFor(CharClass::Isa isa)
+{
+#ifdef HTTP_SIMD_X86
+    switch (isa)
+    {
+        case CharClass::Isa::AVX2:
+            return skipAvx2;
+        case CharClass::Isa::SSE42:
+            return skipSse42;
+        default:
+            break;
+    }
+#else
+    (void)isa;
+#endif
+    return skipScalar;
+}
+
+std::atomic<CharClass::Isa> activeIsa{supportedIsa(CharClass::Isa::AVX2)};
+std::atomic<SkipFn> activeSkip{skipFor(activeIsa.load())};
+} // namespace
+
+const char* CharClass::skip(Kind kind, const char* p, const char* end)
+{
+    return activeSkip.load(std::memory_order_relaxed)(TABLES[kind], p, end);
+}
+
+bool CharClass::contains(Kind kind, unsigned char c)
+{
+    return TABLES[kind].allowed[c];
+}
+
+CharClass::Isa CharClass::bestIsa()
+{
+    return supportedIsa(Isa::AVX2);
+}
+
+void CharClass::selectIsa(Isa isa)
+{
+    Isa actual = supportedIsa(isa);
+    activeIsa.store(actual);
+    activeSkip.store(skipFor(actual));
+}
+
+CharClass::Isa CharClass::currentIsa()
+{
+    return activeIsa.load();
+}
+
+const char* CharClass::isaName(Isa isa)
+{
+    switch (isa)
+    {
+        case Isa::AVX2:
+            return "avx2";
+        case Isa::SSE42:
+            return "sse4.2";
+        default:
+            return "scalar";
+    }
+}
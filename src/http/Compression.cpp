@@ -0,0 +1,213 @@
+#include "http/Compression.h"
+#include "http/HttpHeaders.h"
+#include <algorithm>
+#include <cstdlib>
+#include <zlib.h>
+#ifdef VORTEX_WITH_BROTLI
+#include <brotli/encode.h>
+#endif
+
+namespace
+{
+std::string_view trim(std::string_view text)
+{
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+    {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t'))
+    {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// 解析 ";q=0.5" 形式的参数，没有q参数时为1
+double qualityOf(std::string_view params)
+{
+    while (!params.empty())
+    {
+        size_t semicolon = params.find(';');
+        std::string_view param = trim(params.substr(0, semicolon));
+        params = semicolon == std::string_view::npos ? std::string_view() : params.substr(semicolon + 1);
+        if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=')
+        {
+            return std::strtod(std::string(param.substr(2)).c_str(), nullptr);
+        }
+    }
+    return 1.0;
+}
+
+bool compressGzip(int level, std::string_view input, std::string& output)
+{
+    z_stream stream{};
+    // windowBits 15 + 16：带gzip头和尾
+    if (deflateInit2(&stream, std::clamp(level, 1, 9), Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        return false;
+    }
+    output.resize(deflateBound(&stream, static_cast<uLong>(input.size())));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+    stream.avail_out = static_cast<uInt>(output.size());
+    int rc = deflate(&stream, Z_FINISH);
+    output.resize(stream.total_out);
+    deflateEnd(&stream);
+    return rc == Z_STREAM_END;
+}
+
+#ifdef VORTEX_WITH_BROTLI
+bool compressBrotli(int level, std::string_view input, std::string& output)
+{
+    size_t size = BrotliEncoderMaxCompressedSize(input.size());
+    if (size == 0)
+    {
+        return false;
+    }
+    output.resize(size);
+    if (!BrotliEncoderCompress(std::clamp(level, BROTLI_MIN_QUALITY, BROTLI_MAX_QUALITY), BROTLI_DEFAULT_WINDOW,
+                               BROTLI_MODE_GENERIC, input.size(), reinterpret_cast<const uint8_t*>(input.data()),
+                               &size, reinterpret_cast<uint8_t*>(&output[0])))
+    {
+        return false;
+    }
+    output.resize(size);
+    return true;
+}
+#endif
+} // namespace
+
+bool Compression::brotliAvailable()
+{
+#ifdef VORTEX_WITH_BROTLI
+    return true;
+#else
+    return false;
+#endif
+}
+
+ContentEncoding Compression::negotiate(std::string_view acceptEncoding, bool allowBrotli)
+{
+    // 各编码的q值，-1表示客户端未列出
+    double gzip = -1.0;
+    double brotli = -1.0;
+    double wildcard = -1.0;
+    while (!acceptEncoding.empty())
+    {
+        size_t comma = acceptEncoding.find(',');
+        std::string_view item = acceptEncoding.substr(0, comma);
+        acceptEncoding = comma == std::string_view::npos ? std::string_view() : acceptEncoding.substr(comma + 1);
+
+        size_t semicolon = item.find(';');
+        std::string_view coding = trim(item.substr(0, semicolon));
+        double q = semicolon == std::string_view::npos ? 1.0 : qualityOf(item.substr(semicolon + 1));
+        if (HttpHeaders::equalsIgnoreCase(coding, "gzip") || HttpHeaders::equalsIgnoreCase(coding, "x-gzip"))
+        {
+            gzip = q;
+        }
+        else if (HttpHeaders::equalsIgnoreCase(coding, "br"))
+        {
+            brotli = q;
+        }
+        else if (coding == "*")
+        {
+            wildcard = q;
+        }
+    }
+    if (gzip < 0)
+    {
+        gzip = wildcard;
+    }
+    if (brotli < 0)
+    {
+        brotli = wildcard;
+    }
+    if (!allowBrotli)
+    {
+        brotli = -1.0;
+    }
+
+    if (brotli > 0 && brotli >= gzip)
+    {
+        return ContentEncoding::BROTLI;
+    }
+    if (gzip > 0)
+    {
+        return ContentEncoding::GZIP;
+    }
+    return ContentEncoding::IDENTITY;
+}
+
+const char* Compression::token(ContentEncoding encoding)
+{
+    switch (encoding)
+    {
+        case ContentEncoding::GZIP:
+            return "gzip";
+        case ContentEncoding::BROTLI:
+            return "br";
+        default:
+            return "";
+    }
+}
+
+const char* Compression::fileSuffix(ContentEncoding encoding)
+{
+    switch (encoding)
+    {
+        case ContentEncoding::GZIP:
+            return ".gz";
+        case ContentEncoding::BROTLI:
+            return ".br";
+        default:
+            return "";
+    }
+}
+
+int Compression::maxLevel(ContentEncoding encoding)
+{
+    return encoding == ContentEncoding::BROTLI ? 11 : 9;
+}
+
+int Compression::levelFor(const std::vector<CompressionRule>& rules, std::string_view contentType)
+{
+    for (const CompressionRule& rule : rules)
+    {
+        if (contentType.size() >= rule.typePrefix.size() &&
+            HttpHeaders::equalsIgnoreCase(contentType.substr(0, rule.typePrefix.size()), rule.typePrefix))
+        {
+            return rule.level;
+        }
+    }
+    return 0;
+}
+
+std::vector<CompressionRule> Compression::defaultRules()
+{
+    // 接口响应对延迟更敏感，使用较低级别
+    return {
+        {"text/event-stream", 0},
+        {"text/", 6},
+        {"application/json", 4},
+        {"application/javascript", 6},
+        {"application/xml", 6},
+        {"image/svg+xml", 6},
+        {"application/wasm", 6},
+    };
+}
+
+bool Compression::compress(ContentEncoding encoding, int level, std::string_view input, std::string& output)
+{
+    switch (encoding)
+    {
+        case ContentEncoding::GZIP:
+            return compressGzip(level, input, output);
+#ifdef VORTEX_WITH_BROTLI
+        case ContentEncoding::BROTLI:
+            return compressBrotli(level, input, output);
+#endif
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,595 @@
+#include "http/Hpack.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+// RFC 7541 附录A
+const std::pair<std::string_view, std::string_view> STATIC_TABLE[Hpack::STATIC_TABLE_SIZE] = {
+    {":authority", ""},
+    {":method", "GET"},
+    {":method", "POST"},
+    {":path", "/"},
+    {":path", "/index.html"},
+    {":scheme", "http"},
+    {":scheme", "https"},
+    {":status", "200"},
+    {":status", "204"},
+    {":status", "206"},
+    {":status", "304"},
+    {":status", "400"},
+    {":status", "404"},
+    {":status", "500"},
+    {"accept-charset", ""},
+    {"accept-encoding", "gzip, deflate"},
+    {"accept-language", ""},
+    {"accept-ranges", ""},
+    {"accept", ""},
+    {"access-control-allow-origin", ""},
+    {"age", ""},
+    {"allow", ""},
+    {"authorization", ""},
+    {"cache-control", ""},
+    {"content-disposition", ""},
+    {"content-encoding", ""},
+    {"content-language", ""},
+    {"content-length", ""},
+    {"content-location", ""},
+    {"content-range", ""},
+    {"content-type", ""},
+    {"cookie", ""},
+    {"date", ""},
+    {"etag", ""},
+    {"expect", ""},
+    {"expires", ""},
+    {"from", ""},
+    {"host", ""},
+    {"if-match", ""},
+    {"if-modified-since", ""},
+    {"if-none-match", ""},
+    {"if-range", ""},
+    {"if-unmodified-since", ""},
+    {"last-modified", ""},
+    {"link", ""},
+    {"location", ""},
+    {"max-forwards", ""},
+    {"proxy-authenticate", ""},
+    {"proxy-authorization", ""},
+    {"range", ""},
+    {"referer", ""},
+    {"refresh", ""},
+    {"retry-after", ""},
+    {"server", ""},
+    {"set-cookie", ""},
+    {"strict-transport-security", ""},
+    {"transfer-encoding", ""},
+    {"user-agent", ""},
+    {"vary", ""},
+    {"via", ""},
+    {"www-authenticate", ""},
+};
+
+// RFC 7541 附录B：按符号排列的Huffman码字及其位数，256为EOS
+struct HuffmanCode
+{
+    uint32_t code;
+    uint8_t bits;
+};
+const HuffmanCode HUFFMAN_CODES[257] = {
+    {0x1ff8, 13}, {0x7fffd8, 23}, {0xfffffe2, 28}, {0xfffffe3, 28}, {0xfffffe4, 28}, {0xfffffe5, 28},
+    {0xfffffe6, 28}, {0xfffffe7, 28}, {0xfffffe8, 28}, {0xffffea, 24}, {0x3ffffffc, 30}, {0xfffffe9, 28},
+    {0xfffffea, 28}, {0x3ffffffd, 30}, {0xfffffeb, 28}, {0xfffffec, 28}, {0xfffffed, 28}, {0xfffffee, 28},
+    {0xfffffef, 28}, {0xffffff0, 28}, {0xffffff1, 28}, {0xffffff2, 28}, {0x3ffffffe, 30}, {0xffffff3, 28},
+    {0xffffff4, 28}, {0xffffff5, 28}, {0xffffff6, 28}, {0xffffff7, 28}, {0xffffff8, 28}, {0xffffff9, 28},
+    {0xffffffa, 28}, {0xffffffb, 28}, {0x14, 6}, {0x3f8, 10}, {0x3f9, 10}, {0xffa, 12},
+    {0x1ff9, 13}, {0x15, 6}, {0xf8, 8}, {0x7fa, 11}, {0x3fa, 10}, {0x3fb, 10},
+    {0xf9, 8}, {0x7fb, 11}, {0xfa, 8}, {0x16, 6}, {0x17, 6}, {0x18, 6},
+    {0x0, 5}, {0x1, 5}, {0x2, 5}, {0x19, 6}, {0x1a, 6}, {0x1b, 6},
+    {0x1c, 6}, {0x1d, 6}, {0x1e, 6}, {0x1f, 6}, {0x5c, 7}, {0xfb, 8},
+    {0x7ffc, 15}, {0x20, 6}, {0xffb, 12}, {0x3fc, 10}, {0x1ffa, 13}, {0x21, 6},
+    {0x5d, 7}, {0x5e, 7}, {0x5f, 7}, {0x60, 7}, {0x61, 7}, {0x62, 7},
+    {0x63, 7}, {0x64, 7}, {0x65, 7}, {0x66, 7}, {0x67, 7}, {0x68, 7},
+    {0x69, 7}, {0x6a, 7}, {0x6b, 7}, {0x6c, 7}, {0x6d, 7}, {0x6e, 7},
+    {0x6f, 7}, {0x70, 7}, {0x71, 7}, {0x72, 7}, {0xfc, 8}, {0x73, 7},
+    {0xfd, 8}, {0x1ffb, 13}, {0x7fff0, 19}, {0x1ffc, 13}, {0x3ffc, 14}, {0x22, 6},
+    {0x7ffd, 15}, {0x3, 5}, {0x23, 6}, {0x4, 5}, {0x24, 6}, {0x5, 5},
+    {0x25, 6}, {0x26, 6}, {0x27, 6}, {0x6, 5}, {0x74, 7}, {0x75, 7},
+    {0x28, 6}, {0x29, 6}, {0x2a, 6}, {0x7, 5}, {0x2b, 6}, {0x76, 7},
+    {0x2c, 6}, {0x8, 5}, {0x9, 5}, {0x2d, 6}, {0x77, 7}, {0x78, 7},
+    {0x79, 7}, {0x7a, 7}, {0x7b, 7}, {0x7ffe, 15}, {0x7fc, 11}, {0x3ffd, 14},
+    {0x1ffd, 13}, {0xffffffc, 28}, {0xfffe6, 20}, {0x3fffd2, 22}, {0xfffe7, 20}, {0xfffe8, 20},
+    {0x3fffd3, 22}, {0x3fffd4, 22}, {0x3fffd5, 22}, {0x7fffd9, 23}, {0x3fffd6, 22}, {0x7fffda, 23},
+    {0x7fffdb, 23}, {0x7fffdc, 23}, {0x7fffdd, 23}, {0x7fffde, 23}, {0xffffeb, 24}, {0x7fffdf, 23},
+    {0xffffec, 24}, {0xffffed, 24}, {0x3fffd7, 22}, {0x7fffe0, 23}, {0xffffee, 24}, {0x7fffe1, 23},
+    {0x7fffe2, 23}, {0x7fffe3, 23}, {0x7fffe4, 23}, {0x1fffdc, 21}, {0x3fffd8, 22}, {0x7fffe5, 23},
+    {0x3fffd9, 22}, {0x7fffe6, 23}, {0x7fffe7, 23}, {0xffffef, 24}, {0x3fffda, 22}, {0x1fffdd, 21},
+    {0xfffe9, 20}, {0x3fffdb, 22}, {0x3fffdc, 22}, {0x7fffe8, 23}, {0x7fffe9, 23}, {0x1fffde, 21},
+    {0x7fffea, 23}, {0x3fffdd, 22}, {0x3fffde, 22}, {0xfffff0, 24}, {0x1fffdf, 21}, {0x3fffdf, 22},
+    {0x7fffeb, 23}, {0x7fffec, 23}, {0x1fffe0, 21}, {0x1fffe1, 21}, {0x3fffe0, 22}, {0x1fffe2, 21},
+    {0x7fffed, 23}, {0x3fffe1, 22}, {0x7fffee, 23}, {0x7fffef, 23}, {0xfffea, 20}, {0x3fffe2, 22},
+    {0x3fffe3, 22}, {0x3fffe4, 22}, {0x7ffff0, 23}, {0x3fffe5, 22}, {0x3fffe6, 22}, {0x7ffff1, 23},
+    {0x3ffffe0, 26}, {0x3ffffe1, 26}, {0xfffeb, 20}, {0x7fff1, 19}, {0x3fffe7, 22}, {0x7ffff2, 23},
+    {0x3fffe8, 22}, {0x1ffffec, 25}, {0x3ffffe2, 26}, {0x3ffffe3, 26}, {0x3ffffe4, 26}, {0x7ffffde, 27},
+    {0x7ffffdf, 27}, {0x3ffffe5, 26}, {0xfffff1, 24}, {0x1ffffed, 25}, {0x7fff2, 19}, {0x1fffe3, 21},
+    {0x3ffffe6, 26}, {0x7ffffe0, 27}, {0x7ffffe1, 27}, {0x3ffffe7, 26}, {0x7ffffe2, 27}, {0xfffff2, 24},
+    {0x1fffe4, 21}, {0x1fffe5, 21}, {0x3ffffe8, 26}, {0x3ffffe9, 26}, {0xffffffd, 28}, {0x7ffffe3, 27},
+    {0x7ffffe4, 27}, {0x7ffffe5, 27}, {0xfffec, 20}, {0xfffff3, 24}, {0xfffed, 20}, {0x1fffe6, 21},
+    {0x3fffe9, 22}, {0x1fffe7, 21}, {0x1fffe8, 21}, {0x7ffff3, 23}, {0x3fffea, 22}, {0x3fffeb, 22},
+    {0x1ffffee, 25}, {0x1ffffef, 25}, {0xfffff4, 24}, {0xfffff5, 24}, {0x3ffffea, 26}, {0x7ffff4, 23},
+    {0x3ffffeb, 26}, {0x7ffffe6, 27}, {0x3ffffec, 26}, {0x3ffffed, 26}, {0x7ffffe7, 27}, {0x7ffffe8, 27},
+    {0x7ffffe9, 27}, {0x7ffffea, 27}, {0x7ffffeb, 27}, {0xffffffe, 28}, {0x7ffffec, 27}, {0x7ffffed, 27},
+    {0x7ffffee, 27}, {0x7ffffef, 27}, {0x7fffff0, 27}, {0x3ffffee, 26}, {0x3fffffff, 30},
+};
+
+/**
+ * @brief 按半字节解码的Huffman状态机
+ *
+ * 状态为码树的内部节点（共256个，0为根），每个状态对16种半字节预先算出下一状态和途中完成的符号；
+ * 最短的码字为5位，一个半字节内至多完成一个符号。解码时每个输入字节只需查两次表
+ */
+class HuffmanMachine
+{
+public:
+    static constexpr uint8_t EMIT = 1;   // 途中完成了一个符号
+    static constexpr uint8_t FAIL = 2;   // 遇到EOS
+
+    struct Transition
+    {
+        uint8_t next;
+        uint8_t symbol;
+        uint8_t flags;
+    };
+
+    HuffmanMachine()
+    {
+        // 建码树：child为下一个内部节点，leaf为该位完成的符号，-1表示没有
+        struct Node
+        {
+            int child[2] = {-1, -1};
+            int leaf[2] = {-1, -1};
+            int depth = 0;
+            bool allOnes = true;
+        };
+        std::vector<Node> nodes(1);
+        for (int symbol = 0; symbol < 257; ++symbol)
+        {
+            const HuffmanCode& code = HUFFMAN_CODES[symbol];
+            int current = 0;
+            for (int bit = code.bits - 1; bit > 0; --bit)
+            {
+                int b = (code.code >> bit) & 1;
+                if (nodes[current].child[b] < 0)
+                {
+                    Node node;
+                    node.depth = nodes[current].depth + 1;
+                    node.allOnes = nodes[current].allOnes && b == 1;
+                    nodes[current].child[b] = static_cast<int>(nodes.size());
+                    nodes.push_back(node);
+                }
+                current = nodes[current].child[b];
+            }
+            nodes[current].leaf[code.code & 1] = symbol;
+        }
+
+        for (size_t state = 0; state < nodes.size() && state < 256; ++state)
+        {
+            // 结束时只允许停在根或不足8位的全1前缀上（EOS的前缀作为填充）
+            accepting[state] = nodes[state].allOnes && nodes[state].depth < 8;
+            for (int nibble = 0; nibble < 16; ++nibble)
+            {
+                Transition& t = table[state][nibble];
+                t = Transition{0, 0, 0};
+                int current = static_cast<int>(state);
+                for (int bit = 3; bit >= 0; --bit)
+                {
+                    int b = (nibble >> bit) & 1;
+                    int symbol = nodes[current].leaf[b];
+                    if (symbol == 256)
+                    {
+                        t.flags = FAIL;
+                        break;
+                    }
+                    if (symbol >= 0)
+                    {
+                        t.symbol = static_cast<uint8_t>(symbol);
+                        t.flags = EMIT;
+                        current = 0;
+                    }
+                    else
+                    {
+                        current = nodes[current].child[b];
+                    }
+                }
+                t.next = static_cast<uint8_t>(current);
+            }
+        }
+    }
+
+    Transition table[256][16];
+    bool accepting[256];
+};
+
+const HuffmanMachine& huffmanMachine()
+{
+    static const HuffmanMachine machine;
+    return machine;
+}
+
+// 静态表中名称 -> 第一个同名项的下标
+const std::unordered_map<std::string_view, size_t>& staticNames()
+{
+    static const std::unordered_map<std::string_view, size_t> names = [] {
+        std::unordered_map<std::string_view, size_t> map;
+        for (size_t i = Hpack::STATIC_TABLE_SIZE; i > 0; --i)
+        {
+            map[STATIC_TABLE[i - 1].first] = i;
+        }
+        return map;
+    }();
+    return names;
+}
+
+// 以prefixBits位前缀解码整数
+bool readInteger(std::string_view& input, int prefixBits, uint64_t& value)
+{
+    if (input.empty())
+    {
+        return false;
+    }
+    const uint64_t mask = (1u << prefixBits) - 1;
+    value = static_cast<uint8_t>(input[0]) & mask;
+    input.remove_prefix(1);
+    if (value < mask)
+    {
+        return true;
+    }
+    for (int shift = 0; !input.empty(); shift += 7)
+    {
+        // 超过2^28的整数在任何合理的头部块中都不会出现
+        if (shift > 21)
+        {
+            return false;
+        }
+        uint8_t b = static_cast<uint8_t>(input[0]);
+        input.remove_prefix(1);
+        value += static_cast<uint64_t>(b & 0x7f) << shift;
+        if ((b & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace
+
+bool Hpack::staticEntry(size_t index, std::string_view& name, std::string_view& value)
+{
+    if (index == 0 || index > STATIC_TABLE_SIZE)
+    {
+        return false;
+    }
+    name = STATIC_TABLE[index - 1].first;
+    value = STATIC_TABLE[index - 1].second;
+    return true;
+}
+
+size_t Hpack::findStatic(std::string_view name, std::string_view value, bool& exact)
+{
+    exact = false;
+    const auto& names = staticNames();
+    auto it = names.find(name);
+    if (it == names.end())
+    {
+        return 0;
+    }
+    // 同名的项在静态表中相邻
+    for (size_t i = it->second; i <= STATIC_TABLE_SIZE && STATIC_TABLE[i - 1].first == name; ++i)
+    {
+        if (STATIC_TABLE[i - 1].second == value)
+        {
+            exact = true;
+            return i;
+        }
+    }
+    return it->second;
+}
+
+bool Hpack::huffmanDecode(std::string_view input, std::string& output)
+{
+    const HuffmanMachine& machine = huffmanMachine();
+    uint8_t state = 0;
+    for (char c : input)
+    {
+        const uint8_t byte = static_cast<uint8_t>(c);
+        for (uint8_t nibble : {static_cast<uint8_t>(byte >> 4), static_cast<uint8_t>(byte & 0x0f)})
+        {
+            const HuffmanMachine::Transition& t = machine.table[state][nibble];
+            if (t.flags & HuffmanMachine::FAIL)
+            {
+                return false;
+            }
+            if (t.flags & HuffmanMachine::EMIT)
+            {
+                output.push_back(static_cast<char>(t.symbol));
+            }
+            state = t.next;
+        }
+    }
+    return machine.accepting[state];
+}
+
+size_t Hpack::huffmanLength(std::string_view input)
+{
+    size_t bits = 0;
+    for (char c : input)
+    {
+        bits += HUFFMAN_CODES[static_cast<uint8_t>(c)].bits;
+    }
+    return (bits + 7) / 8;
+}
+
+void Hpack::huffmanEncode(std::string_view input, std::string& output)
+{
+    uint64_t bits = 0;
+    int count = 0;
+    for (char c : input)
+    {
+        const HuffmanCode& code = HUFFMAN_CODES[static_cast<uint8_t>(c)];
+        bits = (bits << code.bits) | code.code;
+        count += code.bits;
+        while (count >= 8)
+        {
+            count -= 8;
+            output.push_back(static_cast<char>(bits >> count));
+        }
+        bits &= (1u << count) - 1;
+    }
+    // 以EOS的高位（全1）填充最后一个字节
+    if (count > 0)
+    {
+        output.push_back(static_cast<char>((bits << (8 - count)) | (0xff >> count)));
+    }
+}
+
+void HpackDynamicTable::insert(std::string_view name, std::string_view value)
+{
+    // 先拷贝：name可能引用表中即将被淘汰的条目
+    std::pair<std::string, std::string> entry(name, value);
+    const size_t size = entry.first.size() + entry.second.size() + Hpack::ENTRY_OVERHEAD;
+    if (size > capacity)
+    {
+        entries.clear();
+        used = 0;
+        return;
+    }
+    used += size;
+    entries.push_front(std::move(entry));
+    evict();
+}
+
+void HpackDynamicTable::resize(size_t maxSize)
+{
+    capacity = maxSize;
+    evict();
+}
+
+void HpackDynamicTable::evict()
+{
+    while (used > capacity && !entries.empty())
+    {
+        used -= entries.back().first.size() + entries.back().second.size() + Hpack::ENTRY_OVERHEAD;
+        entries.pop_back();
+    }
+}
+
+bool HpackDecoder::readString(std::string_view& input, std::string& scratch, std::string_view& out)
+{
+    if (input.empty())
+    {
+        return false;
+    }
+    const bool huffman = (static_cast<uint8_t>(input[0]) & 0x80) != 0;
+    uint64_t length = 0;
+    if (!readInteger(input, 7, length) || length > input.size())
+    {
+        return false;
+    }
+    std::string_view raw = input.substr(0, static_cast<size_t>(length));
+    input.remove_prefix(static_cast<size_t>(length));
+    if (!huffman)
+    {
+        out = raw;
+        return true;
+    }
+    scratch.clear();
+    if (!Hpack::huffmanDecode(raw, scratch))
+    {
+        return false;
+    }
+    out = scratch;
+    return true;
+}
+
+/**
+ * @brief 解码头部块
+ *
+ * 表示方式由首字节的高位区分：1xxxxxxx下标、01xxxxxx带索引的字面量、001xxxxx表大小更新、
+ * 0000xxxx/0001xxxx不索引（或永不索引）的字面量。表大小更新只能出现在块的开头
+ */
+bool HpackDecoder::decode(std::string_view block, const FieldCallback& onField)
+{
+    bool deliver = true;
+    bool fieldSeen = false;
+    auto lookup = [this](uint64_t index, std::string_view& name, std::string_view& value) {
+        if (index <= Hpack::STATIC_TABLE_SIZE)
+        {
+            return Hpack::staticEntry(static_cast<size_t>(index), name, value);
+        }
+        const auto* entry = table.at(static_cast<size_t>(index - Hpack::STATIC_TABLE_SIZE - 1));
+        if (entry == nullptr)
+        {
+            return false;
+        }
+        name = entry->first;
+        value = entry->second;
+        return true;
+    };
+
+    while (!block.empty())
+    {
+        const uint8_t first = static_cast<uint8_t>(block[0]);
+        std::string_view name;
+        std::string_view value;
+        uint64_t index = 0;
+        if (first & 0x80)
+        {
+            if (!readInteger(block, 7, index) || index == 0 || !lookup(index, name, value))
+            {
+                return false;
+            }
+            fieldSeen = true;
+            deliver = deliver && onField(name, value);
+            continue;
+        }
+        if ((first & 0xe0) == 0x20)
+        {
+            if (fieldSeen || !readInteger(block, 5, index) || index > limit)
+            {
+                return false;
+            }
+            table.resize(static_cast<size_t>(index));
+            continue;
+        }
+
+        const bool indexed = (first & 0x40) != 0;
+        if (!readInteger(block, indexed ? 6 : 4, index))
+        {
+            return false;
+        }
+        if (index != 0)
+        {
+            std::string_view ignored;
+            if (!lookup(index, name, ignored))
+            {
+                return false;
+            }
+        }
+        else if (!readString(block, nameScratch, name))
+        {
+            return false;
+        }
+        if (!readString(block, valueScratch, value))
+        {
+            return false;
+        }
+        fieldSeen = true;
+        deliver = deliver && onField(name, value);
+        if (indexed)
+        {
+            table.insert(name, value);
+        }
+    }
+    return true;
+}
+
+void HpackEncoder::setPeerTableSize(size_t size)
+{
+    // 编码端的动态表不超过默认大小，对端允许更大的表也不使用
+    size = std::min(size, Hpack::DEFAULT_TABLE_SIZE);
+    if (size == table.maxSize() && pendingMin == SIZE_MAX)
+    {
+        return;
+    }
+    table.resize(size);
+    pendingMin = std::min(pendingMin, size);
+    pendingFinal = size;
+}
+
+void HpackEncoder::begin(std::string& out)
+{
+    // 两次头部块之间先缩小再放大时，需先通知最小值再通知最终值（RFC 7541 4.2）
+    if (pendingMin == SIZE_MAX)
+    {
+        return;
+    }
+    if (pendingMin < pendingFinal)
+    {
+        writeInteger(pendingMin, 5, 0x20, out);
+    }
+    writeInteger(pendingFinal, 5, 0x20, out);
+    pendingMin = SIZE_MAX;
+}
+
+void HpackEncoder::encode(std::string_view name, std::string_view value, bool indexable, std::string& out)
+{
+    bool exact = false;
+    uint64_t index = Hpack::findStatic(name, value, exact);
+    if (exact)
+    {
+        writeInteger(index, 7, 0x80, out);
+        return;
+    }
+    for (size_t i = 0; i < table.count(); ++i)
+    {
+        const auto* entry = table.at(i);
+        if (entry->first != name)
+        {
+            continue;
+        }
+        if (entry->second == value)
+        {
+            writeInteger(Hpack::STATIC_TABLE_SIZE + 1 + i, 7, 0x80, out);
+            return;
+        }
+        if (index == 0)
+        {
+            index = Hpack::STATIC_TABLE_SIZE + 1 + i;
+        }
+    }
+
+    // 太大的字段加入动态表只会挤掉其他条目
+    indexable = indexable && name.size() + value.size() + Hpack::ENTRY_OVERHEAD <= table.maxSize() / 4;
+    writeInteger(index, indexable ? 6 : 4, indexable ? 0x40 : 0x00, out);
+    if (index == 0)
+    {
+        writeString(name, out);
+    }
+    writeString(value, out);
+    if (indexable)
+    {
+        table.insert(name, value);
+    }
+}
+
+void HpackEncoder::writeInteger(uint64_t value, int prefixBits, uint8_t first, std::string& out)
+{
+    const uint64_t max = (1u << prefixBits) - 1;
+    if (value < max)
+    {
+        out.push_back(static_cast<char>(first | value));
+        return;
+    }
+    out.push_back(static_cast<char>(first | max));
+    value -= max;
+    while (value >= 128)
+    {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void HpackEncoder::writeString(std::string_view text, std::string& out)
+{
+    const size_t huffman = Hpack::huffmanLength(text);
+    if (huffman < text.size())
+    {
+        writeInteger(huffman, 7, 0x80, out);
+        Hpack::huffmanEncode(text, out);
+        return;
+    }
+    writeInteger(text.size(), 7, 0x00, out);
+    out.append(text.data(), text.size());
+}
@@ -0,0 +1,1006 @@
+#include "http/Http2Session.h"
+#include "utils/Logger.h"
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+constexpr size_t FRAME_HEADER_SIZE = 9;
+constexpr int64_t MAX_WINDOW = 0x7fffffff;
+constexpr uint32_t DEFAULT_WINDOW = 65535;
+
+// 本端接受的最大帧载荷（不通告更大的SETTINGS_MAX_FRAME_SIZE）
+constexpr size_t MAX_FRAME_SIZE = 16384;
+
+// 发送DATA帧的上限：对端允许更大的帧时也不超过它，多个流的消息体交错得更均匀
+constexpr uint32_t MAX_SEND_FRAME_SIZE = 64 * 1024;
+
+// 记住的本端最近重置的流数，这些流上在途的帧被忽略而不是视为连接错误
+constexpr size_t RESET_HISTORY = 128;
+
+// 帧标志
+constexpr uint8_t FLAG_END_STREAM = 0x1;
+constexpr uint8_t FLAG_ACK = 0x1;
+constexpr uint8_t FLAG_END_HEADERS = 0x4;
+constexpr uint8_t FLAG_PADDED = 0x8;
+constexpr uint8_t FLAG_PRIORITY = 0x20;
+
+// SETTINGS参数
+constexpr uint16_t SETTINGS_HEADER_TABLE_SIZE = 0x1;
+constexpr uint16_t SETTINGS_ENABLE_PUSH = 0x2;
+constexpr uint16_t SETTINGS_MAX_CONCURRENT_STREAMS = 0x3;
+constexpr uint16_t SETTINGS_INITIAL_WINDOW_SIZE = 0x4;
+constexpr uint16_t SETTINGS_MAX_FRAME_SIZE = 0x5;
+constexpr uint16_t SETTINGS_MAX_HEADER_LIST_SIZE = 0x6;
+
+uint32_t readUint32(const char* p)
+{
+    const auto* u = reinterpret_cast<const uint8_t*>(p);
+    return (uint32_t(u[0]) << 24) | (uint32_t(u[1]) << 16) | (uint32_t(u[2]) << 8) | u[3];
+}
+
+void appendUint32(std::string& out, uint32_t value)
+{
+    char bytes[4] = {static_cast<char>(value >> 24), static_cast<char>(value >> 16), static_cast<char>(value >> 8),
+                     static_cast<char>(value)};
+    out.append(bytes, 4);
+}
+
+void appendSetting(std::string& out, uint16_t id, uint32_t value)
+{
+    out.push_back(static_cast<char>(id >> 8));
+    out.push_back(static_cast<char>(id));
+    appendUint32(out, value);
+}
+
+// HTTP/2中禁止的连接级头部（RFC 9113 8.2.2）
+bool isConnectionSpecific(std::string_view name)
+{
+    return name == "connection" || name == "keep-alive" || name == "proxy-connection" ||
+           name == "transfer-encoding" || name == "upgrade";
+}
+
+// 字段名：小写的token字符
+bool validName(std::string_view name)
+{
+    if (name.empty())
+    {
+        return false;
+    }
+    for (char c : name)
+    {
+        if (c <= 0x20 || c >= 0x7f || (c >= 'A' && c <= 'Z') || strchr("\"(),/:;<=>?@[\\]{}", c) != nullptr)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 字段值：不能含NUL、CR、LF（否则合成的请求头会被注入额外的行）
+bool validValue(std::string_view value)
+{
+    return value.find_first_of(std::string_view("\0\r\n", 3)) == std::string_view::npos;
+}
+
+// 请求行中的方法和路径：可见字符，不含空白
+bool validToken(std::string_view text)
+{
+    if (text.empty())
+    {
+        return false;
+    }
+    for (char c : text)
+    {
+        if (c <= 0x20 || c >= 0x7f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 值随每个响应变化或较敏感的字段不加入动态表
+bool indexable(std::string_view name)
+{
+    return name != "content-length" && name != "content-range" && name != "date" && name != "etag" &&
+           name != "last-modified" && name != "age" && name != "set-cookie" && name != "authorization";
+}
+
+// base64url解码（HTTP2-Settings），忽略末尾的'='
+bool decodeBase64Url(std::string_view input, std::string& output)
+{
+    while (!input.empty() && input.back() == '=')
+    {
+        input.remove_suffix(1);
+    }
+    uint32_t bits = 0;
+    int count = 0;
+    for (char c : input)
+    {
+        int value;
+        if (c >= 'A' && c <= 'Z')
+        {
+            value = c - 'A';
+        }
+        else if (c >= 'a' && c <= 'z')
+        {
+            value = c - 'a' + 26;
+        }
+        else if (c >= '0' && c <= '9')
+        {
+            value = c - '0' + 52;
+        }
+        else if (c == '-' || c == '+')
+        {
+            value = 62;
+        }
+        else if (c == '_' || c == '/')
+        {
+            value = 63;
+        }
+        else
+        {
+            return false;
+        }
+        bits = (bits << 6) | static_cast<uint32_t>(value);
+        count += 6;
+        if (count >= 8)
+        {
+            count -= 8;
+            output.push_back(static_cast<char>(bits >> count));
+        }
+    }
+    return true;
+}
+} // namespace
+
+Http2Session::Http2Session(const Options& options, Handler handler)
+    : options(options), handler(std::move(handler))
+{
+}
+
+bool Http2Session::applyUpgradeSettings(std::string_view http2Settings)
+{
+    std::string payload;
+    ErrorCode error = NO_ERROR;
+    return decodeBase64Url(http2Settings, payload) && payload.size() % 6 == 0 && applySettings(payload, error);
+}
+
+/**
+ * @brief 服务器连接前言
+ *
+ * 流的接收窗口通过SETTINGS_INITIAL_WINDOW_SIZE放大，连接窗口只能以WINDOW_UPDATE放大
+ */
+void Http2Session::start()
+{
+    writeFrameHeader(18, SETTINGS, 0, 0);
+    appendSetting(out, SETTINGS_MAX_CONCURRENT_STREAMS, options.maxConcurrentStreams);
+    appendSetting(out, SETTINGS_INITIAL_WINDOW_SIZE, options.streamWindow);
+    appendSetting(out, SETTINGS_MAX_HEADER_LIST_SIZE, static_cast<uint32_t>(options.maxHeaderSize));
+    if (options.connectionWindow > DEFAULT_WINDOW)
+    {
+        writeWindowUpdate(0, options.connectionWindow - DEFAULT_WINDOW);
+        connectionRecvWindow = options.connectionWindow;
+    }
+}
+
+Http2Stream& Http2Session::upgradeStream()
+{
+    auto stream = std::make_unique<Http2Stream>(1);
+    stream->remoteClosed = true;
+    stream->recvWindow = options.streamWindow;
+    stream->sendWindow = peerInitialWindow;
+    lastStreamId = 1;
+    Http2Stream& result = *stream;
+    streams[1] = std::move(stream);
+    return result;
+}
+
+/**
+ * @brief 依次处理完整的帧
+ *
+ * 帧头声明的长度超过本端的最大帧大小时立即按连接错误处理，不等待载荷到齐
+ */
+size_t Http2Session::receive(const char* data, size_t length)
+{
+    if (failed)
+    {
+        return length;
+    }
+    size_t consumed = 0;
+    if (!prefaceReceived)
+    {
+        if (length < PREFACE.size())
+        {
+            return 0;
+        }
+        if (std::string_view(data, PREFACE.size()) != PREFACE)
+        {
+            connectionError(PROTOCOL_ERROR);
+            return length;
+        }
+        prefaceReceived = true;
+        consumed = PREFACE.size();
+    }
+
+    while (length - consumed >= FRAME_HEADER_SIZE)
+    {
+        const char* frame = data + consumed;
+        const size_t payloadLength = (size_t(static_cast<uint8_t>(frame[0])) << 16) |
+                                     (size_t(static_cast<uint8_t>(frame[1])) << 8) | static_cast<uint8_t>(frame[2]);
+        if (payloadLength > MAX_FRAME_SIZE)
+        {
+            connectionError(FRAME_SIZE_ERROR);
+            return length;
+        }
+        if (length - consumed < FRAME_HEADER_SIZE + payloadLength)
+        {
+            break;
+        }
+        const uint8_t type = static_cast<uint8_t>(frame[3]);
+        const uint8_t flags = static_cast<uint8_t>(frame[4]);
+        const uint32_t streamId = readUint32(frame + 5) & 0x7fffffff;
+        consumed += FRAME_HEADER_SIZE + payloadLength;
+        if (!handleFrame(type, flags, streamId, std::string_view(frame + FRAME_HEADER_SIZE, payloadLength)))
+        {
+            return length;
+        }
+    }
+    return consumed;
+}
+
+bool Http2Session::handleFrame(uint8_t type, uint8_t flags, uint32_t streamId, std::string_view payload)
+{
+    // 前言之后的第一个帧必须是SETTINGS；头部块未结束时只能是同一个流的CONTINUATION
+    if (!settingsReceived && !(type == SETTINGS && (flags & FLAG_ACK) == 0))
+    {
+        return connectionError(PROTOCOL_ERROR);
+    }
+    if (headerStreamId != 0 && type != CONTINUATION)
+    {
+        return connectionError(PROTOCOL_ERROR);
+    }
+
+    switch (type)
+    {
+    case DATA:
+        return handleData(flags, streamId, payload);
+    case HEADERS:
+        return handleHeaders(flags, streamId, payload);
+    case CONTINUATION:
+        return handleContinuation(flags, streamId, payload);
+    case SETTINGS:
+        return handleSettings(flags, streamId, payload);
+    case WINDOW_UPDATE:
+        return handleWindowUpdate(streamId, payload);
+    case PRIORITY:
+        // 优先级已被RFC 9113废弃，只校验格式
+        if (streamId == 0)
+        {
+            return connectionError(PROTOCOL_ERROR);
+        }
+        if (payload.size() != 5)
+        {
+            writeRstStream(streamId, FRAME_SIZE_ERROR);
+            removeStream(streamId);
+        }
+        return true;
+    case RST_STREAM:
+        if (streamId == 0 || streamId > lastStreamId)
+        {
+            return connectionError(PROTOCOL_ERROR);
+        }
+        if (payload.size() != 4)
+        {
+            return connectionError(FRAME_SIZE_ERROR);
+        }
+        removeStream(streamId);
+        return true;
+    case PING:
+        if (streamId != 0)
+        {
+            return connectionError(PROTOCOL_ERROR);
+        }
+        if (payload.size() != 8)
+        {
+            return connectionError(FRAME_SIZE_ERROR);
+        }
+        if ((flags & FLAG_ACK) == 0)
+        {
+            writeFrameHeader(8, PING, FLAG_ACK, 0);
+            out.append(payload.data(), payload.size());
+        }
+        return true;
+    case GOAWAY:
+        if (streamId != 0)
+        {
+            return connectionError(PROTOCOL_ERROR);
+        }
+        if (payload.size() < 8)
+        {
+            return connectionError(FRAME_SIZE_ERROR);
+        }
+        goawayReceived = true;
+        return true;
+    case PUSH_PROMISE:
+        // 客户端不能推送
+        return connectionError(PROTOCOL_ERROR);
+    default:
+        // 未知类型的帧必须忽略
+        return true;
+    }
+}
+
+bool Http2Session::handleData(uint8_t flags, uint32_t streamId, std::string_view payload)
+{
+    if (streamId == 0 || streamId > lastStreamId)
+    {
+        return connectionError(PROTOCOL_ERROR);
+    }
+
+    // 流量控制按整个载荷（含填充）计算
+    if (static_cast<int64_t>(payload.size()) > connectionRecvWindow)
+    {
+        return connectionError(FLOW_CONTROL_ERROR);
+    }
+    connectionRecvWindow -= static_cast<int64_t>(payload.size());
+
+    std::string_view data = payload;
+    if (flags & FLAG_PADDED)
+    {
+        if (data.empty() || static_cast<uint8_t>(data[0]) >= data.size())
+        {
+            return connectionError(PROTOCOL_ERROR);
+        }
+        const size_t padding = static_cast<uint8_t>(data[0]);
+        data = data.substr(1, data.size() - 1 - padding);
+    }
+
+    Http2Stream* stream = findStream(streamId);
+    if (stream == nullptr || stream->remoteClosed)
+    {
+        // 已关闭或已重置的流（重置前已在途的数据）：丢弃，连接窗口照常补足
+        if (stream != nullptr)
+        {
+            resetStream(*stream, STREAM_CLOSED);
+        }
+        replenishWindows(nullptr);
+        return true;
+    }
+    if (static_cast<int64_t>(payload.size()) > stream->recvWindow)
+    {
+        resetStream(*stream, FLOW_CONTROL_ERROR);
+        replenishWindows(nullptr);
+        return true;
+    }
+    stream->recvWindow -= static_cast<int64_t>(payload.size());
+    stream->bodyBytes += data.size();
+    const HttpParser& parser = stream->parser;
+    if (parser.bodyType() == HttpParser::BodyType::CONTENT_LENGTH && stream->bodyBytes > parser.contentLength())
+    {
+        resetStream(*stream, PROTOCOL_ERROR);
+        replenishWindows(nullptr);
+        return true;
+    }
+
+    const bool endStream = (flags & FLAG_END_STREAM) != 0;
+    stream->remoteClosed = endStream;
+    if (!data.empty() && !stream->responded && handler.onData)
+    {
+        handler.onData(*stream, data);
+    }
+    // 回调中可能已响应并移除了流
+    stream = findStream(streamId);
+    replenishWindows(stream);
+    if (endStream && stream != nullptr)
+    {
+        finishRequest(streamId);
+    }
+    return true;
+}
+
+bool Http2Session::handleHeaders(uint8_t flags, uint32_t streamId, std::string_view payload)
+{
+    if (streamId == 0 || (streamId & 1) == 0)
+    {
+        return connectionError(PROTOCOL_ERROR);
+    }
+    std::string_view block = payload;
+    if (flags & FLAG_PADDED)
+    {
+        if (block.empty() || static_cast<uint8_t>(block[0]) >= block.size())
+        {
+            return connectionError(PROTOCOL_ERROR);
+        }
+        const size_t padding = static_cast<uint8_t>(block[0]);
+        block = block.substr(1, block.size() - 1 - padding);
+    }
+    if (flags & FLAG_PRIORITY)
+    {
+        if (block.size() < 5)
+        {
+            return connectionError(FRAME_SIZE_ERROR);
+        }
+        block.remove_prefix(5);
+    }
+
+    headerStreamId = streamId;
+    headerEndStream = (flags & FLAG_END_STREAM) != 0;
+    headerBlock.assign(block.data(), block.size());
+    if (flags & FLAG_END_HEADERS)
+    {
+        return finishHeaderBlock();
+    }
+    return true;
+}
+
+bool Http2Session::handleContinuation(uint8_t flags, uint32_t streamId, std::string_view payload)
+{
+    if (headerStreamId == 0 || streamId != headerStreamId)
+    {
+        return connectionError(PROTOCOL_ERROR);
+    }
+    // 压缩后的头部块不会比解码结果的上限还大，超过说明对端在消耗内存
+    if (headerBlock.size() + payload.size() > options.maxHeaderSize)
+    {
+        return connectionError(ENHANCE_YOUR_CALM);
+    }
+    headerBlock.append(payload.data(), payload.size());
+    if (flags & FLAG_END_HEADERS)
+    {
+        return finishHeaderBlock();
+    }
+    return true;
+}
+
+/**
+ * @brief 头部块接收完整
+ *
+ * 新流ID必须大于之前的所有流；不大于时只能是尾部字段（流仍在接收请求体），
+ * 或本端刚重置的流上在途的帧（忽略）。其他情况（从未打开或已关闭的流）是连接错误（RFC 9113 5.1）。
+ * 无论结果如何头部块都先解码，保持动态表同步
+ */
+bool Http2Session::finishHeaderBlock()
+{
+    const uint32_t streamId = headerStreamId;
+    headerStreamId = 0;
+    const bool isNew = streamId > lastStreamId;
+    const bool accept = isNew && streams.size() < options.maxConcurrentStreams;
+
+    std::vector<std::pair<std::string, std::string>> fields;
+    size_t listSize = 0;
+    bool tooLarge = false;
+    bool decoded = decoder.decode(headerBlock, [&](std::string_view name, std::string_view value) {
+        if (!accept)
+        {
+            return false;
+        }
+        listSize += name.size() + value.size() + Hpack::ENTRY_OVERHEAD;
+        if (listSize > options.maxHeaderSize)
+        {
+            tooLarge = true;
+            return false;
+        }
+        fields.emplace_back(name, value);
+        return true;
+    });
+    headerBlock.clear();
+    if (!decoded)
+    {
+        return connectionError(COMPRESSION_ERROR);
+    }
+
+    if (!isNew)
+    {
+        Http2Stream* stream = findStream(streamId);
+        if (stream == nullptr)
+        {
+            return wasReset(streamId) ? true : connectionError(PROTOCOL_ERROR);
+        }
+        // 尾部字段：必须结束请求，内容不交给处理器
+        if (stream->remoteClosed || !headerEndStream)
+        {
+            resetStream(*stream, stream->remoteClosed ? STREAM_CLOSED : PROTOCOL_ERROR);
+            return true;
+        }
+        stream->remoteClosed = true;
+        finishRequest(streamId);
+        return true;
+    }
+
+    lastStreamId = streamId;
+    if (!accept)
+    {
+        writeRstStream(streamId, REFUSED_STREAM);
+        return true;
+    }
+    auto owned = std::make_unique<Http2Stream>(streamId);
+    Http2Stream& stream = *owned;
+    streams[streamId] = std::move(owned);
+    stream.recvWindow = options.streamWindow;
+    stream.sendWindow = peerInitialWindow;
+    stream.remoteClosed = headerEndStream;
+
+    if (tooLarge)
+    {
+        respond(stream, 431, {}, std::string());
+        return true;
+    }
+    if (!buildRequest(stream, fields))
+    {
+        resetStream(stream, PROTOCOL_ERROR);
+        return true;
+    }
+    if (handler.onHeaders)
+    {
+        handler.onHeaders(stream);
+    }
+    if (headerEndStream)
+    {
+        finishRequest(streamId);
+    }
+    return true;
+}
+
+/**
+ * @brief 合成HTTP/1.1风格的请求头
+ *
+ * 伪头部必须在普通字段之前且各出现一次；:authority在没有host字段时转为host；
+ * 多个cookie字段按RFC 9113 8.2.3以"; "合并为一个
+ */
+bool Http2Session::buildRequest(Http2Stream& stream, const std::vector<std::pair<std::string, std::string>>& fields)
+{
+    std::string_view method, scheme, path, authority;
+    std::string cookie;
+    std::string headers;
+    bool regular = false;
+    bool hasHost = false;
+    for (const auto& field : fields)
+    {
+        const std::string& name = field.first;
+        const std::string& value = field.second;
+        if (!validValue(value))
+        {
+            return false;
+        }
+        if (!name.empty() && name[0] == ':')
+        {
+            std::string_view* slot = name == ":method" ? &method
+                                     : name == ":scheme" ? &scheme
+                                     : name == ":path" ? &path
+                                     : name == ":authority" ? &authority
+                                                            : nullptr;
+            if (regular || slot == nullptr || slot->data() != nullptr)
+            {
+                return false;
+            }
+            *slot = value;
+            continue;
+        }
+        regular = true;
+        if (!validName(name) || isConnectionSpecific(name) || (name == "te" && value != "trailers"))
+        {
+            return false;
+        }
+        if (name == "cookie")
+        {
+            cookie += cookie.empty() ? "" : "; ";
+            cookie += value;
+            continue;
+        }
+        hasHost = hasHost || name == "host";
+        headers += name;
+        headers += ": ";
+        headers += value;
+        headers += "\r\n";
+    }
+    // 不支持CONNECT（它没有:path）
+    if (!validToken(method) || scheme.empty() || !validToken(path))
+    {
+        return false;
+    }
+
+    std::string& head = stream.head;
+    head.reserve(method.size() + path.size() + authority.size() + headers.size() + cookie.size() + 40);
+    head.append(method).append(" ").append(path).append(" HTTP/2.0\r\n");
+    if (!authority.empty() && !hasHost)
+    {
+        head.append("host: ").append(authority).append("\r\n");
+    }
+    head += headers;
+    if (!cookie.empty())
+    {
+        head.append("cookie: ").append(cookie).append("\r\n");
+    }
+    head += "\r\n";
+    return stream.parser.parse(head.data(), head.size()) == head.size() && !stream.parser.hasError();
+}
+
+void Http2Session::finishRequest(uint32_t streamId)
+{
+    Http2Stream* stream = findStream(streamId);
+    if (stream == nullptr || stream->responded)
+    {
+        return;
+    }
+    const HttpParser& parser = stream->parser;
+    if (parser.bodyType() == HttpParser::BodyType::CONTENT_LENGTH && stream->bodyBytes != parser.contentLength())
+    {
+        resetStream(*stream, PROTOCOL_ERROR);
+        return;
+    }
+    if (handler.onRequest)
+    {
+        handler.onRequest(*stream);
+    }
+}
+
+bool Http2Session::handleSettings(uint8_t flags, uint32_t streamId, std::string_view payload)
+{
+    if (streamId != 0)
+    {
+        return connectionError(PROTOCOL_ERROR);
+    }
+    if (flags & FLAG_ACK)
+    {
+        return payload.empty() || connectionError(FRAME_SIZE_ERROR);
+    }
+    if (payload.size() % 6 != 0)
+    {
+        return connectionError(FRAME_SIZE_ERROR);
+    }
+    ErrorCode error = NO_ERROR;
+    if (!applySettings(payload, error))
+    {
+        return connectionError(error);
+    }
+    settingsReceived = true;
+    writeFrameHeader(0, SETTINGS, FLAG_ACK, 0);
+    return true;
+}
+
+bool Http2Session::applySettings(std::string_view payload, ErrorCode& error)
+{
+    for (size_t i = 0; i + 6 <= payload.size(); i += 6)
+    {
+        const uint16_t id = static_cast<uint16_t>((static_cast<uint8_t>(payload[i]) << 8) |
+                                                  static_cast<uint8_t>(payload[i + 1]));
+        const uint32_t value = readUint32(payload.data() + i + 2);
+        switch (id)
+        {
+        case SETTINGS_HEADER_TABLE_SIZE:
+            encoder.setPeerTableSize(value);
+            break;
+        case SETTINGS_ENABLE_PUSH:
+            if (value > 1)
+            {
+                error = PROTOCOL_ERROR;
+                return false;
+            }
+            break;
+        case SETTINGS_INITIAL_WINDOW_SIZE:
+        {
+            if (value > MAX_WINDOW)
+            {
+                error = FLOW_CONTROL_ERROR;
+                return false;
+            }
+            // 新的初始窗口按差值作用于所有已打开的流（RFC 9113 6.9.2）
+            const int64_t delta = static_cast<int64_t>(value) - peerInitialWindow;
+            for (auto& entry : streams)
+            {
+                Http2Stream& stream = *entry.second;
+                stream.sendWindow += delta;
+                if (stream.sendWindow > MAX_WINDOW)
+                {
+                    error = FLOW_CONTROL_ERROR;
+                    return false;
+                }
+                schedule(stream);
+            }
+            peerInitialWindow = value;
+            break;
+        }
+        case SETTINGS_MAX_FRAME_SIZE:
+            if (value < MAX_FRAME_SIZE || value > 0xffffff)
+            {
+                error = PROTOCOL_ERROR;
+                return false;
+            }
+            peerMaxFrameSize = std::min(value, MAX_SEND_FRAME_SIZE);
+            break;
+        default:
+            // MAX_CONCURRENT_STREAMS限制的是服务器推送，其余未知参数必须忽略
+            break;
+        }
+    }
+    return true;
+}
+
+bool Http2Session::handleWindowUpdate(uint32_t streamId, std::string_view payload)
+{
+    if (payload.size() != 4)
+    {
+        return connectionError(FRAME_SIZE_ERROR);
+    }
+    const uint32_t increment = readUint32(payload.data()) & 0x7fffffff;
+    if (streamId == 0)
+    {
+        if (increment == 0)
+        {
+            return connectionError(PROTOCOL_ERROR);
+        }
+        connectionSendWindow += increment;
+        return connectionSendWindow <= MAX_WINDOW || connectionError(FLOW_CONTROL_ERROR);
+    }
+    if (streamId > lastStreamId)
+    {
+        return connectionError(PROTOCOL_ERROR);
+    }
+    Http2Stream* stream = findStream(streamId);
+    if (stream == nullptr)
+    {
+        return true;
+    }
+    if (increment == 0)
+    {
+        resetStream(*stream, PROTOCOL_ERROR);
+        return true;
+    }
+    stream->sendWindow += increment;
+    if (stream->sendWindow > MAX_WINDOW)
+    {
+        resetStream(*stream, FLOW_CONTROL_ERROR);
+        return true;
+    }
+    schedule(*stream);
+    return true;
+}
+
+/**
+ * @brief 接收窗口消费过半时补足
+ *
+ * 数据在回调中即被消费（交给处理器或缓存在流上），因此补足不必等待处理器；
+ * 请求体的总量由服务器的maxBodySize限制。已收到END_STREAM的流不再需要窗口
+ */
+void Http2Session::replenishWindows(Http2Stream* stream)
+{
+    if (connectionRecvWindow < options.connectionWindow / 2)
+    {
+        writeWindowUpdate(0, static_cast<uint32_t>(options.connectionWindow - connectionRecvWindow));
+        connectionRecvWindow = options.connectionWindow;
+    }
+    if (stream != nullptr && !stream->remoteClosed && stream->recvWindow < options.streamWindow / 2)
+    {
+        writeWindowUpdate(stream->id, static_cast<uint32_t>(options.streamWindow - stream->recvWindow));
+        stream->recvWindow = options.streamWindow;
+    }
+}
+
+void Http2Session::respond(Http2Stream& stream, int status, const std::vector<Field>& fields, std::string body)
+{
+    stream.responded = true;
+    if (body.empty())
+    {
+        writeHeaders(stream, status, fields, true);
+        finishResponse(stream);
+        return;
+    }
+    writeHeaders(stream, status, fields, false);
+    stream.remaining = body.size();
+    stream.data = std::move(body);
+    stream.dataOffset = 0;
+    schedule(stream);
+}
+
+void Http2Session::respondFile(Http2Stream& stream, int status, const std::vector<Field>& fields,
+                               std::shared_ptr<const CachedFile> file, off_t offset, size_t length)
+{
+    stream.responded = true;
+    if (!file || length == 0)
+    {
+        writeHeaders(stream, status, fields, true);
+        finishResponse(stream);
+        return;
+    }
+    writeHeaders(stream, status, fields, false);
+    stream.file = std::move(file);
+    stream.fileOffset = offset;
+    stream.remaining = length;
+    schedule(stream);
+}
+
+void Http2Session::resetStream(Http2Stream& stream, ErrorCode code)
+{
+    const uint32_t id = stream.id;
+    writeRstStream(id, code);
+    removeStream(id);
+}
+
+/**
+ * @brief 编码响应头
+ *
+ * 头部块超过对端的最大帧大小时拆分为HEADERS + CONTINUATION，连续写出，中间不插入其他帧
+ */
+void Http2Session::writeHeaders(Http2Stream& stream, int status, const std::vector<Field>& fields, bool endStream)
+{
+    std::string block;
+    encoder.begin(block);
+    char statusText[8];
+    int statusLength = snprintf(statusText, sizeof(statusText), "%d", status);
+    encoder.encode(":status", std::string_view(statusText, static_cast<size_t>(statusLength)), true, block);
+
+    std::string name;
+    for (const Field& field : fields)
+    {
+        name.assign(field.name.data(), field.name.size());
+        std::transform(name.begin(), name.end(), name.begin(), [](char c) {
+            return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+        });
+        if (isConnectionSpecific(name))
+        {
+            continue;
+        }
+        encoder.encode(name, field.value, indexable(name), block);
+    }
+
+    size_t offset = 0;
+    bool first = true;
+    do
+    {
+        const size_t length = std::min<size_t>(block.size() - offset, peerMaxFrameSize);
+        const bool last = offset + length == block.size();
+        const uint8_t flags = (last ? FLAG_END_HEADERS : 0) | (first && endStream ? FLAG_END_STREAM : 0);
+        writeFrameHeader(length, first ? HEADERS : CONTINUATION, flags, stream.id);
+        out.append(block, offset, length);
+        offset += length;
+        first = false;
+    } while (offset < block.size());
+}
+
+void Http2Session::finishResponse(Http2Stream& stream)
+{
+    const uint32_t id = stream.id;
+    // 请求体尚未结束：告诉对端不必再发送（RFC 9113 8.1）
+    if (!stream.remoteClosed)
+    {
+        writeRstStream(id, NO_ERROR);
+    }
+    removeStream(id);
+}
+
+void Http2Session::schedule(Http2Stream& stream)
+{
+    if (!stream.queued && stream.remaining > 0 && stream.sendWindow > 0)
+    {
+        stream.queued = true;
+        sendQueue.push_back(stream.id);
+    }
+}
+
+/**
+ * @brief 轮转生成DATA帧
+ *
+ * 每次从队首取一个流生成一帧，流仍有数据和窗口时放回队尾；流窗口耗尽的流离开队列，
+ * 收到它的WINDOW_UPDATE后再加入。文件内容以pread直接读入输出
+ */
+void Http2Session::pump(size_t budget)
+{
+    const size_t start = out.size();
+    while (!sendQueue.empty() && connectionSendWindow > 0 && out.size() - start < budget)
+    {
+        const uint32_t id = sendQueue.front();
+        sendQueue.pop_front();
+        Http2Stream* stream = findStream(id);
+        if (stream == nullptr)
+        {
+            continue;
+        }
+        stream->queued = false;
+        if (stream->sendWindow <= 0 || stream->remaining == 0)
+        {
+            continue;
+        }
+
+        const size_t length = std::min({stream->remaining, static_cast<size_t>(peerMaxFrameSize),
+                                        static_cast<size_t>(stream->sendWindow),
+                                        static_cast<size_t>(connectionSendWindow)});
+        const bool end = length == stream->remaining;
+        const size_t frameStart = out.size();
+        writeFrameHeader(length, DATA, end ? FLAG_END_STREAM : 0, id);
+        if (stream->file)
+        {
+            const size_t dataStart = out.size();
+            out.resize(dataStart + length);
+            ssize_t n;
+            do
+            {
+                n = pread(stream->file->fd, &out[dataStart], length, stream->fileOffset);
+            } while (n < 0 && errno == EINTR);
+            if (n != static_cast<ssize_t>(length))
+            {
+                // 文件在发送过程中被截断或读取出错，已无法满足content-length
+                LOG(ERROR) << "Cannot read " << stream->file->realPath << " for HTTP/2 stream " << id << ": "
+                           << (n < 0 ? strerror(errno) : "file truncated");
+                out.resize(frameStart);
+                resetStream(*stream, INTERNAL_ERROR);
+                continue;
+            }
+            stream->fileOffset += static_cast<off_t>(length);
+        }
+        else
+        {
+            out.append(stream->data, stream->dataOffset, length);
+            stream->dataOffset += length;
+        }
+        stream->remaining -= length;
+        stream->sendWindow -= static_cast<int64_t>(length);
+        connectionSendWindow -= static_cast<int64_t>(length);
+        if (end)
+        {
+            finishResponse(*stream);
+            continue;
+        }
+        schedule(*stream);
+    }
+}
+
+bool Http2Session::connectionError(ErrorCode code)
+{
+    if (!failed)
+    {
+        failed = true;
+        LOG(WARNING) << "HTTP/2 connection error " << code << " after stream " << lastStreamId;
+        writeFrameHeader(8, GOAWAY, 0, 0);
+        appendUint32(out, lastStreamId);
+        appendUint32(out, code);
+        sendQueue.clear();
+    }
+    return false;
+}
+
+void Http2Session::writeFrameHeader(size_t length, uint8_t type, uint8_t flags, uint32_t streamId)
+{
+    char header[FRAME_HEADER_SIZE] = {static_cast<char>(length >> 16), static_cast<char>(length >> 8),
+                                      static_cast<char>(length), static_cast<char>(type),
+                                      static_cast<char>(flags)};
+    out.append(header, 5);
+    appendUint32(out, streamId);
+}
+
+void Http2Session::writeRstStream(uint32_t streamId, ErrorCode code)
+{
+    writeFrameHeader(4, RST_STREAM, 0, streamId);
+    appendUint32(out, code);
+    if (resetIds.size() >= RESET_HISTORY)
+    {
+        resetIds.pop_front();
+    }
+    resetIds.push_back(streamId);
+}
+
+bool Http2Session::wasReset(uint32_t streamId) const
+{
+    return std::find(resetIds.begin(), resetIds.end(), streamId) != resetIds.end();
+}
+
+void Http2Session::writeWindowUpdate(uint32_t streamId, uint32_t increment)
+{
+    writeFrameHeader(4, WINDOW_UPDATE, 0, streamId);
+    appendUint32(out, increment);
+}
+
+Http2Stream* Http2Session::findStream(uint32_t streamId)
+{
+    auto it = streams.find(streamId);
+    return it == streams.end() ? nullptr : it->second.get();
+}
+
+void Http2Session::removeStream(uint32_t streamId)
+{
+    streams.erase(streamId);
+}
@@ -0,0 +1,67 @@
+#include "http/HttpDate.h"
+#include <atomic>
+#include <cstring>
+
+namespace
+{
+constexpr size_t SLOT_SIZE = 64;
+
+struct DateSlots
+{
+    DateSlots() { update(); }
+
+    // 时间进入新的一秒时格式化到空闲槽位并切换
+    void update()
+    {
+        time_t now = time(nullptr);
+        if (now == second)
+        {
+            return;
+        }
+        int next = 1 - current.load(std::memory_order_relaxed);
+        memcpy(text[next], "Date: ", 6);
+        size_t len = 6 + HttpDate::format(now, text[next] + 6, SLOT_SIZE - 8);
+        memcpy(text[next] + len, "\r\n", 2);
+        length[next] = len + 2;
+        second = now;
+        current.store(next, std::memory_order_release);
+    }
+
+    char text[2][SLOT_SIZE];
+    size_t length[2] = {0, 0};
+    std::atomic<int> current{0};
+    time_t second = 0;              // 当前槽位对应的秒，仅刷新线程访问
+    std::atomic<bool> updating{false};
+};
+
+DateSlots& slots()
+{
+    static DateSlots instance;
+    return instance;
+}
+} // namespace
+
+size_t HttpDate::format(time_t t, char* out, size_t size)
+{
+    struct tm tmBuf;
+    gmtime_r(&t, &tmBuf);
+    return strftime(out, size, "%a, %d %b %Y %H:%M:%S GMT", &tmBuf);
+}
+
+void HttpDate::refresh()
+{
+    // 多个服务器的事件循环可能同时刷新，只需其中一个完成
+    DateSlots& s = slots();
+    if (!s.updating.exchange(true, std::memory_order_acquire))
+    {
+        s.update();
+        s.updating.store(false, std::memory_order_release);
+    }
+}
+
+std::string_view HttpDate::header()
+{
+    const DateSlots& s = slots();
+    int index = s.current.load(std::memory_order_acquire);
+    return std::string_view(s.text[index], s.length[index]);
+}
@@ -0,0 +1,282 @@
+#include "http/HttpHeaders.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+// 常用字段的规范名称，顺序与HeaderId一致
+constexpr std::string_view KNOWN_NAMES[static_cast<size_t>(HeaderId::KNOWN_COUNT)] = {
+    "Host",
+    "Connection",
+    "Content-Length",
+    "Content-Type",
+    "Transfer-Encoding",
+    "Accept",
+    "Accept-Encoding",
+    "Accept-Language",
+    "User-Agent",
+    "Cookie",
+    "Authorization",
+    "Cache-Control",
+    "Expect",
+    "Range",
+    "If-Range",
+    "If-None-Match",
+    "If-Modified-Since",
+    "Upgrade",
+    "HTTP2-Settings",
+    "TE",
+    "Referer",
+    "Origin",
+    "X-Forwarded-For",
+};
+
+constexpr char toLowerAscii(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+// 常用字段名的小写形式及大小写掩码（字母位置为0x20），比较时 (c | mask) == lower 即为不区分大小写相等，
+// 非字母字符掩码为0，不会被误判
+constexpr size_t MAX_KNOWN_LENGTH = 17;
+
+struct FoldedName
+{
+    char lower[MAX_KNOWN_LENGTH + 7];
+    char mask[MAX_KNOWN_LENGTH + 7];
+};
+
+constexpr bool isAlpha(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+// 按名称长度分桶的候选编号，识别时只需比较同长度的少数几个名称
+constexpr size_t BUCKET_SIZE = 4;
+
+struct NameIndex
+{
+    FoldedName folded[static_cast<size_t>(HeaderId::KNOWN_COUNT)];
+    uint8_t ids[MAX_KNOWN_LENGTH + 1][BUCKET_SIZE];
+    uint8_t sizes[MAX_KNOWN_LENGTH + 1];
+};
+
+constexpr NameIndex makeIndex()
+{
+    NameIndex index{};
+    for (size_t i = 0; i < static_cast<size_t>(HeaderId::KNOWN_COUNT); ++i)
+    {
+        std::string_view name = KNOWN_NAMES[i];
+        for (size_t j = 0; j < name.size(); ++j)
+        {
+            index.folded[i].lower[j] = toLowerAscii(name[j]);
+            index.folded[i].mask[j] = isAlpha(name[j]) ? 0x20 : 0;
+        }
+        index.ids[name.size()][index.sizes[name.size()]++] = static_cast<uint8_t>(i);
+    }
+    return index;
+}
+
+constexpr NameIndex NAME_INDEX = makeIndex();
+
+// name是否与第id个常用字段名不区分大小写相等（调用方保证长度相同），每次比较8字节
+inline bool matchesKnown(size_t id, std::string_view name)
+{
+    const FoldedName& known = NAME_INDEX.folded[id];
+    size_t i = 0;
+    for (; i + 8 <= name.size(); i += 8)
+    {
+        uint64_t text, mask, lower;
+        memcpy(&text, name.data() + i, 8);
+        memcpy(&mask, known.mask + i, 8);
+        memcpy(&lower, known.lower + i, 8);
+        if ((text | mask) != lower)
+        {
+            return false;
+        }
+    }
+    for (; i < name.size(); ++i)
+    {
+        if ((name[i] | known.mask[i]) != known.lower[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+void HttpHeaders::add(uint32_t nameOffset, uint32_t nameLength, uint32_t valueOffset, uint32_t valueLength)
+{
+    HeaderId id = identify(view(nameOffset, nameLength));
+    Entry entry{nameOffset, nameLength, valueOffset, valueLength, id};
+    if (count < INLINE_CAPACITY)
+    {
+        inlineEntries[count] = entry;
+    }
+    else
+    {
+        overflow.push_back(entry);
+    }
+
+    if (id != HeaderId::OTHER && first[static_cast<size_t>(id)] < 0)
+    {
+        first[static_cast<size_t>(id)] = static_cast<int32_t>(count);
+    }
+    ++count;
+}
+
+void HttpHeaders::clear()
+{
+    count = 0;
+    overflow.clear();
+    std::fill(std::begin(first), std::end(first), -1);
+}
+
+HttpHeaders::Field HttpHeaders::operator[](size_t i) const
+{
+    const Entry& e = entry(i);
+    return Field{view(e.nameOffset, e.nameLength), view(e.valueOffset, e.valueLength), e.id};
+}
+
+std::string_view HttpHeaders::get(HeaderId id) const
+{
+    if (id == HeaderId::OTHER || first[static_cast<size_t>(id)] < 0)
+    {
+        return std::string_view();
+    }
+    const Entry& e = entry(static_cast<size_t>(first[static_cast<size_t>(id)]));
+    return view(e.valueOffset, e.valueLength);
+}
+
+std::string_view HttpHeaders::get(std::string_view name) const
+{
+    HeaderId id = identify(name);
+    if (id != HeaderId::OTHER)
+    {
+        return get(id);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Entry& e = entry(i);
+        if (e.id == HeaderId::OTHER && equalsIgnoreCase(view(e.nameOffset, e.nameLength), name))
+        {
+            return view(e.valueOffset, e.valueLength);
+        }
+    }
+    return std::string_view();
+}
+
+size_t HttpHeaders::countOf(HeaderId id) const
+{
+    if (!has(id))
+    {
+        return 0;
+    }
+    size_t n = 0;
+    for (size_t i = static_cast<size_t>(first[static_cast<size_t>(id)]); i < count; ++i)
+    {
+        n += entry(i).id == id;
+    }
+    return n;
+}
+
+HeaderId HttpHeaders::identify(std::string_view name)
+{
+    if (name.size() > MAX_KNOWN_LENGTH)
+    {
+        return HeaderId::OTHER;
+    }
+
+    // 常用字段名都以字母开头，先用首字母快速排除同长度的其他候选
+    const size_t length = name.size();
+    const char lead = static_cast<char>(name.empty() ? 0 : name[0] | 0x20);
+    for (size_t i = 0; i < NAME_INDEX.sizes[length]; ++i)
+    {
+        size_t id = NAME_INDEX.ids[length][i];
+        if (NAME_INDEX.folded[id].lower[0] == lead && matchesKnown(id, name))
+        {
+            return static_cast<HeaderId>(id);
+        }
+    }
+    return HeaderId::OTHER;
+}
+
+std::string_view HttpHeaders::nameOf(HeaderId id)
+{
+    return id == HeaderId::OTHER ? std::string_view() : KNOWN_NAMES[static_cast<size_t>(id)];
+}
+
+bool HttpHeaders::equalsIgnoreCase(std::string_view a, std::string_view b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (toLowerAscii(a[i]) != toLowerAscii(b[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool HttpHeaders::hasToken(std::string_view list, std::string_view token)
+{
+    while (!list.empty())
+    {
+        size_t comma = list.find(',');
+        std::string_view item = list.substr(0, comma);
+        list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+        while (!item.empty() && (item.front() == ' ' || item.front() == '\t'))
+        {
+            item.remove_prefix(1);
+        }
+        while (!item.empty() && (item.back() == ' ' || item.back() == '\t'))
+        {
+            item.remove_suffix(1);
+        }
+        if (equalsIgnoreCase(item, token))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool HttpHeaders::matchesETag(std::string_view ifNoneMatch, std::string_view etag)
+{
+    if (ifNoneMatch == "*")
+    {
+        return true;
+    }
+    // 逐个比较逗号分隔的ETag，弱比较时忽略W/前缀
+    size_t pos = 0;
+    while (pos < ifNoneMatch.size())
+    {
+        size_t comma = ifNoneMatch.find(',', pos);
+        if (comma == std::string_view::npos)
+        {
+            comma = ifNoneMatch.size();
+        }
+        size_t b = ifNoneMatch.find_first_not_of(" \t", pos);
+        size_t e = ifNoneMatch.find_last_not_of(" \t", comma - 1);
+        if (b != std::string_view::npos && b < comma && e != std::string_view::npos && e >= b)
+        {
+            std::string_view tag = ifNoneMatch.substr(b, e - b + 1);
+            if (tag.substr(0, 2) == "W/")
+            {
+                tag.remove_prefix(2);
+            }
+            if (tag == etag)
+            {
+                return true;
+            }
+        }
+        pos = comma + 1;
+    }
+    return false;
+}
@@ -1,92 +1,478 @@
 #include "http/HttpParser.h"
+#include "http/CharClass.h"
 #include "utils/Logger.h"
 #include <algorithm>
+#include <cstring>
 
-void HttpParser::parse(const char* data, size_t length) 
+namespace
 {
+constexpr size_t MAX_CHUNK_LINE = 4096;      // 块大小行（含扩展）最大字节数
+constexpr size_t MAX_TRAILER_SIZE = 8192;    // 尾部字段最大总字节数
+constexpr uint64_t MAX_CHUNK_SIZE = uint64_t(1) << 60; // 块大小上限，防止溢出
+
+// 解析十进制Content-Length，必须全部为数字且不溢出
+bool parseDecimal(std::string_view text, uint64_t& value)
+{
+    if (text.empty() || text.size() > 19)
+    {
+        return false;
+    }
+    value = 0;
+    for (char c : text)
+    {
+        if (c < '0' || c > '9')
+        {
+            return false;
+        }
+        value = value * 10 + static_cast<uint64_t>(c - '0');
+    }
+    return true;
+}
+
+inline int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 跳过空格和水平制表符
+const char* skipWhitespace(const char* p, const char* end)
+{
+    while (p < end && (*p == ' ' || *p == '\t'))
+    {
+        ++p;
+    }
+    return p;
+}
+} // namespace
+
+size_t HttpParser::parse(const char* data, size_t length)
+{
+    base = data;
+    headers.setBase(data);
     const char* end = data + length;
-    
-    while (data < end && !parseComplete) 
+
+    while (!parseComplete && !parseError)
     {
-        switch (state) 
+        // 以\n为界逐行处理，没有完整的行时等待更多数据
+        const char* line = data + scanned;
+        const char* from = data + (searched > scanned ? searched : scanned);
+        const char* newline = static_cast<const char*>(memchr(from, '\n', end - from));
+        if (newline == nullptr)
         {
-            case State::METHOD:
-                // 解析方法直到遇到空格
-                if (const char* space = std::find(data, end, ' '); space != end) 
+            searched = length;
+            break;
+        }
+
+        // 行必须以CRLF结束，拒绝单独的\n
+        if (newline == line || newline[-1] != '\r')
+        {
+            parseError = true;
+            break;
+        }
+        const char* lineEnd = newline - 1;
+
+        if (state == State::REQUEST_LINE)
+        {
+            // 请求行之前的空行按RFC 9112忽略
+            if (lineEnd != line)
+            {
+                if (mode == Mode::REQUEST)
                 {
-                    method.assign(data, space);
-                    data = space + 1;
-                    state = State::PATH;
+                    parseRequestLine(line, lineEnd);
                 }
-                break;
-                
-            case State::PATH:
-                // 解析路径直到遇到空格
-                if (const char* space = std::find(data, end, ' '); space != end) 
+                else
+                {
+                    parseStatusLine(line, lineEnd);
+                }
+                state = State::HEADERS;
+            }
+        }
+        else if (lineEnd == line)
+        {
+            // 空行表示头部结束
+            parseComplete = true;
+        }
+        else
+        {
+            parseHeaderLine(line, lineEnd);
+        }
+        scanned = newline + 1 - data;
+    }
+
+    if (parseComplete)
+    {
+        if (state == State::HEADERS)
+        {
+            prepareBody();
+            if (mode == Mode::REQUEST)
+            {
+                LOG(DEBUG) << "Parsed request: " << getMethod() << " " << getPath() << " " << getVersion();
+            }
+            else
+            {
+                LOG(DEBUG) << "Parsed response: " << getVersion() << " " << status;
+            }
+        }
+        return scanned;
+    }
+    return 0;
+}
+
+/**
+ * @brief 根据头部确定消息体长度
+ *
+ * 按RFC 9112第6.3节：Transfer-Encoding的最后一个编码必须是chunked；
+ * 同时出现Transfer-Encoding和Content-Length、或多个不一致的Content-Length时
+ * 视为格式错误，避免与前置代理对消息边界理解不一致（请求走私）
+ */
+void HttpParser::prepareBody()
+{
+    // 响应：HEAD请求的响应以及1xx/204/304没有消息体，不论头部如何声明
+    if (mode == Mode::RESPONSE && (noBody || status < 200 || status == 204 || status == 304))
+    {
+        state = State::COMPLETE;
+        return;
+    }
+
+    if (headers.has(HeaderId::TRANSFER_ENCODING))
+    {
+        if (headers.has(HeaderId::CONTENT_LENGTH) || headers.countOf(HeaderId::TRANSFER_ENCODING) > 1)
+        {
+            parseError = true;
+            return;
+        }
+        std::string_view codings = headers.get(HeaderId::TRANSFER_ENCODING);
+        size_t comma = codings.rfind(',');
+        std::string_view last = comma == std::string_view::npos ? codings : codings.substr(comma + 1);
+        const char* begin = skipWhitespace(last.data(), last.data() + last.size());
+        last.remove_prefix(begin - last.data());
+        if (!HttpHeaders::equalsIgnoreCase(last, "chunked"))
+        {
+            parseError = true;
+            return;
+        }
+        body = BodyType::CHUNKED;
+        state = State::CHUNK_SIZE;
+        return;
+    }
+
+    if (headers.has(HeaderId::CONTENT_LENGTH))
+    {
+        bool first = true;
+        for (size_t i = 0; i < headers.size(); ++i)
+        {
+            HttpHeaders::Field field = headers[i];
+            uint64_t value = 0;
+            if (field.id != HeaderId::CONTENT_LENGTH)
+            {
+                continue;
+            }
+            if (!parseDecimal(field.value, value) || (!first && value != declaredLength))
+            {
+                parseError = true;
+                return;
+            }
+            declaredLength = value;
+            first = false;
+        }
+        body = BodyType::CONTENT_LENGTH;
+        chunkRemaining = declaredLength;
+        state = declaredLength > 0 ? State::BODY : State::COMPLETE;
+        return;
+    }
+
+    // 没有长度信息的请求没有消息体，响应则持续到连接关闭
+    if (mode == Mode::RESPONSE)
+    {
+        body = BodyType::UNTIL_CLOSE;
+        chunkRemaining = UINT64_MAX;
+        state = State::BODY;
+        return;
+    }
+    state = State::COMPLETE;
+}
+
+bool HttpParser::finishAtClose()
+{
+    if (body == BodyType::UNTIL_CLOSE && state == State::BODY)
+    {
+        state = State::COMPLETE;
+    }
+    return state == State::COMPLETE;
+}
+
+size_t HttpParser::parseBody(const char* data, size_t length, const BodyCallback& onData, uint64_t maxBody)
+{
+    const char* p = data;
+    const char* end = data + length;
+    bool needMore = false;
+
+    while (p < end && !needMore && !parseError && !bodyTooLarge && parseComplete && state != State::COMPLETE)
+    {
+        switch (state)
+        {
+            case State::BODY:
+            case State::CHUNK_DATA: {
+                size_t n = static_cast<size_t>(std::min<uint64_t>(chunkRemaining, end - p));
+                if (n > maxBody - bodyReceived)
                 {
-                    path.assign(data, space);
-                    data = space + 1;
-                    state = State::VERSION;
+                    // 超出上限的数据不交给回调，避免缓存或转发
+                    bodyTooLarge = true;
+                    break;
+                }
+                onData(std::string_view(p, n));
+                p += n;
+                chunkRemaining -= n;
+                bodyReceived += n;
+                if (chunkRemaining == 0)
+                {
+                    state = state == State::BODY ? State::COMPLETE : State::CHUNK_DATA_END;
                 }
                 break;
-                
-            case State::VERSION:
-                // 查找CRLF结束符
-                if (const char* crlf = std::find(data, end, '\r'); crlf != end && crlf+1 < end) 
+            }
+
+            case State::CHUNK_DATA_END:
+                // 块数据之后必须紧跟CRLF
+                if (end - p < 2)
+                {
+                    needMore = true;
+                    break;
+                }
+                if (p[0] != '\r' || p[1] != '\n')
                 {
-                    version.assign(data, crlf);
-                    data = crlf + 2; // 跳过\r\n
-                    state = State::HEADER_KEY;
+                    parseError = true;
+                    break;
                 }
+                p += 2;
+                state = State::CHUNK_SIZE;
                 break;
-                
-            case State::HEADER_KEY: {
-                // 查找冒号分隔符
-                const char* colon = std::find(data, end, ':');
-                if (colon == end) 
+
+            case State::CHUNK_SIZE:
+            case State::CHUNK_TRAILER: {
+                const char* newline = static_cast<const char*>(memchr(p, '\n', end - p));
+                if (newline == nullptr)
                 {
-                    // 空行表示头部结束
-                    if (data + 1 < end && *data == '\r' && *(data+1) == '\n') 
+                    size_t limit = state == State::CHUNK_SIZE ? MAX_CHUNK_LINE : MAX_TRAILER_SIZE - trailerBytes;
+                    parseError = static_cast<size_t>(end - p) > limit;
+                    needMore = true;
+                    break;
+                }
+                if (newline == p || newline[-1] != '\r')
+                {
+                    parseError = true;
+                    break;
+                }
+                const char* lineEnd = newline - 1;
+
+                if (state == State::CHUNK_SIZE)
+                {
+                    if (!parseChunkSize(p, lineEnd))
                     {
-                        parseComplete = true;
-                        data += 2;
+                        parseError = true;
+                        break;
                     }
-                    break;
+                    // 大小为0的块是最后一块，其后是尾部字段
+                    state = chunkRemaining > 0 ? State::CHUNK_DATA : State::CHUNK_TRAILER;
                 }
-                
-                currentHeaderKey.assign(data, colon);
-                data = colon + 1;
-                state = State::HEADER_VAL;
-                break;
-            }
-                
-            case State::HEADER_VAL:
-                // 查找CRLF结束符
-                if (const char* crlf = std::find(data, end, '\r'); crlf != end && crlf+1 < end) 
+                else if (lineEnd == p)
                 {
-                    // 跳过首部空白字符
-                    while (data < crlf && (*data == ' ' || *data == '\t')) ++data;
-                    
-                    std::string value(data, crlf);
-                    headers[currentHeaderKey] = value;
-                    data = crlf + 2; // 跳过\r\n
-                    state = State::HEADER_KEY;
+                    state = State::COMPLETE;
                 }
+                else
+                {
+                    // 尾部字段只校验格式，不合并到请求头
+                    trailerBytes += newline + 1 - p;
+                    const char* colon = CharClass::skip(CharClass::TOKEN, p, lineEnd);
+                    if (colon == p || colon == lineEnd || *colon != ':' || trailerBytes > MAX_TRAILER_SIZE)
+                    {
+                        parseError = true;
+                        break;
+                    }
+                }
+                p = newline + 1;
                 break;
-                
-            case State::BODY:
-                // 预留body处理逻辑
-                
-                parseComplete = true;
+            }
+
+            default:
+                needMore = true;
                 break;
         }
     }
-    
-    LOG(DEBUG) << "Parsed request: " << method << " " << path << " " << version;
+    return p - data;
+}
+
+/**
+ * @brief 解析块大小行：1*HEXDIG [ BWS ";" chunk-ext ]
+ */
+bool HttpParser::parseChunkSize(const char* line, const char* lineEnd)
+{
+    const char* p = line;
+    uint64_t size = 0;
+    while (p < lineEnd && hexValue(*p) >= 0)
+    {
+        size = size * 16 + static_cast<uint64_t>(hexValue(*p));
+        if (size >= MAX_CHUNK_SIZE)
+        {
+            return false;
+        }
+        ++p;
+    }
+    if (p == line)
+    {
+        return false;
+    }
+
+    // 块扩展直接忽略，但不允许出现控制字符
+    p = skipWhitespace(p, lineEnd);
+    if (p != lineEnd && (*p != ';' || CharClass::skip(CharClass::FIELD_VALUE, p, lineEnd) != lineEnd))
+    {
+        return false;
+    }
+    chunkRemaining = size;
+    return true;
 }
 
-std::string HttpParser::getHeader(const std::string& key) const 
+/**
+ * @brief 解析请求行：method SP request-target SP HTTP-version
+ */
+void HttpParser::parseRequestLine(const char* line, const char* lineEnd)
 {
-    auto it = headers.find(key);
-    return it != headers.end() ? it->second : "";
-}
\ No newline at end of file
+    const char* p = CharClass::skip(CharClass::TOKEN, line, lineEnd);
+    if (p == line || p == lineEnd || *p != ' ')
+    {
+        parseError = true;
+        return;
+    }
+    method = spanOf(line, p);
+
+    const char* target = p + 1;
+    p = CharClass::skip(CharClass::TARGET, target, lineEnd);
+    if (p == target || p == lineEnd || *p != ' ')
+    {
+        parseError = true;
+        return;
+    }
+    path = spanOf(target, p);
+
+    // HTTP-version = "HTTP/" DIGIT "." DIGIT
+    const char* ver = p + 1;
+    if (lineEnd - ver != 8 || memcmp(ver, "HTTP/", 5) != 0 ||
+        ver[5] < '0' || ver[5] > '9' || ver[6] != '.' || ver[7] < '0' || ver[7] > '9')
+    {
+        parseError = true;
+        return;
+    }
+    version = spanOf(ver, lineEnd);
+}
+
+/**
+ * @brief 解析状态行：HTTP-version SP 3DIGIT SP [ reason-phrase ]
+ */
+void HttpParser::parseStatusLine(const char* line, const char* lineEnd)
+{
+    const char* ver = line;
+    if (lineEnd - ver < 12 || memcmp(ver, "HTTP/", 5) != 0 || ver[5] < '0' || ver[5] > '9' || ver[6] != '.' ||
+        ver[7] < '0' || ver[7] > '9' || ver[8] != ' ')
+    {
+        parseError = true;
+        return;
+    }
+    version = spanOf(ver, ver + 8);
+
+    const char* code = ver + 9;
+    status = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        if (code[i] < '0' || code[i] > '9')
+        {
+            parseError = true;
+            return;
+        }
+        status = status * 10 + (code[i] - '0');
+    }
+    if (status < 100 || (code + 3 != lineEnd && code[3] != ' '))
+    {
+        parseError = true;
+        return;
+    }
+
+    // 原因短语可以为空，其中不允许控制字符
+    const char* reason = code + 3 == lineEnd ? lineEnd : code + 4;
+    if (CharClass::skip(CharClass::FIELD_VALUE, reason, lineEnd) != lineEnd)
+    {
+        parseError = true;
+        return;
+    }
+    path = spanOf(reason, lineEnd);
+}
+
+/**
+ * @brief 解析头部行：field-name ":" OWS field-value OWS
+ *
+ * 字段名与冒号之间不允许空白，不支持已废弃的折行（obs-fold），字段值中不允许控制字符
+ */
+void HttpParser::parseHeaderLine(const char* line, const char* lineEnd)
+{
+    const char* colon = CharClass::skip(CharClass::TOKEN, line, lineEnd);
+    if (colon == line || colon == lineEnd || *colon != ':')
+    {
+        parseError = true;
+        return;
+    }
+
+    const char* value = skipWhitespace(colon + 1, lineEnd);
+    if (CharClass::skip(CharClass::FIELD_VALUE, value, lineEnd) != lineEnd)
+    {
+        parseError = true;
+        return;
+    }
+    const char* valueEnd = lineEnd;
+    while (valueEnd > value && (valueEnd[-1] == ' ' || valueEnd[-1] == '\t'))
+    {
+        --valueEnd;
+    }
+    Span name = spanOf(line, colon);
+    Span fieldValue = spanOf(value, valueEnd);
+    headers.add(name.offset, name.length, fieldValue.offset, fieldValue.length);
+}
+
+void HttpParser::reset()
+{
+    state = State::REQUEST_LINE;
+    parseComplete = false;
+    parseError = false;
+    scanned = 0;
+    searched = 0;
+    base = nullptr;
+    method = path = version = Span();
+    status = 0;
+    noBody = false;
+    headers.clear();
+    body = BodyType::NONE;
+    declaredLength = 0;
+    bodyReceived = 0;
+    bodyTooLarge = false;
+    chunkRemaining = 0;
+    trailerBytes = 0;
+}
+
+bool HttpParser::expectsContinue() const
+{
+    return HttpHeaders::equalsIgnoreCase(headers.get(HeaderId::EXPECT), "100-continue");
+}
+
+bool HttpParser::shouldKeepAlive() const
+{
+    std::string_view connection = getHeader(HeaderId::CONNECTION);
+
+    // Connection是逗号分隔的选项列表：任何版本列出close都关闭；
+    // HTTP/1.1默认长连接，HTTP/1.0默认短连接，除非列出keep-alive
+    if (HttpHeaders::hasToken(connection, "close"))
+    {
+        return false;
+    }
+    return getVersion() == "HTTP/1.1" || HttpHeaders::hasToken(connection, "keep-alive");
+}
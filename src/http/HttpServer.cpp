@@ -1,20 +1,284 @@
 #include "http/HttpServer.h"
+#include "core/IoUringPoller.h"
 #include <sys/socket.h>
 #include <arpa/inet.h>
+#include <netinet/tcp.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/sendfile.h>
+#include <climits>
+#include <cstdio>
 #include <cstring>
+#include <ctime>
+#include <algorithm>
+
+namespace
+{
+// 到期时连接正被工作线程处理，稍后重试检查的间隔
+constexpr int64_t TIMEOUT_RETRY_MS = 100;
+
+// 缓存的Date头部的刷新间隔
+constexpr int64_t DATE_REFRESH_MS = 1000;
+
+// 启动时预先序列化的错误响应
+constexpr int PRESET_ERRORS[] = {400, 404, 405, 408, 413, 431, 500, 502, 503, 504, 505};
+
+// 响应可能有多种编码时附加的头部
+const char VARY_ACCEPT_ENCODING[] = "Vary: Accept-Encoding\r\n";
+
+// 逐跳（hop-by-hop）头部只对单个连接有意义，代理时不转发；消息长度由代理按自己的分帧重新生成
+bool isHopByHop(std::string_view name, std::string_view connection)
+{
+    static const char* const NAMES[] = {"Connection", "Keep-Alive", "Proxy-Connection", "TE", "Trailer",
+                                        "Transfer-Encoding", "Upgrade", "Content-Length"};
+    for (const char* hop : NAMES)
+    {
+        if (HttpHeaders::equalsIgnoreCase(name, hop))
+        {
+            return true;
+        }
+    }
+    // Connection中列出的字段同样是逐跳的
+    return HttpHeaders::hasToken(connection, name);
+}
+
+// 缓存的Date头部行（"Date: ...\r\n"）中的值
+std::string_view dateValue()
+{
+    std::string_view line = HttpDate::header();
+    return line.substr(6, line.size() - 8);
+}
+
+// 重发不会产生额外副作用的方法，复用的上游连接失效时可以在新连接上重发
+bool isIdempotent(std::string_view method)
+{
+    return method == "GET" || method == "HEAD" || method == "PUT" || method == "DELETE" || method == "OPTIONS" ||
+           method == "TRACE";
+}
+
+// 错误响应的消息体
+std::string errorBody(int code)
+{
+    std::string title = std::to_string(code) + " " + std::string(Response::reasonPhrase(code));
+    return "<html><body><h1>" + title + "</h1></body></html>";
+}
+
+// 客户端地址的文本形式，如 "1.2.3.4:5678"、"[::1]:5678"
+std::string formatAddress(const sockaddr_storage& addr)
+{
+    char ip[INET6_ADDRSTRLEN] = {};
+    if (addr.ss_family == AF_INET6)
+    {
+        const auto& addr6 = reinterpret_cast<const sockaddr_in6&>(addr);
+        inet_ntop(AF_INET6, &addr6.sin6_addr, ip, sizeof(ip));
+        return "[" + std::string(ip) + "]:" + std::to_string(ntohs(addr6.sin6_port));
+    }
+    const auto& addr4 = reinterpret_cast<const sockaddr_in&>(addr);
+    inet_ntop(AF_INET, &addr4.sin_addr, ip, sizeof(ip));
+    return std::string(ip) + ":" + std::to_string(ntohs(addr4.sin_port));
+}
+
+ServerConfig makeConfig(int port, int threadNum, int reactorNum)
+{
+    ServerConfig config;
+    config.port = port;
+    config.threadNum = threadNum;
+    config.reactorNum = reactorNum;
+    return config;
+}
+} // namespace
 
 /**
  * @brief 构造函数初始化服务器
  * @param port 监听端口号
  * @param threadNum 线程池工作线程数量
+ * @param reactorNum Reactor线程数量，0表示单Reactor+线程池模式
+ */
+HttpServer::HttpServer(int port, int threadNum, int reactorNum)
+    : HttpServer(makeConfig(port, threadNum, reactorNum))
+{
+}
+
+/**
+ * @brief 使用完整配置初始化服务器
+ */
+HttpServer::HttpServer(const ServerConfig& config)
+    : config(config),
+      stats(metricsRegistry),
+      multiReactor(config.reactorNum > 0),
+      pool(config.threadNum,
+           config.workStealing ? ThreadPool::Mode::WORK_STEALING : ThreadPool::Mode::SHARED_QUEUE,
+           config.poolQueueCapacity, config.poolOverflowPolicy),
+      admission(config.shedTargetMs * 1000000, config.shedIntervalMs * 1000000)
+{
+    int loopNum = multiReactor ? config.reactorNum : 1;
+    // 多Reactor模式下默认每个循环拥有独立的监听socket，由内核在它们之间分发连接；
+    // 关闭reusePort时所有循环共享一个监听socket，以EPOLLEXCLUSIVE注册，新连接只唤醒其中一个循环
+    const bool sharedListener = multiReactor && !config.reusePort;
+    const int sharedFd = sharedListener ? createListenSocket(false) : -1;
+    for (int i = 0; i < loopNum; ++i)
+    {
+        auto reactor = std::make_unique<Reactor>(config.ioBackend);
+        reactor->listenFd = sharedListener ? sharedFd : createListenSocket(multiReactor);
+        reactor->idleFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+        Reactor* r = reactor.get();
+        if (multiReactor && r->loop.uring() != nullptr)
+        {
+            // 连接只在本线程处理，accept/recv/send/close全部以完成事件的形式批量提交
+            r->uring = r->loop.uring();
+            r->uring->acceptMultishot(r->listenFd, [this, r](int connFd) {
+                acceptUring(r, connFd);
+            });
+        }
+        else
+        {
+            // 将监听socket加入事件源（水平触发），用于监听新的事件
+            uint32_t events = EPOLLIN;
+            if (sharedListener && r->loop.backend() == Poller::Backend::EPOLL)
+            {
+                events |= EPOLLEXCLUSIVE;
+            }
+            r->loop.addFd(r->listenFd, events, [this, r](uint32_t) {
+                acceptConnection(r);
+            });
+        }
+        reactors.push_back(std::move(reactor));
+    }
+
+    // 预先生成Server头部和常见的错误响应
+    if (!config.serverName.empty())
+    {
+        serverHeader = "Server: " + config.serverName + "\r\n";
+    }
+    // 过载时的503同样预先生成，带Retry-After
+    for (int code : PRESET_ERRORS)
+    {
+        std::string extraHeaders;
+        if (code == 503 && config.retryAfterSeconds > 0)
+        {
+            extraHeaders = "Retry-After: " + std::to_string(config.retryAfterSeconds) + "\r\n";
+        }
+        errorResponses.emplace(code, FixedResponse::make(code, "text/html", errorBody(code), serverHeader,
+                                                         extraHeaders));
+    }
+
+    // 抓取时计算的瞬时量
+    metricsRegistry.gauge("vortex_connections_open", "Currently open connections.", [this] {
+        return static_cast<double>(stats.accepted.value() - stats.closed.value());
+    });
+    metricsRegistry.gauge("vortex_threadpool_queue_depth", "Tasks waiting in the thread pool.", [this] {
+        return static_cast<double>(pool.queueSize());
+    });
+    metricsRegistry.gauge("vortex_overloaded", "1 while queue-delay admission control is shedding requests.",
+                          [this] { return admission.overloaded() ? 1.0 : 0.0; });
+    if (!config.metricsPath.empty())
+    {
+        router.add("GET", config.metricsPath, [this](const Request&, Response& response) {
+            response.setContentType(MetricsRegistry::contentType());
+            response.setBody(metricsRegistry.render());
+        });
+    }
+
+    if (config.responseCacheBytes > 0)
+    {
+        responseCache = std::make_unique<ResponseCache>(config.responseCacheBytes, config.responseCacheShards,
+                                                        config.responseCacheDefaultTtlMs);
+        metricsRegistry.gauge("vortex_cache_entries", "Entries in the response cache.", [this] {
+            return static_cast<double>(responseCache->size());
+        });
+        metricsRegistry.gauge("vortex_cache_bytes", "Bytes charged to the response cache.", [this] {
+            return static_cast<double>(responseCache->bytes());
+        });
+    }
+
+    // Date头部由第0个循环每秒刷新一次
+    HttpDate::refresh();
+    reactors[0]->loop.runEvery(DATE_REFRESH_MS, &HttpDate::refresh);
+
+    // 静态文件缓存的inotify事件由第0个循环处理
+    if (!config.staticRoot.empty())
+    {
+        staticFiles = std::make_unique<StaticFileHandler>(config.staticRoot, config.fileCacheCapacity);
+        if (staticFiles->inotifyFd() >= 0)
+        {
+            reactors[0]->loop.addFd(staticFiles->inotifyFd(), EPOLLIN, [this](uint32_t) {
+                staticFiles->handleInotify();
+            });
+        }
+    }
+    LOG(INFO) << "Server initialized on port " << config.port << " ("
+              << (multiReactor ? "multi-reactor" : "single-reactor") << ", "
+              << loopNum << " event loop(s), "
+              << Poller::backendName(reactors[0]->loop.backend()) << ")";
+}
+
+HttpServer::~HttpServer()
+{
+    for (auto& reactor : reactors)
+    {
+        reactor->loop.quit();
+    }
+    for (auto& reactor : reactors)
+    {
+        if (reactor->thread.joinable())
+        {
+            reactor->thread.join();
+        }
+        // 共享的监听socket只关闭一次
+        if (reactor == reactors.front() || reactor->listenFd != reactors.front()->listenFd)
+        {
+            close(reactor->listenFd);
+        }
+        close(reactor->idleFd);
+    }
+}
+
+/**
+ * @brief 创建监听socket（非阻塞模式）
+ *
+ * 地址为空时绑定IPv6双栈（同时接受IPv4映射地址），系统不支持IPv6时回退到IPv4。
+ * TCP_NODELAY设置在监听socket上，accept得到的连接会继承，不必逐个连接调用setsockopt
  */
-HttpServer::HttpServer(int port, int threadNum)
-    : port(port), pool(threadNum)
+int HttpServer::createListenSocket(bool reusePort)
 {
-    // 创建监听socket（非阻塞模式）
-    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    // 解析监听地址
+    sockaddr_storage serverAddr{};
+    socklen_t addrLen = 0;
+    std::string address = config.bindAddress.empty() ? "::" : config.bindAddress;
+    int listenFd = -1;
+    if (address.find(':') != std::string::npos)
+    {
+        auto* addr6 = reinterpret_cast<sockaddr_in6*>(&serverAddr);
+        addr6->sin6_family = AF_INET6;
+        addr6->sin6_port = htons(config.port);
+        if (inet_pton(AF_INET6, address.c_str(), &addr6->sin6_addr) != 1)
+        {
+            LOG(FATAL) << "Invalid bind address: " << address;
+            exit(EXIT_FAILURE);
+        }
+        addrLen = sizeof(sockaddr_in6);
+        listenFd = socket(AF_INET6, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd == -1 && errno == EAFNOSUPPORT && config.bindAddress.empty())
+        {
+            LOG(WARNING) << "IPv6 unavailable, listening on 0.0.0.0";
+            address = "0.0.0.0";
+            serverAddr = sockaddr_storage{};
+        }
+    }
+    if (address.find(':') == std::string::npos)
+    {
+        auto* addr4 = reinterpret_cast<sockaddr_in*>(&serverAddr);
+        addr4->sin_family = AF_INET;
+        addr4->sin_port = htons(config.port);
+        if (inet_pton(AF_INET, address.c_str(), &addr4->sin_addr) != 1)
+        {
+            LOG(FATAL) << "Invalid bind address: " << address;
+            exit(EXIT_FAILURE);
+        }
+        addrLen = sizeof(sockaddr_in);
+        listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    }
     if (listenFd == -1)
     {
         LOG(FATAL) << "Socket creation failed: " << strerror(errno);
@@ -28,243 +292,2914 @@ HttpServer::HttpServer(int port, int threadNum)
         LOG(ERROR) << "Set SO_REUSEADDR failed: " << strerror(errno);
     }
 
-    // 绑定地址结构体
-    struct sockaddr_in serverAddr{};
-    serverAddr.sin_family = AF_INET;
-    serverAddr.sin_port = htons(port);
-    serverAddr.sin_addr.s_addr = INADDR_ANY;
+    // 多个socket绑定同一端口，内核按四元组哈希分发新连接
+    if (reusePort && setsockopt(listenFd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0)
+    {
+        LOG(FATAL) << "Set SO_REUSEPORT failed: " << strerror(errno);
+        close(listenFd);
+        exit(EXIT_FAILURE);
+    }
+
+    // 双栈：IPv6 socket同时接受IPv4连接
+    if (serverAddr.ss_family == AF_INET6)
+    {
+        int v6only = config.ipv6Only ? 1 : 0;
+        if (setsockopt(listenFd, IPPROTO_IPV6, IPV6_V6ONLY, &v6only, sizeof(v6only)) < 0)
+        {
+            LOG(ERROR) << "Set IPV6_V6ONLY failed: " << strerror(errno);
+        }
+    }
+
+    // TCP选项：由新连接继承的TCP_NODELAY、数据到达后才交付连接的TCP_DEFER_ACCEPT、TCP Fast Open
+    if (config.tcpNoDelay && setsockopt(listenFd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt)) < 0)
+    {
+        LOG(ERROR) << "Set TCP_NODELAY failed: " << strerror(errno);
+    }
+    if (config.deferAcceptSeconds > 0 &&
+        setsockopt(listenFd, IPPROTO_TCP, TCP_DEFER_ACCEPT, &config.deferAcceptSeconds,
+                   sizeof(config.deferAcceptSeconds)) < 0)
+    {
+        LOG(ERROR) << "Set TCP_DEFER_ACCEPT failed: " << strerror(errno);
+    }
+    if (config.fastOpenQueue > 0 &&
+        setsockopt(listenFd, IPPROTO_TCP, TCP_FASTOPEN, &config.fastOpenQueue, sizeof(config.fastOpenQueue)) < 0)
+    {
+        LOG(ERROR) << "Set TCP_FASTOPEN failed: " << strerror(errno);
+    }
 
     // 绑定socket
-    if (bind(listenFd, (struct sockaddr *)&serverAddr, sizeof(serverAddr)) < 0)
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&serverAddr), addrLen) < 0)
     {
-        LOG(FATAL) << "Bind failed: " << strerror(errno);
+        LOG(FATAL) << "Bind to " << address << " failed: " << strerror(errno);
         close(listenFd);
         exit(EXIT_FAILURE);
     }
 
     // 开始监听
-    if (listen(listenFd, SOMAXCONN) < 0)
+    if (listen(listenFd, config.listenBacklog > 0 ? config.listenBacklog : SOMAXCONN) < 0)
     {
         LOG(FATAL) << "Listen failed: " << strerror(errno);
         close(listenFd);
         exit(EXIT_FAILURE);
     }
-
-    // 将监听socket加入epoll，用于监听新的事件
-    epoll.addFd(listenFd, EPOLLIN);
-    LOG(INFO) << "Server initialized on port " << port;
+    return listenFd;
 }
 
 /**
  * @brief 启动服务器主循环
+ *
+ * 多Reactor模式下第0个循环运行在调用线程，其余各自启动线程
  */
 void HttpServer::start()
 {
     LOG(INFO) << "Server started, entering event loop";
-        while (true)
-        {
-            // 等待事件发生（无限阻塞）
-            int numEvents = epoll.wait();
+    for (size_t i = 1; i < reactors.size(); ++i)
+    {
+        Reactor* r = reactors[i].get();
+        r->thread = std::thread([r] { r->loop.loop(); });
+    }
+    reactors[0]->loop.loop();
+}
 
-            // 处理所有就绪事件
-            for (int i = 0; i < numEvents; ++i)
+/**
+ * @brief 处理连接上的Epoll事件
+ */
+void HttpServer::handleEvent(Reactor* reactor, const ConnectionPtr& conn, uint32_t events)
+{
+    // 处理客户端连接事件
+    if (events & (EPOLLERR | EPOLLHUP))
+    {
+        LOG(WARNING) << "Error event on fd " << conn->fd;
+        closeConnection(reactor, conn);
+    }
+    else if (events & (EPOLLIN | EPOLLOUT))
+    {
+        int64_t readyNs = reactor->loop.pollTimeNs();
+        if (multiReactor)
+        {
+            // 多Reactor模式下在本线程处理到底，不跨线程
+            handleConnection(reactor, conn, events, readyNs);
+        }
+        else
+        {
+            // 将读写事件提交给线程池处理；队列已满被拒绝或排队后被丢弃时，
+            // 在提交线程中读取请求头并直接回复503，不占用工作线程
+            auto shed = [this, reactor, conn, events, readyNs]
+            { handleConnection(reactor, conn, events, readyNs, true); };
+            if (!pool.enqueue([this, reactor, conn, events, readyNs]
+                              { handleConnection(reactor, conn, events, readyNs); }, shed))
             {
-                //事件event
-                const auto &event = epoll.events()[i];
-                int fd = event.data.fd;
-                uint32_t events = event.events;
-
-                // 如果该事件是监听事件，建立连结
-                if (fd == listenFd)
-                {
-                    // 处理新连接请求
-                    acceptConnection();
-                }
-                else
-                {
-                    // 处理客户端连接事件
-                    if (events & (EPOLLERR | EPOLLHUP))
-                    {
-                        LOG(WARNING) << "Error event on fd " << fd;
-                        closeConnection(fd);
-                    }
-                    else if (events & EPOLLIN)
-                    {
-                        // 将读事件提交给线程池处理
-                        pool.enqueue([this, fd]
-                                    { handleRequest(fd); });
-                    }
-                }
+                shed();
             }
         }
+    }
 }
 
 /**
- * @brief 发送错误响应
+ * @brief 在持有连接锁的情况下分发读写事件
  */
-void HttpServer::sendErrorResponse(int fd, int code, const std::string &message)
+void HttpServer::handleConnection(Reactor* reactor, const ConnectionPtr& conn, uint32_t events, int64_t readyNs,
+                                  bool shed)
 {
-    const std::string body =
-        "<html><body><h1>" + std::to_string(code) + " " + message + "</h1></body></html>";
+    std::lock_guard<std::mutex> lock(conn->mutex);
+    if (conn->closed)
+    {
+        return;
+    }
+    conn->readyNs = readyNs;
+    int64_t nowNs = EventLoop::nowNs();
+    stats.queueWait.record(static_cast<uint64_t>(nowNs - readyNs));
 
-    const std::string response =
-        "HTTP/1.1 " + std::to_string(code) + " " + message + "\r\n"
-                                                             "Content-Type: text/html\r\n"
-                                                             "Content-Length: " +
-        std::to_string(body.size()) + "\r\n"
-                                      "Connection: close\r\n"
-                                      "\r\n" +
-        body;
+    // 单Reactor模式下排队时间即线程池排队时间，持续积压时排队过久的请求直接回复503
+    conn->shedRequest = shed || (!multiReactor && admission.shouldShed(nowNs - readyNs, nowNs));
+
+    if (events & EPOLLOUT)
+    {
+        handleWrite(reactor, conn);
+    }
+    if ((events & EPOLLIN) && !conn->closed && !conn->readPaused && !conn->closeAfterWrite &&
+        !conn->responsePending)
+    {
+        handleRequest(reactor, conn);
+    }
 
-    if (send(fd, response.data(), response.size(), 0) == -1)
+    // 处理结束后更新超时并重新激活EPOLLONESHOT的fd
+    if (!conn->closed)
     {
-        LOG(ERROR) << "Failed to send error response to fd " << fd;
+        refreshDeadline(reactor, conn);
+        updateEvents(conn, true);
     }
 }
 
 /**
- * @brief 接受新的客户端连接
+ * @brief 发送错误响应
  *
- * 1. 使用accept4非阻塞接收新连接
- * 2. 设置socket为非阻塞模式
- * 3. 将新连接加入epoll监控
+ * 常见错误响应在启动时已预先序列化，只需与Date头部一起写出。
+ * 报文格式错误、超限或请求体未读完时不保持连接（写完后关闭）；
+ * 完整读取的请求只是没有对应资源（404/405）时按请求本身的keepAlive决定
+ * @return 连接出错时返回false
  */
-void HttpServer::acceptConnection()
+bool HttpServer::sendErrorResponse(const ConnectionPtr& conn, int code, bool keepAlive,
+                                   const std::string& extraHeaders)
 {
-    struct sockaddr_in clientAddr{};
-    socklen_t addrLen = sizeof(clientAddr);
-
-    // 1.2.使用accept4非阻塞接收连接（SOCK_NONBLOCK）
-    int connFd = accept4(listenFd, (struct sockaddr *)&clientAddr,
-                         &addrLen, SOCK_NONBLOCK);
-    if (connFd == -1)
+    if (!keepAlive)
     {
-        LOG(ERROR) << "Accept failed: " << strerror(errno);
-        return;
+        conn->closeAfterWrite = true;
     }
+    stats.countResponse(code);
+    const bool headOnly = conn->parser.isHeaderComplete() && conn->parser.getMethod() == "HEAD";
 
-    // 转换客户端地址为字符串
-    char ipStr[INET_ADDRSTRLEN];
-
-    // 点分十进制转换为inet形式
-    inet_ntop(AF_INET, &clientAddr.sin_addr, ipStr, sizeof(ipStr));
-    LOG(INFO) << "Accepted connection from " << ipStr << ":"
-              << ntohs(clientAddr.sin_port) << " (fd: " << connFd << ")";
-
-    try
-    {
-        // 3.将新连接加入epoll（连接可读且设置为边缘触发模式）
-        epoll.addFd(connFd, EPOLLIN | EPOLLET);
-        LOG(DEBUG) << "Added new connection to epoll (fd: " << connFd << ")";
-    }
-    catch (const std::exception &e)
+    ResponseWriter writer;
+    auto it = errorResponses.find(code);
+    if (it != errorResponses.end() && extraHeaders.empty())
     {
-        LOG(ERROR) << "Failed to add fd " << connFd << " to epoll: " << e.what();
-        close(connFd);
+        writer.fixed(it->second, keepAlive, headOnly);
+        return sendVector(conn, writer);
     }
+
+    FixedResponse response = FixedResponse::make(code, "text/html", errorBody(code), serverHeader, extraHeaders);
+    writer.fixed(response, keepAlive, headOnly);
+    return sendVector(conn, writer);
 }
 
-// 发送函数
-void sendAll(int fd, const char *buf, size_t len)
+/**
+ * @brief 接受新的客户端连接
+ *
+ * 1. 循环accept4直到EAGAIN，一次可读事件处理一批连接，单轮数量受acceptBatch限制，
+ *    剩余的连接由水平触发的监听socket在下一轮继续交付
+ * 2. 新连接直接以非阻塞、close-on-exec方式创建
+ * 3. 将新连接加入epoll监控
+ */
+void HttpServer::acceptConnection(Reactor* reactor)
 {
-    size_t totalSent = 0;
-    
-    //如果数据没有发送完成，一直发送，直至完全发送结束
-    while (totalSent < len)
+    for (int i = 0; i < std::max(config.acceptBatch, 1); ++i)
     {
-        ssize_t sent = send(fd, buf + totalSent, len - totalSent, 0);
-        if (sent == -1)
+        sockaddr_storage clientAddr{};
+        socklen_t addrLen = sizeof(clientAddr);
+
+        // 1.2.使用accept4非阻塞接收连接（SOCK_NONBLOCK | SOCK_CLOEXEC）
+        int connFd = accept4(reactor->listenFd, reinterpret_cast<sockaddr*>(&clientAddr), &addrLen,
+                             SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (connFd == -1)
         {
+            // 已取完，或共享监听socket时被其他循环抢先
             if (errno == EAGAIN || errno == EWOULDBLOCK)
             {
-                // 等待可写事件（需配合EPOLLOUT事件处理）
+                return;
+            }
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
                 continue;
             }
-            throw std::runtime_error("send error: " + std::string(strerror(errno)));
+            if (errno == EMFILE || errno == ENFILE)
+            {
+                // fd耗尽：水平触发下连接留在队列中会不停触发，用预留的fd接受后立即关闭
+                LOG(ERROR) << "Accept failed: " << strerror(errno) << ", dropping connection";
+                close(reactor->idleFd);
+                int dropped = accept(reactor->listenFd, nullptr, nullptr);
+                if (dropped >= 0)
+                {
+                    close(dropped);
+                }
+                reactor->idleFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+                return;
+            }
+            LOG(ERROR) << "Accept failed: " << strerror(errno);
+            return;
+        }
+        LOG(DEBUG) << "Accepted connection from " << formatAddress(clientAddr) << " (fd: " << connFd << ")";
+
+        try
+        {
+            // 3.创建连接状态并加入epoll（连接可读且设置为边缘触发模式）
+            auto conn = std::make_shared<Connection>(connFd, &reactor->loop);
+            conn->events = initialEvents();
+            conn->requestStartMs = EventLoop::nowMs();
+            conn->acceptedNs = EventLoop::nowNs();
+            reactor->loop.addFd(connFd, conn->events, [this, reactor, conn](uint32_t events) {
+                handleEvent(reactor, conn, events);
+            });
+            reactor->connections[connFd] = conn;
+            stats.accepted.add();
+
+            // 第一个请求同样受请求头超时约束，防止只建连不发数据占用连接
+            refreshDeadline(reactor, conn);
+        }
+        catch (const std::exception &e)
+        {
+            LOG(ERROR) << "Failed to add fd " << connFd << " to epoll: " << e.what();
+            close(connFd);
         }
-        totalSent += sent;
     }
 }
 
 /**
- * @brief 处理HTTP请求
+ * @brief io_uring完成式路径：multishot accept交付的新连接
  *
- * 1. 读取请求数据
- * 2. 解析HTTP请求
+ * 连接不在事件源中注册，直接提交multishot recv，数据到达后以完成事件交付
  */
-void HttpServer::handleRequest(int fd)
+void HttpServer::acceptUring(Reactor* reactor, int connFd)
 {
-    char buffer[4096];
-    ssize_t bytesRead = read(fd, buffer, sizeof(buffer));
-
-    if (bytesRead > 0)
+    if (connFd < 0)
     {
-        // 移除终止符构建字符串
-        std::string request(buffer, bytesRead);
-
-        // 构建解析器
-        HttpParser parser;
-        parser.parse(request.data(), request.size());
-        sendResponse(fd);
+        if (connFd != -ECANCELED)
+        {
+            LOG(ERROR) << "Accept failed: " << strerror(-connFd);
+        }
+        return;
     }
+    LOG(DEBUG) << "Accepted connection (fd: " << connFd << ", io_uring)";
 
-    closeConnection(fd);
+    auto conn = std::make_shared<Connection>(connFd, &reactor->loop);
+    conn->uring = true;
+    conn->requestStartMs = EventLoop::nowMs();
+    conn->acceptedNs = EventLoop::nowNs();
+    reactor->connections[connFd] = conn;
+    stats.accepted.add();
+    startUringRecv(reactor, conn);
+    refreshDeadline(reactor, conn);
 }
 
+/**
+ * @brief 为连接提交multishot recv
+ */
+void HttpServer::startUringRecv(Reactor* reactor, const ConnectionPtr& conn)
+{
+    conn->recvOp = reactor->uring->recvMultishot(conn->fd, [this, reactor, conn](const char* data, ssize_t n) {
+        handleUringRecv(reactor, conn, data, n);
+    });
+}
 
-// 发送HTTP响应
-void HttpServer::sendResponse(int fd)
+/**
+ * @brief io_uring完成式路径：处理recv的完成事件
+ *
+ * 数据已由内核写入provided buffer，追加到输入缓冲后处理其中所有完整的请求，
+ * 本轮产生的全部响应合并为一次send提交
+ */
+void HttpServer::handleUringRecv(Reactor* reactor, const ConnectionPtr& conn, const char* data, ssize_t n)
 {
-    // 构造动态响应
-    const std::string body = "Hello World1111111111";
-    const std::string response =
-        "HTTP/1.1 200 OK\r\n"
-        "Content-Type: text/plain\r\n"
-        "Content-Length: " +
-        std::to_string(body.size()) + "\r\n"
-                                      "Connection: close\r\n"
-                                      "\r\n" +
-        body;
+    if (n <= 0)
+    {
+        conn->recvOp = 0;
+    }
+    if (conn->closed)
+    {
+        return;
+    }
 
-    // 完整发送数据
-    try
+    if (n < 0)
+    {
+        if (n != -ECANCELED)
+        {
+            LOG(ERROR) << "Read failed on fd " << conn->fd << ": " << strerror(static_cast<int>(-n));
+            closeConnection(reactor, conn);
+        }
+        else if (!conn->readPaused && !conn->closeAfterWrite)
+        {
+            // 暂停期间积压已回落，取消完成后重新提交
+            startUringRecv(reactor, conn);
+        }
+        return;
+    }
+    if (n == 0)
+    {
+        // 对端已关闭写方向：发完已有响应后关闭
+        if (!conn->hasPendingOutput())
+        {
+            closeConnection(reactor, conn);
+        }
+        else
+        {
+            conn->closeAfterWrite = true;
+        }
+        return;
+    }
+
+    // 同一轮循环中同一连接的多个数据块只记录第一块的排队时间，与epoll的一次就绪事件对应
+    if (conn->readyNs != reactor->loop.pollTimeNs())
+    {
+        conn->readyNs = reactor->loop.pollTimeNs();
+        stats.queueWait.record(static_cast<uint64_t>(EventLoop::nowNs() - conn->readyNs));
+    }
+    stats.bytesReceived.add(static_cast<uint64_t>(n));
+
+    // 暂停或等待关闭期间（取消尚未生效）到达的数据同样留在缓冲区，恢复后再处理
+    conn->inputBuffer.append(data, static_cast<size_t>(n));
+    processRequests(reactor, conn);
+    if (conn->closed)
+    {
+        return;
+    }
+
+    // 积压超过高水位或即将关闭：停止接收，直到输出回落
+    if ((conn->readPaused || conn->closeAfterWrite) && conn->recvOp != 0)
     {
-        sendAll(fd, response.data(), response.size());
-        LOG(INFO) << "Sent " << response.size() << " bytes to fd " << fd;
+        reactor->uring->cancel(conn->recvOp);
     }
-    catch (const std::exception &e)
+    flushUring(reactor, conn);
+    if (!conn->closed)
     {
-        LOG(ERROR) << "Send failed: " << e.what();
+        refreshDeadline(reactor, conn);
     }
-}   
+}
 
 /**
- * @brief 关闭连接并清理资源
+ * @brief io_uring完成式路径：提交积压的输出
  *
- * 1. 从epoll移除监控
- * 2. 关闭socket文件描述符
- * 3. 更新连接计数
+ * 输出缓冲整体移入sendBuffer后提交一次send，完成前sendBuffer保持不变，
+ * 期间新产生的响应继续追加到输出缓冲，下一次提交时一并发出。
+ * 文件区间仍用sendfile直接发送，socket写满时提交一次单次poll等待可写
  */
-void HttpServer::closeConnection(int fd)
+void HttpServer::flushUring(Reactor* reactor, const ConnectionPtr& conn)
 {
-    try
+    while (!conn->closed && !conn->sending)
+    {
+        if (!conn->pendingFiles.empty() && conn->bytesFlushed == conn->pendingFiles.front().startAt)
+        {
+            FileSegment& segment = conn->pendingFiles.front();
+            ssize_t n = sendfile(conn->fd, segment.file->fd, &segment.offset, segment.remaining);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                conn->sending = true;
+                reactor->uring->pollOnce(conn->fd, EPOLLOUT, [this, reactor, conn](uint32_t) {
+                    conn->sending = false;
+                    flushUring(reactor, conn);
+                });
+                return;
+            }
+            if (n <= 0)
+            {
+                LOG(ERROR) << "sendfile failed on fd " << conn->fd << ": "
+                           << (n == 0 ? "file truncated" : strerror(errno));
+                closeConnection(reactor, conn);
+                return;
+            }
+            stats.bytesSent.add(static_cast<uint64_t>(n));
+            segment.remaining -= static_cast<size_t>(n);
+            if (segment.remaining == 0)
+            {
+                conn->pendingFiles.erase(conn->pendingFiles.begin());
+            }
+            continue;
+        }
+
+        if (conn->outputBuffer.readableBytes() == 0)
+        {
+            onUringDrained(reactor, conn);
+            return;
+        }
+
+        // 有文件排队时只发送到文件起始位置为止，并带MSG_MORE与文件首段合并
+        size_t length = conn->outputBuffer.readableBytes();
+        int flags = 0;
+        if (!conn->pendingFiles.empty())
+        {
+            length = std::min<size_t>(length, conn->pendingFiles.front().startAt - conn->bytesFlushed);
+            flags = MSG_MORE;
+        }
+        conn->sendBuffer.assign(conn->outputBuffer.peek(), length);
+        conn->outputBuffer.retrieve(length);
+        conn->sendOffset = 0;
+        conn->sending = true;
+        conn->sendStartNs = EventLoop::nowNs();
+
+        submitUringSend(reactor, conn, flags);
+        return;
+    }
+}
+
+/**
+ * @brief 提交sendBuffer中尚未发送的部分
+ */
+void HttpServer::submitUringSend(Reactor* reactor, const ConnectionPtr& conn, int flags)
+{
+    reactor->uring->send(conn->fd, conn->sendBuffer.data() + conn->sendOffset,
+                         conn->sendBuffer.size() - conn->sendOffset, flags,
+                         [this, reactor, conn, flags](ssize_t n) {
+                             handleUringSent(reactor, conn, flags, n);
+                         });
+}
+
+/**
+ * @brief send完成：部分发送时继续提交剩余部分，全部发送后提交后续输出
+ */
+void HttpServer::handleUringSent(Reactor* reactor, const ConnectionPtr& conn, int flags, ssize_t n)
+{
+    if (conn->closed)
     {
-        // 从epoll移除
-        epoll.removeFd(fd);
-        LOG(DEBUG) << "Removed fd " << fd << " from epoll";
+        return;
     }
-    catch (const std::exception &e)
+    if (n < 0 && n != -EAGAIN && n != -EINTR)
     {
-        LOG(ERROR) << "Failed to remove fd " << fd << ": " << e.what();
+        LOG(ERROR) << "Send failed on fd " << conn->fd << ": " << strerror(static_cast<int>(-n));
+        closeConnection(reactor, conn);
+        return;
     }
-
-    // 关闭socket
-    if (close(fd) == -1)
+    if (n > 0)
     {
-        LOG(ERROR) << "Close failed for fd " << fd << ": " << strerror(errno);
+        conn->sendOffset += static_cast<size_t>(n);
+        conn->bytesFlushed += static_cast<uint64_t>(n);
+        stats.bytesSent.add(static_cast<uint64_t>(n));
     }
-    else
+    if (conn->sendOffset < conn->sendBuffer.size())
+    {
+        submitUringSend(reactor, conn, flags);
+        return;
+    }
+    stats.write.record(static_cast<uint64_t>(EventLoop::nowNs() - conn->sendStartNs));
+
+    conn->sendBuffer.clear();
+    conn->sendOffset = 0;
+    conn->sending = false;
+    flushUring(reactor, conn);
+    if (!conn->closed)
     {
-        LOG(INFO) << "Closed connection (fd: " << fd << ")";
+        refreshDeadline(reactor, conn);
     }
 }
+
+/**
+ * @brief io_uring完成式路径：输出全部写出
+ */
+void HttpServer::onUringDrained(Reactor* reactor, const ConnectionPtr& conn)
+{
+    // 因积压暂停的异步响应或HTTP/2消息体此时恢复，恢复后产生了新的输出则继续提交
+    if (conn->onWritable)
+    {
+        std::function<void()> onWritable = std::move(conn->onWritable);
+        conn->onWritable = nullptr;
+        onWritable();
+        if (conn->closed)
+        {
+            return;
+        }
+        if (conn->hasQueuedOutput())
+        {
+            flushUring(reactor, conn);
+            return;
+        }
+    }
+    // 异步生成中的响应还没有排队，完成后再继续
+    if (conn->responsePending)
+    {
+        return;
+    }
+    if (conn->closeAfterWrite)
+    {
+        closeConnection(reactor, conn);
+        return;
+    }
+    if (!conn->readPaused)
+    {
+        return;
+    }
+
+    // 恢复读取：先处理暂停期间留在缓冲区的请求，recv的取消完成后会自动重新提交
+    conn->readPaused = false;
+    processRequests(reactor, conn);
+    if (conn->closed)
+    {
+        return;
+    }
+    if (conn->recvOp == 0 && !conn->readPaused && !conn->closeAfterWrite)
+    {
+        startUringRecv(reactor, conn);
+    }
+    flushUring(reactor, conn);
+}
+
+/**
+ * @brief 发送数据
+ */
+bool HttpServer::sendData(const ConnectionPtr& conn, const char* data, size_t len)
+{
+    iovec vec{const_cast<char*>(data), len};
+    return sendIov(conn, &vec, 1, 0);
+}
+
+/**
+ * @brief 发送组装好的响应
+ */
+bool HttpServer::sendVector(const ConnectionPtr& conn, const ResponseWriter& writer, bool more)
+{
+    return sendIov(conn, writer.iov(), writer.iovCount(), more ? MSG_MORE : 0);
+}
+
+/**
+ * @brief 以一次系统调用发送多段数据
+ *
+ * 没有积压输出时先用sendmsg（带MSG_NOSIGNAL的writev）直接写socket，
+ * 内核接收不下的部分按顺序追加到输出缓冲，并关注EPOLLOUT等待可写后继续发送，
+ * 工作线程不会在EAGAIN上空转。
+ * @return 连接出错时返回false
+ */
+bool HttpServer::sendIov(const ConnectionPtr& conn, const iovec* iov, int iovcnt, int flags)
+{
+    size_t written = 0;
+    if (!conn->uring && !conn->hasPendingOutput())
+    {
+        msghdr msg{};
+        msg.msg_iov = const_cast<iovec*>(iov);
+        msg.msg_iovlen = static_cast<size_t>(std::min(iovcnt, IOV_MAX));
+        int64_t startNs = EventLoop::nowNs();
+        ssize_t n = sendmsg(conn->fd, &msg, MSG_NOSIGNAL | flags);
+        stats.write.record(static_cast<uint64_t>(EventLoop::nowNs() - startNs));
+        if (n >= 0)
+        {
+            written = static_cast<size_t>(n);
+            stats.bytesSent.add(static_cast<uint64_t>(n));
+        }
+        else if (errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            LOG(ERROR) << "Send failed on fd " << conn->fd << ": " << strerror(errno);
+            return false;
+        }
+    }
+
+    // 跳过已写出的部分，其余追加到输出缓冲
+    for (int i = 0; i < iovcnt; ++i)
+    {
+        size_t length = iov[i].iov_len;
+        if (written >= length)
+        {
+            written -= length;
+            continue;
+        }
+        conn->outputBuffer.append(static_cast<const char*>(iov[i].iov_base) + written, length - written);
+        conn->bytesQueued += length - written;
+        written = 0;
+    }
+
+    // 积压超过高水位，暂停读取新请求直到对端消费
+    if (conn->pendingBytes() >= config.outputHighWaterMark)
+    {
+        conn->readPaused = true;
+    }
+    updateEvents(conn);
+    return true;
+}
+
+/**
+ * @brief 排队文件区间并立即尝试发送
+ *
+ * 文件内容通过sendfile由内核直接拷贝到socket，不经过用户态缓冲
+ */
+bool HttpServer::sendFile(const ConnectionPtr& conn, const std::shared_ptr<const CachedFile>& file,
+                          off_t offset, size_t length)
+{
+    conn->pendingFiles.push_back(FileSegment{file, offset, length, conn->bytesQueued});
+    return sendQueued(conn);
+}
+
+/**
+ * @brief 写出已排队的输出，剩余部分等待EPOLLOUT
+ */
+bool HttpServer::sendQueued(const ConnectionPtr& conn)
+{
+    // 完成式路径在本轮请求处理完后统一提交
+    if (conn->uring)
+    {
+        return true;
+    }
+    if (!flushOutput(conn))
+    {
+        return false;
+    }
+    updateEvents(conn);
+    return true;
+}
+
+/**
+ * @brief 按入队顺序写出输出缓冲和文件区间
+ *
+ * 紧跟文件的响应头带MSG_MORE发送，让内核把头部与文件首段合并成同一个报文
+ */
+bool HttpServer::flushOutput(const ConnectionPtr& conn)
+{
+    while (conn->hasQueuedOutput())
+    {
+        if (!conn->pendingFiles.empty() && conn->bytesFlushed == conn->pendingFiles.front().startAt)
+        {
+            FileSegment& segment = conn->pendingFiles.front();
+            ssize_t n = sendfile(conn->fd, segment.file->fd, &segment.offset, segment.remaining);
+            if (n < 0)
+            {
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    return true;
+                }
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                LOG(ERROR) << "sendfile failed on fd " << conn->fd << ": " << strerror(errno);
+                return false;
+            }
+            if (n == 0)
+            {
+                // 文件在发送过程中被截断，已无法满足Content-Length
+                LOG(ERROR) << "File truncated while sending to fd " << conn->fd;
+                return false;
+            }
+            stats.bytesSent.add(static_cast<uint64_t>(n));
+            segment.remaining -= static_cast<size_t>(n);
+            if (segment.remaining == 0)
+            {
+                conn->pendingFiles.erase(conn->pendingFiles.begin());
+            }
+            continue;
+        }
+
+        // 有文件排队时只写到文件起始位置为止
+        size_t limit = SIZE_MAX;
+        int flags = 0;
+        if (!conn->pendingFiles.empty())
+        {
+            limit = conn->pendingFiles.front().startAt - conn->bytesFlushed;
+            flags = MSG_MORE;
+        }
+
+        int savedErrno = 0;
+        ssize_t n = conn->outputBuffer.writeFd(conn->fd, &savedErrno, limit, flags);
+        if (n < 0)
+        {
+            if (savedErrno == EAGAIN || savedErrno == EWOULDBLOCK)
+            {
+                return true;
+            }
+            if (savedErrno == EINTR)
+            {
+                continue;
+            }
+            LOG(ERROR) << "Send failed on fd " << conn->fd << ": " << strerror(savedErrno);
+            return false;
+        }
+        conn->bytesFlushed += static_cast<uint64_t>(n);
+        stats.bytesSent.add(static_cast<uint64_t>(n));
+    }
+    return true;
+}
+
+/**
+ * @brief 可写事件：继续发送积压的输出数据和文件
+ */
+void HttpServer::handleWrite(Reactor* reactor, const ConnectionPtr& conn)
+{
+    if (!flushOutput(conn))
+    {
+        closeConnection(reactor, conn);
+        return;
+    }
+
+    if (!conn->hasPendingOutput() && conn->closeAfterWrite)
+    {
+        closeConnection(reactor, conn);
+        return;
+    }
+
+    // 积压回落到高水位一半以下时恢复读取，以及恢复被暂停的异步响应
+    const bool drained = conn->pendingBytes() <= config.outputHighWaterMark / 2;
+    bool resumeRead = conn->readPaused && drained;
+    if (resumeRead)
+    {
+        conn->readPaused = false;
+    }
+    if (drained && conn->onWritable)
+    {
+        std::function<void()> onWritable = std::move(conn->onWritable);
+        conn->onWritable = nullptr;
+        onWritable();
+    }
+    updateEvents(conn);
+
+    // 暂停期间到达的数据不会再触发边缘事件，恢复后主动读一次
+    if (resumeRead)
+    {
+        handleRequest(reactor, conn);
+    }
+}
+
+/**
+ * @brief 根据连接状态计算并更新epoll关注的事件
+ */
+void HttpServer::updateEvents(const ConnectionPtr& conn, bool rearm)
+{
+    // 完成式路径的连接不在事件源中注册
+    if (conn->uring)
+    {
+        return;
+    }
+    uint32_t events = initialEvents();
+    // 单Reactor模式下异步响应完成前不读取，否则重新激活的EPOLLIN会不断把连接交给线程池
+    if (conn->readPaused || (!multiReactor && conn->responsePending))
+    {
+        events &= ~EPOLLIN;
+    }
+    if (conn->hasQueuedOutput())
+    {
+        events |= EPOLLOUT;
+    }
+
+    // 单Reactor模式：处理期间fd保持失活，统一在处理结束时激活
+    // 多Reactor模式：事件未变化时无需系统调用
+    if (multiReactor ? events == conn->events : !rearm)
+    {
+        return;
+    }
+
+    try
+    {
+        conn->loop->modFd(conn->fd, events);
+        conn->events = events;
+    }
+    catch (const std::exception& e)
+    {
+        LOG(ERROR) << "Failed to update events for fd " << conn->fd << ": " << e.what();
+    }
+}
+
+/**
+ * @brief 根据连接状态刷新超时截止时间
+ *
+ * - 有积压输出：距上次写出进展writeTimeoutMs
+ * - 正在接收请求体：距上次读到数据bodyTimeoutMs
+ * - 请求头未接收完整（含新连接的第一个请求）：从请求开始到达起headerTimeoutMs，
+ *   慢速发送请求头不会因为持续有数据而无限续期
+ * - 其余为空闲长连接：idleTimeoutMs
+ *
+ * 截止时间推后时不动定时器，到期后由handleTimeout按新的截止时间续期；
+ * 只有提前时才需要通知循环线程重新调度
+ */
+void HttpServer::refreshDeadline(Reactor* reactor, const ConnectionPtr& conn)
+{
+    int64_t now = EventLoop::nowMs();
+    int64_t deadline = 0;
+    // HTTP/2连接上的请求由各流分别完成，输入缓冲中留下的只是不完整的帧，按空闲计时
+    bool partialRequest = !conn->http2 && (conn->requestCount == 0 || conn->inputBuffer.readableBytes() > 0);
+
+    if (conn->hasPendingOutput() && config.writeTimeoutMs > 0)
+    {
+        deadline = now + config.writeTimeoutMs;
+    }
+    else if (conn->parser.isHeaderComplete() && config.bodyTimeoutMs > 0)
+    {
+        // 正在接收请求体：按读取进展计时，大文件上传不受请求头超时限制
+        deadline = now + config.bodyTimeoutMs;
+    }
+    else if (partialRequest && config.headerTimeoutMs > 0)
+    {
+        if (conn->requestStartMs == 0)
+        {
+            conn->requestStartMs = now;
+        }
+        deadline = conn->requestStartMs + config.headerTimeoutMs;
+    }
+    else if (config.idleTimeoutMs > 0)
+    {
+        deadline = now + config.idleTimeoutMs;
+    }
+
+    // 与handleTimeout中“先清timerExpire再读deadline”配对，两边至少有一方看到对方的写入
+    conn->deadline.store(deadline);
+    int64_t expire = conn->timerExpire.load();
+    if (deadline != 0 && (expire == 0 || deadline < expire))
+    {
+        reactor->loop.runInLoop([this, reactor, conn] {
+            if (!conn->closed)
+            {
+                armTimer(reactor, conn);
+            }
+        });
+    }
+}
+
+/**
+ * @brief 按截止时间调度连接的超时定时器
+ *
+ * 优先复用已有定时器节点，节点已被回收时才新建
+ */
+void HttpServer::armTimer(Reactor* reactor, const ConnectionPtr& conn)
+{
+    int64_t deadline = conn->deadline.load();
+    if (deadline == 0)
+    {
+        return;
+    }
+
+    int64_t delay = std::max<int64_t>(0, deadline - EventLoop::nowMs());
+    if (!reactor->loop.restartTimer(conn->timer, delay))
+    {
+        std::weak_ptr<Connection> weakConn = conn;
+        conn->timer = reactor->loop.runAfter(delay, [this, reactor, weakConn] {
+            handleTimeout(reactor, weakConn);
+        });
+    }
+    conn->timerExpire.store(deadline);
+}
+
+/**
+ * @brief 连接超时定时器到期
+ *
+ * 定时器只持有连接的弱引用，连接已关闭时什么也不做
+ */
+void HttpServer::handleTimeout(Reactor* reactor, const std::weak_ptr<Connection>& weakConn)
+{
+    ConnectionPtr conn = weakConn.lock();
+    if (!conn || conn->closed)
+    {
+        return;
+    }
+
+    conn->timerExpire.store(0);
+    int64_t deadline = conn->deadline.load();
+    if (deadline == 0)
+    {
+        return;
+    }
+    if (EventLoop::nowMs() < deadline)
+    {
+        // 期间有新的活动，按新的截止时间续期
+        armTimer(reactor, conn);
+        return;
+    }
+
+    // 连接正被工作线程处理，处理结束时会刷新截止时间，稍后再检查
+    std::unique_lock<std::mutex> lock(conn->mutex, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        reactor->loop.restartTimer(conn->timer, TIMEOUT_RETRY_MS);
+        conn->timerExpire.store(EventLoop::nowMs() + TIMEOUT_RETRY_MS);
+        return;
+    }
+    if (conn->closed || EventLoop::nowMs() < conn->deadline.load())
+    {
+        if (!conn->closed)
+        {
+            armTimer(reactor, conn);
+        }
+        return;
+    }
+
+    LOG(INFO) << "Connection timed out (fd: " << conn->fd << ", "
+              << (conn->hasPendingOutput() ? "write" : conn->requestStartMs != 0 ? "header" : "idle")
+              << ")";
+    closeConnection(reactor, conn);
+}
+
+/**
+ * @brief 新连接初始关注的事件
+ *
+ * 单Reactor模式下同一fd的事件会被投递到线程池，使用EPOLLONESHOT
+ * 保证一个连接同一时刻只被一个工作线程处理
+ */
+uint32_t HttpServer::initialEvents() const
+{
+    return multiReactor ? (EPOLLIN | EPOLLET) : (EPOLLIN | EPOLLET | EPOLLONESHOT);
+}
+
+/**
+ * @brief 处理HTTP请求
+ *
+ * 1. 边缘触发模式下循环读取直到EAGAIN，数据追加到连接的输入缓冲区
+ * 2. 增量解析，不完整的请求留在缓冲区等待后续数据
+ * 3. 依次处理缓冲区中所有完整的流水线请求
+ * 4. 根据长连接语义决定响应后保持还是关闭连接
+ */
+void HttpServer::handleRequest(Reactor* reactor, const ConnectionPtr& conn)
+{
+    // 单次读取的上限，避免一个连接长时间独占线程，也限制输入缓冲的增长
+    constexpr size_t kMaxReadPerRound = 1024 * 1024;
+
+    bool drained = false;
+    bool peerClosed = false;
+    while (!drained && !conn->closed && !conn->readPaused && !conn->closeAfterWrite && !conn->responsePending)
+    {
+        // 1.读取数据直到EAGAIN或达到本轮上限
+        size_t roundBytes = 0;
+        while (roundBytes < kMaxReadPerRound)
+        {
+            int savedErrno = 0;
+            ssize_t n = conn->inputBuffer.readFd(conn->fd, &savedErrno);
+            if (n > 0)
+            {
+                roundBytes += n;
+                stats.bytesReceived.add(static_cast<uint64_t>(n));
+                continue;
+            }
+            if (n == 0)
+            {
+                peerClosed = true;
+                drained = true;
+                break;
+            }
+            if (savedErrno == EINTR)
+            {
+                continue;
+            }
+            if (savedErrno == EAGAIN || savedErrno == EWOULDBLOCK)
+            {
+                drained = true;
+                break;
+            }
+            // 读出错
+            LOG(ERROR) << "Read failed on fd " << conn->fd << ": " << strerror(savedErrno);
+            closeConnection(reactor, conn);
+            return;
+        }
+
+        // 2.3.处理缓冲区中所有完整的请求
+        if (!processRequests(reactor, conn))
+        {
+            return;
+        }
+    }
+
+    // 对端已关闭写方向：发完已有响应后关闭
+    if (peerClosed && !conn->closed)
+    {
+        if (!conn->hasPendingOutput())
+        {
+            closeConnection(reactor, conn);
+        }
+        else
+        {
+            conn->closeAfterWrite = true;
+        }
+    }
+}
+
+/**
+ * @brief 依次解析并响应输入缓冲区中的完整请求
+ * @return 连接已被关闭时返回false
+ */
+bool HttpServer::processRequests(Reactor* reactor, const ConnectionPtr& conn)
+{
+    if (conn->http2)
+    {
+        return processHttp2(reactor, conn);
+    }
+    HttpParser& parser = conn->parser;
+    Buffer& input = conn->inputBuffer;
+
+    // 请求体分片：路由注册了流式处理器时直接交给它，否则缓存在连接上
+    const HttpParser::BodyCallback onBody = [&conn](std::string_view data) {
+        if (conn->route != nullptr && conn->route->onBody)
+        {
+            Request request(conn->parser, conn->params, std::string_view());
+            conn->route->onBody(request, data);
+        }
+        else
+        {
+            conn->body.append(data.data(), data.size());
+        }
+    };
+
+    while (input.readableBytes() > 0 && !conn->readPaused && !conn->closeAfterWrite && !conn->responsePending)
+    {
+        // 明文HTTP/2（prior knowledge）：新连接以连接前言开头，只收到前言的一部分时等待
+        if (config.http2 && conn->requestCount == 0 && !parser.isHeaderComplete())
+        {
+            size_t n = std::min(input.readableBytes(), Http2Session::PREFACE.size());
+            if (std::string_view(input.peek(), n) == Http2Session::PREFACE.substr(0, n))
+            {
+                if (n < Http2Session::PREFACE.size())
+                {
+                    break;
+                }
+                startHttp2(conn);
+                conn->http2->start();
+                return processHttp2(reactor, conn);
+            }
+        }
+
+        // 1.解析请求头，解析结果引用输入缓冲区，请求处理完之后才移除请求头；
+        //   只交给解析器前maxHeaderSize字节，超长的请求头不会被完整扫描
+        if (!parser.isHeaderComplete())
+        {
+            int64_t parseStart = EventLoop::nowNs();
+            conn->headerLength = parser.parse(input.peek(), std::min(input.readableBytes(), config.maxHeaderSize));
+            conn->parseNs += EventLoop::nowNs() - parseStart;
+            if (parser.hasError())
+            {
+                LOG(WARNING) << "Malformed request on fd " << conn->fd;
+                return finishErrorResponse(reactor, conn, 400);
+            }
+            if (!parser.isHeaderComplete())
+            {
+                // 前maxHeaderSize字节中请求头仍未结束
+                if (input.readableBytes() > config.maxHeaderSize)
+                {
+                    LOG(WARNING) << "Request header too large on fd " << conn->fd;
+                    return finishErrorResponse(reactor, conn, 431);
+                }
+                break;
+            }
+            stats.parse.record(static_cast<uint64_t>(conn->parseNs));
+            conn->parseNs = 0;
+            if (!parser.isKnownVersion())
+            {
+                LOG(WARNING) << "Unsupported version " << parser.getVersion() << " on fd " << conn->fd;
+                return finishErrorResponse(reactor, conn, 505);
+            }
+            if (conn->shedRequest)
+            {
+                stats.shed.add();
+                return finishErrorResponse(reactor, conn, 503);
+            }
+            if (!startRequestBody(reactor, conn))
+            {
+                return false;
+            }
+        }
+        else if (conn->requestBase != input.peek())
+        {
+            // 读取请求体期间输入缓冲区可能已搬移，解析结果和路由参数改为引用新地址
+            parser.rebase(input.peek());
+            conn->params.rebase(conn->requestBase, input.peek());
+            conn->requestBase = input.peek();
+        }
+
+        // 2.解码请求体，已解码的部分立即从缓冲区移除，只保留请求头
+        if (!parser.isComplete())
+        {
+            size_t used = parser.parseBody(input.peek() + conn->headerLength,
+                                           input.readableBytes() - conn->headerLength, onBody,
+                                           config.maxBodySize);
+            input.erase(conn->headerLength, used);
+            if (parser.hasError())
+            {
+                LOG(WARNING) << "Malformed request body on fd " << conn->fd;
+                return finishErrorResponse(reactor, conn, 400);
+            }
+            if (parser.exceedsBodyLimit())
+            {
+                LOG(WARNING) << "Chunked request body exceeds limit on fd " << conn->fd;
+                return finishErrorResponse(reactor, conn, 413);
+            }
+            if (!parser.isComplete())
+            {
+                break;
+            }
+        }
+
+        // Upgrade: h2c：回复101后该请求作为流1在HTTP/2上响应，之后的数据全部是HTTP/2帧
+        if (config.http2 && upgradeHttp2(conn))
+        {
+            return processHttp2(reactor, conn);
+        }
+
+        // 3.请求完整，生成响应；达到单连接请求数上限后主动关闭
+        ++conn->requestCount;
+        conn->requestStartMs = 0;
+        bool keepAlive = parser.shouldKeepAlive() &&
+                         (config.maxKeepAliveRequests <= 0 ||
+                          conn->requestCount < config.maxKeepAliveRequests);
+        conn->closeAfterWrite = !keepAlive;
+        bool sent = sendResponse(reactor, conn, keepAlive);
+        if (conn->requestDeferred)
+        {
+            // 同一个缓存键正由其他请求生成：请求留在输入缓冲中，被唤醒后从这里重新处理
+            conn->requestDeferred = false;
+            --conn->requestCount;
+            conn->closeAfterWrite = false;
+            break;
+        }
+        int64_t sentNs = EventLoop::nowNs();
+        stats.requests.add();
+        stats.request.record(static_cast<uint64_t>(sentNs - conn->readyNs));
+        if (conn->requestCount == 1)
+        {
+            stats.acceptToFirstByte.record(static_cast<uint64_t>(sentNs - conn->acceptedNs));
+        }
+        parser.reset();
+        input.retrieve(conn->headerLength);
+        conn->headerLength = 0;
+        conn->body.clear();
+        conn->route = nullptr;
+        conn->params.clear();
+        conn->requestBase = nullptr;
+        conn->arena.reset();
+
+        // 发送出错，或需要关闭且响应已全部写出：立即关闭；否则等EPOLLOUT写完后关闭
+        if (!sent || (conn->closeAfterWrite && !conn->hasPendingOutput()))
+        {
+            closeConnection(reactor, conn);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 请求头完整后、读取请求体之前的检查
+ *
+ * 声明的长度超出上限时直接返回413，不读取请求体；
+ * 客户端带Expect: 100-continue且请求体尚未开始发送时先回复100 Continue
+ * @return 连接已被关闭时返回false
+ */
+bool HttpServer::startRequestBody(Reactor* reactor, const ConnectionPtr& conn)
+{
+    const HttpParser& parser = conn->parser;
+
+    // 匹配路由，查询串不参与匹配
+    std::string_view target = parser.getPath();
+    conn->route = router.match(parser.getMethod(), target.substr(0, target.find('?')), conn->params);
+    conn->requestBase = conn->inputBuffer.peek();
+
+    // 没有处理器接收请求体时不必读取它
+    std::string_view method = parser.getMethod();
+    if (!parser.isComplete() && conn->route == nullptr &&
+        !(staticFiles && (method == "GET" || method == "HEAD")))
+    {
+        return finishErrorResponse(reactor, conn, 404);
+    }
+
+    if (parser.bodyType() == HttpParser::BodyType::CONTENT_LENGTH &&
+        parser.contentLength() > config.maxBodySize)
+    {
+        LOG(WARNING) << "Request body of " << parser.contentLength()
+                     << " bytes exceeds limit on fd " << conn->fd;
+        return finishErrorResponse(reactor, conn, 413);
+    }
+
+    if (!parser.isComplete() && parser.expectsContinue() && parser.getVersion() == "HTTP/1.1" &&
+        conn->inputBuffer.readableBytes() == conn->headerLength)
+    {
+        static const char CONTINUE[] = "HTTP/1.1 100 Continue\r\n\r\n";
+        if (!sendData(conn, CONTINUE, sizeof(CONTINUE) - 1))
+        {
+            closeConnection(reactor, conn);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 发送错误响应，已全部写出时立即关闭连接
+ * @return 总是返回false，表示不再处理该连接上的后续请求
+ */
+bool HttpServer::finishErrorResponse(Reactor* reactor, const ConnectionPtr& conn, int code)
+{
+    if (!sendErrorResponse(conn, code) || !conn->hasPendingOutput())
+    {
+        closeConnection(reactor, conn);
+    }
+    return false;
+}
+
+/**
+ * @brief 在连接上开始HTTP/2会话
+ *
+ * 会话的回调都在processHttp2（或升级）期间、持有连接锁时调用，因此直接引用连接
+ */
+void HttpServer::startHttp2(const ConnectionPtr& conn)
+{
+    Http2Session::Options options;
+    options.maxConcurrentStreams = config.http2MaxStreams;
+    options.streamWindow = std::min<uint32_t>(config.http2StreamWindow, INT32_MAX);
+    options.connectionWindow = static_cast<uint32_t>(std::min<uint64_t>(uint64_t(options.streamWindow) * 16, INT32_MAX));
+    options.maxHeaderSize = config.maxHeaderSize;
+
+    Connection* c = conn.get();
+    Http2Session::Handler handler;
+    handler.onHeaders = [this, c](Http2Stream& stream) {
+        stats.http2Streams.add();
+        const HttpParser& parser = stream.parser;
+        std::string_view target = parser.getPath();
+        stream.route = router.match(parser.getMethod(), target.substr(0, target.find('?')), stream.params);
+
+        // 与startRequestBody相同：没有处理器接收请求体时不读取，声明的长度超出上限时直接拒绝
+        std::string_view method = parser.getMethod();
+        if (!stream.remoteClosed && stream.route == nullptr &&
+            !(staticFiles && (method == "GET" || method == "HEAD")))
+        {
+            respondHttp2Error(*c->http2, stream, 404);
+            return;
+        }
+        if (parser.bodyType() == HttpParser::BodyType::CONTENT_LENGTH && parser.contentLength() > config.maxBodySize)
+        {
+            respondHttp2Error(*c->http2, stream, 413);
+        }
+    };
+    handler.onData = [this, c](Http2Stream& stream, std::string_view data) {
+        if (stream.bodyBytes > config.maxBodySize)
+        {
+            respondHttp2Error(*c->http2, stream, 413);
+            return;
+        }
+        if (stream.route != nullptr && stream.route->onBody)
+        {
+            Request request(stream.parser, stream.params, std::string_view());
+            stream.route->onBody(request, data);
+        }
+        else
+        {
+            stream.body.append(data.data(), data.size());
+        }
+    };
+    handler.onRequest = [this, c](Http2Stream& stream) { dispatchHttp2(*c->http2, stream); };
+
+    conn->http2 = std::make_unique<Http2Session>(options, std::move(handler));
+    stats.http2Connections.add();
+}
+
+/**
+ * @brief 处理完整的HTTP/1.1请求中的h2c升级（RFC 7540 3.2）
+ *
+ * 请求带Upgrade: h2c、Connection: Upgrade, HTTP2-Settings和HTTP2-Settings头部时回复101并发送服务器连接前言，
+ * 原请求成为流1，在HTTP/2上响应
+ * @return 未升级时返回false，请求按HTTP/1.1继续处理
+ */
+bool HttpServer::upgradeHttp2(const ConnectionPtr& conn)
+{
+    HttpParser& parser = conn->parser;
+    std::string_view connection = parser.getHeader(HeaderId::CONNECTION);
+    if (parser.getVersion() != "HTTP/1.1" || !HttpHeaders::hasToken(parser.getHeader(HeaderId::UPGRADE), "h2c") ||
+        !HttpHeaders::hasToken(connection, "Upgrade") || !HttpHeaders::hasToken(connection, "HTTP2-Settings"))
+    {
+        return false;
+    }
+    startHttp2(conn);
+    Http2Session& session = *conn->http2;
+    if (!session.applyUpgradeSettings(parser.getHeader(HeaderId::HTTP2_SETTINGS)))
+    {
+        conn->http2.reset();
+        return false;
+    }
+
+    static const char SWITCHING[] = "HTTP/1.1 101 Switching Protocols\r\nConnection: Upgrade\r\nUpgrade: h2c\r\n\r\n";
+    sendData(conn, SWITCHING, sizeof(SWITCHING) - 1);
+    session.start();
+
+    // 请求头拷贝到流中重新解析，输入缓冲中只留下其后的HTTP/2数据
+    Http2Stream& stream = session.upgradeStream();
+    stream.head.assign(conn->inputBuffer.peek(), conn->headerLength);
+    stream.parser.parse(stream.head.data(), stream.head.size());
+    std::string_view target = stream.parser.getPath();
+    stream.route = router.match(stream.parser.getMethod(), target.substr(0, target.find('?')), stream.params);
+    stream.body = std::move(conn->body);
+    stream.bodyBytes = stream.body.size();
+    stats.http2Streams.add();
+
+    parser.reset();
+    conn->inputBuffer.retrieve(conn->headerLength);
+    conn->headerLength = 0;
+    conn->body.clear();
+    conn->route = nullptr;
+    conn->params.clear();
+    conn->requestBase = nullptr;
+    ++conn->requestCount;
+    conn->requestStartMs = 0;
+
+    dispatchHttp2(session, stream);
+    return true;
+}
+
+/**
+ * @brief 把输入缓冲中完整的HTTP/2帧交给会话，并写出生成的帧
+ * @return 连接已被关闭时返回false
+ */
+bool HttpServer::processHttp2(Reactor* reactor, const ConnectionPtr& conn)
+{
+    Http2Session& session = *conn->http2;
+    Buffer& input = conn->inputBuffer;
+    if (input.readableBytes() > 0 && !conn->closeAfterWrite)
+    {
+        input.retrieve(session.receive(input.peek(), input.readableBytes()));
+    }
+    if (!flushHttp2(reactor, conn))
+    {
+        closeConnection(reactor, conn);
+        return false;
+    }
+
+    // 连接错误（已发送GOAWAY）或对端GOAWAY后所有流都已结束：写完后关闭
+    if (session.finished())
+    {
+        conn->closeAfterWrite = true;
+        if (!conn->hasPendingOutput())
+        {
+            closeConnection(reactor, conn);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 写出会话生成的帧，并按流量控制窗口继续生成消息体的DATA帧
+ *
+ * 每次只生成一批，输出积压达到高水位时停止，积压回落（onWritable）后从这里继续，
+ * 大文件不会整个读入内存
+ * @return 发送出错时返回false
+ */
+bool HttpServer::flushHttp2(Reactor* reactor, const ConnectionPtr& conn)
+{
+    constexpr size_t kPumpBatch = 256 * 1024;
+
+    Http2Session& session = *conn->http2;
+    const size_t limit = config.outputHighWaterMark;
+    for (;;)
+    {
+        size_t pending = conn->pendingBytes();
+        if (session.hasReadyData() && pending < limit)
+        {
+            session.pump(std::min(limit - pending, kPumpBatch));
+        }
+        std::string& out = session.output();
+        if (out.empty())
+        {
+            break;
+        }
+        bool sent = sendData(conn, out.data(), out.size());
+        out.clear();
+        if (!sent)
+        {
+            return false;
+        }
+        if (!session.hasReadyData() || conn->pendingBytes() >= limit)
+        {
+            break;
+        }
+    }
+
+    if (session.hasReadyData())
+    {
+        std::weak_ptr<Connection> weakConn = conn;
+        conn->onWritable = [this, reactor, weakConn] {
+            ConnectionPtr c = weakConn.lock();
+            if (c && !c->closed && c->http2 && !flushHttp2(reactor, c))
+            {
+                closeConnection(reactor, c);
+            }
+        };
+    }
+    return true;
+}
+
+/**
+ * @brief 请求流完整后生成响应，与sendResponse的分派规则相同
+ *
+ * 固定响应和处理器的响应重新编码为HEADERS；反向代理和协程路由暂不支持HTTP/2，返回501
+ */
+void HttpServer::dispatchHttp2(Http2Session& session, Http2Stream& stream)
+{
+    stats.requests.add();
+    const HttpParser& parser = stream.parser;
+    const bool headOnly = parser.getMethod() == "HEAD";
+    const Route* route = stream.route;
+    if (route != nullptr)
+    {
+        if (route->fixed)
+        {
+            const FixedResponse& fixed = *route->fixed;
+            stats.countResponse(fixed.code);
+            std::string length = std::to_string(fixed.body.size());
+            std::vector<Http2Session::Field> fields;
+            fields.reserve(4);
+            if (!config.serverName.empty())
+            {
+                fields.push_back({"server", config.serverName});
+            }
+            fields.push_back({"date", dateValue()});
+            fields.push_back({"content-type", fixed.contentType});
+            fields.push_back({"content-length", length});
+            session.respond(stream, fixed.code, fields, headOnly ? std::string() : fixed.body);
+            return;
+        }
+        if (route->upstream || route->async)
+        {
+            respondHttp2Error(session, stream, 501);
+            return;
+        }
+
+        Request request(parser, stream.params, stream.body);
+        Response response;
+        int64_t handlerStart = EventLoop::nowNs();
+        try
+        {
+            route->handler(request, response);
+        }
+        catch (const std::exception& e)
+        {
+            LOG(ERROR) << "Handler for " << route->method << " " << route->pattern << " failed: " << e.what();
+            response = Response();
+            response.setStatus(500);
+            response.setBody("Internal Server Error");
+        }
+        stats.handler.record(static_cast<uint64_t>(EventLoop::nowNs() - handlerStart));
+        respondHttp2(session, stream, response);
+        return;
+    }
+
+    std::string_view method = parser.getMethod();
+    if (staticFiles && (method == "GET" || method == "HEAD"))
+    {
+        serveStaticFileHttp2(session, stream);
+        return;
+    }
+    std::string_view target = parser.getPath();
+    std::string allowed = router.allowedMethods(target.substr(0, target.find('?')));
+    if (!allowed.empty())
+    {
+        respondHttp2Error(session, stream, 405, allowed);
+        return;
+    }
+    respondHttp2Error(session, stream, 404);
+}
+
+/**
+ * @brief 以处理器填写的Response响应HTTP/2流
+ *
+ * 连接相关的头部不能出现在HTTP/2消息中，消息体长度由DATA帧决定，Content-Length按实际长度重新生成
+ */
+void HttpServer::respondHttp2(Http2Session& session, Http2Stream& stream, Response& response)
+{
+    const int status = response.status();
+    stats.countResponse(status);
+    const bool bodyAllowed = status >= 200 && status != 204 && status != 304;
+    const bool headOnly = stream.parser.getMethod() == "HEAD";
+
+    std::vector<Http2Session::Field> fields;
+    fields.reserve(response.headers().size() + 4);
+    if (!config.serverName.empty())
+    {
+        fields.push_back({"server", config.serverName});
+    }
+    fields.push_back({"date", dateValue()});
+    for (const auto& [name, value] : response.headers())
+    {
+        if (HttpHeaders::equalsIgnoreCase(name, "Content-Length") || isHopByHop(name, std::string_view()))
+        {
+            continue;
+        }
+        fields.push_back({name, value});
+    }
+    std::string length;
+    if (bodyAllowed)
+    {
+        if (!response.hasHeader("Content-Type"))
+        {
+            fields.push_back({"content-type", "text/plain"});
+        }
+        length = std::to_string(response.body().size());
+        fields.push_back({"content-length", length});
+    }
+    session.respond(stream, status, fields, bodyAllowed && !headOnly ? std::string(response.body()) : std::string());
+}
+
+/**
+ * @brief 以错误页响应HTTP/2流，allow非空时附带Allow头部（405）
+ */
+void HttpServer::respondHttp2Error(Http2Session& session, Http2Stream& stream, int code, std::string_view allow)
+{
+    stats.countResponse(code);
+    std::string body = errorBody(code);
+    std::string length = std::to_string(body.size());
+    std::vector<Http2Session::Field> fields;
+    if (!config.serverName.empty())
+    {
+        fields.push_back({"server", config.serverName});
+    }
+    fields.push_back({"date", dateValue()});
+    fields.push_back({"content-type", "text/html"});
+    fields.push_back({"content-length", length});
+    if (!allow.empty())
+    {
+        fields.push_back({"allow", allow});
+    }
+    if (stream.parser.getMethod() == "HEAD")
+    {
+        body.clear();
+    }
+    session.respond(stream, code, fields, std::move(body));
+}
+
+/**
+ * @brief 以静态文件响应HTTP/2流
+ *
+ * 与serveStaticFile相同的条件请求和单区间Range规则，文件内容由会话按窗口以pread分帧发送；
+ * 不选择压缩表示
+ */
+void HttpServer::serveStaticFileHttp2(Http2Session& session, Http2Stream& stream)
+{
+    const HttpParser& parser = stream.parser;
+    std::shared_ptr<const CachedFile> file = staticFiles->lookup(std::string(parser.getPath()));
+    if (!file)
+    {
+        respondHttp2Error(session, stream, 404);
+        return;
+    }
+
+    std::vector<Http2Session::Field> fields;
+    if (!config.serverName.empty())
+    {
+        fields.push_back({"server", config.serverName});
+    }
+    fields.push_back({"date", dateValue()});
+
+    if (StaticFileHandler::notModified(*file, file->etag, parser.getHeader(HeaderId::IF_NONE_MATCH),
+                                       parser.getHeader(HeaderId::IF_MODIFIED_SINCE)))
+    {
+        stats.countResponse(304);
+        fields.push_back({"etag", file->etag});
+        fields.push_back({"last-modified", file->lastModified});
+        session.respond(stream, 304, fields, std::string());
+        return;
+    }
+
+    off_t first = 0;
+    off_t last = file->size - 1;
+    auto range = StaticFileHandler::RangeResult::NONE;
+    std::string_view rangeHeader = parser.getHeader(HeaderId::RANGE);
+    if (!rangeHeader.empty())
+    {
+        std::string_view ifRange = parser.getHeader(HeaderId::IF_RANGE);
+        if (ifRange.empty() || ifRange == file->etag || ifRange == file->lastModified)
+        {
+            range = StaticFileHandler::parseRange(rangeHeader, file->size, first, last);
+        }
+    }
+
+    std::string contentRange;
+    if (range == StaticFileHandler::RangeResult::UNSATISFIABLE)
+    {
+        stats.countResponse(416);
+        contentRange = "bytes */" + std::to_string(file->size);
+        fields.push_back({"content-range", contentRange});
+        fields.push_back({"content-length", "0"});
+        session.respond(stream, 416, fields, std::string());
+        return;
+    }
+
+    const int status = range == StaticFileHandler::RangeResult::SATISFIABLE ? 206 : 200;
+    stats.countResponse(status);
+    size_t length = file->size == 0 ? 0 : static_cast<size_t>(last - first + 1);
+    std::string lengthValue = std::to_string(length);
+    if (status == 206)
+    {
+        contentRange = "bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" + std::to_string(file->size);
+        fields.push_back({"content-range", contentRange});
+    }
+    fields.push_back({"content-type", file->contentType});
+    fields.push_back({"last-modified", file->lastModified});
+    fields.push_back({"etag", file->etag});
+    fields.push_back({"accept-ranges", "bytes"});
+    fields.push_back({"content-length", lengthValue});
+    if (parser.getMethod() == "HEAD")
+    {
+        session.respondFile(stream, status, fields, nullptr, 0, 0);
+        return;
+    }
+    session.respondFile(stream, status, fields, std::move(file), first, length);
+}
+
+
+/**
+ * @brief 注册返回固定内容的路由
+ */
+void HttpServer::fixedRoute(std::string_view method, std::string_view pattern, int code,
+                            std::string_view contentType, std::string_view body)
+{
+    auto response = std::make_shared<const FixedResponse>(
+        FixedResponse::make(code, contentType, body, serverHeader));
+    router.add(method, pattern, std::move(response));
+}
+
+/**
+ * @brief 发送HTTP响应
+ *
+ * 优先由匹配到的路由处理；没有匹配时GET/HEAD交给静态文件处理器，
+ * 路径能被其他方法匹配时返回405，否则返回404
+ */
+bool HttpServer::sendResponse(Reactor* reactor, const ConnectionPtr& conn, bool keepAlive)
+{
+    if (conn->route != nullptr)
+    {
+        return sendRouteResponse(reactor, conn, keepAlive);
+    }
+
+    // 配置了静态根目录时，GET/HEAD请求由静态文件处理器响应
+    std::string_view method = conn->parser.getMethod();
+    if (staticFiles && (method == "GET" || method == "HEAD"))
+    {
+        return serveStaticFile(conn, keepAlive);
+    }
+
+    std::string_view target = conn->parser.getPath();
+    std::string allowed = router.allowedMethods(target.substr(0, target.find('?')));
+    if (!allowed.empty())
+    {
+        return sendErrorResponse(conn, 405, keepAlive, "Allow: " + allowed + "\r\n");
+    }
+    return sendErrorResponse(conn, 404, keepAlive);
+}
+
+/**
+ * @brief 线程池中压缩的响应，压缩完成后回到连接所属循环发送
+ */
+struct HttpServer::CompressionJob
+{
+    Response response;
+    CompressionChoice choice;
+    std::string encoded;     // 压缩后的消息体（choice.encoding为IDENTITY时为空）
+    bool keepAlive = false;
+    bool headOnly = false;
+};
+
+/**
+ * @brief 调用路由处理器并发送其响应
+ *
+ * 固定响应的路由直接写出预先序列化的内容；其余路由调用处理器，抛出异常时返回500。
+ * 需要压缩的消息体在单Reactor模式下就地压缩（已在工作线程中），多Reactor模式下交给线程池，
+ * 完成前连接上的后续请求留在输入缓冲中等待
+ */
+bool HttpServer::sendRouteResponse(Reactor* reactor, const ConnectionPtr& conn, bool keepAlive)
+{
+    const Route* route = conn->route;
+    const bool headOnly = conn->parser.getMethod() == "HEAD";
+    ResponseWriter writer;
+    if (route->fixed)
+    {
+        stats.countResponse(route->fixed->code);
+        writer.fixed(*route->fixed, keepAlive, headOnly);
+        return sendVector(conn, writer);
+    }
+    if (route->upstream)
+    {
+        return forwardRequest(reactor, conn, keepAlive);
+    }
+    if (route->async)
+    {
+        return startAsync(reactor, conn, keepAlive);
+    }
+
+    // 响应缓存：命中（或等到了同一个键的leader生成的条目）时不调用处理器
+    ResponseCache::Lookup cached;
+    if (responseCache && ResponseCache::cacheableRequest(conn->parser))
+    {
+        if (conn->cacheRetry)
+        {
+            // 被唤醒的请求：leader的条目适用于本请求时直接使用，否则自行生成，不再等待
+            conn->cacheRetry = false;
+            ResponseCache::EntryPtr entry = std::move(conn->cacheHandoff);
+            if (entry && ResponseCache::matches(*entry, conn->parser))
+            {
+                stats.cacheHits.add();
+                return sendCachedResponse(conn, entry, keepAlive, headOnly);
+            }
+            cached = responseCache->lookup(conn->parser, EventLoop::nowMs(), nullptr);
+        }
+        else
+        {
+            cached = responseCache->lookup(conn->parser, EventLoop::nowMs(),
+                                           [this, reactor, conn](const ResponseCache::EntryPtr& entry) {
+                                               reactor->loop.queueInLoop([this, reactor, conn, entry] {
+                                                   resumeCachedRequest(reactor, conn, entry);
+                                               });
+                                           });
+        }
+        if (cached.entry)
+        {
+            stats.cacheHits.add();
+            return sendCachedResponse(conn, cached.entry, keepAlive, headOnly);
+        }
+        if (cached.waiting)
+        {
+            stats.cacheCoalesced.add();
+            conn->requestDeferred = true;
+            conn->responsePending = true;
+            return true;
+        }
+        stats.cacheMisses.add();
+    }
+
+    // 响应分配在连接的请求内存池中，请求处理完后整体回收；异步压缩和缓存条目按堆分配器复制一份
+    Request request(conn->parser, conn->params, conn->body);
+    Response response(&conn->arena);
+    int64_t handlerStart = EventLoop::nowNs();
+    try
+    {
+        route->handler(request, response);
+    }
+    catch (const std::exception& e)
+    {
+        LOG(ERROR) << "Handler for " << route->method << " " << route->pattern << " failed: " << e.what();
+        response = Response(&conn->arena);
+        response.setStatus(500);
+        response.setBody("Internal Server Error");
+    }
+
+    stats.handler.record(static_cast<uint64_t>(EventLoop::nowNs() - handlerStart));
+
+    // leader无论响应是否可缓存都要唤醒等待者
+    if (!cached.key.empty() && !cached.pass)
+    {
+        ResponseCache::EntryPtr entry = responseCache->insert(conn->parser, response, EventLoop::nowMs());
+        if (cached.leader)
+        {
+            responseCache->complete(cached.key, entry);
+        }
+        if (entry)
+        {
+            return sendCachedResponse(conn, entry, keepAlive, headOnly);
+        }
+    }
+    stats.countResponse(response.status());
+
+    CompressionChoice choice = chooseCompression(conn->parser, response);
+    if (choice.encoding == ContentEncoding::IDENTITY)
+    {
+        return writeRouteResponse(conn, response, choice, response.body(), keepAlive, headOnly);
+    }
+
+    auto job = std::make_shared<CompressionJob>();
+    job->response = std::move(response);
+    job->choice = choice;
+    job->keepAlive = keepAlive;
+    job->headOnly = headOnly;
+    auto compress = [](CompressionJob& job) {
+        std::string_view body = job.response.body();
+        if (!Compression::compress(job.choice.encoding, job.choice.level, body, job.encoded) ||
+            job.encoded.size() >= body.size())
+        {
+            job.choice.encoding = ContentEncoding::IDENTITY;
+            job.encoded.clear();
+        }
+    };
+
+    if (!multiReactor)
+    {
+        compress(*job);
+        return writeRouteResponse(conn, job->response, job->choice,
+                                  job->choice.encoding == ContentEncoding::IDENTITY ? job->response.body() : job->encoded,
+                                  keepAlive, headOnly);
+    }
+
+    // 多Reactor模式下处理器在循环线程中运行，压缩交给线程池，不阻塞本循环的其他连接
+    // 线程池已满时不再压缩：被拒绝就地发送原始内容，排队后被丢弃则回到本循环发送原始内容
+    conn->responsePending = true;
+    auto dropped = [this, reactor, conn, job] {
+        job->choice.encoding = ContentEncoding::IDENTITY;
+        reactor->loop.runInLoop([this, reactor, conn, job] { finishCompressedResponse(reactor, conn, *job); });
+    };
+    if (!pool.enqueue([this, reactor, conn, job, compress] {
+            compress(*job);
+            reactor->loop.runInLoop([this, reactor, conn, job] { finishCompressedResponse(reactor, conn, *job); });
+        }, dropped))
+    {
+        conn->responsePending = false;
+        job->choice.encoding = ContentEncoding::IDENTITY;
+        return writeRouteResponse(conn, job->response, job->choice, job->response.body(), keepAlive, headOnly);
+    }
+    return true;
+}
+
+/**
+ * @brief 决定动态响应的编码
+ *
+ * 只压缩有消息体、未自行设置Content-Encoding、大小不低于compressMinSize且
+ * Content-Type在规则中级别大于0的响应
+ */
+HttpServer::CompressionChoice HttpServer::chooseCompression(const HttpParser& parser, const Response& response) const
+{
+    CompressionChoice choice;
+    const int status = response.status();
+    if (!config.compression || response.body().size() < config.compressMinSize || status < 200 ||
+        status == 204 || status == 206 || status == 304 || response.hasHeader("Content-Encoding"))
+    {
+        return choice;
+    }
+    std::string_view type = response.header("Content-Type");
+    choice.level = Compression::levelFor(config.compressionRules, type.empty() ? "text/plain" : type);
+    if (choice.level <= 0)
+    {
+        return choice;
+    }
+    choice.vary = true;
+    choice.encoding = Compression::negotiate(parser.getHeader(HeaderId::ACCEPT_ENCODING));
+    return choice;
+}
+
+/**
+ * @brief 写出处理器生成的响应
+ *
+ * Content-Length、Connection、Date和Server由服务器生成，HEAD请求以及204/304响应不发送消息体
+ */
+bool HttpServer::writeRouteResponse(const ConnectionPtr& conn, const Response& response,
+                                    const CompressionChoice& choice, std::string_view body, bool keepAlive,
+                                    bool headOnly, std::string_view extraHeaders)
+{
+    const int status = response.status();
+    const bool noBody = status == 204 || status == 304 || (status >= 100 && status < 200);
+
+    ResponseWriter writer;
+    writer.statusLine(status, response.reason());
+    writer.append(serverHeader);
+    writer.date();
+    for (const auto& header : response.headers())
+    {
+        if (HttpHeaders::equalsIgnoreCase(header.first, "Content-Length") ||
+            HttpHeaders::equalsIgnoreCase(header.first, "Connection"))
+        {
+            continue;
+        }
+        writer.header(header.first, header.second);
+    }
+    writer.append(extraHeaders);
+    if (!noBody)
+    {
+        if (!response.body().empty() && !response.hasHeader("Content-Type"))
+        {
+            writer.append("Content-Type: text/plain\r\n");
+        }
+        if (choice.encoding != ContentEncoding::IDENTITY)
+        {
+            writer.header("Content-Encoding", Compression::token(choice.encoding));
+        }
+        if (choice.vary)
+        {
+            writer.append(VARY_ACCEPT_ENCODING);
+        }
+        writer.header("Content-Length", static_cast<uint64_t>(body.size()));
+    }
+    writer.endHeaders(keepAlive);
+    if (!noBody && !headOnly)
+    {
+        writer.append(body);
+    }
+    return sendVector(conn, writer);
+}
+
+/**
+ * @brief 线程池压缩完成：发送响应，再继续处理等待期间留在输入缓冲中的请求
+ *
+ * 在连接所属循环线程中执行；连接已关闭（如超时）时丢弃结果
+ */
+void HttpServer::finishCompressedResponse(Reactor* reactor, const ConnectionPtr& conn, CompressionJob& job)
+{
+    std::lock_guard<std::mutex> lock(conn->mutex);
+    if (conn->closed)
+    {
+        return;
+    }
+    conn->responsePending = false;
+    std::string_view body = job.choice.encoding == ContentEncoding::IDENTITY ? std::string_view(job.response.body())
+                                                                             : std::string_view(job.encoded);
+    if (!writeRouteResponse(conn, job.response, job.choice, body, job.keepAlive, job.headOnly) ||
+        (conn->closeAfterWrite && !conn->hasPendingOutput()))
+    {
+        closeConnection(reactor, conn);
+        return;
+    }
+    resumeAfterResponse(reactor, conn);
+}
+
+/**
+ * @brief 异步响应写出后继续处理等待期间留在输入缓冲（及socket）中的请求
+ */
+void HttpServer::resumeAfterResponse(Reactor* reactor, const ConnectionPtr& conn)
+{
+    if (conn->uring)
+    {
+        processRequests(reactor, conn);
+        if (conn->closed)
+        {
+            return;
+        }
+        if ((conn->readPaused || conn->closeAfterWrite) && conn->recvOp != 0)
+        {
+            reactor->uring->cancel(conn->recvOp);
+        }
+        flushUring(reactor, conn);
+    }
+    else
+    {
+        // 等待期间到达的数据不会再触发边缘事件，主动读一次
+        handleRequest(reactor, conn);
+        if (conn->closed)
+        {
+            return;
+        }
+        updateEvents(conn);
+    }
+    if (!conn->closed)
+    {
+        refreshDeadline(reactor, conn);
+    }
+}
+
+/**
+ * @brief 以缓存的条目响应
+ *
+ * 按Accept-Encoding选择表示，条件请求与所选表示的ETag比较；304带上ETag、Cache-Control和Vary，
+ * 其余响应附加ETag和Age（条目在缓存中的秒数）
+ */
+bool HttpServer::sendCachedResponse(const ConnectionPtr& conn, const ResponseCache::EntryPtr& entry, bool keepAlive,
+                                    bool headOnly)
+{
+    const HttpParser& parser = conn->parser;
+    CompressionChoice choice = chooseCompression(parser, entry->response);
+    std::shared_ptr<const std::string> encoded;
+    if (choice.encoding != ContentEncoding::IDENTITY)
+    {
+        encoded = cachedEncoding(entry, choice);
+        if (!encoded || encoded->empty())
+        {
+            choice.encoding = ContentEncoding::IDENTITY;
+            encoded = nullptr;
+        }
+    }
+    const std::string& etag = entry->etags[static_cast<int>(choice.encoding)];
+
+    if (HttpHeaders::matchesETag(parser.getHeader(HeaderId::IF_NONE_MATCH), etag))
+    {
+        stats.countResponse(304);
+        ResponseWriter writer;
+        writer.statusLine(304);
+        writer.append(serverHeader);
+        writer.date();
+        writer.header("ETag", etag);
+        if (!entry->cacheControl.empty())
+        {
+            writer.header("Cache-Control", entry->cacheControl);
+        }
+        if (!entry->vary.empty())
+        {
+            writer.header("Vary", entry->vary);
+        }
+        if (choice.vary)
+        {
+            writer.append(VARY_ACCEPT_ENCODING);
+        }
+        writer.endHeaders(keepAlive);
+        return sendVector(conn, writer);
+    }
+
+    stats.countResponse(entry->response.status());
+    std::string extraHeaders = "ETag: " + etag + "\r\nAge: " +
+                               std::to_string((EventLoop::nowMs() - entry->storedMs) / 1000) + "\r\n";
+    return writeRouteResponse(conn, entry->response, choice,
+                              encoded ? std::string_view(*encoded) : std::string_view(entry->response.body()),
+                              keepAlive, headOnly, extraHeaders);
+}
+
+/**
+ * @brief 缓存条目的压缩表示
+ *
+ * 每种编码只压缩一次，结果挂在条目上；压缩后没有变小时保存空字符串，之后直接发送原始内容
+ */
+std::shared_ptr<const std::string> HttpServer::cachedEncoding(const ResponseCache::EntryPtr& entry,
+                                                              const CompressionChoice& choice)
+{
+    const int index = static_cast<int>(choice.encoding);
+    std::shared_ptr<const std::string> encoded = std::atomic_load(&entry->encoded[index]);
+    if (encoded || entry->compressStarted[index].exchange(true))
+    {
+        return encoded;
+    }
+    auto compress = [entry, choice, index] {
+        auto output = std::make_shared<std::string>();
+        std::string_view body = entry->response.body();
+        if (!Compression::compress(choice.encoding, choice.level, body, *output) || output->size() >= body.size())
+        {
+            output->clear();
+        }
+        std::atomic_store(&entry->encoded[index], std::shared_ptr<const std::string>(std::move(output)));
+    };
+
+    if (!multiReactor)
+    {
+        compress();
+        return std::atomic_load(&entry->encoded[index]);
+    }
+    // 线程池已满时放弃本次压缩，之后的请求再尝试
+    auto dropped = [entry, index] { entry->compressStarted[index] = false; };
+    if (!pool.enqueue(compress, dropped))
+    {
+        dropped();
+    }
+    return nullptr;
+}
+
+/**
+ * @brief 同一个缓存键的leader已完成：重新处理留在输入缓冲中的请求
+ *
+ * 在连接所属循环线程中执行；请求优先使用leader交来的条目，不适用时自行调用处理器
+ */
+void HttpServer::resumeCachedRequest(Reactor* reactor, const ConnectionPtr& conn, ResponseCache::EntryPtr entry)
+{
+    {
+        std::lock_guard<std::mutex> lock(conn->mutex);
+        if (conn->closed)
+        {
+            return;
+        }
+        conn->responsePending = false;
+        conn->cacheRetry = true;
+        conn->cacheHandoff = std::move(entry);
+        if (multiReactor)
+        {
+            resumeAfterResponse(reactor, conn);
+            return;
+        }
+    }
+
+    // 单Reactor模式：与普通的可读事件一样交给线程池
+    if (!conn->closed)
+    {
+        handleEvent(reactor, conn, EPOLLIN);
+    }
+}
+
+/**
+ * @brief 注册反向代理路由
+ */
+void HttpServer::proxy(std::string_view pattern, ProxyConfig config, const std::vector<std::string>& methods)
+{
+    auto group = std::make_shared<UpstreamGroup>(std::move(config));
+    for (const std::string& method : methods)
+    {
+        router.add(method, pattern, group);
+    }
+}
+
+/**
+ * @brief 一次转发在客户端一侧的状态，由各回调共享
+ */
+struct HttpServer::ProxyState
+{
+    std::weak_ptr<UpstreamPool::Exchange> exchange; // 弱引用，回调由exchange持有，避免循环引用
+    int64_t startNs = 0;        // 请求交给所属循环的时间
+    bool keepAlive = false;
+    bool headOnly = false;
+    bool http10 = false;        // 客户端为HTTP/1.0，不能使用chunked
+    bool chunked = false;       // 响应没有长度信息，以chunked重新分帧
+    bool headersSent = false;   // 已向客户端写出响应头
+};
+
+/**
+ * @brief 转发请求
+ *
+ * 请求报文按解析结果重新组装：去掉逐跳头部，请求体（已缓存在连接上）以Content-Length发送，
+ * 追加X-Forwarded-For。转发在所属循环中进行，回调不会在本函数中同步执行，
+ * 完成前连接上的后续请求留在输入缓冲中等待
+ */
+bool HttpServer::forwardRequest(Reactor* reactor, const ConnectionPtr& conn, bool keepAlive)
+{
+    const HttpParser& parser = conn->parser;
+    const std::string_view method = parser.getMethod();
+    const std::string_view connection = parser.getHeader(HeaderId::CONNECTION);
+    UpstreamGroup* group = conn->route->upstream.get();
+
+    std::string request;
+    request.reserve(conn->headerLength + conn->body.size() + 64);
+    request.append(method).append(" ").append(parser.getPath()).append(" HTTP/1.1\r\n");
+    const HttpHeaders& headers = parser.getHeaders();
+    for (size_t i = 0; i < headers.size(); ++i)
+    {
+        HttpHeaders::Field field = headers[i];
+        if (isHopByHop(field.name, connection) || HttpHeaders::equalsIgnoreCase(field.name, "Expect") ||
+            HttpHeaders::equalsIgnoreCase(field.name, "X-Forwarded-For"))
+        {
+            continue;
+        }
+        request.append(field.name).append(": ").append(field.value).append("\r\n");
+    }
+    if (!headers.has(HeaderId::HOST))
+    {
+        request.append("Host: ").append(group->config().upstreams.front()).append("\r\n");
+    }
+
+    sockaddr_storage peer{};
+    socklen_t peerLength = sizeof(peer);
+    std::string_view forwardedFor = parser.getHeader(HeaderId::X_FORWARDED_FOR);
+    if (getpeername(conn->fd, reinterpret_cast<sockaddr*>(&peer), &peerLength) == 0 &&
+        (peer.ss_family == AF_INET || peer.ss_family == AF_INET6))
+    {
+        std::string address = formatAddress(peer);
+        address.erase(address.rfind(':'));
+        if (address.front() == '[')
+        {
+            address = address.substr(1, address.size() - 2);
+        }
+        request.append("X-Forwarded-For: ");
+        if (!forwardedFor.empty())
+        {
+            request.append(forwardedFor).append(", ");
+        }
+        request.append(address).append("\r\n");
+    }
+    if (parser.bodyType() != HttpParser::BodyType::NONE || !conn->body.empty())
+    {
+        request.append("Content-Length: ").append(std::to_string(conn->body.size())).append("\r\n");
+    }
+    request.append("\r\n").append(conn->body);
+
+    auto state = std::make_shared<ProxyState>();
+    state->startNs = EventLoop::nowNs();
+    state->keepAlive = keepAlive;
+    state->headOnly = method == "HEAD";
+    state->http10 = parser.getVersion() == "HTTP/1.0";
+    const bool idempotent = isIdempotent(method);
+
+    conn->responsePending = true;
+    reactor->loop.queueInLoop([this, reactor, conn, group, state, idempotent, request = std::move(request)]() mutable {
+        if (conn->closed)
+        {
+            return;
+        }
+        ProxyHandler handler;
+        handler.onHeaders = [this, reactor, conn, state](const HttpParser& response) {
+            return proxyHeaders(reactor, conn, *state, response);
+        };
+        handler.onBody = [this, reactor, conn, state](std::string_view data) {
+            return proxyBody(reactor, conn, *state, data);
+        };
+        handler.onComplete = [this, reactor, conn, state](int error) {
+            finishProxy(reactor, conn, *state, error);
+        };
+        state->exchange = reactor->upstreams.forward(*group, std::move(request), state->headOnly, idempotent,
+                                                     std::move(handler));
+    });
+    return true;
+}
+
+/**
+ * @brief 上游响应头到达
+ *
+ * 上游的逐跳头部、Date和Server由服务器重新生成。向客户端的分帧：上游给出长度时沿用
+ * Content-Length；否则HTTP/1.1客户端改用chunked，HTTP/1.0客户端以关闭连接结束消息体
+ */
+ProxyHandler::Flow HttpServer::proxyHeaders(Reactor* reactor, const ConnectionPtr& conn, ProxyState& state,
+                                            const HttpParser& response)
+{
+    std::lock_guard<std::mutex> lock(conn->mutex);
+    if (conn->closed)
+    {
+        return ProxyHandler::Flow::ABORT;
+    }
+    stats.upstream.record(static_cast<uint64_t>(EventLoop::nowNs() - state.startNs));
+    const int status = response.getStatus();
+    stats.countResponse(status);
+
+    const std::string_view connection = response.getHeader(HeaderId::CONNECTION);
+    ResponseWriter writer;
+    writer.statusLine(status, response.getReason());
+    writer.append(serverHeader);
+    writer.date();
+    const HttpHeaders& headers = response.getHeaders();
+    for (size_t i = 0; i < headers.size(); ++i)
+    {
+        HttpHeaders::Field field = headers[i];
+        if (isHopByHop(field.name, connection) || HttpHeaders::equalsIgnoreCase(field.name, "Date") ||
+            HttpHeaders::equalsIgnoreCase(field.name, "Server"))
+        {
+            continue;
+        }
+        writer.header(field.name, field.value);
+    }
+
+    if (state.headOnly || status == 204 || status == 304)
+    {
+        // 没有消息体：HEAD的Content-Length描述的是GET时的长度，原样转发
+        std::string_view length = response.getHeader(HeaderId::CONTENT_LENGTH);
+        if (!length.empty() && status != 204)
+        {
+            writer.header("Content-Length", length);
+        }
+    }
+    else if (response.bodyType() == HttpParser::BodyType::CONTENT_LENGTH)
+    {
+        writer.header("Content-Length", response.contentLength());
+    }
+    else if (!state.http10)
+    {
+        writer.append("Transfer-Encoding: chunked\r\n");
+        state.chunked = true;
+    }
+    else
+    {
+        state.keepAlive = false;
+        conn->closeAfterWrite = true;
+    }
+    writer.endHeaders(state.keepAlive);
+    state.headersSent = true;
+    if (!sendVector(conn, writer))
+    {
+        closeConnection(reactor, conn);
+        return ProxyHandler::Flow::ABORT;
+    }
+    return afterProxyWrite(reactor, conn, state);
+}
+
+/**
+ * @brief 上游响应体分片到达
+ */
+ProxyHandler::Flow HttpServer::proxyBody(Reactor* reactor, const ConnectionPtr& conn, ProxyState& state,
+                                         std::string_view data)
+{
+    std::lock_guard<std::mutex> lock(conn->mutex);
+    if (conn->closed)
+    {
+        return ProxyHandler::Flow::ABORT;
+    }
+    ResponseWriter writer;
+    if (state.chunked)
+    {
+        char sizeLine[24];
+        int length = snprintf(sizeLine, sizeof(sizeLine), "%zx\r\n", data.size());
+        writer.appendCopy(std::string_view(sizeLine, static_cast<size_t>(length)));
+        writer.append(data);
+        writer.append("\r\n");
+    }
+    else
+    {
+        writer.append(data);
+    }
+    if (!sendVector(conn, writer))
+    {
+        closeConnection(reactor, conn);
+        return ProxyHandler::Flow::ABORT;
+    }
+    return afterProxyWrite(reactor, conn, state);
+}
+
+/**
+ * @brief 写出转发的数据之后
+ *
+ * 客户端消费慢、积压达到高水位时暂停读取上游，积压回落到一半以下（handleWrite）
+ * 或全部写出（io_uring路径）时通过onWritable恢复
+ */
+ProxyHandler::Flow HttpServer::afterProxyWrite(Reactor* reactor, const ConnectionPtr& conn, ProxyState& state)
+{
+    if (conn->uring)
+    {
+        flushUring(reactor, conn);
+    }
+    else if (!multiReactor)
+    {
+        updateEvents(conn, true);
+    }
+    if (conn->closed)
+    {
+        return ProxyHandler::Flow::ABORT;
+    }
+    refreshDeadline(reactor, conn);
+    if (conn->pendingBytes() < config.outputHighWaterMark)
+    {
+        return ProxyHandler::Flow::CONTINUE;
+    }
+
+    // 在所属循环中稍后恢复：onWritable可能在工作线程中、持有连接锁时调用
+    std::weak_ptr<UpstreamPool::Exchange> exchange = state.exchange;
+    conn->onWritable = [reactor, exchange] {
+        reactor->loop.queueInLoop([reactor, exchange] { reactor->upstreams.resume(exchange.lock()); });
+    };
+    return ProxyHandler::Flow::PAUSE;
+}
+
+/**
+ * @brief 转发结束
+ *
+ * 响应头写出之前失败时回复502/504；之后失败只能关闭连接，让客户端察觉响应被截断
+ */
+void HttpServer::finishProxy(Reactor* reactor, const ConnectionPtr& conn, ProxyState& state, int error)
+{
+    {
+        std::lock_guard<std::mutex> lock(conn->mutex);
+        conn->onWritable = nullptr;
+        if (conn->closed)
+        {
+            return;
+        }
+        conn->responsePending = false;
+        bool sent = true;
+        if (error != 0)
+        {
+            if (state.headersSent)
+            {
+                closeConnection(reactor, conn);
+                return;
+            }
+            sent = sendErrorResponse(conn, error);
+        }
+        else if (state.chunked)
+        {
+            static const char LAST_CHUNK[] = "0\r\n\r\n";
+            sent = sendData(conn, LAST_CHUNK, sizeof(LAST_CHUNK) - 1);
+        }
+        if (!sent || (conn->closeAfterWrite && !conn->hasPendingOutput()))
+        {
+            closeConnection(reactor, conn);
+            return;
+        }
+        if (multiReactor)
+        {
+            resumeAfterResponse(reactor, conn);
+            return;
+        }
+    }
+
+    // 单Reactor模式：后续请求与普通的可读事件一样交给线程池（不能持有连接锁，队列满时会就地处理）
+    if (!conn->closed)
+    {
+        handleEvent(reactor, conn, EPOLLIN);
+    }
+}
+
+/**
+ * @brief 协程处理器的一次调用
+ *
+ * 请求头和请求体在启动时拷贝出连接（之后连接的输入缓冲会继续处理下一个请求）。
+ * 挂起期间由awaiter登记的回调（定时器、onWritable、上游请求）持有调用，只引用连接的弱指针：
+ * 连接关闭后回调释放调用，协程帧随Task一起销毁；sleep的定时器在关闭时立即取消，不等到期
+ */
+struct HttpServer::AsyncCall : AsyncContext, std::enable_shared_from_this<AsyncCall>
+{
+    AsyncCall(HttpServer& server, Reactor* reactor, Connection& conn, bool keepAlive)
+        : AsyncContext(std::string(conn.inputBuffer.peek(), conn.headerLength), conn.parser, conn.params,
+                       conn.inputBuffer.peek(), std::move(conn.body)),
+          server(server),
+          reactor(reactor),
+          route(conn.route),
+          keepAlive(keepAlive),
+          headOnly(conn.parser.getMethod() == "HEAD"),
+          http10(conn.parser.getVersion() == "HTTP/1.0")
+    {
+    }
+
+    void suspendSleep(int64_t delayMs, std::coroutine_handle<> handle) override
+    {
+        // 总是延后到所属循环中登记：协程可能在工作线程中运行，定时器只能由循环线程访问
+        std::shared_ptr<AsyncCall> self = shared_from_this();
+        reactor->loop.queueInLoop([self, delayMs, handle] {
+            ConnectionPtr conn = self->connection.lock();
+            if (!conn || conn->closed)
+            {
+                return;
+            }
+            EventLoop& loop = self->reactor->loop;
+            self->sleepTimer = loop.runAfter(delayMs, [self, handle] { self->server.resumeAsync(self, handle); });
+            // 关闭连接时取消定时器，释放其持有的调用
+            std::weak_ptr<AsyncCall> weak = self;
+            conn->cancelSleep = [weak, &loop] {
+                if (std::shared_ptr<AsyncCall> call = weak.lock())
+                {
+                    loop.cancelTimer(call->sleepTimer);
+                }
+            };
+        });
+    }
+
+    bool writeBody(std::string_view data) override
+    {
+        ConnectionPtr conn = connection.lock();
+        return !conn || server.writeAsyncBody(conn, *this, data);
+    }
+
+    void suspendWrite(std::coroutine_handle<> handle) override
+    {
+        ConnectionPtr conn = connection.lock();
+        if (!conn || conn->closed)
+        {
+            return;
+        }
+        // onWritable在持有连接锁时调用，恢复延后到所属循环中进行
+        std::shared_ptr<AsyncCall> self = shared_from_this();
+        conn->onWritable = [self, handle] {
+            self->reactor->loop.queueInLoop([self, handle] { self->server.resumeAsync(self, handle); });
+        };
+    }
+
+    void suspendFetch(FetchAwaiter& awaiter, std::coroutine_handle<> handle) override
+    {
+        // awaiter位于协程帧中，帧在调用结束之前一直有效
+        std::shared_ptr<AsyncCall> self = shared_from_this();
+        FetchAwaiter* fetch = &awaiter;
+        reactor->loop.queueInLoop([self, fetch, handle] {
+            ProxyHandler handler;
+            handler.onHeaders = [fetch](const HttpParser& response) {
+                fetch->result.status = response.getStatus();
+                const HttpHeaders& headers = response.getHeaders();
+                for (size_t i = 0; i < headers.size(); ++i)
+                {
+                    fetch->result.headers.emplace_back(headers[i].name, headers[i].value);
+                }
+                return ProxyHandler::Flow::CONTINUE;
+            };
+            handler.onBody = [self, fetch, handle](std::string_view data) {
+                if (fetch->result.body.size() + data.size() > self->server.config.maxBodySize)
+                {
+                    // 放弃后不再回调onComplete，在这里结束等待
+                    fetch->result.error = 502;
+                    self->reactor->loop.queueInLoop([self, handle] { self->server.resumeAsync(self, handle); });
+                    return ProxyHandler::Flow::ABORT;
+                }
+                fetch->result.body.append(data.data(), data.size());
+                return ProxyHandler::Flow::CONTINUE;
+            };
+            handler.onComplete = [self, fetch, handle](int error) {
+                fetch->result.error = error;
+                // 连接立即失败时onComplete在forward返回前调用，同样延后恢复
+                self->reactor->loop.queueInLoop([self, handle] { self->server.resumeAsync(self, handle); });
+            };
+            std::string_view method(fetch->request.data(), fetch->request.find(' '));
+            self->reactor->upstreams.forward(fetch->group, std::move(fetch->request), fetch->headRequest,
+                                             isIdempotent(method), std::move(handler));
+        });
+    }
+
+    HttpServer& server;
+    Reactor* reactor;
+    std::weak_ptr<Connection> connection;
+    const Route* route;
+    Task task;
+    TimerId sleepTimer;        // sleep的定时器，仅循环线程访问
+    bool keepAlive;
+    const bool headOnly;
+    const bool http10;
+    bool headersSent = false;  // 已通过write发出响应头
+    bool chunked = false;      // 流式响应以chunked分帧
+    bool bodyless = false;     // 流式响应没有消息体（HEAD、204、304）
+};
+
+/**
+ * @brief 启动协程处理器
+ *
+ * 协程在当前线程（持有连接锁）执行到第一个挂起点；没有挂起就结束时与同步处理器一样立即发送响应，
+ * 否则连接进入等待状态，后续请求留在输入缓冲中，直到协程在所属循环中结束
+ */
+bool HttpServer::startAsync(Reactor* reactor, const ConnectionPtr& conn, bool keepAlive)
+{
+    auto call = std::make_shared<AsyncCall>(*this, reactor, *conn, keepAlive);
+    call->connection = conn;
+    conn->responsePending = true;
+    call->task = conn->route->async(*call);
+    call->task.start();
+    if (conn->closed || !call->task.done())
+    {
+        return true;
+    }
+    conn->responsePending = false;
+    return finishAsync(conn, *call);
+}
+
+void HttpServer::resumeAsync(const std::shared_ptr<AsyncCall>& call, std::coroutine_handle<> handle)
+{
+    ConnectionPtr conn = call->connection.lock();
+    if (!conn)
+    {
+        return;
+    }
+    Reactor* reactor = call->reactor;
+    {
+        std::lock_guard<std::mutex> lock(conn->mutex);
+        if (conn->closed)
+        {
+            return;
+        }
+        handle.resume();
+        if (conn->closed)
+        {
+            return;
+        }
+        if (!call->task.done())
+        {
+            refreshDeadline(reactor, conn);
+            return;
+        }
+        conn->responsePending = false;
+        if (!finishAsync(conn, *call) || (conn->closeAfterWrite && !conn->hasPendingOutput()))
+        {
+            closeConnection(reactor, conn);
+            return;
+        }
+        if (multiReactor)
+        {
+            resumeAfterResponse(reactor, conn);
+            return;
+        }
+    }
+
+    // 单Reactor模式：后续请求交给线程池（与finishProxy相同）
+    if (!conn->closed)
+    {
+        handleEvent(reactor, conn, EPOLLIN);
+    }
+}
+
+/**
+ * @brief 写出协程的消息体分片
+ *
+ * 第一次写出时发送response()中的状态码和头部：处理器设置了Content-Length时按它分帧，
+ * 否则HTTP/1.1客户端使用chunked，HTTP/1.0客户端以关闭连接结束消息体
+ */
+bool HttpServer::writeAsyncBody(const ConnectionPtr& conn, AsyncCall& call, std::string_view data)
+{
+    if (conn->closed)
+    {
+        return true;
+    }
+    ResponseWriter writer;
+    if (!call.headersSent)
+    {
+        const Response& response = call.response();
+        const int status = response.status();
+        stats.countResponse(status);
+        writer.statusLine(status, response.reason());
+        writer.append(serverHeader);
+        writer.date();
+        for (const auto& header : response.headers())
+        {
+            if (HttpHeaders::equalsIgnoreCase(header.first, "Connection") ||
+                HttpHeaders::equalsIgnoreCase(header.first, "Transfer-Encoding"))
+            {
+                continue;
+            }
+            writer.header(header.first, header.second);
+        }
+        call.bodyless = call.headOnly || status == 204 || status == 304 || (status >= 100 && status < 200);
+        if (!call.bodyless && !response.hasHeader("Content-Length"))
+        {
+            if (!call.http10)
+            {
+                writer.append("Transfer-Encoding: chunked\r\n");
+                call.chunked = true;
+            }
+            else
+            {
+                call.keepAlive = false;
+                conn->closeAfterWrite = true;
+            }
+        }
+        writer.endHeaders(call.keepAlive);
+        call.headersSent = true;
+    }
+
+    if (!call.bodyless && !data.empty())
+    {
+        if (call.chunked)
+        {
+            char sizeLine[24];
+            int length = snprintf(sizeLine, sizeof(sizeLine), "%zx\r\n", data.size());
+            writer.appendCopy(std::string_view(sizeLine, static_cast<size_t>(length)));
+            writer.append(data);
+            writer.append("\r\n");
+        }
+        else
+        {
+            writer.append(data);
+        }
+    }
+    if (writer.iovCount() > 0 && !sendVector(conn, writer))
+    {
+        closeConnection(call.reactor, conn);
+        return true;
+    }
+    if (conn->uring)
+    {
+        flushUring(call.reactor, conn);
+    }
+    else if (!multiReactor)
+    {
+        updateEvents(conn, true);
+    }
+    if (conn->closed)
+    {
+        return true;
+    }
+    refreshDeadline(call.reactor, conn);
+    return conn->pendingBytes() >= config.outputHighWaterMark;
+}
+
+/**
+ * @brief 协程结束
+ *
+ * 没有流式写出时按response()发送完整响应；协程抛出异常时回复500，已发出响应头则只能关闭连接
+ */
+bool HttpServer::finishAsync(const ConnectionPtr& conn, AsyncCall& call)
+{
+    Response& response = call.response();
+    if (std::exception_ptr error = call.task.exception())
+    {
+        try
+        {
+            std::rethrow_exception(error);
+        }
+        catch (const std::exception& e)
+        {
+            LOG(ERROR) << "Handler for " << call.route->method << " " << call.route->pattern << " failed: " << e.what();
+        }
+        catch (...)
+        {
+            LOG(ERROR) << "Handler for " << call.route->method << " " << call.route->pattern << " failed";
+        }
+        if (call.headersSent)
+        {
+            return false;
+        }
+        response = Response();
+        response.setStatus(500);
+        response.setBody("Internal Server Error");
+    }
+
+    if (!call.headersSent)
+    {
+        stats.countResponse(response.status());
+        return writeRouteResponse(conn, response, CompressionChoice(), response.body(), call.keepAlive,
+                                  call.headOnly);
+    }
+    if (call.chunked)
+    {
+        static const char LAST_CHUNK[] = "0\r\n\r\n";
+        return sendData(conn, LAST_CHUNK, sizeof(LAST_CHUNK) - 1);
+    }
+    return true;
+}
+
+/**
+ * @brief 选择静态文件的压缩表示
+ *
+ * 磁盘上的.gz/.br同名文件在打开时已载入；没有同名文件且类型、大小合适时，
+ * 第一次请求某种编码时提交线程池以最高级别压缩一次，结果挂在缓存条目上供之后的请求使用
+ */
+std::shared_ptr<const EncodedFile> HttpServer::staticEncoding(const std::shared_ptr<const CachedFile>& file,
+                                                              const HttpParser& parser, bool& vary)
+{
+    auto variant = [&file](ContentEncoding encoding) {
+        return std::atomic_load(&file->encoded[static_cast<int>(encoding)]);
+    };
+    std::shared_ptr<const EncodedFile> gzip = variant(ContentEncoding::GZIP);
+    std::shared_ptr<const EncodedFile> brotli = variant(ContentEncoding::BROTLI);
+    const size_t size = static_cast<size_t>(file->size);
+    const bool compressible = size >= config.compressMinSize && size <= config.staticCompressMaxSize &&
+                              Compression::levelFor(config.compressionRules, file->contentType) > 0;
+    vary = compressible || gzip || brotli;
+
+    // Range总是针对原始内容
+    if (!vary || !parser.getHeader(HeaderId::RANGE).empty())
+    {
+        return nullptr;
+    }
+    ContentEncoding encoding = Compression::negotiate(parser.getHeader(HeaderId::ACCEPT_ENCODING),
+                                                      brotli != nullptr ||
+                                                          (compressible && Compression::brotliAvailable()));
+    if (encoding == ContentEncoding::IDENTITY)
+    {
+        return nullptr;
+    }
+    std::shared_ptr<const EncodedFile>& chosen = encoding == ContentEncoding::GZIP ? gzip : brotli;
+    const int index = static_cast<int>(encoding);
+    if (!chosen && compressible && !file->compressStarted[index].exchange(true))
+    {
+        // 线程池已满时放弃本次压缩，之后的请求再尝试
+        auto dropped = [file, index] { file->compressStarted[index] = false; };
+        if (!pool.enqueue([file, encoding, index] {
+                std::shared_ptr<const EncodedFile> encoded =
+                    StaticFileHandler::compress(*file, encoding, Compression::maxLevel(encoding));
+                if (encoded)
+                {
+                    std::atomic_store(&file->encoded[index], encoded);
+                }
+            }, dropped))
+        {
+            dropped();
+        }
+    }
+    return chosen;
+}
+
+/**
+ * @brief 以静态文件响应GET/HEAD请求
+ *
+ * 响应头来自缓存条目中预先生成的内容，文件体通过sendfile零拷贝发送；
+ * 支持单区间Range（206/416）和If-None-Match/If-Modified-Since（304）
+ */
+bool HttpServer::serveStaticFile(const ConnectionPtr& conn, bool keepAlive)
+{
+    const HttpParser& parser = conn->parser;
+    std::shared_ptr<const CachedFile> file = staticFiles->lookup(std::string(parser.getPath()));
+    if (!file)
+    {
+        return sendErrorResponse(conn, 404, keepAlive);
+    }
+
+    const bool headOnly = parser.getMethod() == "HEAD";
+    ResponseWriter writer;
+
+    // 按Accept-Encoding选择表示，条件请求与所选表示的ETag比较
+    bool vary = false;
+    std::shared_ptr<const EncodedFile> encoded;
+    if (config.compression)
+    {
+        encoded = staticEncoding(file, parser, vary);
+    }
+    const std::string& etag = encoded ? encoded->etag : file->etag;
+
+    // 条件请求：客户端缓存仍然有效
+    if (StaticFileHandler::notModified(*file, etag, parser.getHeader(HeaderId::IF_NONE_MATCH),
+                                       parser.getHeader(HeaderId::IF_MODIFIED_SINCE)))
+    {
+        stats.countResponse(304);
+        writer.statusLine(304);
+        writer.append(serverHeader);
+        writer.date();
+        writer.header("ETag", etag);
+        writer.header("Last-Modified", file->lastModified);
+        if (vary)
+        {
+            writer.append(VARY_ACCEPT_ENCODING);
+        }
+        writer.endHeaders(keepAlive);
+        return sendVector(conn, writer);
+    }
+
+    // 压缩表示：磁盘上的同名文件以sendfile发送，内存中的内容直接写出
+    if (encoded)
+    {
+        stats.countResponse(200);
+        writer.append(encoded->okHeaders);
+        writer.append(serverHeader);
+        writer.date();
+        writer.endHeaders(keepAlive);
+        if (headOnly || encoded->size == 0)
+        {
+            return sendVector(conn, writer);
+        }
+        if (encoded->file)
+        {
+            return sendVector(conn, writer, true) &&
+                   sendFile(conn, encoded->file, 0, static_cast<size_t>(encoded->size));
+        }
+        writer.append(encoded->data);
+        return sendVector(conn, writer);
+    }
+
+    // Range请求；If-Range与当前版本不一致时忽略Range返回完整内容
+    off_t first = 0;
+    off_t last = file->size - 1;
+    auto range = StaticFileHandler::RangeResult::NONE;
+    std::string_view rangeHeader = parser.getHeader(HeaderId::RANGE);
+    if (!rangeHeader.empty())
+    {
+        std::string_view ifRange = parser.getHeader(HeaderId::IF_RANGE);
+        if (ifRange.empty() || ifRange == file->etag || ifRange == file->lastModified)
+        {
+            range = StaticFileHandler::parseRange(rangeHeader, file->size, first, last);
+        }
+    }
+
+    if (range == StaticFileHandler::RangeResult::UNSATISFIABLE)
+    {
+        stats.countResponse(416);
+        writer.statusLine(416);
+        writer.append(serverHeader);
+        writer.date();
+        writer.appendCopy("Content-Range: bytes */");
+        writer.appendUint(static_cast<uint64_t>(file->size));
+        writer.appendCopy("\r\nContent-Length: 0\r\n");
+        writer.endHeaders(keepAlive);
+        return sendVector(conn, writer);
+    }
+
+    stats.countResponse(range == StaticFileHandler::RangeResult::SATISFIABLE ? 206 : 200);
+    if (range == StaticFileHandler::RangeResult::SATISFIABLE)
+    {
+        writer.statusLine(206);
+        writer.append(file->commonHeaders);
+        writer.appendCopy("Content-Range: bytes ");
+        writer.appendUint(static_cast<uint64_t>(first));
+        writer.appendCopy("-");
+        writer.appendUint(static_cast<uint64_t>(last));
+        writer.appendCopy("/");
+        writer.appendUint(static_cast<uint64_t>(file->size));
+        writer.appendCopy("\r\n");
+        writer.header("Content-Length", static_cast<uint64_t>(last - first + 1));
+    }
+    else
+    {
+        writer.append(file->okHeaders);
+    }
+    if (vary)
+    {
+        writer.append(VARY_ACCEPT_ENCODING);
+    }
+    writer.append(serverHeader);
+    writer.date();
+    writer.endHeaders(keepAlive);
+
+    // 紧跟文件内容时带MSG_MORE，让内核把头部与文件首段合并成同一个报文
+    size_t length = static_cast<size_t>(last - first + 1);
+    if (headOnly || file->size == 0)
+    {
+        return sendVector(conn, writer);
+    }
+    return sendVector(conn, writer, true) && sendFile(conn, file, first, length);
+}
+
+/**
+ * @brief 关闭连接并清理资源
+ *
+ * 1. 从epoll移除监控
+ * 2. 关闭socket文件描述符
+ * 3. 更新连接计数
+ *
+ * 回调表只归循环线程所有，且fd必须在移除后才能关闭（防止被新连接复用），
+ * 因此工作线程发起的关闭会投递回所属循环线程执行
+ */
+void HttpServer::closeConnection(Reactor* reactor, const ConnectionPtr& conn)
+{
+    // 立即标记，使正在处理该连接的线程尽快停止；重复关闭直接忽略
+    if (conn->closed.exchange(true))
+    {
+        return;
+    }
+    stats.closed.add();
+
+    reactor->loop.runInLoop([reactor, conn] {
+        int fd = conn->fd;
+        reactor->connections.erase(fd);
+        reactor->loop.cancelTimer(conn->timer);
+        if (conn->cancelSleep)
+        {
+            conn->cancelSleep();
+            conn->cancelSleep = nullptr;
+        }
+
+        if (conn->uring)
+        {
+            // 取消连接上进行中的recv/send后关闭，与本轮其他请求一起提交；
+            // 被取消操作的回调看到closed后直接返回，它们持有的连接引用在结束时释放
+            reactor->uring->close(fd);
+            LOG(INFO) << "Closed connection (fd: " << fd << ")";
+            return;
+        }
+
+        try
+        {
+            // 从epoll移除
+            reactor->loop.removeFd(fd);
+            LOG(DEBUG) << "Removed fd " << fd << " from epoll";
+        }
+        catch (const std::exception &e)
+        {
+            LOG(ERROR) << "Failed to remove fd " << fd << ": " << e.what();
+        }
+
+        // 关闭socket
+        if (close(fd) == -1)
+        {
+            LOG(ERROR) << "Close failed for fd " << fd << ": " << strerror(errno);
+        }
+        else
+        {
+            LOG(INFO) << "Closed connection (fd: " << fd << ")";
+        }
+    });
+}
@@ -0,0 +1,90 @@
+#include "http/Response.h"
+#include "http/HttpHeaders.h"
+#include <algorithm>
+
+void Response::setHeader(std::string_view name, std::string_view value)
+{
+    for (auto& header : headerList)
+    {
+        if (HttpHeaders::equalsIgnoreCase(header.first, name))
+        {
+            header.second.assign(value.data(), value.size());
+            return;
+        }
+    }
+    addHeader(name, value);
+}
+
+void Response::removeHeader(std::string_view name)
+{
+    headerList.erase(std::remove_if(headerList.begin(), headerList.end(),
+                                    [name](const HeaderList::value_type& header) {
+                                        return HttpHeaders::equalsIgnoreCase(header.first, name);
+                                    }),
+                     headerList.end());
+}
+
+bool Response::hasHeader(std::string_view name) const
+{
+    for (const auto& header : headerList)
+    {
+        if (HttpHeaders::equalsIgnoreCase(header.first, name))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string_view Response::header(std::string_view name) const
+{
+    for (const auto& header : headerList)
+    {
+        if (HttpHeaders::equalsIgnoreCase(header.first, name))
+        {
+            return header.second;
+        }
+    }
+    return std::string_view();
+}
+
+std::string_view Response::reasonPhrase(int code)
+{
+    switch (code)
+    {
+        case 100: return "Continue";
+        case 101: return "Switching Protocols";
+        case 200: return "OK";
+        case 201: return "Created";
+        case 202: return "Accepted";
+        case 204: return "No Content";
+        case 206: return "Partial Content";
+        case 301: return "Moved Permanently";
+        case 302: return "Found";
+        case 303: return "See Other";
+        case 304: return "Not Modified";
+        case 307: return "Temporary Redirect";
+        case 308: return "Permanent Redirect";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 408: return "Request Timeout";
+        case 409: return "Conflict";
+        case 411: return "Length Required";
+        case 413: return "Content Too Large";
+        case 414: return "URI Too Long";
+        case 415: return "Unsupported Media Type";
+        case 416: return "Range Not Satisfiable";
+        case 429: return "Too Many Requests";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 502: return "Bad Gateway";
+        case 503: return "Service Unavailable";
+        case 504: return "Gateway Timeout";
+        case 505: return "HTTP Version Not Supported";
+        default: return "Unknown";
+    }
+}
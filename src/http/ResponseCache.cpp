@@ -0,0 +1,575 @@
+#include "http/ResponseCache.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+namespace
+{
+// 假定的平均条目大小，用于估计分片能容纳的条目数（决定频率表的宽度）
+constexpr size_t ASSUMED_ENTRY_BYTES = 1024;
+
+// 条目本身的固定开销（对象、链表节点和索引），计入容量
+constexpr size_t ENTRY_OVERHEAD = sizeof(CachedResponse) + 128;
+
+// 不可缓存标记的有效期，期间同一请求目标直接调用处理器
+constexpr int64_t PASS_TTL_MS = 10000;
+
+std::string_view trim(std::string_view text)
+{
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+    {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t'))
+    {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// 从逗号分隔的列表中取出下一项（已去除空白），列表为空时返回false
+bool nextToken(std::string_view& list, std::string_view& token)
+{
+    while (!list.empty())
+    {
+        size_t comma = list.find(',');
+        token = trim(list.substr(0, comma));
+        list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+        if (!token.empty())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 解析"name=seconds"形式指令的秒数，格式不对时返回-1
+int64_t directiveSeconds(std::string_view token, std::string_view name)
+{
+    if (token.size() <= name.size() + 1 || !HttpHeaders::equalsIgnoreCase(token.substr(0, name.size()), name) ||
+        token[name.size()] != '=')
+    {
+        return -1;
+    }
+    std::string_view digits = token.substr(name.size() + 1);
+    if (digits.size() >= 2 && digits.front() == '"' && digits.back() == '"')
+    {
+        digits = digits.substr(1, digits.size() - 2);
+    }
+    if (digits.empty() || digits.size() > 10)
+    {
+        return -1;
+    }
+    int64_t seconds = 0;
+    for (char c : digits)
+    {
+        if (c < '0' || c > '9')
+        {
+            return -1;
+        }
+        seconds = seconds * 10 + (c - '0');
+    }
+    return seconds;
+}
+
+/**
+ * @brief 按响应的Cache-Control决定共享缓存可以保存多久（毫秒）
+ * @return 不允许共享缓存（no-store、private、no-cache或寿命为0）时返回-1，没有给出寿命时返回0
+ */
+int64_t sharedTtlMs(std::string_view cacheControl)
+{
+    int64_t maxAge = -1;
+    int64_t sMaxAge = -1;
+    std::string_view token;
+    while (nextToken(cacheControl, token))
+    {
+        std::string_view name = token.substr(0, token.find('='));
+        if (HttpHeaders::equalsIgnoreCase(name, "no-store") || HttpHeaders::equalsIgnoreCase(name, "private") ||
+            HttpHeaders::equalsIgnoreCase(name, "no-cache"))
+        {
+            return -1;
+        }
+        int64_t seconds = directiveSeconds(token, "s-maxage");
+        if (seconds >= 0)
+        {
+            sMaxAge = seconds;
+            continue;
+        }
+        seconds = directiveSeconds(token, "max-age");
+        if (seconds >= 0)
+        {
+            maxAge = seconds;
+        }
+    }
+    // s-maxage只对共享缓存有效，优先于max-age
+    int64_t seconds = sMaxAge >= 0 ? sMaxAge : maxAge;
+    if (seconds == 0)
+    {
+        return -1;
+    }
+    return seconds > 0 ? seconds * 1000 : 0;
+}
+
+// 请求要求不使用缓存的响应：Cache-Control: no-cache / max-age=0，或Pragma: no-cache
+bool bypassRequested(const HttpParser& request)
+{
+    std::string_view cacheControl = request.getHeader(HeaderId::CACHE_CONTROL);
+    std::string_view token;
+    while (nextToken(cacheControl, token))
+    {
+        if (HttpHeaders::equalsIgnoreCase(token, "no-cache") || directiveSeconds(token, "max-age") == 0)
+        {
+            return true;
+        }
+    }
+    return HttpHeaders::equalsIgnoreCase(trim(request.getHeader("Pragma")), "no-cache");
+}
+
+// 默认可以被缓存的状态码（RFC 9110 15.1）
+bool cacheableStatus(int code)
+{
+    switch (code)
+    {
+    case 200:
+    case 203:
+    case 204:
+    case 300:
+    case 301:
+    case 308:
+    case 404:
+    case 405:
+    case 410:
+    case 414:
+    case 501:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// 解析Vary为小写字段名，Accept-Encoding由压缩表示处理，不进入键；Vary: *返回false
+bool parseVary(std::string_view vary, std::vector<std::string>& names)
+{
+    std::string_view token;
+    while (nextToken(vary, token))
+    {
+        if (token == "*")
+        {
+            return false;
+        }
+        if (HttpHeaders::equalsIgnoreCase(token, "Accept-Encoding"))
+        {
+            continue;
+        }
+        std::string name(token);
+        std::transform(name.begin(), name.end(), name.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (std::find(names.begin(), names.end(), name) == names.end())
+        {
+            names.push_back(std::move(name));
+        }
+    }
+    return true;
+}
+
+// 处理器没有给出ETag时按消息体生成强校验值（FNV-1a，跨进程稳定）
+std::string makeETag(std::string_view body)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : body)
+    {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    char text[40];
+    int len = snprintf(text, sizeof(text), "\"%016llx-%zx\"", static_cast<unsigned long long>(hash), body.size());
+    return std::string(text, static_cast<size_t>(len));
+}
+
+size_t roundUpPowerOfTwo(size_t n)
+{
+    size_t power = 1;
+    while (power < n)
+    {
+        power <<= 1;
+    }
+    return power;
+}
+} // namespace
+
+ResponseCache::FrequencySketch::FrequencySketch(size_t width)
+    : table(4 * width, 0), mask(width - 1), sampleSize(10 * width)
+{
+}
+
+size_t ResponseCache::FrequencySketch::index(uint64_t hash, int row) const
+{
+    // 每行以不同的奇数乘子重新混合，近似独立的哈希函数
+    static const uint64_t SEEDS[4] = {0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL,
+                                      0xcbf29ce484222325ULL};
+    uint64_t h = (hash + static_cast<uint64_t>(row)) * SEEDS[row];
+    h ^= h >> 32;
+    return static_cast<size_t>(row) * (mask + 1) + (static_cast<size_t>(h) & mask);
+}
+
+void ResponseCache::FrequencySketch::increment(uint64_t hash)
+{
+    for (int row = 0; row < 4; ++row)
+    {
+        uint8_t& counter = table[index(hash, row)];
+        if (counter < 15)
+        {
+            ++counter;
+        }
+    }
+    // 定期减半，使频率反映近期的访问
+    if (++additions >= sampleSize)
+    {
+        for (uint8_t& counter : table)
+        {
+            counter >>= 1;
+        }
+        additions /= 2;
+    }
+}
+
+int ResponseCache::FrequencySketch::estimate(uint64_t hash) const
+{
+    int frequency = 15;
+    for (int row = 0; row < 4; ++row)
+    {
+        frequency = std::min(frequency, static_cast<int>(table[index(hash, row)]));
+    }
+    return frequency;
+}
+
+ResponseCache::ResponseCache(size_t capacityBytes, size_t shardCount, int64_t defaultTtlMs)
+    : defaultTtlMs(defaultTtlMs)
+{
+    shardCount = roundUpPowerOfTwo(std::max<size_t>(shardCount, 1));
+    shardMask = shardCount - 1;
+    const size_t shardCapacity = capacityBytes / shardCount;
+    windowCapacity = std::max<size_t>(shardCapacity / 100, 1);
+    mainCapacity = shardCapacity - std::min(windowCapacity, shardCapacity);
+    protectedCapacity = mainCapacity / 5 * 4;
+    maxEntryBytes = shardCapacity / 8;
+    const size_t sketchWidth = roundUpPowerOfTwo(std::max<size_t>(shardCapacity / ASSUMED_ENTRY_BYTES, 64));
+    for (size_t i = 0; i < shardCount; ++i)
+    {
+        shards.push_back(std::make_unique<Shard>(sketchWidth));
+    }
+}
+
+bool ResponseCache::cacheableRequest(const HttpParser& request)
+{
+    std::string_view method = request.getMethod();
+    return (method == "GET" || method == "HEAD") && !request.getHeaders().has(HeaderId::AUTHORIZATION);
+}
+
+std::string ResponseCache::primaryKey(const HttpParser& request)
+{
+    std::string_view target = request.getPath();
+    std::string key;
+    key.reserve(4 + target.size());
+    key.append("GET ");
+    key.append(target.data(), target.size());
+    return key;
+}
+
+std::string ResponseCache::fullKey(const std::string& primary, const std::vector<std::string>& names,
+                                   const HttpParser& request)
+{
+    // 请求目标中不会出现换行，以它分隔各字段的值
+    std::string key = primary;
+    for (const std::string& name : names)
+    {
+        std::string_view value = request.getHeader(name);
+        key.push_back('\n');
+        key.append(value.data(), value.size());
+    }
+    return key;
+}
+
+bool ResponseCache::matches(const CachedResponse& entry, const HttpParser& request)
+{
+    return fullKey(primaryKey(request), entry.varyNames, request) == entry.key;
+}
+
+ResponseCache::Lookup ResponseCache::lookup(const HttpParser& request, int64_t nowMs, Waiter waiter)
+{
+    Lookup result;
+    if (!cacheableRequest(request))
+    {
+        return result;
+    }
+    const std::string primary = primaryKey(request);
+    const bool bypass = bypassRequested(request);
+    Shard& shard = shardFor(primary);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto vary = shard.vary.find(primary);
+    result.key = vary == shard.vary.end() ? primary : fullKey(primary, vary->second.names, request);
+    shard.sketch.increment(std::hash<std::string>()(result.key));
+
+    auto it = shard.index.find(result.key);
+    if (it != shard.index.end())
+    {
+        if (it->second->entry->expiresMs <= nowMs)
+        {
+            remove(shard, it->second);
+        }
+        else if (it->second->entry->pass)
+        {
+            onHit(shard, it->second);
+            result.pass = true;
+            return result;
+        }
+        else if (!bypass)
+        {
+            onHit(shard, it->second);
+            result.entry = it->second->entry;
+            return result;
+        }
+    }
+
+    if (!waiter)
+    {
+        return result;
+    }
+    auto pending = shard.inflight.find(result.key);
+    if (pending != shard.inflight.end())
+    {
+        pending->second.push_back(std::move(waiter));
+        result.waiting = true;
+    }
+    else
+    {
+        shard.inflight.emplace(result.key, std::vector<Waiter>());
+        result.leader = true;
+    }
+    return result;
+}
+
+ResponseCache::EntryPtr ResponseCache::insert(const HttpParser& request, Response& response, int64_t nowMs)
+{
+    if (!cacheableRequest(request))
+    {
+        return nullptr;
+    }
+    const std::string primary = primaryKey(request);
+    int64_t ttlMs = sharedTtlMs(response.header("Cache-Control"));
+    if (ttlMs == 0)
+    {
+        ttlMs = defaultTtlMs;
+    }
+    std::vector<std::string> names;
+    bool cacheable = ttlMs > 0 && cacheableStatus(response.status()) && !response.hasHeader("Set-Cookie") &&
+                     parseVary(response.header("Vary"), names);
+    std::string key;
+    size_t charge = 0;
+    if (cacheable)
+    {
+        key = fullKey(primary, names, request);
+        charge = ENTRY_OVERHEAD + key.size() + response.body().size();
+        for (const auto& header : response.headers())
+        {
+            charge += header.first.size() + header.second.size();
+        }
+        cacheable = charge <= maxEntryBytes;
+    }
+    if (!cacheable)
+    {
+        auto marker = std::make_shared<CachedResponse>();
+        marker->key = primary;
+        marker->pass = true;
+        marker->storedMs = nowMs;
+        marker->expiresMs = nowMs + PASS_TTL_MS;
+        store(primary, std::move(marker), ENTRY_OVERHEAD + primary.size());
+        return nullptr;
+    }
+
+    auto entry = std::make_shared<CachedResponse>();
+    entry->key = std::move(key);
+    entry->varyNames = std::move(names);
+    entry->storedMs = nowMs;
+    entry->expiresMs = nowMs + ttlMs;
+    entry->cacheControl = std::string(response.header("Cache-Control"));
+    entry->vary = std::string(response.header("Vary"));
+    std::string etag(response.header("ETag"));
+    if (etag.empty())
+    {
+        etag = makeETag(response.body());
+    }
+    // "tag" -> "tag-gzip"，与未压缩表示区分
+    const bool quoted = etag.size() >= 2 && etag.back() == '"';
+    for (int i = 0; i < Compression::ENCODINGS; ++i)
+    {
+        auto encoding = static_cast<ContentEncoding>(i);
+        entry->etags[i] = encoding == ContentEncoding::IDENTITY
+                              ? etag
+                              : etag.substr(0, etag.size() - quoted) + "-" + Compression::token(encoding) +
+                                    (quoted ? "\"" : "");
+    }
+    response.removeHeader("ETag");
+    entry->response = std::move(response);
+    store(primary, entry, charge);
+    return entry;
+}
+
+void ResponseCache::store(const std::string& primary, EntryPtr entry, size_t charge)
+{
+    Shard& shard = shardFor(primary);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto existing = shard.index.find(entry->key);
+    if (existing != shard.index.end())
+    {
+        remove(shard, existing->second);
+    }
+    // 以最新响应的Vary为准，按旧字段生成的条目不再被查到，随淘汰移除
+    VaryInfo& info = shard.vary[primary];
+    if (!entry->pass)
+    {
+        info.names = entry->varyNames;
+    }
+    ++info.entries;
+
+    const uint64_t hash = std::hash<std::string>()(entry->key);
+    shard.window.push_front(Item{std::move(entry), hash, primary.size(), charge, Segment::WINDOW});
+    shard.index[shard.window.front().entry->key] = shard.window.begin();
+    shard.windowBytes += charge;
+    entryCount.fetch_add(1, std::memory_order_relaxed);
+    byteCount.fetch_add(charge, std::memory_order_relaxed);
+    evict(shard);
+}
+
+void ResponseCache::complete(const std::string& key, const EntryPtr& entry)
+{
+    Shard& shard = shardFor(key.substr(0, key.find('\n')));
+    std::vector<Waiter> waiters;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.inflight.find(key);
+        if (it == shard.inflight.end())
+        {
+            return;
+        }
+        waiters = std::move(it->second);
+        shard.inflight.erase(it);
+    }
+    for (const Waiter& waiter : waiters)
+    {
+        waiter(entry);
+    }
+}
+
+size_t ResponseCache::size() const
+{
+    return entryCount.load(std::memory_order_relaxed);
+}
+
+size_t ResponseCache::bytes() const
+{
+    return byteCount.load(std::memory_order_relaxed);
+}
+
+ResponseCache::ItemList& ResponseCache::listOf(Shard& shard, Segment segment)
+{
+    switch (segment)
+    {
+    case Segment::WINDOW:
+        return shard.window;
+    case Segment::PROBATION:
+        return shard.probation;
+    default:
+        return shard.protectedList;
+    }
+}
+
+size_t& ResponseCache::bytesOf(Shard& shard, Segment segment)
+{
+    switch (segment)
+    {
+    case Segment::WINDOW:
+        return shard.windowBytes;
+    case Segment::PROBATION:
+        return shard.probationBytes;
+    default:
+        return shard.protectedBytes;
+    }
+}
+
+void ResponseCache::moveTo(Shard& shard, ItemList::iterator it, Segment segment)
+{
+    bytesOf(shard, it->segment) -= it->charge;
+    bytesOf(shard, segment) += it->charge;
+    ItemList& to = listOf(shard, segment);
+    to.splice(to.begin(), listOf(shard, it->segment), it);
+    it->segment = segment;
+}
+
+void ResponseCache::onHit(Shard& shard, ItemList::iterator it)
+{
+    if (it->segment != Segment::PROBATION)
+    {
+        moveTo(shard, it, it->segment);
+        return;
+    }
+    moveTo(shard, it, Segment::PROTECTED);
+    // 受保护段溢出：最久未用的条目降回受试段，重新参与淘汰
+    while (shard.protectedBytes > protectedCapacity && shard.protectedList.size() > 1)
+    {
+        moveTo(shard, std::prev(shard.protectedList.end()), Segment::PROBATION);
+    }
+}
+
+void ResponseCache::remove(Shard& shard, ItemList::iterator it)
+{
+    auto vary = shard.vary.find(it->entry->key.substr(0, it->primaryLength));
+    if (vary != shard.vary.end() && --vary->second.entries == 0)
+    {
+        shard.vary.erase(vary);
+    }
+    bytesOf(shard, it->segment) -= it->charge;
+    entryCount.fetch_sub(1, std::memory_order_relaxed);
+    byteCount.fetch_sub(it->charge, std::memory_order_relaxed);
+    shard.index.erase(it->entry->key);
+    listOf(shard, it->segment).erase(it);
+}
+
+/**
+ * @brief W-TinyLFU的准入和淘汰
+ *
+ * 窗口中最久未用的条目是候选：主区放得下时直接进入受试段；否则依次与受试段（为空时受保护段）
+ * 最久未用的条目比较估计频率，候选更高时淘汰对方继续比较，不高于对方时淘汰候选本身
+ */
+void ResponseCache::evict(Shard& shard)
+{
+    while (shard.windowBytes > windowCapacity && !shard.window.empty())
+    {
+        auto candidate = std::prev(shard.window.end());
+        const int candidateFrequency = shard.sketch.estimate(candidate->hash);
+        bool admitted = true;
+        while (shard.probationBytes + shard.protectedBytes + candidate->charge > mainCapacity)
+        {
+            ItemList& victims = shard.probation.empty() ? shard.protectedList : shard.probation;
+            if (victims.empty())
+            {
+                break;
+            }
+            auto victim = std::prev(victims.end());
+            if (candidateFrequency <= shard.sketch.estimate(victim->hash))
+            {
+                admitted = false;
+                break;
+            }
+            remove(shard, victim);
+        }
+        if (admitted)
+        {
+            moveTo(shard, candidate, Segment::PROBATION);
+        }
+        else
+        {
+            remove(shard, candidate);
+        }
+    }
+}
@@ -0,0 +1,211 @@
+#include "http/ResponseWriter.h"
+#include "http/HttpDate.h"
+#include "http/Response.h"
+#include <array>
+#include <charconv>
+#include <cstring>
+
+namespace
+{
+constexpr int MIN_STATUS = 100;
+constexpr int MAX_STATUS = 599;
+
+// 头部的名称和值合计不超过该长度时拷贝到内部缓冲，否则按4段引用
+constexpr size_t SMALL_HEADER = 128;
+
+// 所有已知状态码的状态行，首次使用时生成
+const std::array<std::string, MAX_STATUS - MIN_STATUS + 1>& statusLines()
+{
+    static const auto lines = [] {
+        std::array<std::string, MAX_STATUS - MIN_STATUS + 1> table;
+        for (int code = MIN_STATUS; code <= MAX_STATUS; ++code)
+        {
+            std::string_view reason = Response::reasonPhrase(code);
+            if (reason != "Unknown")
+            {
+                table[code - MIN_STATUS] = "HTTP/1.1 " + std::to_string(code) + " " + std::string(reason) + "\r\n";
+            }
+        }
+        return table;
+    }();
+    return lines;
+}
+} // namespace
+
+FixedResponse FixedResponse::make(int code, std::string_view contentType, std::string_view body,
+                                  std::string_view serverHeader, std::string_view extraHeaders)
+{
+    FixedResponse response;
+    response.code = code;
+    response.contentType = std::string(contentType);
+    std::string_view line = ResponseWriter::statusLineOf(code);
+    if (line.empty())
+    {
+        response.head = "HTTP/1.1 " + std::to_string(code) + " Unknown\r\n";
+    }
+    else
+    {
+        response.head = std::string(line);
+    }
+    response.head += serverHeader;
+    if (!contentType.empty())
+    {
+        response.head += "Content-Type: " + std::string(contentType) + "\r\n";
+    }
+    response.head += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    response.head += extraHeaders;
+    response.body = std::string(body);
+    return response;
+}
+
+std::string_view ResponseWriter::statusLineOf(int code)
+{
+    if (code < MIN_STATUS || code > MAX_STATUS)
+    {
+        return std::string_view();
+    }
+    return statusLines()[code - MIN_STATUS];
+}
+
+size_t ResponseWriter::formatUint(uint64_t value, char* out)
+{
+    return static_cast<size_t>(std::to_chars(out, out + 20, value).ptr - out);
+}
+
+void ResponseWriter::statusLine(int code, std::string_view reason)
+{
+    std::string_view line = statusLineOf(code);
+    if (!line.empty() && (reason.empty() || reason == Response::reasonPhrase(code)))
+    {
+        append(line);
+        return;
+    }
+    appendCopy("HTTP/1.1 ");
+    appendUint(static_cast<uint64_t>(code));
+    appendCopy(" ");
+    appendCopy(reason.empty() ? std::string_view("Unknown") : reason);
+    appendCopy("\r\n");
+}
+
+void ResponseWriter::header(std::string_view name, std::string_view value)
+{
+    if (name.size() + value.size() <= SMALL_HEADER)
+    {
+        char* p = reserve(name.size() + value.size() + 4);
+        memcpy(p, name.data(), name.size());
+        p += name.size();
+        memcpy(p, ": ", 2);
+        memcpy(p + 2, value.data(), value.size());
+        memcpy(p + 2 + value.size(), "\r\n", 2);
+        return;
+    }
+    appendCopy(name);
+    append(": ");
+    append(value);
+    append("\r\n");
+}
+
+void ResponseWriter::header(std::string_view name, uint64_t value)
+{
+    char digits[20];
+    size_t length = formatUint(value, digits);
+    header(name, std::string_view(digits, length));
+}
+
+void ResponseWriter::date()
+{
+    append(HttpDate::header());
+}
+
+void ResponseWriter::endHeaders(bool keepAlive)
+{
+    append(keepAlive ? std::string_view("Connection: keep-alive\r\n\r\n")
+                     : std::string_view("Connection: close\r\n\r\n"));
+}
+
+void ResponseWriter::append(std::string_view data)
+{
+    if (!data.empty())
+    {
+        push(data.data(), data.size());
+    }
+}
+
+void ResponseWriter::appendCopy(std::string_view data)
+{
+    if (!data.empty())
+    {
+        memcpy(reserve(data.size()), data.data(), data.size());
+    }
+}
+
+void ResponseWriter::appendUint(uint64_t value)
+{
+    char digits[20];
+    appendCopy(std::string_view(digits, formatUint(value, digits)));
+}
+
+void ResponseWriter::fixed(const FixedResponse& response, bool keepAlive, bool headOnly)
+{
+    append(response.head);
+    date();
+    endHeaders(keepAlive);
+    if (!headOnly)
+    {
+        append(response.body);
+    }
+}
+
+void ResponseWriter::clear()
+{
+    overflow.clear();
+    count = 0;
+    bytes = 0;
+    scratchUsed = 0;
+    spill.clear();
+}
+
+char* ResponseWriter::reserve(size_t n)
+{
+    char* p;
+    if (scratchUsed + n <= SCRATCH_SIZE)
+    {
+        p = scratch + scratchUsed;
+        scratchUsed += n;
+    }
+    else
+    {
+        spill.push_back(std::make_unique<char[]>(n));
+        p = spill.back().get();
+    }
+    push(p, n);
+    return p;
+}
+
+void ResponseWriter::push(const char* data, size_t length)
+{
+    bytes += length;
+    iovec* vecs = overflow.empty() ? inlineVecs : overflow.data();
+    if (count > 0)
+    {
+        iovec& last = vecs[count - 1];
+        if (static_cast<const char*>(last.iov_base) + last.iov_len == data)
+        {
+            last.iov_len += length;
+            return;
+        }
+    }
+
+    iovec vec{const_cast<char*>(data), length};
+    if (count < INLINE_IOVECS && overflow.empty())
+    {
+        inlineVecs[count++] = vec;
+        return;
+    }
+    if (overflow.empty())
+    {
+        overflow.assign(inlineVecs, inlineVecs + count);
+    }
+    overflow.push_back(vec);
+    ++count;
+}
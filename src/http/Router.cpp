@@ -0,0 +1,328 @@
+#include "http/Router.h"
+#include <cstring>
+#include <stdexcept>
+
+/**
+ * @brief 路由树节点
+ *
+ * 静态节点的label为压缩后的公共前缀；参数/通配节点的label为参数名，匹配时消耗一个路径段或剩余全部路径
+ */
+struct Router::Node
+{
+    std::string label;
+    std::string indices;                          // 各静态子节点label的首字节，与children一一对应
+    std::vector<std::unique_ptr<Node>> children;  // 静态子节点
+    std::unique_ptr<Node> param;                  // :param 子节点
+    std::unique_ptr<Node> wildcard;               // *wildcard 子节点
+    const Route* route = nullptr;                 // 在此结束的路由
+};
+
+namespace
+{
+size_t commonPrefix(std::string_view a, std::string_view b)
+{
+    size_t n = std::min(a.size(), b.size());
+    size_t i = 0;
+    while (i < n && a[i] == b[i])
+    {
+        ++i;
+    }
+    return i;
+}
+
+[[noreturn]] void invalidPattern(std::string_view pattern, const char* reason)
+{
+    throw std::runtime_error("Invalid route pattern '" + std::string(pattern) + "': " + reason);
+}
+} // namespace
+
+Router::Router() = default;
+Router::~Router() = default;
+
+void Router::add(std::string_view method, std::string_view pattern,
+                 Route::Handler handler, Route::BodyHandler onBody)
+{
+    addRoute(Route{std::string(method), std::string(pattern), std::move(handler), std::move(onBody), nullptr, nullptr,
+                   nullptr});
+}
+
+void Router::add(std::string_view method, std::string_view pattern, std::shared_ptr<const FixedResponse> fixed)
+{
+    addRoute(Route{std::string(method), std::string(pattern), nullptr, nullptr, std::move(fixed), nullptr, nullptr});
+}
+
+void Router::add(std::string_view method, std::string_view pattern, std::shared_ptr<UpstreamGroup> upstream)
+{
+    addRoute(Route{std::string(method), std::string(pattern), nullptr, nullptr, nullptr, std::move(upstream), nullptr});
+}
+
+void Router::add(std::string_view method, std::string_view pattern, Route::AsyncHandler handler)
+{
+    addRoute(Route{std::string(method), std::string(pattern), nullptr, nullptr, nullptr, nullptr, std::move(handler)});
+}
+
+void Router::addRoute(Route route)
+{
+    const std::string_view pattern = route.pattern;
+    if (pattern.empty() || pattern[0] != '/')
+    {
+        invalidPattern(pattern, "must start with '/'");
+    }
+
+    // 校验参数：只能出现在段首，名称非空，通配符只能在末尾，数量有上限
+    size_t paramCount = 0;
+    for (size_t i = 0; i < pattern.size(); ++i)
+    {
+        if (pattern[i] != ':' && pattern[i] != '*')
+        {
+            continue;
+        }
+        if (pattern[i - 1] != '/')
+        {
+            invalidPattern(pattern, "parameters must start a path segment");
+        }
+        size_t end = pattern.find('/', i);
+        if (end == i + 1 || i + 1 == pattern.size())
+        {
+            invalidPattern(pattern, "parameter name is empty");
+        }
+        if (pattern[i] == '*' && end != std::string_view::npos)
+        {
+            invalidPattern(pattern, "wildcard must be the last segment");
+        }
+        if (++paramCount > RouteParams::MAX_PARAMS)
+        {
+            invalidPattern(pattern, "too many parameters");
+        }
+    }
+
+    routes.push_back(std::move(route));
+    const Route* added = &routes.back();
+
+    Node* root = nullptr;
+    for (MethodTree& tree : trees)
+    {
+        if (tree.method == added->method)
+        {
+            root = tree.root.get();
+        }
+    }
+    if (root == nullptr)
+    {
+        trees.push_back(MethodTree{added->method, std::make_unique<Node>()});
+        root = trees.back().root.get();
+    }
+
+    try
+    {
+        insert(root, added->pattern, added->pattern, added);
+    }
+    catch (...)
+    {
+        routes.pop_back();
+        throw;
+    }
+}
+
+void Router::insert(Node* node, std::string_view pattern, std::string_view rest, const Route* route)
+{
+    while (true)
+    {
+        if (rest.empty())
+        {
+            if (node->route != nullptr)
+            {
+                invalidPattern(pattern, "conflicts with an existing route");
+            }
+            node->route = route;
+            return;
+        }
+
+        // 参数段
+        if (rest[0] == ':' || rest[0] == '*')
+        {
+            bool isWildcard = rest[0] == '*';
+            size_t end = std::min(rest.find('/'), rest.size());
+            std::string_view name = rest.substr(1, end - 1);
+            std::unique_ptr<Node>& child = isWildcard ? node->wildcard : node->param;
+            if (!child)
+            {
+                child = std::make_unique<Node>();
+                child->label = std::string(name);
+            }
+            else if (child->label != name)
+            {
+                // 同一位置的参数名必须一致，否则无法确定参数名
+                invalidPattern(pattern, "parameter name conflicts with an existing route");
+            }
+            node = child.get();
+            rest.remove_prefix(end);
+            continue;
+        }
+
+        // 静态段：直到下一个参数为止
+        size_t staticEnd = rest.size();
+        for (size_t i = 1; i < rest.size(); ++i)
+        {
+            if ((rest[i] == ':' || rest[i] == '*') && rest[i - 1] == '/')
+            {
+                staticEnd = i;
+                break;
+            }
+        }
+        std::string_view segment = rest.substr(0, staticEnd);
+
+        size_t index = node->indices.find(segment[0]);
+        if (index == std::string::npos)
+        {
+            auto child = std::make_unique<Node>();
+            child->label = std::string(segment);
+            node->indices.push_back(segment[0]);
+            node->children.push_back(std::move(child));
+            node = node->children.back().get();
+            rest.remove_prefix(segment.size());
+            continue;
+        }
+
+        Node* child = node->children[index].get();
+        size_t common = commonPrefix(child->label, segment);
+        if (common < child->label.size())
+        {
+            // 拆分已有节点：公共前缀成为新的中间节点
+            auto middle = std::make_unique<Node>();
+            middle->label = child->label.substr(0, common);
+            std::unique_ptr<Node> old = std::move(node->children[index]);
+            old->label.erase(0, common);
+            middle->indices.push_back(old->label[0]);
+            middle->children.push_back(std::move(old));
+            node->children[index] = std::move(middle);
+            child = node->children[index].get();
+        }
+        node = child;
+        rest.remove_prefix(common);
+    }
+}
+
+const Route* Router::matchNode(const Node* node, std::string_view rest, RouteParams& params)
+{
+    if (rest.empty())
+    {
+        if (node->route != nullptr)
+        {
+            return node->route;
+        }
+        // "/files/*path" 也匹配 "/files/"，参数值为空
+        if (node->wildcard && node->wildcard->route != nullptr)
+        {
+            params.push(node->wildcard->label, rest);
+            return node->wildcard->route;
+        }
+        return nullptr;
+    }
+
+    // 1.静态子节点（首字节各不相同，最多一个候选；子节点通常很少，线性扫描比memchr调用更快）
+    const size_t childCount = node->indices.size();
+    for (size_t i = 0; i < childCount; ++i)
+    {
+        if (node->indices[i] != rest[0])
+        {
+            continue;
+        }
+        const Node* child = node->children[i].get();
+        const size_t labelSize = child->label.size();
+        if (rest.size() >= labelSize && memcmp(rest.data(), child->label.data(), labelSize) == 0)
+        {
+            if (const Route* route = matchNode(child, rest.substr(labelSize), params))
+            {
+                return route;
+            }
+        }
+        break;
+    }
+
+    // 2.参数：消耗一个非空路径段
+    if (node->param)
+    {
+        size_t end = std::min(rest.find('/'), rest.size());
+        if (end > 0)
+        {
+            params.push(node->param->label, rest.substr(0, end));
+            if (const Route* route = matchNode(node->param.get(), rest.substr(end), params))
+            {
+                return route;
+            }
+            params.pop();
+        }
+    }
+
+    // 3.通配：消耗剩余全部路径
+    if (node->wildcard && node->wildcard->route != nullptr)
+    {
+        params.push(node->wildcard->label, rest);
+        return node->wildcard->route;
+    }
+    return nullptr;
+}
+
+const Router::Node* Router::treeFor(std::string_view method) const
+{
+    for (const MethodTree& tree : trees)
+    {
+        if (tree.method == method)
+        {
+            return tree.root.get();
+        }
+    }
+    return nullptr;
+}
+
+const Route* Router::match(std::string_view method, std::string_view path, RouteParams& params) const
+{
+    params.clear();
+    if (const Node* root = treeFor(method))
+    {
+        if (const Route* route = matchNode(root, path, params))
+        {
+            return route;
+        }
+    }
+
+    // HEAD默认由GET路由处理，响应时省略消息体
+    if (method == "HEAD")
+    {
+        params.clear();
+        if (const Node* root = treeFor("GET"))
+        {
+            return matchNode(root, path, params);
+        }
+    }
+    return nullptr;
+}
+
+std::string Router::allowedMethods(std::string_view path) const
+{
+    std::string allowed;
+    RouteParams params;
+    for (const MethodTree& tree : trees)
+    {
+        params.clear();
+        if (matchNode(tree.root.get(), path, params) != nullptr)
+        {
+            if (!allowed.empty())
+            {
+                allowed += ", ";
+            }
+            allowed += tree.method;
+        }
+    }
+    // GET路由同时处理HEAD
+    if (treeFor("HEAD") == nullptr && treeFor("GET") != nullptr)
+    {
+        params.clear();
+        if (matchNode(treeFor("GET"), path, params) != nullptr)
+        {
+            allowed += ", HEAD";
+        }
+    }
+    return allowed;
+}
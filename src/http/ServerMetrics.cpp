@@ -0,0 +1,40 @@
+#include "http/ServerMetrics.h"
+#include <string>
+
+ServerMetrics::ServerMetrics(MetricsRegistry& registry)
+    : accepted(registry.counter("vortex_connections_accepted_total", "Accepted TCP connections.")),
+      closed(registry.counter("vortex_connections_closed_total", "Closed TCP connections.")),
+      requests(registry.counter("vortex_requests_total", "Completed HTTP requests.")),
+      responses{},
+      bytesReceived(registry.counter("vortex_received_bytes_total", "Bytes read from client sockets.")),
+      bytesSent(registry.counter("vortex_sent_bytes_total", "Bytes written to client sockets.")),
+      shed(registry.counter("vortex_requests_shed_total",
+                            "Requests answered with 503 because the server was overloaded.")),
+      cacheHits(registry.counter("vortex_cache_lookups_total", "Response cache lookups by result.",
+                                 "result=\"hit\"")),
+      cacheMisses(registry.counter("vortex_cache_lookups_total", "Response cache lookups by result.",
+                                   "result=\"miss\"")),
+      cacheCoalesced(registry.counter("vortex_cache_lookups_total", "Response cache lookups by result.",
+                                      "result=\"coalesced\"")),
+      http2Connections(registry.counter("vortex_http2_connections_total",
+                                        "Connections that switched to HTTP/2 (prior knowledge or h2c upgrade).")),
+      http2Streams(registry.counter("vortex_http2_streams_total", "HTTP/2 request streams.")),
+      acceptToFirstByte(registry.histogram("vortex_accept_to_first_byte_seconds",
+                                           "Time from accepting a connection to its first response byte.")),
+      queueWait(registry.histogram("vortex_queue_wait_seconds",
+                                   "Time from readiness notification to processing the connection.")),
+      parse(registry.histogram("vortex_parse_seconds", "Time spent parsing request headers.")),
+      handler(registry.histogram("vortex_handler_seconds", "Time spent in route handlers.")),
+      write(registry.histogram("vortex_write_seconds", "Time spent handing responses to the kernel.")),
+      request(registry.histogram("vortex_request_seconds",
+                                 "Time from readiness notification to the response being sent.")),
+      upstream(registry.histogram("vortex_upstream_seconds",
+                                  "Time from forwarding a request to receiving the upstream response header."))
+{
+    // 同一族的样本需连续输出，因此最后统一注册
+    for (int i = 0; i < 5; ++i)
+    {
+        responses[i] = &registry.counter("vortex_responses_total", "HTTP responses by status class.",
+                                         "class=\"" + std::to_string(i + 1) + "xx\"");
+    }
+}
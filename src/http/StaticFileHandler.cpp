@@ -0,0 +1,534 @@
+#include "http/StaticFileHandler.h"
+#include "http/HttpHeaders.h"
+#include "utils/Logger.h"
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <strings.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+// 解析非负十进制整数，必须全部为数字且不溢出
+bool parseOffset(std::string_view text, long long& value)
+{
+    if (text.empty())
+    {
+        return false;
+    }
+    value = 0;
+    for (char c : text)
+    {
+        if (c < '0' || c > '9' || value > (LLONG_MAX - (c - '0')) / 10)
+        {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+// 按扩展名推断Content-Type
+const char* contentTypeOf(const std::string& path)
+{
+    static const struct
+    {
+        const char* ext;
+        const char* type;
+    } types[] = {
+        {".html", "text/html; charset=utf-8"},
+        {".htm", "text/html; charset=utf-8"},
+        {".css", "text/css; charset=utf-8"},
+        {".js", "application/javascript; charset=utf-8"},
+        {".json", "application/json"},
+        {".txt", "text/plain; charset=utf-8"},
+        {".xml", "application/xml"},
+        {".svg", "image/svg+xml"},
+        {".png", "image/png"},
+        {".jpg", "image/jpeg"},
+        {".jpeg", "image/jpeg"},
+        {".gif", "image/gif"},
+        {".ico", "image/x-icon"},
+        {".webp", "image/webp"},
+        {".woff", "font/woff"},
+        {".woff2", "font/woff2"},
+        {".wasm", "application/wasm"},
+        {".pdf", "application/pdf"},
+    };
+
+    size_t dot = path.rfind('.');
+    if (dot != std::string::npos && path.find('/', dot) == std::string::npos)
+    {
+        const char* ext = path.c_str() + dot;
+        for (const auto& t : types)
+        {
+            if (strcasecmp(ext, t.ext) == 0)
+            {
+                return t.type;
+            }
+        }
+    }
+    return "application/octet-stream";
+}
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 去掉查询串并做百分号解码，非法编码或包含NUL时返回false
+bool decodePath(const std::string& raw, std::string& out)
+{
+    size_t end = raw.find_first_of("?#");
+    if (end == std::string::npos)
+    {
+        end = raw.size();
+    }
+
+    out.clear();
+    out.reserve(end);
+    for (size_t i = 0; i < end; ++i)
+    {
+        char c = raw[i];
+        if (c == '%')
+        {
+            if (i + 2 >= end)
+            {
+                return false;
+            }
+            int hi = hexValue(raw[i + 1]);
+            int lo = hexValue(raw[i + 2]);
+            if (hi < 0 || lo < 0)
+            {
+                return false;
+            }
+            c = static_cast<char>(hi * 16 + lo);
+            i += 2;
+        }
+        if (c == '\0')
+        {
+            return false;
+        }
+        out.push_back(c);
+    }
+    return !out.empty() && out[0] == '/';
+}
+} // namespace
+
+CachedFile::~CachedFile()
+{
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+}
+
+StaticFileHandler::StaticFileHandler(const std::string& rootDir, size_t capacity)
+    : capacity(capacity)
+{
+    char resolved[PATH_MAX];
+    if (realpath(rootDir.c_str(), resolved) == nullptr)
+    {
+        LOG(FATAL) << "Static root " << rootDir << " is not accessible: " << strerror(errno);
+        throw std::runtime_error("invalid static root");
+    }
+    root = resolved;
+
+    notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notifyFd == -1)
+    {
+        // 没有inotify时退化为不缓存，保证不会返回过期内容
+        LOG(WARNING) << "inotify_init1 failed, static file cache disabled: " << strerror(errno);
+        this->capacity = 0;
+    }
+    LOG(INFO) << "Serving static files from " << root;
+}
+
+StaticFileHandler::~StaticFileHandler()
+{
+    if (notifyFd >= 0)
+    {
+        close(notifyFd);
+    }
+}
+
+std::shared_ptr<const CachedFile> StaticFileHandler::lookup(const std::string& path)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(path);
+        if (it != index.end())
+        {
+            // 命中：移动到LRU头部
+            lru.splice(lru.begin(), lru, it->second);
+            return it->second->second;
+        }
+    }
+
+    // 未命中：在锁外完成路径解析和文件打开
+    std::shared_ptr<const CachedFile> file = open(path);
+    if (!file || capacity == 0)
+    {
+        return file;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(path);
+    if (it != index.end())
+    {
+        // 其他线程已经插入
+        lru.splice(lru.begin(), lru, it->second);
+        return it->second->second;
+    }
+
+    // 必须先有目录监听才能缓存；监听建立前文件可能已变化，再确认一次
+    struct stat st;
+    if (!watchDirectory(file->realPath.substr(0, file->realPath.rfind('/'))) ||
+        stat(file->realPath.c_str(), &st) == -1 ||
+        st.st_mtime != file->mtime || st.st_size != file->size)
+    {
+        return file;
+    }
+    lru.emplace_front(path, file);
+    index[path] = lru.begin();
+    if (lru.size() > capacity)
+    {
+        index.erase(lru.back().first);
+        lru.pop_back();
+    }
+    return file;
+}
+
+std::shared_ptr<const CachedFile> StaticFileHandler::open(const std::string& requestPath)
+{
+    std::string decoded;
+    if (!decodePath(requestPath, decoded))
+    {
+        return nullptr;
+    }
+
+    std::string candidate = root + decoded;
+    if (candidate.back() == '/')
+    {
+        candidate += "index.html";
+    }
+
+    // realpath消除 .. 和符号链接，再确认仍位于根目录之下
+    char resolved[PATH_MAX];
+    if (realpath(candidate.c_str(), resolved) == nullptr)
+    {
+        return nullptr;
+    }
+    std::string realPath = resolved;
+
+    struct stat st;
+    if (stat(realPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+    {
+        realPath += "/index.html";
+    }
+    if (realPath.compare(0, root.size(), root) != 0 ||
+        (realPath.size() > root.size() && realPath[root.size()] != '/'))
+    {
+        LOG(WARNING) << "Rejected path outside static root: " << requestPath;
+        return nullptr;
+    }
+
+    int fd = ::open(realPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return nullptr;
+    }
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode))
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    auto file = std::make_shared<CachedFile>();
+    file->fd = fd;
+    file->size = st.st_size;
+    file->mtime = st.st_mtime;
+    file->realPath = realPath;
+
+    char buf[64];
+    snprintf(buf, sizeof(buf), "\"%lx-%lx\"",
+             static_cast<unsigned long>(st.st_mtime), static_cast<unsigned long>(st.st_size));
+    file->etag = buf;
+
+    struct tm tmBuf;
+    gmtime_r(&st.st_mtime, &tmBuf);
+    strftime(buf, sizeof(buf), "%a, %d %b %Y %H:%M:%S GMT", &tmBuf);
+    file->lastModified = buf;
+
+    file->contentType = contentTypeOf(realPath);
+    file->commonHeaders = std::string("Content-Type: ") + file->contentType + "\r\n" +
+                          "Last-Modified: " + file->lastModified + "\r\n" +
+                          "ETag: " + file->etag + "\r\n" +
+                          "Accept-Ranges: bytes\r\n";
+    file->okHeaders = "HTTP/1.1 200 OK\r\n" + file->commonHeaders +
+                      "Content-Length: " + std::to_string(st.st_size) + "\r\n";
+    openSiblings(*file);
+    return file;
+}
+
+void StaticFileHandler::openSiblings(CachedFile& file)
+{
+    for (ContentEncoding encoding : {ContentEncoding::GZIP, ContentEncoding::BROTLI})
+    {
+        std::string path = file.realPath + Compression::fileSuffix(encoding);
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+        {
+            continue;
+        }
+        // 比原始文件旧的压缩文件视为过期，不使用
+        struct stat st;
+        if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_mtime < file.mtime)
+        {
+            close(fd);
+            continue;
+        }
+        auto sibling = std::make_shared<CachedFile>();
+        sibling->fd = fd;
+        sibling->size = st.st_size;
+        sibling->mtime = st.st_mtime;
+        sibling->realPath = path;
+
+        auto encoded = std::make_shared<EncodedFile>();
+        encoded->file = std::move(sibling);
+        encoded->size = st.st_size;
+        describe(file, encoding, *encoded);
+        file.encoded[static_cast<int>(encoding)] = std::move(encoded);
+    }
+}
+
+void StaticFileHandler::describe(const CachedFile& file, ContentEncoding encoding, EncodedFile& encoded)
+{
+    // "mtime-size" -> "mtime-size-gzip"
+    encoded.etag = file.etag.substr(0, file.etag.size() - 1) + "-" + Compression::token(encoding) + "\"";
+    encoded.okHeaders = std::string("HTTP/1.1 200 OK\r\n") +
+                        "Content-Type: " + file.contentType + "\r\n" +
+                        "Content-Encoding: " + Compression::token(encoding) + "\r\n" +
+                        "Vary: Accept-Encoding\r\n" +
+                        "Last-Modified: " + file.lastModified + "\r\n" +
+                        "ETag: " + encoded.etag + "\r\n" +
+                        "Content-Length: " + std::to_string(encoded.size) + "\r\n";
+}
+
+std::shared_ptr<const EncodedFile> StaticFileHandler::compress(const CachedFile& file, ContentEncoding encoding,
+                                                               int level)
+{
+    std::string content(static_cast<size_t>(file.size), '\0');
+    size_t done = 0;
+    while (done < content.size())
+    {
+        ssize_t n = pread(file.fd, &content[done], content.size() - done, static_cast<off_t>(done));
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            LOG(WARNING) << "Failed to read " << file.realPath << " for compression";
+            return nullptr;
+        }
+        done += static_cast<size_t>(n);
+    }
+
+    auto encoded = std::make_shared<EncodedFile>();
+    if (!Compression::compress(encoding, level, content, encoded->data) || encoded->data.size() >= content.size())
+    {
+        return nullptr;
+    }
+    encoded->size = static_cast<off_t>(encoded->data.size());
+    describe(file, encoding, *encoded);
+    LOG(DEBUG) << "Compressed " << file.realPath << " with " << Compression::token(encoding) << ": "
+               << file.size << " -> " << encoded->size << " bytes";
+    return encoded;
+}
+
+bool StaticFileHandler::watchDirectory(const std::string& dir)
+{
+    if (watchedDirs.count(dir))
+    {
+        return true;
+    }
+    int wd = inotify_add_watch(notifyFd, dir.c_str(),
+                               IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_DELETE |
+                                   IN_MOVED_FROM | IN_MOVED_TO | IN_CREATE);
+    if (wd == -1)
+    {
+        LOG(WARNING) << "inotify_add_watch " << dir << " failed: " << strerror(errno);
+        return false;
+    }
+    watches[wd] = dir;
+    watchedDirs[dir] = wd;
+    return true;
+}
+
+void StaticFileHandler::invalidate(const std::string& realPath)
+{
+    // 压缩同名文件变化时使原始文件的条目失效
+    std::string original = realPath;
+    for (ContentEncoding encoding : {ContentEncoding::GZIP, ContentEncoding::BROTLI})
+    {
+        std::string suffix = Compression::fileSuffix(encoding);
+        if (original.size() > suffix.size() &&
+            original.compare(original.size() - suffix.size(), suffix.size(), suffix) == 0)
+        {
+            original.resize(original.size() - suffix.size());
+            break;
+        }
+    }
+
+    for (auto it = lru.begin(); it != lru.end();)
+    {
+        if (it->second->realPath == realPath || it->second->realPath == original)
+        {
+            LOG(DEBUG) << "Invalidated cached file " << realPath;
+            index.erase(it->first);
+            it = lru.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void StaticFileHandler::handleInotify()
+{
+    alignas(struct inotify_event) char buf[4096];
+    while (true)
+    {
+        ssize_t n = read(notifyFd, buf, sizeof(buf));
+        if (n <= 0)
+        {
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (char* p = buf; p < buf + n;)
+        {
+            auto* event = reinterpret_cast<struct inotify_event*>(p);
+            p += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                // 事件丢失，无法确定哪些文件变化，清空整个缓存
+                index.clear();
+                lru.clear();
+                continue;
+            }
+            if (event->mask & IN_IGNORED)
+            {
+                auto it = watches.find(event->wd);
+                if (it != watches.end())
+                {
+                    watchedDirs.erase(it->second);
+                    watches.erase(it);
+                }
+                continue;
+            }
+            auto it = watches.find(event->wd);
+            if (it != watches.end() && event->len > 0)
+            {
+                invalidate(it->second + "/" + event->name);
+            }
+        }
+    }
+}
+
+StaticFileHandler::RangeResult StaticFileHandler::parseRange(std::string_view header, off_t size,
+                                                             off_t& first, off_t& last)
+{
+    constexpr std::string_view prefix = "bytes=";
+    if (header.substr(0, prefix.size()) != prefix || header.find(',') != std::string_view::npos)
+    {
+        return RangeResult::NONE;
+    }
+    header.remove_prefix(prefix.size());
+
+    size_t dash = header.find('-');
+    if (dash == std::string_view::npos)
+    {
+        return RangeResult::NONE;
+    }
+    std::string_view startText = header.substr(0, dash);
+    std::string_view endText = header.substr(dash + 1);
+
+    long long start = 0;
+    long long end = 0;
+    if (startText.empty())
+    {
+        // 后缀区间：最后N个字节
+        if (!parseOffset(endText, end))
+        {
+            return RangeResult::NONE;
+        }
+        if (end == 0 || size == 0)
+        {
+            return RangeResult::UNSATISFIABLE;
+        }
+        first = end >= size ? 0 : size - end;
+        last = size - 1;
+        return RangeResult::SATISFIABLE;
+    }
+
+    if (!parseOffset(startText, start))
+    {
+        return RangeResult::NONE;
+    }
+    end = size - 1;
+    if (!endText.empty() && (!parseOffset(endText, end) || end < start))
+    {
+        return RangeResult::NONE;
+    }
+    if (start >= size)
+    {
+        return RangeResult::UNSATISFIABLE;
+    }
+    first = start;
+    last = end >= size ? size - 1 : end;
+    return RangeResult::SATISFIABLE;
+}
+
+bool StaticFileHandler::notModified(const CachedFile& file, std::string_view etag, std::string_view ifNoneMatch,
+                                    std::string_view ifModifiedSince)
+{
+    // If-None-Match优先于If-Modified-Since
+    if (!ifNoneMatch.empty())
+    {
+        return HttpHeaders::matchesETag(ifNoneMatch, etag);
+    }
+
+    if (!ifModifiedSince.empty())
+    {
+        if (ifModifiedSince == file.lastModified)
+        {
+            return true;
+        }
+        // strptime需要以'\0'结尾的字符串，HTTP日期定长29字节，过长的值直接忽略
+        char text[64];
+        if (ifModifiedSince.size() >= sizeof(text))
+        {
+            return false;
+        }
+        memcpy(text, ifModifiedSince.data(), ifModifiedSince.size());
+        text[ifModifiedSince.size()] = '\0';
+
+        struct tm tmBuf{};
+        if (strptime(text, "%a, %d %b %Y %H:%M:%S GMT", &tmBuf) != nullptr)
+        {
+            return file.mtime <= timegm(&tmBuf);
+        }
+    }
+    return false;
+}
@@ -0,0 +1,147 @@
+#include "http/Upstream.h"
+#include "utils/Logger.h"
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/un.h>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+constexpr char UNIX_PREFIX[] = "unix:";
+
+// 解析"host:port"、"[v6]:port"或"unix:/path"
+void resolve(UpstreamServer& server)
+{
+    const std::string& name = server.name;
+    if (name.compare(0, sizeof(UNIX_PREFIX) - 1, UNIX_PREFIX) == 0)
+    {
+        std::string path = name.substr(sizeof(UNIX_PREFIX) - 1);
+        auto* addr = reinterpret_cast<sockaddr_un*>(&server.address);
+        if (path.empty() || path.size() >= sizeof(addr->sun_path))
+        {
+            throw std::runtime_error("Invalid unix socket path in upstream: " + name);
+        }
+        addr->sun_family = AF_UNIX;
+        memcpy(addr->sun_path, path.c_str(), path.size() + 1);
+        server.addressLength = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size() + 1);
+        return;
+    }
+
+    size_t colon = name.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == name.size())
+    {
+        throw std::runtime_error("Upstream address must be host:port or unix:/path: " + name);
+    }
+    std::string host = name.substr(0, colon);
+    std::string port = name.substr(colon + 1);
+    if (host.front() == '[' && host.back() == ']')
+    {
+        host = host.substr(1, host.size() - 2);
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICSERV;
+    addrinfo* result = nullptr;
+    int rc = getaddrinfo(host.c_str(), port.c_str(), &hints, &result);
+    if (rc != 0 || result == nullptr)
+    {
+        throw std::runtime_error("Cannot resolve upstream " + name + ": " + gai_strerror(rc));
+    }
+    memcpy(&server.address, result->ai_addr, result->ai_addrlen);
+    server.addressLength = result->ai_addrlen;
+    freeaddrinfo(result);
+}
+} // namespace
+
+UpstreamGroup::UpstreamGroup(ProxyConfig config) : options(std::move(config))
+{
+    if (options.upstreams.empty())
+    {
+        throw std::runtime_error("Proxy needs at least one upstream");
+    }
+    for (const std::string& name : options.upstreams)
+    {
+        auto server = std::make_unique<UpstreamServer>();
+        server->name = name;
+        resolve(*server);
+        servers.push_back(std::move(server));
+    }
+}
+
+/**
+ * @brief 选择进行中请求最少的健康服务器
+ *
+ * 从轮转位置开始扫描，请求数相同时靠前者胜出，使空闲时的请求均匀分布；
+ * 全部被摘除时选择最早恢复的服务器（同样尽量避开exclude），而不是直接拒绝
+ */
+UpstreamServer* UpstreamGroup::pick(int64_t nowMs, const UpstreamServer* exclude)
+{
+    const size_t n = servers.size();
+    const size_t start = nextIndex.fetch_add(1, std::memory_order_relaxed) % n;
+    UpstreamServer* best = nullptr;
+    UpstreamServer* soonest = nullptr;
+    bool excludeHealthy = false;
+    for (size_t i = 0; i < n; ++i)
+    {
+        UpstreamServer* server = servers[(start + i) % n].get();
+        int64_t ejectedUntil = server->ejectedUntilMs.load(std::memory_order_relaxed);
+        if (ejectedUntil > nowMs)
+        {
+            if (server == exclude && n > 1)
+            {
+                continue;
+            }
+            if (soonest == nullptr || ejectedUntil < soonest->ejectedUntilMs.load(std::memory_order_relaxed))
+            {
+                soonest = server;
+            }
+            continue;
+        }
+        if (server == exclude && n > 1)
+        {
+            excludeHealthy = true;
+            continue;
+        }
+        if (best == nullptr || server->outstanding.load(std::memory_order_relaxed) <
+                                   best->outstanding.load(std::memory_order_relaxed))
+        {
+            best = server;
+        }
+    }
+    if (best != nullptr)
+    {
+        return best;
+    }
+    if (excludeHealthy)
+    {
+        return const_cast<UpstreamServer*>(exclude);
+    }
+    return soonest;
+}
+
+void UpstreamGroup::reportSuccess(UpstreamServer& server)
+{
+    if (server.failures.load(std::memory_order_relaxed) != 0)
+    {
+        server.failures.store(0, std::memory_order_relaxed);
+    }
+}
+
+void UpstreamGroup::reportFailure(UpstreamServer& server, int64_t nowMs)
+{
+    if (options.maxFails <= 0)
+    {
+        return;
+    }
+    if (server.failures.fetch_add(1, std::memory_order_relaxed) + 1 >= options.maxFails)
+    {
+        server.failures.store(0, std::memory_order_relaxed);
+        server.ejectedUntilMs.store(nowMs + options.failTimeoutMs, std::memory_order_relaxed);
+        LOG(WARNING) << "Upstream " << server.name << " ejected for " << options.failTimeoutMs << " ms after "
+                     << options.maxFails << " consecutive failures";
+    }
+}
@@ -0,0 +1,565 @@
+#include "http/UpstreamPool.h"
+#include "core/Buffer.h"
+#include "core/EventLoop.h"
+#include "utils/Logger.h"
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace
+{
+// 上游响应头的上限
+constexpr size_t MAX_RESPONSE_HEADER = 64 * 1024;
+
+// 每轮事件从一个上游连接读取的上限，水平触发下剩余数据在下一轮继续读取
+constexpr size_t MAX_READ_PER_ROUND = 256 * 1024;
+
+// 等待响应和空闲时关注的事件
+constexpr uint32_t READ_EVENTS = EPOLLIN | EPOLLRDHUP;
+} // namespace
+
+/**
+ * @brief 到上游的一条连接
+ */
+struct UpstreamPool::Link
+{
+    int fd = -1;
+    UpstreamServer* server = nullptr;
+    uint32_t events = 0;        // 当前关注的事件，0表示未注册
+    bool connecting = false;    // 非阻塞connect尚未完成
+    bool reused = false;        // 之前已完成过请求
+    ExchangePtr exchange;       // 当前的转发，空闲时为空
+};
+
+/**
+ * @brief 一次转发的状态，连接失败重试时换用新的连接，其余状态保留
+ */
+struct UpstreamPool::Exchange
+{
+    UpstreamGroup* group = nullptr;
+    std::string request;        // 请求报文，收到响应头之前保留以便重发
+    size_t sent = 0;            // 当前连接上已发出的字节数
+    bool headRequest = false;
+    bool idempotent = false;
+    ProxyHandler handler;
+
+    LinkPtr link;                       // 当前使用的连接
+    UpstreamServer* server = nullptr;   // 当前的上游（已计入其outstanding）
+    UpstreamServer* lastServer = nullptr; // 上一次尝试的上游，重试时尽量避开
+    int attempts = 0;                   // 已尝试的次数
+    bool freshOnly = false;             // 复用的连接失效后只用新连接
+
+    HttpParser parser{HttpParser::Mode::RESPONSE};
+    Buffer input;               // 已读入、尚未交给回调的响应数据
+    size_t headerLength = 0;
+    bool received = false;      // 当前连接上已收到响应字节
+    bool headersDone = false;   // 已把响应头交给回调
+    bool keepAlive = false;     // 上游是否允许复用连接
+    bool paused = false;
+    bool done = false;          // 已结束（完成、失败或放弃）
+    TimerId timer;
+};
+
+UpstreamPool::UpstreamPool(EventLoop& loop) : loop(loop)
+{
+}
+
+UpstreamPool::~UpstreamPool()
+{
+    for (auto& entry : links)
+    {
+        if (entry.second->events != 0)
+        {
+            loop.removeFd(entry.first);
+        }
+        close(entry.first);
+    }
+}
+
+std::shared_ptr<UpstreamPool::Exchange> UpstreamPool::forward(UpstreamGroup& group, std::string request,
+                                                              bool headRequest, bool idempotent,
+                                                              ProxyHandler handler)
+{
+    auto exchange = std::make_shared<Exchange>();
+    exchange->group = &group;
+    exchange->request = std::move(request);
+    exchange->headRequest = headRequest;
+    exchange->idempotent = idempotent;
+    exchange->handler = std::move(handler);
+    connect(exchange);
+    return exchange;
+}
+
+void UpstreamPool::resume(const std::shared_ptr<Exchange>& exchange)
+{
+    if (!exchange || exchange->done || !exchange->paused)
+    {
+        return;
+    }
+    exchange->paused = false;
+    armTimer(exchange, exchange->group->config().responseTimeoutMs);
+    // 水平触发：暂停期间积压在socket中的数据会立即触发可读
+    setEvents(*exchange->link, READ_EVENTS);
+}
+
+size_t UpstreamPool::idleCount() const
+{
+    size_t count = 0;
+    for (const auto& entry : idle)
+    {
+        count += entry.second.size();
+    }
+    return count;
+}
+
+/**
+ * @brief 选择上游并发出请求
+ *
+ * 优先复用该上游最近放回的空闲连接，没有时新建连接
+ */
+void UpstreamPool::connect(const ExchangePtr& exchange)
+{
+    Exchange& ex = *exchange;
+    UpstreamServer* server = ex.group->pick(EventLoop::nowMs(), ex.lastServer);
+    ++ex.attempts;
+    ex.server = server;
+    server->outstanding.fetch_add(1, std::memory_order_relaxed);
+
+    ex.sent = 0;
+    ex.input.retrieveAll();
+    ex.parser.reset();
+    if (ex.headRequest)
+    {
+        ex.parser.expectNoBody();
+    }
+    ex.received = false;
+
+    LinkPtr link;
+    auto it = idle.find(server);
+    if (!ex.freshOnly && it != idle.end() && !it->second.empty())
+    {
+        link = std::move(it->second.back());
+        it->second.pop_back();
+    }
+    else
+    {
+        link = open(server);
+        if (!link)
+        {
+            fail(exchange, 502, true, Retry::NEXT_UPSTREAM);
+            return;
+        }
+    }
+    link->exchange = exchange;
+    ex.link = link;
+
+    const ProxyConfig& config = ex.group->config();
+    armTimer(exchange, link->connecting ? config.connectTimeoutMs : config.responseTimeoutMs);
+    if (link->connecting)
+    {
+        setEvents(*link, EPOLLOUT);
+    }
+    else
+    {
+        writeRequest(link, exchange);
+    }
+}
+
+UpstreamPool::LinkPtr UpstreamPool::open(UpstreamServer* server)
+{
+    const int family = server->address.ss_family;
+    int fd = socket(family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        LOG(ERROR) << "Failed to create upstream socket: " << strerror(errno);
+        return nullptr;
+    }
+    if (family != AF_UNIX)
+    {
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+
+    int rc = ::connect(fd, reinterpret_cast<const sockaddr*>(&server->address), server->addressLength);
+    if (rc < 0 && errno != EINPROGRESS)
+    {
+        // Unix域socket的EAGAIN表示对端的监听队列已满，同样视为连接失败
+        LOG(WARNING) << "Connect to upstream " << server->name << " failed: " << strerror(errno);
+        close(fd);
+        return nullptr;
+    }
+
+    auto link = std::make_shared<Link>();
+    link->fd = fd;
+    link->server = server;
+    link->connecting = rc < 0;
+    links.emplace(fd, link);
+    return link;
+}
+
+/**
+ * @brief 上游连接的就绪事件
+ *
+ * 水平触发，具体是哪种事件无关紧要：按连接所处的阶段检查connect结果、继续写请求或读取响应，
+ * 错误和挂断都会在随后的系统调用中体现
+ */
+void UpstreamPool::handleEvent(int fd)
+{
+    auto it = links.find(fd);
+    if (it == links.end())
+    {
+        return;
+    }
+    LinkPtr link = it->second;
+    ExchangePtr exchange = link->exchange;
+
+    // 空闲连接上的任何事件都意味着对端关闭或发来了不属于任何请求的数据
+    if (!exchange)
+    {
+        std::vector<LinkPtr>& stack = idle[link->server];
+        for (auto pos = stack.begin(); pos != stack.end(); ++pos)
+        {
+            if (*pos == link)
+            {
+                stack.erase(pos);
+                break;
+            }
+        }
+        LOG(DEBUG) << "Idle upstream connection to " << link->server->name << " closed (fd: " << fd << ")";
+        closeLink(link);
+        return;
+    }
+
+    if (link->connecting)
+    {
+        int error = 0;
+        socklen_t length = sizeof(error);
+        getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length);
+        if (error != 0)
+        {
+            LOG(WARNING) << "Connect to upstream " << link->server->name << " failed: " << strerror(error);
+            fail(exchange, 502, true, Retry::NEXT_UPSTREAM);
+            return;
+        }
+        link->connecting = false;
+        armTimer(exchange, exchange->group->config().responseTimeoutMs);
+    }
+
+    if (exchange->sent < exchange->request.size())
+    {
+        writeRequest(link, exchange);
+        return;
+    }
+    readResponse(link, exchange);
+}
+
+/**
+ * @brief 写出请求，socket写满时关注EPOLLOUT
+ */
+void UpstreamPool::writeRequest(const LinkPtr& link, const ExchangePtr& exchange)
+{
+    Exchange& ex = *exchange;
+    while (ex.sent < ex.request.size())
+    {
+        ssize_t n = send(link->fd, ex.request.data() + ex.sent, ex.request.size() - ex.sent, MSG_NOSIGNAL);
+        if (n > 0)
+        {
+            ex.sent += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            setEvents(*link, EPOLLOUT);
+            return;
+        }
+
+        bool stale = link->reused && ex.idempotent && !ex.freshOnly;
+        LOG(stale ? DEBUG : WARNING) << "Send to upstream " << link->server->name
+                                     << " failed: " << strerror(errno);
+        fail(exchange, 502, !stale, stale ? Retry::NEW_CONNECTION : Retry::NONE);
+        return;
+    }
+    setEvents(*link, READ_EVENTS);
+}
+
+/**
+ * @brief 读取响应
+ *
+ * 在收到任何字节之前被关闭的复用连接按失效处理，幂等请求在新连接上重发；
+ * 没有长度信息的响应以连接关闭作为结束
+ */
+void UpstreamPool::readResponse(const LinkPtr& link, const ExchangePtr& exchange)
+{
+    Exchange& ex = *exchange;
+    size_t roundBytes = 0;
+    while (roundBytes < MAX_READ_PER_ROUND && !ex.paused && link->exchange == exchange)
+    {
+        int savedErrno = 0;
+        ssize_t n = ex.input.readFd(link->fd, &savedErrno);
+        if (n > 0)
+        {
+            roundBytes += static_cast<size_t>(n);
+            ex.received = true;
+            armTimer(exchange, ex.group->config().responseTimeoutMs);
+            processResponse(link, exchange);
+            continue;
+        }
+        if (n < 0 && savedErrno == EINTR)
+        {
+            continue;
+        }
+        if (n < 0 && (savedErrno == EAGAIN || savedErrno == EWOULDBLOCK))
+        {
+            return;
+        }
+
+        if (n == 0 && ex.headersDone && ex.parser.finishAtClose())
+        {
+            finish(link, exchange, false);
+            return;
+        }
+        bool stale = !ex.received && link->reused && ex.idempotent && !ex.freshOnly;
+        LOG(stale ? DEBUG : WARNING) << "Upstream " << link->server->name << " closed the connection"
+                                     << (ex.received ? " mid-response" : " before responding")
+                                     << (n < 0 ? std::string(": ") + strerror(savedErrno) : std::string());
+        fail(exchange, 502, !stale, stale ? Retry::NEW_CONNECTION : Retry::NONE);
+        return;
+    }
+}
+
+/**
+ * @brief 解析响应头和消息体并交给回调
+ *
+ * 1xx中间响应直接丢弃；响应头交给回调之后立即从缓冲中移除，消息体解码后边读边交付
+ */
+void UpstreamPool::processResponse(const LinkPtr& link, const ExchangePtr& exchange)
+{
+    Exchange& ex = *exchange;
+    Buffer& input = ex.input;
+    using Flow = ProxyHandler::Flow;
+
+    while (!ex.headersDone)
+    {
+        ex.headerLength = ex.parser.parse(input.peek(), input.readableBytes());
+        if (ex.parser.hasError() ||
+            (!ex.parser.isHeaderComplete() && input.readableBytes() > MAX_RESPONSE_HEADER))
+        {
+            LOG(WARNING) << "Malformed response header from upstream " << link->server->name;
+            fail(exchange, 502, true, Retry::NONE);
+            return;
+        }
+        if (!ex.parser.isHeaderComplete())
+        {
+            return;
+        }
+        if (ex.parser.getStatus() < 200)
+        {
+            input.retrieve(ex.headerLength);
+            ex.parser.reset();
+            if (ex.headRequest)
+            {
+                ex.parser.expectNoBody();
+            }
+            continue;
+        }
+
+        ex.headersDone = true;
+        ex.keepAlive = ex.parser.shouldKeepAlive();
+        ex.group->reportSuccess(*link->server);
+        std::string().swap(ex.request);
+
+        Flow flow = ex.handler.onHeaders(ex.parser);
+        input.retrieve(ex.headerLength);
+        if (flow == Flow::ABORT)
+        {
+            abort(exchange);
+            return;
+        }
+        if (flow == Flow::PAUSE)
+        {
+            ex.paused = true;
+        }
+    }
+
+    // 暂停之前已读入的数据仍然交付，暂停只停止继续读取上游
+    if (!ex.parser.isComplete())
+    {
+        bool aborted = false;
+        size_t used = ex.parser.parseBody(input.peek(), input.readableBytes(), [&](std::string_view data) {
+            if (aborted)
+            {
+                return;
+            }
+            Flow flow = ex.handler.onBody(data);
+            aborted = flow == Flow::ABORT;
+            ex.paused = ex.paused || flow == Flow::PAUSE;
+        });
+        input.retrieve(used);
+        if (aborted)
+        {
+            abort(exchange);
+            return;
+        }
+        if (ex.parser.hasError())
+        {
+            LOG(WARNING) << "Malformed response body from upstream " << link->server->name;
+            fail(exchange, 502, true, Retry::NONE);
+            return;
+        }
+    }
+
+    if (ex.parser.isComplete())
+    {
+        // 上游多发的数据说明连接状态已不可信，不再复用
+        finish(link, exchange, ex.keepAlive && input.readableBytes() == 0);
+        return;
+    }
+    if (ex.paused)
+    {
+        setEvents(*link, 0);
+    }
+}
+
+void UpstreamPool::fail(const ExchangePtr& exchange, int error, bool countFailure, Retry retry)
+{
+    Exchange& ex = *exchange;
+    if (ex.link)
+    {
+        LinkPtr link = std::move(ex.link);
+        link->exchange.reset();
+        closeLink(link);
+    }
+    if (countFailure)
+    {
+        ex.group->reportFailure(*ex.server, EventLoop::nowMs());
+    }
+    release(ex);
+
+    if (retry == Retry::NEW_CONNECTION ||
+        (retry == Retry::NEXT_UPSTREAM && ex.attempts < static_cast<int>(ex.group->size())))
+    {
+        ex.freshOnly = ex.freshOnly || retry == Retry::NEW_CONNECTION;
+        connect(exchange);
+        return;
+    }
+
+    ex.done = true;
+    loop.cancelTimer(ex.timer);
+    ex.handler.onComplete(error);
+}
+
+void UpstreamPool::finish(const LinkPtr& link, const ExchangePtr& exchange, bool reusable)
+{
+    Exchange& ex = *exchange;
+    ex.done = true;
+    ex.link.reset();
+    link->exchange.reset();
+    release(ex);
+    loop.cancelTimer(ex.timer);
+
+    std::vector<LinkPtr>& stack = idle[link->server];
+    if (reusable && stack.size() < ex.group->config().maxIdlePerReactor)
+    {
+        link->reused = true;
+        setEvents(*link, READ_EVENTS);
+        stack.push_back(link);
+    }
+    else
+    {
+        closeLink(link);
+    }
+    ex.handler.onComplete(0);
+}
+
+void UpstreamPool::abort(const ExchangePtr& exchange)
+{
+    Exchange& ex = *exchange;
+    ex.done = true;
+    if (ex.link)
+    {
+        LinkPtr link = std::move(ex.link);
+        link->exchange.reset();
+        closeLink(link);
+    }
+    release(ex);
+    loop.cancelTimer(ex.timer);
+}
+
+void UpstreamPool::release(Exchange& exchange)
+{
+    if (exchange.server != nullptr)
+    {
+        exchange.server->outstanding.fetch_sub(1, std::memory_order_relaxed);
+        exchange.lastServer = exchange.server;
+        exchange.server = nullptr;
+    }
+}
+
+void UpstreamPool::armTimer(const ExchangePtr& exchange, int64_t delayMs)
+{
+    if (!loop.restartTimer(exchange->timer, delayMs))
+    {
+        std::weak_ptr<Exchange> weakExchange = exchange;
+        exchange->timer = loop.runAfter(delayMs, [this, weakExchange] { handleTimeout(weakExchange); });
+    }
+}
+
+/**
+ * @brief 超时：连接阶段换一个上游重试，等待响应阶段以504结束
+ *
+ * 因客户端消费慢而暂停期间的超时不计入上游的健康状态
+ */
+void UpstreamPool::handleTimeout(const std::weak_ptr<Exchange>& weakExchange)
+{
+    ExchangePtr exchange = weakExchange.lock();
+    if (!exchange || exchange->done || !exchange->link)
+    {
+        return;
+    }
+    const std::string& name = exchange->link->server->name;
+    if (exchange->link->connecting)
+    {
+        LOG(WARNING) << "Connect to upstream " << name << " timed out";
+        fail(exchange, 504, true, Retry::NEXT_UPSTREAM);
+        return;
+    }
+    LOG(WARNING) << "Upstream " << name << " timed out" << (exchange->paused ? " (paused by client)" : "");
+    fail(exchange, 504, !exchange->paused, Retry::NONE);
+}
+
+void UpstreamPool::setEvents(Link& link, uint32_t events)
+{
+    if (events == link.events)
+    {
+        return;
+    }
+    if (events == 0)
+    {
+        loop.removeFd(link.fd);
+    }
+    else if (link.events == 0)
+    {
+        const int fd = link.fd;
+        loop.addFd(fd, events, [this, fd](uint32_t) { handleEvent(fd); });
+    }
+    else
+    {
+        loop.modFd(link.fd, events);
+    }
+    link.events = events;
+}
+
+void UpstreamPool::closeLink(const LinkPtr& link)
+{
+    setEvents(*link, 0);
+    close(link->fd);
+    links.erase(link->fd);
+}
@@ -0,0 +1,292 @@
+#include "utils/AsyncLogging.h"
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+// t所在自然日（本地时间）结束、下一天开始的时刻，与滚动文件名的本地时间后缀一致
+std::time_t nextLocalMidnight(std::time_t t)
+{
+    struct tm tmBuf;
+    localtime_r(&t, &tmBuf);
+    tmBuf.tm_mday += 1;
+    tmBuf.tm_hour = 0;
+    tmBuf.tm_min = 0;
+    tmBuf.tm_sec = 0;
+    tmBuf.tm_isdst = -1;
+    return std::mktime(&tmBuf);
+}
+} // namespace
+
+LogFile::LogFile(const std::string &path, size_t rollSize)
+    : path(path), rollSize(rollSize)
+{
+    open();
+}
+
+LogFile::~LogFile()
+{
+    if (fd >= 0)
+    {
+        ::close(fd);
+    }
+}
+
+void LogFile::open()
+{
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    written = 0;
+    if (fd >= 0)
+    {
+        // 追加模式下从已有文件大小开始计数
+        off_t size = ::lseek(fd, 0, SEEK_END);
+        written = size > 0 ? static_cast<size_t>(size) : 0;
+    }
+    dayEnd = nextLocalMidnight(std::time(nullptr));
+}
+
+void LogFile::roll()
+{
+    if (fd >= 0)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+
+    // 旧文件重命名为 path.YYYYmmdd-HHMMSS
+    char suffix[32];
+    std::time_t now = std::time(nullptr);
+    struct tm tmBuf;
+    localtime_r(&now, &tmBuf);
+    std::strftime(suffix, sizeof(suffix), ".%Y%m%d-%H%M%S", &tmBuf);
+    std::rename(path.c_str(), (path + suffix).c_str());
+
+    open();
+}
+
+void LogFile::write(const char *buf, size_t len)
+{
+    if (written + len > rollSize || std::time(nullptr) >= dayEnd)
+    {
+        roll();
+    }
+    if (fd < 0)
+    {
+        return;
+    }
+
+    // 循环写直至完成，一次系统调用通常即可写完整块缓冲区
+    while (len > 0)
+    {
+        ssize_t n = ::write(fd, buf, len);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return;
+        }
+        buf += n;
+        len -= static_cast<size_t>(n);
+        written += static_cast<size_t>(n);
+    }
+}
+
+AsyncLogging::AsyncLogging(const std::string &path, size_t rollSize,
+                           int flushIntervalSec, size_t maxPendingBuffers)
+    : path(path),
+      rollSize(rollSize),
+      flushInterval(flushIntervalSec),
+      maxPendingBuffers(maxPendingBuffers)
+{
+}
+
+AsyncLogging::~AsyncLogging()
+{
+    stop();
+}
+
+void AsyncLogging::start()
+{
+    bool expected = false;
+    if (running.compare_exchange_strong(expected, true))
+    {
+        thread = std::thread([this] { threadFunc(); });
+    }
+}
+
+void AsyncLogging::stop()
+{
+    if (running.exchange(false))
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            wakeup = true;
+        }
+        cond.notify_one();
+        thread.join();
+    }
+}
+
+AsyncLogging::ThreadBuffer &AsyncLogging::localBuffer()
+{
+    // 线程退出时只释放这里的引用，缓冲区中剩余的日志仍由后台线程写出
+    thread_local std::shared_ptr<ThreadBuffer> local;
+    thread_local const AsyncLogging *owner = nullptr;
+    if (!local || owner != this)
+    {
+        local = std::make_shared<ThreadBuffer>();
+        owner = this;
+        std::lock_guard<std::mutex> lock(mutex);
+        threadBuffers.push_back(local);
+    }
+    return *local;
+}
+
+void AsyncLogging::append(const char *line, size_t len)
+{
+    if (len > LogBuffer::CAPACITY)
+    {
+        len = LogBuffer::CAPACITY;
+    }
+
+    ThreadBuffer &local = localBuffer();
+    std::lock_guard<std::mutex> lock(local.mutex);
+    if (local.current && local.current->avail() >= len)
+    {
+        local.current->append(line, len);
+        return;
+    }
+
+    // 当前缓冲区已满，挂到待写队列并唤醒后台线程；被后台取走时直接换一块
+    bool full = local.current != nullptr;
+    if (full)
+    {
+        if (pendingBuffers.load(std::memory_order_relaxed) >= maxPendingBuffers)
+        {
+            // 后台来不及落盘：丢弃本条，避免内存无限增长
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        local.full.push_back(std::move(local.current));
+        pendingBuffers.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (!freeBuffers.empty())
+        {
+            local.current = std::move(freeBuffers.back());
+            freeBuffers.pop_back();
+        }
+        wakeup = wakeup || full;
+    }
+    if (full)
+    {
+        cond.notify_one();
+    }
+    if (!local.current)
+    {
+        local.current.reset(new LogBuffer);
+    }
+    local.current->append(line, len);
+}
+
+void AsyncLogging::collect(std::vector<BufferPtr> &out)
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        wakeup = false;
+        snapshot = threadBuffers;
+    }
+
+    // 逐个线程取走，写满的缓冲区在前，同一线程内保持顺序
+    for (const auto &buffer : snapshot)
+    {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        pendingBuffers.fetch_sub(buffer->full.size(), std::memory_order_relaxed);
+        for (auto &full : buffer->full)
+        {
+            out.push_back(std::move(full));
+        }
+        buffer->full.clear();
+        if (buffer->current && buffer->current->length() > 0)
+        {
+            out.push_back(std::move(buffer->current));
+        }
+    }
+    snapshot.clear();
+
+    // 只剩这里的引用说明线程已退出，之后不会再追加
+    std::lock_guard<std::mutex> lock(mutex);
+    threadBuffers.erase(std::remove_if(threadBuffers.begin(), threadBuffers.end(),
+                                       [](const std::shared_ptr<ThreadBuffer> &buffer) {
+                                           if (buffer.use_count() > 1)
+                                           {
+                                               return false;
+                                           }
+                                           std::lock_guard<std::mutex> guard(buffer->mutex);
+                                           return buffer->full.empty() &&
+                                                  (!buffer->current || buffer->current->length() == 0);
+                                       }),
+                        threadBuffers.end());
+}
+
+void AsyncLogging::threadFunc()
+{
+    // 回收的空缓冲区上限，其余落盘后释放
+    constexpr size_t MAX_FREE_BUFFERS = 8;
+
+    LogFile output(path, rollSize);
+    std::vector<BufferPtr> buffersToWrite;
+    size_t reportedDrops = 0;
+
+    bool keepRunning = true;
+    while (keepRunning)
+    {
+        keepRunning = running.load();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!wakeup && keepRunning)
+            {
+                cond.wait_for(lock, std::chrono::seconds(flushInterval));
+            }
+        }
+        collect(buffersToWrite);
+
+        size_t totalDrops = dropped.load(std::memory_order_relaxed);
+        if (totalDrops != reportedDrops)
+        {
+            char note[96];
+            int n = std::snprintf(note, sizeof(note),
+                                  "[WARNING] Dropped %zu log messages (backend overloaded)\n",
+                                  totalDrops - reportedDrops);
+            output.write(note, static_cast<size_t>(n));
+            reportedDrops = totalDrops;
+        }
+
+        for (const auto &buffer : buffersToWrite)
+        {
+            output.write(buffer->begin(), buffer->length());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto &buffer : buffersToWrite)
+            {
+                if (freeBuffers.size() >= MAX_FREE_BUFFERS)
+                {
+                    break;
+                }
+                buffer->reset();
+                freeBuffers.push_back(std::move(buffer));
+            }
+        }
+        buffersToWrite.clear();
+    }
+}
@@ -25,10 +25,15 @@ void Logger::log(LogLevel level, const std::string &msg)
     switch (saveToFile)
     {
     case true:
-        // to do
-        //写入到文件
-        logToFile(msg);
+    {
+        //写入到文件（格式化在锁外完成，后端只做一次memcpy）
+        std::string line;
+        line.reserve(msg.size() + 12);
+        line.append("[").append(levelNames[static_cast<int>(level)]).append("] ").append(msg);
+        line.push_back('\n');
+        appendToFile(line);
         break;
+    }
     case false:
         // to do
         //直接打印到标准错误
@@ -39,17 +44,19 @@ void Logger::log(LogLevel level, const std::string &msg)
 }
 
 void Logger::logToFile(const std::string &message)
-{ 
-    std::lock_guard<std::mutex> lock(logMutex);
-    
-    std::ofstream out(logPath,std::ios::app);
-    if(!out.is_open())
-    {
-        return;
-    }
-    out<<message<<std::endl;
-    //out.write(message.c_str(),message.size());
-    out.close();
+{
+    appendToFile(message + '\n');
+}
+
+void Logger::appendToFile(const std::string &line)
+{
+    // 后端（缓冲区和后台线程）延迟到第一条文件日志时创建，只输出到屏幕的进程不分配；
+    // 也保证daemon()之后的子进程才拥有后台线程
+    std::call_once(asyncLogStarted, [this] {
+        asyncLog.reset(new AsyncLogging(logPath));
+        asyncLog->start();
+    });
+    asyncLog->append(line.data(), line.size());
 }
 
 
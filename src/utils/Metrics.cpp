@@ -0,0 +1,240 @@
+#include "utils/Metrics.h"
+#include <cstdio>
+
+namespace
+{
+// 新线程依次领取分片
+std::atomic<size_t> nextShard{0};
+
+// Prometheus直方图输出的桶边界：2^MIN_LE_EXPONENT ~ 2^MAX_EXPONENT纳秒（约1微秒~18分钟）
+constexpr unsigned MIN_LE_EXPONENT = 10;
+
+// 以秒输出纳秒值
+void appendSeconds(std::string& out, uint64_t ns)
+{
+    char buf[32];
+    int n = snprintf(buf, sizeof(buf), "%.9g", static_cast<double>(ns) / 1e9);
+    out.append(buf, static_cast<size_t>(n));
+}
+
+// 名称和标签拼成样本名，extra为附加的标签（如le）
+void appendSample(std::string& out, const std::string& name, const char* suffix,
+                  const std::string& labels, const std::string& extra)
+{
+    out += name;
+    out += suffix;
+    if (!labels.empty() || !extra.empty())
+    {
+        out += '{';
+        out += labels;
+        if (!labels.empty() && !extra.empty())
+        {
+            out += ',';
+        }
+        out += extra;
+        out += '}';
+    }
+    out += ' ';
+}
+} // namespace
+
+size_t Counter::shardIndex()
+{
+    thread_local const size_t index = nextShard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+    return index;
+}
+
+uint64_t Counter::value() const
+{
+    uint64_t total = 0;
+    for (const Shard& shard : shards)
+    {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+Histogram::Histogram() : shards(new Shard[SHARDS])
+{
+    for (size_t i = 0; i < SHARDS; ++i)
+    {
+        shards[i].sum.store(0, std::memory_order_relaxed);
+        for (auto& bucket : shards[i].buckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+size_t Histogram::bucketOf(uint64_t ns)
+{
+    if (ns < SUB_BUCKETS)
+    {
+        return static_cast<size_t>(ns);
+    }
+    unsigned exponent = 63u - static_cast<unsigned>(__builtin_clzll(ns));
+    if (exponent >= MAX_EXPONENT)
+    {
+        return BUCKETS - 1;
+    }
+    // 最高位之后的SUB_BUCKET_BITS位决定子桶
+    unsigned shift = exponent - SUB_BUCKET_BITS;
+    size_t sub = static_cast<size_t>((ns >> shift) & (SUB_BUCKETS - 1));
+    return SUB_BUCKETS + shift * SUB_BUCKETS + sub;
+}
+
+uint64_t Histogram::bucketLowerBound(size_t bucket)
+{
+    if (bucket < SUB_BUCKETS)
+    {
+        return bucket;
+    }
+    size_t shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+    uint64_t sub = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+    return (SUB_BUCKETS | sub) << shift;
+}
+
+void Histogram::record(uint64_t ns)
+{
+    Shard& shard = shards[Counter::shardIndex()];
+    shard.buckets[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(ns, std::memory_order_relaxed);
+}
+
+Histogram::Snapshot Histogram::snapshot() const
+{
+    Snapshot result;
+    result.buckets.assign(BUCKETS, 0);
+    for (size_t i = 0; i < SHARDS; ++i)
+    {
+        const Shard& shard = shards[i];
+        for (size_t b = 0; b < BUCKETS; ++b)
+        {
+            result.buckets[b] += shard.buckets[b].load(std::memory_order_relaxed);
+        }
+        result.sum += shard.sum.load(std::memory_order_relaxed);
+    }
+    // 总数由桶求和得到，保证输出的累计桶与_count一致
+    for (uint64_t n : result.buckets)
+    {
+        result.count += n;
+    }
+    return result;
+}
+
+uint64_t Histogram::Snapshot::countBelow(uint64_t value) const
+{
+    uint64_t total = 0;
+    for (size_t b = 0; b < buckets.size() && Histogram::bucketLowerBound(b) < value; ++b)
+    {
+        total += buckets[b];
+    }
+    return total;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const std::string& labels)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    counters.emplace_back();
+    addEntry(Type::COUNTER, name, help, labels).counter = &counters.back();
+    return counters.back();
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const std::string& labels)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    histograms.emplace_back();
+    addEntry(Type::HISTOGRAM, name, help, labels).histogram = &histograms.back();
+    return histograms.back();
+}
+
+void MetricsRegistry::gauge(const std::string& name, const std::string& help, GaugeFunction fn,
+                            const std::string& labels)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    addEntry(Type::GAUGE, name, help, labels).gauge = std::move(fn);
+}
+
+MetricsRegistry::Entry& MetricsRegistry::addEntry(Type type, const std::string& name, const std::string& help,
+                                                  const std::string& labels)
+{
+    entries.emplace_back();
+    Entry& entry = entries.back();
+    entry.type = type;
+    entry.name = name;
+    entry.help = help;
+    entry.labels = labels;
+    return entry;
+}
+
+std::string MetricsRegistry::render() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string out;
+    out.reserve(entries.size() * 256);
+
+    std::vector<const std::string*> described;
+    for (const Entry& entry : entries)
+    {
+        // 同一族只输出一次HELP/TYPE
+        bool seen = false;
+        for (const std::string* name : described)
+        {
+            seen = seen || *name == entry.name;
+        }
+        if (!seen)
+        {
+            described.push_back(&entry.name);
+            static const char* const TYPE_NAMES[] = {"counter", "gauge", "histogram"};
+            out += "# HELP " + entry.name + " " + entry.help + "\n";
+            out += "# TYPE " + entry.name + " " + TYPE_NAMES[static_cast<int>(entry.type)] + "\n";
+        }
+
+        switch (entry.type)
+        {
+            case Type::COUNTER:
+                appendSample(out, entry.name, "", entry.labels, "");
+                out += std::to_string(entry.counter->value()) + "\n";
+                break;
+            case Type::GAUGE:
+            {
+                char buf[32];
+                int n = snprintf(buf, sizeof(buf), "%.17g", entry.gauge());
+                appendSample(out, entry.name, "", entry.labels, "");
+                out.append(buf, static_cast<size_t>(n));
+                out += '\n';
+                break;
+            }
+            case Type::HISTOGRAM:
+            {
+                Histogram::Snapshot snapshot = entry.histogram->snapshot();
+                // 桶按下界递增，一次遍历累计出各边界以下的记录数
+                uint64_t cumulative = 0;
+                size_t bucket = 0;
+                for (unsigned exponent = MIN_LE_EXPONENT; exponent <= Histogram::MAX_EXPONENT; ++exponent)
+                {
+                    uint64_t bound = 1ull << exponent;
+                    for (; bucket < snapshot.buckets.size() && Histogram::bucketLowerBound(bucket) < bound; ++bucket)
+                    {
+                        cumulative += snapshot.buckets[bucket];
+                    }
+                    std::string le = "le=\"";
+                    appendSeconds(le, bound);
+                    le += '"';
+                    appendSample(out, entry.name, "_bucket", entry.labels, le);
+                    out += std::to_string(cumulative) + "\n";
+                }
+                appendSample(out, entry.name, "_bucket", entry.labels, "le=\"+Inf\"");
+                out += std::to_string(snapshot.count) + "\n";
+                appendSample(out, entry.name, "_sum", entry.labels, "");
+                appendSeconds(out, snapshot.sum);
+                out += '\n';
+                appendSample(out, entry.name, "_count", entry.labels, "");
+                out += std::to_string(snapshot.count) + "\n";
+                break;
+            }
+        }
+    }
+    return out;
+}
+